@@ -744,6 +744,7 @@ static Bool seng_output(void *param)
 	GF_SceneEngine *seng = prog->seng;
 	GF_SimpleDataDescriptor *audio_desc;
 	Bool update_context=0;
+	u64 enc_start, enc_end;
 	Bool force_rap, adjust_carousel_time, discard_pending, signal_rap, signal_critical, version_inc, aggregate_au;
 	u32 period, ts_delta;
 	u16 es_id, aggregate_on_stream;
@@ -849,7 +850,10 @@ static Bool seng_output(void *param)
 						set_broadcast_params(prog, es_id, period, ts_delta, aggregate_on_stream, adjust_carousel_time, force_rap, aggregate_au, discard_pending, signal_rap, signal_critical, version_inc);
 					}
 
+					enc_start = gf_sys_clock_high_res();
 					e = gf_seng_encode_from_file(seng, es_id, aggregate_au ? 0 : 1, prog->src_name, SampleCallBack);
+					enc_end = gf_sys_clock_high_res();
+					GF_LOG(GF_LOG_DEBUG, GF_LOG_SCENE, ("[MPEG-2 TS] Update AU encoded in %u us\n", (u32) (enc_end - enc_start)));
 					if (e){
 						fprintf(stderr, "Processing command failed: %s\n", gf_error_to_string(e));
 					} else
@@ -863,7 +867,10 @@ static Bool seng_output(void *param)
 			}
 			if (update_context) {
 				prog->repeat = 1;
+				enc_start = gf_sys_clock_high_res();
 				e = gf_seng_encode_context(seng, SampleCallBack);
+				enc_end = gf_sys_clock_high_res();
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_SCENE, ("[MPEG-2 TS] RAP carousel encoded in %u us\n", (u32) (enc_end - enc_start)));
 				prog->repeat = 0;
 				update_context = 0;
 			}
@@ -415,6 +415,7 @@ void PrintEncryptUsage()
 {
 	fprintf(stdout, "ISMA Encryption/Decryption Options\n"
 			" -crypt drm_file      crypts a specific track using ISMA AES CTR 128\n"
+			" -crypt-threads N     encrypts samples using N threads (output is unchanged)\n"
 			" -decrypt [drm_file]  decrypts a specific track using ISMA AES CTR 128\n"
 			"                       * Note: drm_file can be omitted if keys are in file\n"
 			" -set-kms kms_uri     changes KMS location for all tracks or a given one.\n"
@@ -454,6 +455,7 @@ void PrintHintUsage()
 			" -hint                hints the file for RTP/RTSP\n"
 			" -mtu size            specifies RTP MTU (max size) in bytes. Default size is 1450\n"
 			"                       * Note: this includes the RTP header (12 bytes)\n"
+			" -hint-threads N      hints up to N tracks in parallel (output is unchanged)\n"
 			" -copy                copies media data to hint track rather than reference\n"
 			"                       * Note: speeds up server but takes much more space\n"
 			" -multi [maxptime]    enables frame concatenation in RTP packets if possible\n"
@@ -663,7 +665,41 @@ void SetupClockReferences(GF_ISOFile *file)
 /*base RTP payload type used (you can specify your own types if needed)*/
 #define BASE_PAYT		96
 
-GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32 base_flags, Bool copy_data, Bool interleave, Bool regular_iod, Bool single_group)
+/*processes and finalizes hinters in track order - as with serial hinting, only an error on the first track is fatal*/
+static GF_Err HintTracks(GF_List *hinters, u32 nb_threads, Bool has_iod)
+{
+	u32 i, count;
+	GF_Err e, ret;
+	GF_RTPHinter **tk_hinters;
+	GF_Err *errors;
+
+	count = gf_list_count(hinters);
+	if (!count) return GF_OK;
+	tk_hinters = (GF_RTPHinter **) gf_malloc(sizeof(GF_RTPHinter *) * count);
+	errors = (GF_Err *) gf_malloc(sizeof(GF_Err) * count);
+	for (i=0; i<count; i++) tk_hinters[i] = (GF_RTPHinter *) gf_list_get(hinters, i);
+
+	gf_hinter_process_tracks(tk_hinters, count, nb_threads, errors);
+
+	ret = GF_OK;
+	for (i=0; i<count; i++) {
+		e = errors[i];
+		if (!e) e = gf_hinter_track_finalize(tk_hinters[i], has_iod);
+		if (e) {
+			fprintf(stdout, "Error while hinting (%s)\n", gf_error_to_string(e));
+			if (!i) {
+				ret = e;
+				break;
+			}
+		}
+	}
+	for (i=0; i<count; i++) gf_hinter_track_del(tk_hinters[i]);
+	gf_free(tk_hinters);
+	gf_free(errors);
+	return ret;
+}
+
+GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32 base_flags, Bool copy_data, Bool interleave, Bool regular_iod, Bool single_group, u32 nb_threads)
 {
 	GF_ESD *esd;
 	GF_InitialObjectDescriptor *iod;
@@ -672,6 +708,7 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 	GF_Err e;
 	char szPayload[30];
 	GF_RTPHinter *hinter;
+	GF_List *hinters;
 	Bool copy, has_iod, single_av;
 	u8 init_payt = BASE_PAYT;
 	u32 iod_mode, mtype;
@@ -704,6 +741,9 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		}
 	}
 
+	/*tracks hinted concurrently: all hint tracks are created first, then processed and finalized in track order*/
+	hinters = (nb_threads>1) ? gf_list_new() : NULL;
+
 	nb_done = 0;
 	for (i=0; i<gf_isom_get_track_count(file); i++) {
 		sl_mode = base_flags;
@@ -780,7 +820,10 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		if (!hinter) {
 			if (e) {
 				fprintf(stdout, "Cannot create hinter (%s)\n", gf_error_to_string(e));
-				if (!nb_done) return e;
+				if (!nb_done) {
+					if (hinters) gf_list_del(hinters);
+					return e;
+				}
 			}
 			continue;
 		} 
@@ -794,6 +837,12 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		if (flags & GP_RTP_PCK_FORCE_MPEG4) fprintf(stdout, "\tMPEG4 transport forced\n");
 		if (flags & GP_RTP_PCK_USE_MULTI) fprintf(stdout, "\tRTP aggregation enabled\n");
 */
+		if (hinters) {
+			gf_list_add(hinters, hinter);
+			init_payt++;
+			nb_done ++;
+			continue;
+		}
 		e = gf_hinter_track_process(hinter);
 
 		if (!e) e = gf_hinter_track_finalize(hinter, has_iod);
@@ -807,6 +856,12 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		nb_done ++;
 	}
 
+	if (hinters) {
+		e = HintTracks(hinters, nb_threads, has_iod);
+		gf_list_del(hinters);
+		if (e) return e;
+	}
+
 	if (has_iod) {
 		iod_mode = GF_SDP_IOD_ISMA;
 		if (regular_iod) iod_mode = GF_SDP_IOD_REGULAR;
@@ -1214,7 +1269,7 @@ int mp4boxMain(int argc, char **argv)
 	u64 movie_time;
 	s32 subsegs_per_sidx;
 	u32 brand_add[MAX_CUMUL_OPS];
-	u32 i, MTUSize, stat_level, hint_flags, info_track_id, import_flags, nb_add, nb_cat, ismaCrypt, agg_samples, nb_sdp_ex, max_ptime, raw_sample_num, split_size, nb_meta_act, nb_track_act, rtp_rate, major_brand, nb_alt_brand_add, nb_alt_brand_rem, old_interleave, car_dur, minor_version, conv_type, nb_tsel_acts, program_number;
+	u32 i, MTUSize, stat_level, hint_flags, info_track_id, import_flags, nb_add, nb_cat, ismaCrypt, crypt_threads, hint_threads, agg_samples, nb_sdp_ex, max_ptime, raw_sample_num, split_size, nb_meta_act, nb_track_act, rtp_rate, major_brand, nb_alt_brand_add, nb_alt_brand_rem, old_interleave, car_dur, minor_version, conv_type, nb_tsel_acts, program_number;
 	Bool HintIt, needSave, FullInter, Frag, HintInter, dump_std, dump_rtp, dump_mode, regular_iod, trackID, HintCopy, remove_sys_tracks, remove_hint, force_new, remove_root_od, import_subtitle, dump_chap;
 	Bool print_sdp, print_info, open_edit, track_dump_type, dump_isom, dump_cr, force_ocr, encode, do_log, do_flat, dump_srt, dump_ttxt, chunk_mode, dump_ts, do_saf, do_mpd, dump_m2ts, dump_cart, do_hash, verbose, force_cat, pack_wgt, single_group;
 	char *inName, *outName, *arg, *mediaSource, *tmpdir, *input_ctx, *output_ctx, *drm_file, *avi2raw, *cprt, *chap_file, *pes_dump, *itunes_tags, *pack_file, *raw_cat, *seg_name, *dash_ctx;
@@ -1255,6 +1310,8 @@ int mp4boxMain(int argc, char **argv)
 	subsegs_per_sidx = 0;
 	track_dump_type = 0;
 	ismaCrypt = 0;
+	crypt_threads = 0;
+	hint_threads = 0;
 	file = NULL;
 	itunes_tags = pes_dump = NULL;
 	seg_name = dash_ctx = NULL;
@@ -1552,6 +1609,11 @@ int mp4boxMain(int argc, char **argv)
 #ifndef GPAC_DISABLE_ISOM_HINTING
 		else if (!stricmp(arg, "-hint")) { open_edit = 1; HintIt = 1; }
 		else if (!stricmp(arg, "-unhint")) { open_edit = 1; remove_hint = 1; }
+		else if (!stricmp(arg, "-hint-threads")) {
+			CHECK_NEXT_ARG
+			hint_threads = atoi(argv[i+1]);
+			i += 1;
+		}
 		else if (!stricmp(arg, "-copy")) HintCopy = 1;
 		else if (!stricmp(arg, "-tight")) {
 			FullInter = 1;
@@ -1898,6 +1960,11 @@ int mp4boxMain(int argc, char **argv)
 			open_edit = 1;
 			i += 1;
 		}
+		else if (!strcmp(arg, "-crypt-threads")) {
+			CHECK_NEXT_ARG
+			crypt_threads = atoi(argv[i+1]);
+			i += 1;
+		}
 		else if (!strcmp(arg, "-decrypt")) {
 			CHECK_NEXT_ARG
 			ismaCrypt = 2;
@@ -2925,7 +2992,7 @@ int mp4boxMain(int argc, char **argv)
 					e = GF_BAD_PARAM;
 					goto err_exit;
 				}
-				e = gf_ismacryp_crypt_file(file, drm_file);
+				e = gf_ismacryp_crypt_file(file, drm_file, crypt_threads);
 			} else if (ismaCrypt ==2) {
 				e = gf_ismacryp_decrypt_file(file, drm_file);
 			}
@@ -3346,7 +3413,7 @@ int mp4boxMain(int argc, char **argv)
 		if (force_ocr) SetupClockReferences(file);
 		fprintf(stdout, "Hinting file with Path-MTU %d Bytes\n", MTUSize);
 		MTUSize -= 12;		
-		e = HintFile(file, MTUSize, max_ptime, rtp_rate, hint_flags, HintCopy, HintInter, regular_iod, single_group);
+		e = HintFile(file, MTUSize, max_ptime, rtp_rate, hint_flags, HintCopy, HintInter, regular_iod, single_group, hint_threads);
 		if (e) goto err_exit;
 		needSave = 1;
 		if (print_sdp) DumpSDP(file, dump_std ? NULL : outfile);
@@ -434,10 +434,133 @@ void dump_depth (GF_Terminal *term, char *rad_name, u32 dump_type, u32 frameNum,
 	if (dump_type!=8) gf_sc_release_screen_buffer(term->compositor, &fb);
 }
 
+/*converts one line of the frame buffer to BGR 24 bits (BGRA 32 bits for RGBD and RGBDS)*/
+static void convert_line(u32 pixel_format, char *src, char *dst, u32 width)
+{
+	u32 i;
+	u16 src_16;
+	switch (pixel_format) {
+	case GF_PIXEL_RGB_32:
+	case GF_PIXEL_ARGB:
+		for (i=0;i<width; i++) {
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			src+=4;
+			dst += 3;
+		}
+		break;
+	case GF_PIXEL_RGBDS:
+		for (i=0;i<width; i++) {
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			dst[3] = src[3];
+			dst +=4;
+			src+=4;
+		}
+		break;		
+	case GF_PIXEL_RGBD:
+		for (i=0;i<width; i++) {
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			dst[3] = src[3];
+			dst += 4;
+			src+=4;
+		}
+		break;				
+	case GF_PIXEL_BGR_32:
+	case GF_PIXEL_RGBA:
+		for (i=0;i<width; i++) {
+			dst[0] = src[3];
+			dst[1] = src[2];
+			dst[2] = src[1];
+			src+=4;
+			dst+=3;
+		}
+		break;
+	case GF_PIXEL_RGB_24:
+		for (i=0;i<width; i++) {
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			src+=3;
+			dst+=3;
+		}
+		break;
+	case GF_PIXEL_BGR_24:
+		for (i=0;i<width; i++) {
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			src+=3;
+			dst+=3;
+		}
+		break;
+	case GF_PIXEL_RGB_565:
+		for (i=0;i<width; i++) {
+			src_16 = * ( (u16 *)src );
+			dst[2] = colmask(src_16 >> 8/*(11 - 3)*/, 3);
+			dst[1] = colmask(src_16 >> 3/*(5 - 2)*/, 2);
+			dst[0] = colmask(src_16 << 3, 3);
+			src+=2;
+			dst+=3;
+		}
+		break;
+	case GF_PIXEL_RGB_555:
+		for (i=0;i<width; i++) {
+			src_16 = * (u16 *)src;
+			dst[2] = colmask(src_16 >> 7/*(10 - 3)*/, 3);
+			dst[1] = colmask(src_16 >> 2/*(5 - 3)*/, 3);
+			dst[0] = colmask(src_16 << 3, 3);
+			src+=2;
+			dst +=3;
+		}
+		break;
+	}
+}
+
+/*writes the frame as BT.601 YUV 4:2:0, each chroma sample being the average of the 2x2 block*/
+static void write_y4m_frame(FILE *out, u8 *bgr, u32 width, u32 height, u8 *yuv)
+{
+	u32 i, j, uv_w, uv_h;
+	u8 *y_p, *u_p, *v_p;
+	uv_w = (width+1)/2;
+	uv_h = (height+1)/2;
+	y_p = yuv;
+	u_p = yuv + width*height;
+	v_p = u_p + uv_w*uv_h;
+
+	for (j=0; j<height; j++) {
+		u8 *src = bgr + j*width*3;
+		for (i=0; i<width; i++) {
+			*y_p++ = (u8) (((66*src[2] + 129*src[1] + 25*src[0] + 128) >> 8) + 16);
+			src += 3;
+		}
+	}
+	for (j=0; j<uv_h; j++) {
+		u8 *l1 = bgr + 2*j*width*3;
+		u8 *l2 = (2*j+1<height) ? l1 + width*3 : l1;
+		for (i=0; i<uv_w; i++) {
+			u32 o2 = (2*i+1<width) ? 3 : 0;
+			s32 b = (l1[0] + l1[o2] + l2[0] + l2[o2] + 2) >> 2;
+			s32 g = (l1[1] + l1[o2+1] + l2[1] + l2[o2+1] + 2) >> 2;
+			s32 r = (l1[2] + l1[o2+2] + l2[2] + l2[o2+2] + 2) >> 2;
+			*u_p++ = (u8) (((-38*r - 74*g + 112*b + 128) >> 8) + 128);
+			*v_p++ = (u8) (((112*r - 94*g - 18*b + 128) >> 8) + 128);
+			l1 += 6;
+			l2 += 6;
+		}
+	}
+	fwrite("FRAME\n", 1, 6, out);
+	fwrite(yuv, 1, width*height + 2*uv_w*uv_h, out);
+}
+
 void dump_frame(GF_Terminal *term, char *rad_name, u32 dump_type, u32 frameNum, char *conv_buf, void *avi_out)
 {
 	GF_Err e = GF_OK;
-	u32 i, k, out_size;
+	u32 k, out_size;
 	GF_VideoSurface fb;
 
 	/*lock it*/
@@ -455,91 +578,11 @@ void dump_frame(GF_Terminal *term, char *rad_name, u32 dump_type, u32 frameNum,
 		/*reverse frame*/
 		for (k=0; k<fb.height; k++) {
 			char *dst, *src;
-			u16 src_16;
 			if (dump_type==5 || dump_type==10) dst = conv_buf + k*fb.width*4;
 			else dst = conv_buf + k*fb.width*3;
 			src = fb.video_buffer + (fb.height-k-1) * fb.pitch_y;
 
-			switch (fb.pixel_format) {
-			case GF_PIXEL_RGB_32:
-			case GF_PIXEL_ARGB:
-				for (i=0;i<fb.width; i++) {
-					dst[0] = src[0];
-					dst[1] = src[1];
-					dst[2] = src[2];
-					src+=4;
-					dst += 3;
-				}
-				break;
-			case GF_PIXEL_RGBDS:
-				for (i=0;i<fb.width; i++) {
-					dst[0] = src[2];
-					dst[1] = src[1];
-					dst[2] = src[0];
-					dst[3] = src[3];
-					dst +=4;
-					src+=4;
-				}
-				break;		
-			case GF_PIXEL_RGBD:
-				for (i=0;i<fb.width; i++) {
-					dst[0] = src[2];
-					dst[1] = src[1];
-					dst[2] = src[0];
-					dst[3] = src[3];
-					dst += 4;
-					src+=4;
-				}
-				break;				
-			case GF_PIXEL_BGR_32:
-			case GF_PIXEL_RGBA:
-				for (i=0;i<fb.width; i++) {
-					dst[0] = src[3];
-					dst[1] = src[2];
-					dst[2] = src[1];
-					src+=4;
-					dst+=3;
-				}
-				break;
-			case GF_PIXEL_RGB_24:
-				for (i=0;i<fb.width; i++) {
-					dst[0] = src[2];
-					dst[1] = src[1];
-					dst[2] = src[0];
-					src+=3;
-					dst+=3;
-				}
-				break;
-			case GF_PIXEL_BGR_24:
-				for (i=0;i<fb.width; i++) {
-					dst[0] = src[2];
-					dst[1] = src[1];
-					dst[2] = src[0];
-					src+=3;
-					dst+=3;
-				}
-				break;
-			case GF_PIXEL_RGB_565:
-				for (i=0;i<fb.width; i++) {
-					src_16 = * ( (u16 *)src );
-					dst[2] = colmask(src_16 >> 8/*(11 - 3)*/, 3);
-					dst[1] = colmask(src_16 >> 3/*(5 - 2)*/, 2);
-					dst[0] = colmask(src_16 << 3, 3);
-					src+=2;
-					dst+=3;
-				}
-				break;
-			case GF_PIXEL_RGB_555:
-				for (i=0;i<fb.width; i++) {
-					src_16 = * (u16 *)src;
-					dst[2] = colmask(src_16 >> 7/*(10 - 3)*/, 3);
-					dst[1] = colmask(src_16 >> 2/*(5 - 3)*/, 3);
-					dst[0] = colmask(src_16 << 3, 3);
-					src+=2;
-					dst +=3;
-				}
-				break;
-			}
+			convert_line(fb.pixel_format, src, dst, fb.width);
 		}
 		if (dump_type!=5 && dump_type!= 10 && dump_type!= 11) { 
 			out_size = fb.height*fb.width*3;
@@ -570,12 +613,24 @@ void dump_frame(GF_Terminal *term, char *rad_name, u32 dump_type, u32 frameNum,
 	case 3:
 		write_raw(&fb, rad_name, frameNum);
 		break;
+	/*video streams, frames are written top to bottom*/
+	case 12:
+	case 13:
+		for (k=0; k<fb.height; k++) {
+			convert_line(fb.pixel_format, fb.video_buffer + k*fb.pitch_y, conv_buf + k*fb.width*3, fb.width);
+		}
+		if (dump_type==12) {
+			write_y4m_frame((FILE *)avi_out, (u8 *) conv_buf, fb.width, fb.height, (u8 *) conv_buf + fb.width*fb.height*3);
+		} else {
+			fwrite(conv_buf, 1, fb.width*fb.height*3, (FILE *)avi_out);
+		}
+		break;
 	}
 	/*unlock it*/
 	gf_sc_release_screen_buffer(term->compositor, &fb);
 }
 
-Bool dump_file(char *url, u32 dump_mode, Double fps, u32 width, u32 height, Float scale, u32 *times, u32 nb_times)
+Bool dump_file(char *url, char *out_url, u32 dump_mode, Double fps, u32 width, u32 height, Float scale, u32 *times, u32 nb_times)
 {
 	GF_Err e;
 	u32 i = 0;
@@ -647,7 +702,83 @@ Bool dump_file(char *url, u32 dump_mode, Double fps, u32 width, u32 height, Floa
 		gf_sc_release_screen_buffer(term->compositor, &fb);
 	}
 
-	if (dump_mode==1 || dump_mode==5 || dump_mode==8 || dump_mode==10) {
+	/*offline rendering to a Y4M or raw BGR stream: clocks are stepped by one frame duration after each frame, and
+the decoders are run until the frame is ready*/
+	if (dump_mode==12 || dump_mode==13) {
+		u32 time, start_time, nb_frames, dump_dur, fps_num, fps_den;
+		char *conv_buf;
+		FILE *out;
+
+		if (out_url) strcpy(szPath, out_url);
+		else strcat(szPath, (dump_mode==12) ? ".y4m" : ".bgr");
+		out = gf_f64_open(szPath, "wb");
+		if (!out) {
+			fprintf(stdout, "Error creating output file %s\n", szPath);
+			return 1;
+		}
+
+		if (!fps) fps = GF_IMPORT_DEFAULT_FPS;
+		/*express frame rate as a fraction, eg 30000/1001 for 29.97*/
+		fps_num = (u32) (fps + 0.5);
+		fps_den = 1;
+		if (ABSDIFF(fps, fps_num) > 0.0001) {
+			fps_num = (u32) (fps*1.001 + 0.5);
+			if (ABSDIFF(fps, fps_num/1.001) < 0.0001) {
+				fps_num *= 1000;
+				fps_den = 1001;
+			} else {
+				fps_num = (u32) (fps*1000 + 0.5);
+				fps_den = 1000;
+			}
+		}
+
+		start_time = 0;
+		if (nb_times==2) {
+			start_time = times[0];
+			dump_dur = times[1] - times[0];
+		} else {
+			dump_dur = times[0] ? times[0] : Duration;
+		}
+		if (!dump_dur) {
+			fprintf(stdout, "Warning: file has no duration, defaulting to 1 sec\n");
+			dump_dur = 1000;
+		}
+
+		if (dump_mode==12) {
+			fprintf(out, "YUV4MPEG2 W%d H%d F%d:%d Ip A1:1 C420jpeg\n", width, height, fps_num, fps_den);
+		}
+		/*BGR frame followed by the YUV frame for Y4M*/
+		conv_buf = gf_malloc(sizeof(char) * (width*height*3 + width*height + 2*((width+1)/2)*((height+1)/2)) );
+
+		if (start_time) gf_term_step_clocks(term, start_time);
+
+		time = 0;
+		nb_frames = 0;
+		while (time < dump_dur) {
+			u32 next_time;
+			while ((gf_term_get_option(term, GF_OPT_PLAY_STATE) == GF_STATE_STEP_PAUSE)) {
+				gf_term_process_flush(term);
+			}
+			dump_frame(term, szPath, dump_mode, nb_frames+1, conv_buf, out);
+			nb_frames++;
+
+			if (!(nb_frames % 25)) 
+				fprintf(stdout, "Rendering %02d/100 %% - time %.02f sec\r", (u32) ((100.0*time)/dump_dur), (start_time+time)/1000.0 );
+
+			/*frame times are computed from the frame count to avoid rounding drift*/
+			next_time = (u32) ( ((u64) nb_frames) * 1000 * fps_den / fps_num);
+			gf_term_step_clocks(term, next_time - time);
+			time = next_time;
+
+			if (gf_prompt_has_input() && (gf_prompt_get_char()=='q')) {
+				fprintf(stdout, "Aborting dump\n");
+				break;
+			}
+		}
+		fclose(out);
+		gf_free(conv_buf);
+		fprintf(stdout, "Rendered %d frames to %s\n", nb_frames, szPath);
+	} else if (dump_mode==1 || dump_mode==5 || dump_mode==8 || dump_mode==10) {
 #ifdef GPAC_DISABLE_AVILIB
 		fprintf(stdout, "AVILib is disabled in this build of GPAC\n");
 		return 0;
@@ -103,7 +103,7 @@ u32 last_x, last_y;
 Bool right_down = 0;
 
 void dump_frame(GF_Terminal *term, char *rad_path, u32 dump_type, u32 frameNum);
-Bool dump_file(char *the_url, u32 dump_mode, Double fps, u32 width, u32 height, Float scale, u32 *times, u32 nb_times);
+Bool dump_file(char *the_url, char *out_url, u32 dump_mode, Double fps, u32 width, u32 height, Float scale, u32 *times, u32 nb_times);
 
 
 void hide_shell(u32 cmd_type)
@@ -199,6 +199,9 @@ void PrintUsage()
 		"\t-png [times]:   dumps given frames to png\n"
 		"\t-raw [times]:   dumps given frames to raw\n"
 		"\t-avi [times]:   dumps given file to raw avi\n"
+		"\t-y4m [times]:   renders given file to YUV4MPEG2 (4:2:0) video, faster than real-time\n"
+		"\t-bgr [times]:   renders given file to raw BGR 24 bits video, faster than real-time\n"
+		"\t-out dst:       output file or named pipe for -y4m and -bgr (default: file name with .y4m or .bgr extension)\n"
 		"\t-rgbds:         dumps the RGBDS pixel format texture\n"
 		"                   with -avi [times]: dumps an rgbds-format .avi\n"
 		"\t-rgbd:          dumps the RGBD pixel format texture\n"
@@ -206,7 +209,7 @@ void PrintUsage()
 		"\t-depth:         dumps depthmap (z-buffer) frames\n"
 		"                   with -avi [times]: dumps depthmap in grayscale .avi\n"		
 		"                   with -bmp: dumps depthmap in grayscale .bmp\n"		
-		"\t-fps FPS:       specifies frame rate for AVI dumping (default: %f)\n"
+		"\t-fps FPS:       specifies frame rate for AVI and video dumping (default: %f)\n"
 		"\t-scale s:       scales the visual size (default: 1)\n"
 		"\t-fill:          uses fill aspect ratio for dumping (default: none)\n"
 		"\t-show:          show window while dumping (default: no)\n"
@@ -893,7 +896,7 @@ int main (int argc, char **argv)
 #endif
 	Double fps = GF_IMPORT_DEFAULT_FPS;
 	Bool fill_ar, visible;
-	char *url_arg, *the_cfg, *rti_file, *views;
+	char *url_arg, *out_arg, *the_cfg, *rti_file, *views;
 	FILE *logfile = NULL;
 	Float scale = 1;
 #ifndef WIN32
@@ -907,7 +910,7 @@ int main (int argc, char **argv)
 
 	dump_mode = 0;
 	fill_ar = visible = 0;
-	url_arg = the_cfg = rti_file = views = NULL;
+	url_arg = out_arg = the_cfg = rti_file = views = NULL;
 	nb_times = 0;
 	times[0] = 0;
 
@@ -1003,6 +1006,15 @@ int main (int argc, char **argv)
 		} else if (!strcmp(arg, "-raw")) {
 			dump_mode = 3;
 			if ((url_arg || (i+2<(u32)argc)) && get_time_list(argv[i+1], times, &nb_times)) i++;
+		} else if (!strcmp(arg, "-y4m")) {
+			dump_mode = 12;
+			if ((url_arg || (i+2<(u32)argc)) && get_time_list(argv[i+1], times, &nb_times)) i++;
+		} else if (!strcmp(arg, "-bgr")) {
+			dump_mode = 13;
+			if ((url_arg || (i+2<(u32)argc)) && get_time_list(argv[i+1], times, &nb_times)) i++;
+		} else if (!strcmp(arg, "-out")) {
+			out_arg = argv[i+1];
+			i++;
 
 		} else if (!stricmp(arg, "-size")) {
 			/*usage of %ud breaks sscanf on MSVC*/
@@ -1132,6 +1144,11 @@ int main (int argc, char **argv)
 	if (dump_mode) {
 		user.init_flags |= GF_TERM_NO_AUDIO | GF_TERM_NO_DECODER_THREAD | GF_TERM_NO_COMPOSITOR_THREAD | GF_TERM_NO_REGULATION /*| GF_TERM_INIT_HIDE*/;
 		if (visible || dump_mode==8) user.init_flags |= GF_TERM_INIT_HIDE;
+		/*offline rendering is done in memory through the software rasterizer, no display needed - the
+		configured video driver is left untouched*/
+		if ((dump_mode==12) || (dump_mode==13)) {
+			gf_cfg_set_key(cfg_file, "Temp", "VideoDriverName", "Raw Video Output");
+		}
 	} else {
 		init_w = forced_width;
 		init_h = forced_height;
@@ -1215,7 +1232,7 @@ int main (int argc, char **argv)
 			times[0] = 0;
 			nb_times++;
 		}
-		dump_file(url_arg, dump_mode, fps, forced_width, forced_height, scale, times, nb_times);
+		dump_file(url_arg, out_arg, dump_mode, fps, forced_width, forced_height, scale, times, nb_times);
 		Run = 0;
 	} else
 
@@ -0,0 +1,181 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Copyright (c) Jean Le Feuvre 2000-2005
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / AES benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*checks the AES CTR and CBC modes of the crypto lib against the NIST SP 800-38A test vectors, then measures
+the encryption throughput on large buffers and on small ones*/
+
+#include <gpac/crypt.h>
+
+typedef struct
+{
+	const char *mode;
+	const char *key, *iv, *cipher;
+} CBVector;
+
+/*SP 800-38A F.5.1, F.5.3, F.5.5, F.2.1 and F.2.5 - the plaintext is the same for all vectors*/
+static const char *cb_plain = "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+static const CBVector cb_vectors[] = {
+	{"CTR", "2b7e151628aed2a6abf7158809cf4f3c", "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+		"874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee"},
+	{"CTR", "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+		"1abc932417521ca24f2b0459fe7e6e0b090339ec0aa6faefd5ccc2c6f4ce8e941e36b26bd1ebc670d1bd1d665620abf74f78a7f6d29809585a97daec58c6b050"},
+	{"CTR", "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+		"601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c52b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6"},
+	{"CBC", "2b7e151628aed2a6abf7158809cf4f3c", "000102030405060708090a0b0c0d0e0f",
+		"7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b273bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7"},
+	{"CBC", "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", "000102030405060708090a0b0c0d0e0f",
+		"f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b"},
+};
+
+static u32 cb_hex(const char *hex, u8 *data)
+{
+	u32 i, len = strlen(hex) / 2;
+	for (i=0; i<len; i++) {
+		u32 v;
+		sscanf(hex + 2*i, "%02x", &v);
+		data[i] = v;
+	}
+	return len;
+}
+
+static GF_Crypt *cb_open(const char *mode, u8 *key, u32 key_size, u8 *iv)
+{
+	GF_Crypt *mc = gf_crypt_open("AES-128", mode);
+	if (!mc) return NULL;
+	if (gf_crypt_init(mc, key, key_size, iv) != GF_OK) {
+		gf_crypt_close(mc);
+		return NULL;
+	}
+	return mc;
+}
+
+/*processes the data in chunks of the given sizes, so that partial CTR blocks are carried between calls*/
+static void cb_process(GF_Crypt *mc, Bool decrypt, u8 *data, u32 size, const u32 *chunks)
+{
+	u32 i = 0;
+	while (size) {
+		u32 s = chunks ? MIN(chunks[i % 4], size) : size;
+		if (decrypt) gf_crypt_decrypt(mc, data, s);
+		else gf_crypt_encrypt(mc, data, s);
+		data += s;
+		size -= s;
+		i++;
+	}
+}
+
+static u32 cb_check_vectors()
+{
+	u32 i, j, nb_errors, key_size, size;
+	u8 key[32], iv[16], plain[64], cipher[64], buf[64];
+	static const u32 ctr_chunks[4] = {1, 7, 16, 37};
+	static const u32 cbc_chunks[4] = {16, 32, 16, 16};
+
+	nb_errors = 0;
+	size = cb_hex(cb_plain, plain);
+	for (i=0; i<sizeof(cb_vectors) / sizeof(CBVector); i++) {
+		const CBVector *v = &cb_vectors[i];
+		key_size = cb_hex(v->key, key);
+		cb_hex(v->iv, iv);
+		cb_hex(v->cipher, cipher);
+		/*whole buffer, then split in several calls*/
+		for (j=0; j<2; j++) {
+			const u32 *chunks = j ? (!strcmp(v->mode, "CTR") ? ctr_chunks : cbc_chunks) : NULL;
+			GF_Crypt *mc = cb_open(v->mode, key, key_size, iv);
+			if (!mc) {
+				fprintf(stderr, "AES-%d %s: cannot open\n", key_size*8, v->mode);
+				nb_errors++;
+				break;
+			}
+			memcpy(buf, plain, size);
+			cb_process(mc, 0, buf, size, chunks);
+			gf_crypt_close(mc);
+			if (memcmp(buf, cipher, size)) {
+				fprintf(stderr, "AES-%d %s%s: encryption mismatch\n", key_size*8, v->mode, j ? " (split)" : "");
+				nb_errors++;
+			}
+			mc = cb_open(v->mode, key, key_size, iv);
+			cb_process(mc, 1, buf, size, chunks);
+			gf_crypt_close(mc);
+			if (memcmp(buf, plain, size)) {
+				fprintf(stderr, "AES-%d %s%s: decryption mismatch\n", key_size*8, v->mode, j ? " (split)" : "");
+				nb_errors++;
+			}
+		}
+	}
+	fprintf(stdout, "Known answer tests: %d errors\n", nb_errors);
+	return nb_errors;
+}
+
+static void cb_bench(const char *mode, Bool decrypt, u32 total_size, u32 chunk_size)
+{
+	u32 i, now;
+	u8 key[16], iv[16], *data;
+	GF_Crypt *mc;
+
+	for (i=0; i<16; i++) key[i] = iv[i] = i;
+	data = gf_malloc(sizeof(u8) * chunk_size);
+	for (i=0; i<chunk_size; i++) data[i] = i;
+	mc = cb_open(mode, key, 16, iv);
+
+	now = gf_sys_clock();
+	for (i=0; i<total_size / chunk_size; i++) {
+		if (decrypt) gf_crypt_decrypt(mc, data, chunk_size);
+		else gf_crypt_encrypt(mc, data, chunk_size);
+	}
+	now = gf_sys_clock() - now;
+
+	gf_crypt_close(mc);
+	gf_free(data);
+	fprintf(stdout, "AES-128 %s %s - %6d byte chunks: %5d ms - %.2f MB/s\n", mode, decrypt ? "decrypt" : "encrypt", chunk_size, now, now ? (1000.0*total_size) / now / (1024*1024) : 0.0);
+}
+
+static void usage()
+{
+	fprintf(stdout, "cryptbench [-s size_in_mb]\n");
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, size, nb_errors;
+
+	size = 256;
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-s") && (i+1<(u32)argc)) size = atoi(argv[++i]);
+		else {
+			usage();
+			return 0;
+		}
+	}
+	size *= 1024*1024;
+
+	gf_sys_init(0);
+	nb_errors = cb_check_vectors();
+	cb_bench("CTR", 0, size, 65536);
+	cb_bench("CTR", 1, size, 65536);
+	cb_bench("CTR", 0, size / 4, 188);
+	cb_bench("CBC", 0, size, 65536);
+	cb_bench("CBC", 1, size, 65536);
+	gf_sys_close();
+	return nb_errors ? 1 : 0;
+}
@@ -0,0 +1,441 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Copyright (c) Jean Le Feuvre 2000-2005
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / download manager benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*downloads many small files from a local HTTP server running in a thread of this application, using threaded
+sessions driven either by one thread per session or by the download manager I/O threads. The content of each
+file is checked against what the server sent. Files are downloaded either without cache or as cacheable resources kept
+in the memory cache, and some of both are written out of the memory cache and checked on disk.
+Sequential downloads are then done on a keep-alive server, first one session per file and then byte ranges of one
+file through a single persistent session pipelining the next range*/
+
+#include <gpac/download.h>
+#include <gpac/network.h>
+#include <gpac/thread.h>
+#include <gpac/config_file.h>
+
+typedef struct
+{
+	GF_Socket *sock;
+	u16 port;
+	Bool run;
+	u32 nb_served;
+	/*serve several requests per connection*/
+	Bool keep_alive;
+	u32 nb_connections;
+} DMBServer;
+
+typedef struct
+{
+	GF_DownloadSession *sess;
+	u32 idx, size, crc;
+	Bool done, failed;
+	/*the session is deleted from its own callback once the file is received*/
+	Bool self_delete;
+} DMBFile;
+
+/*content of the file is fully determined by its index*/
+static u32 dmb_file_size(u32 idx)
+{
+	return 500 + (idx * 131) % 4000;
+}
+
+static u8 dmb_file_byte(u32 idx, u32 pos)
+{
+	return (u8) (idx*7 + pos*13);
+}
+
+static u32 dmb_crc_update(u32 crc, const u8 *data, u32 size)
+{
+	u32 i;
+	for (i=0; i<size; i++) crc = crc*31 + data[i];
+	return crc;
+}
+
+static u32 dmb_file_crc(u32 idx)
+{
+	u32 i, crc = 0;
+	for (i=0; i<dmb_file_size(idx); i++) {
+		u8 b = dmb_file_byte(idx, i);
+		crc = dmb_crc_update(crc, &b, 1);
+	}
+	return crc;
+}
+
+static void dmb_serve_connection(DMBServer *serv, GF_Socket *conn)
+{
+	char req[4096], hdr[512], *body, *end, *range;
+	u32 pos, read, idx, size, i, start, first, last, len;
+	GF_Err e;
+
+	serv->nb_connections++;
+	pos = 0;
+	req[0] = 0;
+	while (1) {
+		/*read the request header, a pipelined request may already be in the buffer*/
+		start = gf_sys_clock();
+		while (! (end = strstr(req, "\r\n\r\n")) ) {
+			e = gf_sk_receive(conn, req, 4095, pos, &read);
+			if (e == GF_OK) {
+				pos += read;
+				req[pos] = 0;
+				continue;
+			}
+			else if ((e != GF_IP_NETWORK_EMPTY) && (e != GF_IP_SOCK_WOULD_BLOCK)) return;
+			if ((pos == 4095) || (gf_sys_clock() - start > 5000)) return;
+			gf_sleep(0);
+		}
+		end[2] = 0;
+		len = (u32) (end + 4 - req);
+
+		idx = 0;
+		if (sscanf(req, "%*s /file%u", &idx) != 1) {
+			strcpy(hdr, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+			gf_sk_send(conn, hdr, strlen(hdr));
+			return;
+		}
+		size = dmb_file_size(idx);
+		first = 0;
+		last = size-1;
+		range = strstr(req, "Range: bytes=");
+		if (range) {
+			sscanf(range, "Range: bytes=%u-%u", &first, &last);
+			if (last >= size) last = size-1;
+			sprintf(hdr, "HTTP/1.1 206 Partial Content\r\nContent-Type: application/octet-stream\r\nContent-Range: bytes %d-%d/%d\r\nContent-Length: %d\r\nConnection: %s\r\n\r\n", first, last, size, last+1-first, serv->keep_alive ? "keep-alive" : "close");
+		} else {
+			sprintf(hdr, "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: %d\r\nConnection: %s\r\n\r\n", size, serv->keep_alive ? "keep-alive" : "close");
+		}
+		body = gf_malloc(sizeof(char) * (strlen(hdr) + last+1-first));
+		strcpy(body, hdr);
+		for (i=first; i<=last; i++) body[strlen(hdr) + i - first] = dmb_file_byte(idx, i);
+		gf_sk_send(conn, body, strlen(hdr) + last+1-first);
+		gf_free(body);
+		serv->nb_served++;
+		if (!serv->keep_alive) return;
+
+		/*remove the request from the buffer*/
+		memmove(req, req + len, pos - len + 1);
+		pos -= len;
+	}
+}
+
+static u32 dmb_server_run(void *par)
+{
+	DMBServer *serv = (DMBServer *)par;
+	while (serv->run) {
+		GF_Socket *conn;
+		GF_Err e = gf_sk_accept(serv->sock, &conn);
+		if (e || !conn) continue;
+		dmb_serve_connection(serv, conn);
+		gf_sk_del(conn);
+	}
+	return 0;
+}
+
+static void dmb_net_io(void *cbk, GF_NETIO_Parameter *param)
+{
+	DMBFile *file = (DMBFile *)cbk;
+	switch (param->msg_type) {
+	case GF_NETIO_DATA_EXCHANGE:
+		file->size += param->size;
+		file->crc = dmb_crc_update(file->crc, (u8 *) param->data, param->size);
+		break;
+	case GF_NETIO_DATA_TRANSFERED:
+		if (file->self_delete) {
+			gf_dm_sess_del(file->sess);
+			file->sess = NULL;
+		}
+		file->done = 1;
+		break;
+	case GF_NETIO_STATE_ERROR:
+		file->failed = 1;
+		break;
+	}
+}
+
+/*writes the cache file of a downloaded file, which moves it out of the memory cache, and checks it*/
+static Bool dmb_check_cache_file(DMBFile *file)
+{
+	u32 i, size, crc;
+	u8 buf[4096];
+	const char *name;
+	FILE *f;
+	if (gf_dm_sess_persist_cache(file->sess) != GF_OK) return 0;
+	name = gf_dm_sess_get_cache_name(file->sess);
+	f = name ? gf_f64_open(name, "rb") : NULL;
+	if (!f) return 0;
+	crc = size = 0;
+	while (1) {
+		i = fread(buf, 1, 4096, f);
+		if (!i) break;
+		crc = dmb_crc_update(crc, buf, i);
+		size += i;
+	}
+	fclose(f);
+	return ((size == file->size) && (crc == file->crc)) ? 1 : 0;
+}
+
+static Bool dmb_run(DMBServer *serv, const char *cache_dir, u32 nb_files, u32 nb_io_threads, const char *mem_cache)
+{
+	u32 i, now, nb_errors;
+	char szURL[100], szVal[20];
+	Bool all_dead;
+	DMBFile *files;
+	GF_Config *cfg;
+	GF_DownloadManager *dm;
+
+	cfg = gf_cfg_force_new(cache_dir, "dmbench.cfg");
+	gf_cfg_set_key(cfg, "General", "CacheDirectory", cache_dir);
+	gf_cfg_set_key(cfg, "Downloader", "CleanCache", "yes");
+	sprintf(szVal, "%d", nb_io_threads);
+	gf_cfg_set_key(cfg, "Downloader", "IOThreads", szVal);
+	if (mem_cache) gf_cfg_set_key(cfg, "Downloader", "MemoryCacheSize", mem_cache);
+	dm = gf_dm_new(cfg);
+
+	files = gf_malloc(sizeof(DMBFile) * nb_files);
+	memset(files, 0, sizeof(DMBFile) * nb_files);
+
+	now = gf_sys_clock();
+	for (i=0; i<nb_files; i++) {
+		GF_Err e;
+		files[i].idx = i;
+		files[i].self_delete = ((i%10) == 5) ? 1 : 0;
+		sprintf(szURL, "http://127.0.0.1:%d/file%d", serv->port, i);
+		files[i].sess = gf_dm_sess_new(dm, szURL, (i%2) ? GF_NETIO_SESSION_MEMORY_CACHE : GF_NETIO_SESSION_NOT_CACHED, dmb_net_io, &files[i], &e);
+		if (!files[i].sess) {
+			fprintf(stderr, "Cannot create session for %s: %s\n", szURL, gf_error_to_string(e));
+			files[i].failed = 1;
+			continue;
+		}
+		gf_dm_sess_process(files[i].sess);
+	}
+	/*wait for all sessions*/
+	while (1) {
+		all_dead = 1;
+		for (i=0; i<nb_files; i++) {
+			/*session released by the downloader*/
+			if (files[i].self_delete) {
+				if (!files[i].done && !files[i].failed) {
+					all_dead = 0;
+					break;
+				}
+				continue;
+			}
+			if (files[i].sess && !gf_dm_is_thread_dead(files[i].sess)) {
+				all_dead = 0;
+				break;
+			}
+		}
+		if (all_dead) break;
+		if (gf_sys_clock() - now > 60000) {
+			fprintf(stderr, "Timeout waiting for downloads\n");
+			break;
+		}
+		gf_sleep(1);
+	}
+	now = gf_sys_clock() - now;
+
+	nb_errors = 0;
+	for (i=0; i<nb_files; i++) {
+		if (files[i].failed || !files[i].done || (files[i].size != dmb_file_size(i)) || (files[i].crc != dmb_file_crc(i))) {
+			if (nb_errors < 10) fprintf(stderr, "File %d: bad download (%d bytes out of %d)\n", i, files[i].size, dmb_file_size(i));
+			nb_errors++;
+		}
+		else if (((i%10) < 2) && !dmb_check_cache_file(&files[i])) {
+			if (nb_errors < 10) fprintf(stderr, "File %d: bad cache file\n", i);
+			nb_errors++;
+		}
+		if (files[i].sess) gf_dm_sess_del(files[i].sess);
+	}
+	gf_dm_del(dm);
+	gf_cfg_remove(cfg);
+	gf_free(files);
+
+	if (nb_io_threads) fprintf(stdout, "%d I/O thread(s):    ", nb_io_threads);
+	else fprintf(stdout, "one thread/session: ");
+	fprintf(stdout, "%d files in %d ms - %d errors\n", nb_files, now, nb_errors);
+	return nb_errors ? 0 : 1;
+}
+
+typedef struct
+{
+	GF_DownloadSession *sess;
+	u32 idx, size, crc, chunk, next_start;
+	Bool done, failed, pipeline;
+} DMBRange;
+
+static void dmb_range_io(void *cbk, GF_NETIO_Parameter *param)
+{
+	DMBRange *rg = (DMBRange *)cbk;
+	switch (param->msg_type) {
+	case GF_NETIO_WAIT_FOR_REPLY:
+		/*request the next range while this one is received*/
+		if (rg->pipeline && (rg->next_start < dmb_file_size(rg->idx))) {
+			u32 end = MIN(rg->next_start + rg->chunk, dmb_file_size(rg->idx)) - 1;
+			gf_dm_sess_pipeline_range(rg->sess, rg->next_start, end);
+		}
+		break;
+	case GF_NETIO_DATA_EXCHANGE:
+		rg->size += param->size;
+		rg->crc = dmb_crc_update(rg->crc, (u8 *) param->data, param->size);
+		break;
+	case GF_NETIO_DATA_TRANSFERED:
+		rg->done = 1;
+		break;
+	case GF_NETIO_STATE_ERROR:
+		rg->failed = 1;
+		break;
+	}
+}
+
+/*sequential downloads on a keep-alive server: one session per file, then ranges of one file through a persistent session*/
+static Bool dmb_run_sequential(DMBServer *serv, const char *cache_dir, u32 nb_files, const char *pool_size, Bool pipeline)
+{
+	u32 i, now, nb_errors, hits, misses, pipelined, nb_conn, total;
+	char szURL[100];
+	GF_Config *cfg;
+	GF_DownloadManager *dm;
+	GF_Err e;
+
+	cfg = gf_cfg_force_new(cache_dir, "dmbench.cfg");
+	gf_cfg_set_key(cfg, "General", "CacheDirectory", cache_dir);
+	gf_cfg_set_key(cfg, "Downloader", "CleanCache", "yes");
+	if (pool_size) gf_cfg_set_key(cfg, "Downloader", "ConnectionPoolSize", pool_size);
+	dm = gf_dm_new(cfg);
+	serv->keep_alive = 1;
+	nb_conn = serv->nb_connections;
+	nb_errors = 0;
+
+	now = gf_sys_clock();
+	if (!pipeline) {
+		for (i=0; i<nb_files; i++) {
+			DMBFile file;
+			memset(&file, 0, sizeof(DMBFile));
+			file.idx = i;
+			sprintf(szURL, "http://127.0.0.1:%d/file%d", serv->port, i);
+			file.sess = gf_dm_sess_new(dm, szURL, GF_NETIO_SESSION_NOT_CACHED | GF_NETIO_SESSION_NOT_THREADED, dmb_net_io, &file, &e);
+			if (file.sess) gf_dm_sess_process(file.sess);
+			if (!file.sess || file.failed || !file.done || (file.size != dmb_file_size(i)) || (file.crc != dmb_file_crc(i))) {
+				if (nb_errors < 10) fprintf(stderr, "File %d: bad download (%d bytes out of %d)\n", i, file.size, dmb_file_size(i));
+				nb_errors++;
+			}
+			if (file.sess) gf_dm_sess_del(file.sess);
+		}
+	} else {
+		DMBRange rg;
+		memset(&rg, 0, sizeof(DMBRange));
+		/*largest file*/
+		for (i=0; i<nb_files; i++) {
+			if (dmb_file_size(i) > dmb_file_size(rg.idx)) rg.idx = i;
+		}
+		total = dmb_file_size(rg.idx);
+		rg.chunk = total / nb_files + 1;
+		rg.pipeline = 1;
+		sprintf(szURL, "http://127.0.0.1:%d/file%d", serv->port, rg.idx);
+		rg.sess = gf_dm_sess_new(dm, szURL, GF_NETIO_SESSION_NOT_CACHED | GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_PERSISTENT, dmb_range_io, &rg, &e);
+		for (i=0; rg.sess && (i<total); i+=rg.chunk) {
+			u32 end = MIN(i + rg.chunk, total) - 1;
+			rg.done = 0;
+			rg.next_start = end + 1;
+			if (i) e = gf_dm_sess_setup_from_url(rg.sess, szURL);
+			if (!e) e = gf_dm_sess_set_range(rg.sess, i, end);
+			if (!e) gf_dm_sess_process(rg.sess);
+			if (e || rg.failed || !rg.done || (rg.size != end+1)) {
+				if (nb_errors < 10) fprintf(stderr, "Range %d-%d: bad download (%d bytes out of %d)\n", i, end, rg.size, end+1);
+				nb_errors++;
+				break;
+			}
+		}
+		if (!rg.sess || (rg.crc != dmb_file_crc(rg.idx))) nb_errors++;
+		if (rg.sess) gf_dm_sess_del(rg.sess);
+	}
+	now = gf_sys_clock() - now;
+
+	gf_dm_get_pool_stats(dm, &hits, &misses, &pipelined);
+	gf_dm_del(dm);
+	gf_cfg_remove(cfg);
+	/*wait for the server to see the pooled connections closed*/
+	gf_sleep(20);
+	serv->keep_alive = 0;
+
+	fprintf(stdout, "%s %d %s in %d ms - %d connections - pool: %d hits %d misses %d pipelined - %d errors\n", pipeline ? "pipelined ranges:  " : "sequential:        ", nb_files, pipeline ? "ranges" : "files", now, serv->nb_connections - nb_conn, hits, misses, pipelined, nb_errors);
+	return nb_errors ? 0 : 1;
+}
+
+static void usage()
+{
+	fprintf(stdout, "dmbench [-n nb_files] [-io nb_io_threads] [-mem memory_cache_kb] [-pool nb_pooled_connections]\n");
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_files, nb_io_threads;
+	char *cache_dir, *mem_cache, *pool_size;
+	Bool ok;
+	DMBServer serv;
+	GF_Thread *th;
+
+	nb_files = 200;
+	nb_io_threads = 1;
+	mem_cache = pool_size = NULL;
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-n") && (i+1<(u32)argc)) nb_files = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-io") && (i+1<(u32)argc)) nb_io_threads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-mem") && (i+1<(u32)argc)) mem_cache = argv[++i];
+		else if (!strcmp(argv[i], "-pool") && (i+1<(u32)argc)) pool_size = argv[++i];
+		else {
+			usage();
+			return 0;
+		}
+	}
+
+	gf_sys_init(0);
+	memset(&serv, 0, sizeof(DMBServer));
+	serv.sock = gf_sk_new(GF_SOCK_TYPE_TCP);
+	for (serv.port=18080; serv.port<18180; serv.port++) {
+		if (gf_sk_bind(serv.sock, "127.0.0.1", serv.port, NULL, 0, GF_SOCK_REUSE_PORT) == GF_OK) break;
+	}
+	if ((serv.port==18180) || gf_sk_listen(serv.sock, 1024)) {
+		fprintf(stderr, "Cannot start local HTTP server\n");
+		gf_sk_del(serv.sock);
+		gf_sys_close();
+		return 1;
+	}
+	serv.run = 1;
+	th = gf_th_new("DMBServer");
+	gf_th_run(th, dmb_server_run, &serv);
+
+	cache_dir = gf_get_default_cache_directory();
+	ok = dmb_run(&serv, cache_dir, nb_files, 0, mem_cache);
+	if (!dmb_run(&serv, cache_dir, nb_files, nb_io_threads, mem_cache)) ok = 0;
+	/*non-threaded sessions wait a bit for each reply, keep these runs short*/
+	if (!dmb_run_sequential(&serv, cache_dir, MIN(nb_files, 50), pool_size, 0)) ok = 0;
+	if (!dmb_run_sequential(&serv, cache_dir, MIN(nb_files, 50), pool_size, 1)) ok = 0;
+	gf_free(cache_dir);
+
+	serv.run = 0;
+	gf_th_del(th);
+	gf_sk_del(serv.sock);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
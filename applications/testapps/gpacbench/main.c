@@ -0,0 +1,1726 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Copyright (c) Jean Le Feuvre 2000-2005
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / reproducible benchmark suite
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*reproducible benchmark suite for the main library code paths. All inputs (AVC elementary stream, MPEG-2 program
+stream, BT, XSR and SVG documents) are generated offline from a fixed seed, so that two builds run on the same machine measure
+exactly the same work. Each test is run a few times to warm up caches, then timed over several runs; median
+and 95th percentile are reported and can be written as JSON for later comparison with -compare*/
+
+#include <gpac/isomedia.h>
+#include <gpac/media_tools.h>
+#include <gpac/mpegts.h>
+#include <gpac/scene_manager.h>
+#include <gpac/xml.h>
+#include <gpac/bitstream.h>
+#include <gpac/module.h>
+#include <gpac/modules/raster2d.h>
+
+#define GB_MAX_RUNS		1000
+
+typedef struct
+{
+	/*scale factor applied to all synthetic inputs*/
+	u32 scale;
+	const char *dir;
+
+	/*synthetic AVC stream, one AU per frame (SPS/PPS included in IDR AUs)*/
+	char *es;
+	u32 es_size, nb_aus;
+	u32 *au_offsets, *au_sizes;
+	Bool *au_rap;
+
+	/*TS muxer state*/
+	u32 ts_au;
+	char *ts;
+	u32 ts_size, ts_alloc;
+	u32 nb_pes;
+
+	/*soft raster*/
+	GF_Config *cfg;
+	GF_ModuleManager *modules;
+	GF_Raster2D *raster;
+	char *pixels;
+
+	char es_name[GF_MAX_PATH], mp4_name[GF_MAX_PATH], bt_name[GF_MAX_PATH], xsr_name[GF_MAX_PATH], svg_name[GF_MAX_PATH];
+	char bifs_name[GF_MAX_PATH], laser_name[GF_MAX_PATH], ps_name[GF_MAX_PATH];
+	char fwd_bt_name[GF_MAX_PATH], fwd_xmt_name[GF_MAX_PATH];
+} GPACBench;
+
+typedef struct
+{
+	const char *name;
+	const char *desc;
+	/*runs the test once, returns the number of input bytes processed*/
+	GF_Err (*run)(GPACBench *gb, u64 *bytes);
+} GBTest;
+
+typedef struct
+{
+	const char *name;
+	u32 runs;
+	u64 bytes;
+	u64 min, max, mean, median, p95;
+} GBResult;
+
+
+/*fixed-seed generator, independent from the libc one (reseeded by GPAC threads)*/
+static u32 gb_seed = 0x47504143;
+static u32 gb_rand()
+{
+	gb_seed = gb_seed * 1103515245 + 12345;
+	return (gb_seed >> 8) & 0xFFFF;
+}
+
+static u64 gb_file_size(const char *name)
+{
+	u64 size;
+	FILE *f = gf_f64_open(name, "rb");
+	if (!f) return 0;
+	gf_f64_seek(f, 0, SEEK_END);
+	size = gf_f64_tell(f);
+	fclose(f);
+	return size;
+}
+
+static void gb_write_file(const char *name, char *data, u32 size)
+{
+	FILE *f = gf_f64_open(name, "wb");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", name);
+		exit(1);
+	}
+	gf_fwrite(data, 1, size, f);
+	fclose(f);
+}
+
+static void gb_quiet_progress(const void *cbck, const char *title, u64 done, u64 total)
+{
+}
+
+
+/*
+		synthetic AVC elementary stream
+*/
+
+static void gb_avc_ue(GF_BitStream *bs, u32 val)
+{
+	u32 nb_bits = 0;
+	u32 tmp = val+1;
+	while (tmp) {
+		nb_bits++;
+		tmp >>= 1;
+	}
+	gf_bs_write_int(bs, 0, nb_bits-1);
+	gf_bs_write_int(bs, val+1, nb_bits);
+}
+
+static void gb_avc_nal_start(GF_BitStream *bs, u32 nal_type)
+{
+	gf_bs_write_u32(bs, 1);
+	gf_bs_write_u8(bs, (3<<5) | nal_type);
+}
+
+static void gb_avc_nal_end(GF_BitStream *bs)
+{
+	gf_bs_write_int(bs, 1, 1);
+	gf_bs_align(bs);
+}
+
+/*baseline 320x240 stream, POC type 2, one slice per frame. Slice data is random non-zero bytes, so that
+no start code emulation can occur and the stream can be parsed (not decoded) by all demuxers*/
+static void gb_make_avc(GPACBench *gb, u32 nb_frames, u32 gop)
+{
+	u32 i, j, frame_num, idr_id, size;
+	GF_BitStream *bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
+
+	gb->nb_aus = nb_frames;
+	gb->au_offsets = gf_malloc(sizeof(u32)*nb_frames);
+	gb->au_sizes = gf_malloc(sizeof(u32)*nb_frames);
+	gb->au_rap = gf_malloc(sizeof(Bool)*nb_frames);
+	frame_num = idr_id = 0;
+	for (i=0; i<nb_frames; i++) {
+		Bool is_idr = (i % gop) ? 0 : 1;
+		gb->au_offsets[i] = (u32) gf_bs_get_position(bs);
+		gb->au_rap[i] = is_idr;
+
+		if (is_idr) {
+			/*SPS*/
+			gb_avc_nal_start(bs, GF_AVC_NALU_SEQ_PARAM);
+			gf_bs_write_u8(bs, 66);
+			gf_bs_write_u8(bs, 0xC0);
+			gf_bs_write_u8(bs, 30);
+			gb_avc_ue(bs, 0);
+			/*log2_max_frame_num_minus4*/
+			gb_avc_ue(bs, 0);
+			/*poc type*/
+			gb_avc_ue(bs, 2);
+			/*num_ref_frames*/
+			gb_avc_ue(bs, 1);
+			gf_bs_write_int(bs, 0, 1);
+			gb_avc_ue(bs, 320/16 - 1);
+			gb_avc_ue(bs, 240/16 - 1);
+			/*frame_mbs_only, direct_8x8_inference, no cropping, no VUI*/
+			gf_bs_write_int(bs, 1, 1);
+			gf_bs_write_int(bs, 1, 1);
+			gf_bs_write_int(bs, 0, 1);
+			gf_bs_write_int(bs, 0, 1);
+			gb_avc_nal_end(bs);
+
+			/*PPS*/
+			gb_avc_nal_start(bs, GF_AVC_NALU_PIC_PARAM);
+			gb_avc_ue(bs, 0);
+			gb_avc_ue(bs, 0);
+			/*CAVLC, no bottom_field_pic_order, 1 slice group, 1 ref*/
+			gf_bs_write_int(bs, 0, 1);
+			gf_bs_write_int(bs, 0, 1);
+			gb_avc_ue(bs, 0);
+			gb_avc_ue(bs, 0);
+			gb_avc_ue(bs, 0);
+			/*no weighted pred, QP/QS/chroma offsets at 0 (se(0) = ue(0))*/
+			gf_bs_write_int(bs, 0, 3);
+			gb_avc_ue(bs, 0);
+			gb_avc_ue(bs, 0);
+			gb_avc_ue(bs, 0);
+			/*deblocking filter control present, no constrained intra, no redundant pic cnt*/
+			gf_bs_write_int(bs, 1, 1);
+			gf_bs_write_int(bs, 0, 1);
+			gf_bs_write_int(bs, 0, 1);
+			gb_avc_nal_end(bs);
+
+			frame_num = 0;
+		}
+
+		gb_avc_nal_start(bs, is_idr ? GF_AVC_NALU_IDR_SLICE : GF_AVC_NALU_NON_IDR_SLICE);
+		/*first_mb, slice type (I or P, all slices of the picture are of the same type), pps id*/
+		gb_avc_ue(bs, 0);
+		gb_avc_ue(bs, is_idr ? 7 : 5);
+		gb_avc_ue(bs, 0);
+		gf_bs_write_int(bs, frame_num, 4);
+		if (is_idr) {
+			gb_avc_ue(bs, idr_id);
+			idr_id = (idr_id+1) % 16;
+		} else {
+			/*num_ref_idx_active_override, ref_pic_list_reordering_flag*/
+			gf_bs_write_int(bs, 0, 1);
+			gf_bs_write_int(bs, 0, 1);
+		}
+		/*dec_ref_pic_marking*/
+		if (is_idr) gf_bs_write_int(bs, 0, 2);
+		else gf_bs_write_int(bs, 0, 1);
+		/*slice_qp_delta, disable_deblocking_filter_idc*/
+		gb_avc_ue(bs, 0);
+		gb_avc_ue(bs, 1);
+
+		size = is_idr ? 12000 + gb_rand() % 8000 : 1500 + gb_rand() % 2000;
+		for (j=0; j<size; j++) {
+			gf_bs_write_int(bs, 1 + gb_rand() % 255, 8);
+		}
+		gb_avc_nal_end(bs);
+
+		gb->au_sizes[i] = (u32) gf_bs_get_position(bs) - gb->au_offsets[i];
+		frame_num = (frame_num+1) % 16;
+	}
+	gf_bs_get_content(bs, &gb->es, &gb->es_size);
+	gf_bs_del(bs);
+}
+
+
+/*
+		ISO media
+*/
+
+static GF_Err gb_import_avc(GPACBench *gb, const char *dst)
+{
+	GF_Err e;
+	GF_MediaImporter import;
+	GF_ISOFile *file = gf_isom_open(dst, GF_ISOM_WRITE_EDIT, gb->dir);
+	if (!file) return gf_isom_last_error(NULL);
+
+	memset(&import, 0, sizeof(GF_MediaImporter));
+	import.dest = file;
+	import.in_name = gb->es_name;
+	import.video_fps = 25.0;
+	e = gf_media_import(&import);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+static GF_Err gb_test_avc_import(GPACBench *gb, u64 *bytes)
+{
+	char szName[GF_MAX_PATH];
+	sprintf(szName, "%s/gpacbench_import.mp4", gb->dir);
+	*bytes = gb->es_size;
+	return gb_import_avc(gb, szName);
+}
+
+static GF_Err gb_test_iso_open(GPACBench *gb, u64 *bytes)
+{
+	GF_ISOFile *file = gf_isom_open(gb->mp4_name, GF_ISOM_OPEN_READ, NULL);
+	if (!file) return gf_isom_last_error(NULL);
+	*bytes = 0;
+	gf_isom_close(file);
+	return GF_OK;
+}
+
+static GF_Err gb_test_iso_samples(GPACBench *gb, u64 *bytes)
+{
+	u32 i, j, count, di;
+	GF_ISOFile *file = gf_isom_open(gb->mp4_name, GF_ISOM_OPEN_READ, NULL);
+	if (!file) return gf_isom_last_error(NULL);
+
+	*bytes = 0;
+	for (i=0; i<gf_isom_get_track_count(file); i++) {
+		count = gf_isom_get_sample_count(file, i+1);
+		for (j=0; j<count; j++) {
+			GF_ISOSample *samp = gf_isom_get_sample(file, i+1, j+1, &di);
+			if (!samp) {
+				gf_isom_close(file);
+				return gf_isom_last_error(file);
+			}
+			*bytes += samp->dataLength;
+			gf_isom_sample_del(&samp);
+		}
+	}
+	gf_isom_close(file);
+	return GF_OK;
+}
+
+static GF_Err gb_test_iso_remux(GPACBench *gb, u64 *bytes)
+{
+	GF_Err e;
+	GF_MediaImporter import;
+	char szName[GF_MAX_PATH];
+	GF_ISOFile *file;
+
+	*bytes = gb_file_size(gb->mp4_name);
+	sprintf(szName, "%s/gpacbench_remux.mp4", gb->dir);
+	file = gf_isom_open(szName, GF_ISOM_WRITE_EDIT, gb->dir);
+	if (!file) return gf_isom_last_error(NULL);
+
+	memset(&import, 0, sizeof(GF_MediaImporter));
+	import.dest = file;
+	import.in_name = gb->mp4_name;
+	e = gf_media_import(&import);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+static GF_Err gb_test_dash(GPACBench *gb, u64 *bytes)
+{
+	GF_Err e;
+	char szMPD[GF_MAX_PATH], szRad[GF_MAX_PATH];
+	GF_ISOFile *file = gf_isom_open(gb->mp4_name, GF_ISOM_OPEN_READ, NULL);
+	if (!file) return gf_isom_last_error(NULL);
+
+	sprintf(szRad, "%s/gpacbench_dash", gb->dir);
+	sprintf(szMPD, "%s/gpacbench_dash.mpd", gb->dir);
+	gf_media_mpd_start(szMPD, "gpacbench", 0, 0, NULL, NULL, 0);
+#ifndef GPAC_DISABLE_ISOM_FRAGMENTS
+	e = gf_media_fragment_file(file, szRad, szMPD, 0.5, 1, 1.0, NULL, "m4s", 0, 0, 0, 0, NULL, NULL, 1);
+#else
+	e = GF_NOT_SUPPORTED;
+#endif
+	gf_media_mpd_end(szMPD);
+	gf_isom_close(file);
+	*bytes = gb_file_size(gb->mp4_name);
+	return e;
+}
+
+
+/*
+		MPEG-2 TS
+*/
+
+static GF_Err gb_ts_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
+{
+	GF_ESIPacket pck;
+	GPACBench *gb = (GPACBench *)ifce->input_udta;
+	if (act_type != GF_ESI_INPUT_DATA_FLUSH) return GF_OK;
+	if (gb->ts_au >= gb->nb_aus) return GF_OK;
+
+	/*same push mode as mp42ts, one AU per flush*/
+	memset(&pck, 0, sizeof(GF_ESIPacket));
+	pck.flags = GF_ESI_DATA_AU_START | GF_ESI_DATA_AU_END | GF_ESI_DATA_HAS_CTS;
+	if (gb->au_rap[gb->ts_au]) pck.flags |= GF_ESI_DATA_AU_RAP;
+	pck.cts = pck.dts = (u64) gb->ts_au * 3600;
+	pck.duration = 3600;
+	pck.data = gb->es + gb->au_offsets[gb->ts_au];
+	pck.data_len = gb->au_sizes[gb->ts_au];
+	ifce->output_ctrl(ifce, GF_ESI_OUTPUT_DATA_DISPATCH, &pck);
+
+	gb->ts_au++;
+	if (gb->ts_au >= gb->nb_aus) ifce->caps |= GF_ESI_STREAM_IS_OVER;
+	return GF_OK;
+}
+
+static GF_Err gb_test_ts_mux(GPACBench *gb, u64 *bytes)
+{
+	u32 status;
+	const char *pck;
+	GF_M2TS_Mux *mux;
+	GF_M2TS_Mux_Program *prog;
+	GF_ESInterface ifce;
+
+	memset(&ifce, 0, sizeof(GF_ESInterface));
+	ifce.stream_id = 1;
+	ifce.stream_type = GF_STREAM_VISUAL;
+	ifce.object_type_indication = GPAC_OTI_VIDEO_AVC;
+	ifce.timescale = 90000;
+	ifce.info_video.width = 320;
+	ifce.info_video.height = 240;
+	ifce.info_video.FPS = 25.0;
+	ifce.input_ctrl = gb_ts_input_ctrl;
+	ifce.input_udta = gb;
+	gb->ts_au = 0;
+
+	mux = gf_m2ts_mux_new(0, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, 0);
+	if (!mux) return GF_OUT_OF_MEM;
+	/*fixed PCR origin, for identical output across runs*/
+	gf_m2ts_mux_set_initial_pcr(mux, 1);
+	prog = gf_m2ts_mux_program_add(mux, 1, 100, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, 0, 0);
+	gf_m2ts_program_stream_add(prog, &ifce, 101, 1, 0);
+	gf_m2ts_mux_update_config(mux, 1);
+
+	gb->ts_size = 0;
+	while (1) {
+		while ((pck = gf_m2ts_mux_process(mux, &status)) != NULL) {
+			if (gb->ts_size + 188 > gb->ts_alloc) {
+				gb->ts_alloc = gb->ts_alloc ? 2*gb->ts_alloc : 188*10000;
+				gb->ts = gf_realloc(gb->ts, gb->ts_alloc);
+			}
+			memcpy(gb->ts + gb->ts_size, pck, 188);
+			gb->ts_size += 188;
+		}
+		if (status==GF_M2TS_STATE_EOS) break;
+	}
+	gf_m2ts_mux_del(mux);
+	*bytes = gb->ts_size;
+	return GF_OK;
+}
+
+static void gb_ts_on_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
+{
+	u32 i;
+	GPACBench *gb = (GPACBench *)ts->user;
+	switch (evt_type) {
+	case GF_M2TS_EVT_PMT_FOUND:
+	{
+		GF_M2TS_Program *prog = (GF_M2TS_Program *)par;
+		for (i=0; i<gf_list_count(prog->streams); i++) {
+			GF_M2TS_ES *es = gf_list_get(prog->streams, i);
+			if (!(es->flags & GF_M2TS_ES_IS_SECTION)) gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_DEFAULT);
+		}
+	}
+		break;
+	case GF_M2TS_EVT_PES_PCK:
+		gb->nb_pes++;
+		break;
+	}
+}
+
+static GF_Err gb_test_ts_demux(GPACBench *gb, u64 *bytes)
+{
+	GF_Err e;
+	u32 pos;
+	GF_M2TS_Demuxer *ts = gf_m2ts_demux_new();
+	if (!ts) return GF_OUT_OF_MEM;
+	ts->on_event = gb_ts_on_event;
+	ts->user = gb;
+	gb->nb_pes = 0;
+
+	e = GF_OK;
+	for (pos=0; pos<gb->ts_size; pos += 188*100) {
+		u32 size = MIN(188*100, gb->ts_size - pos);
+		e = gf_m2ts_process_data(ts, gb->ts + pos, size);
+		if (e) break;
+	}
+	gf_m2ts_demux_del(ts);
+	if (!e && !gb->nb_pes) e = GF_NON_COMPLIANT_BITSTREAM;
+	*bytes = gb->ts_size;
+	return e;
+}
+
+
+/*
+		MPEG-2 PS: one MPEG-2 video stream and several MPEG-1 layer 2 audio streams, one PES per pack
+*/
+
+#define GB_PS_PES_SIZE	2028
+
+static void gb_ps_pack(GF_BitStream *bs)
+{
+	/*MPEG-2 pack header, no stuffing*/
+	gf_bs_write_u32(bs, 0x000001BA);
+	gf_bs_write_u8(bs, 0x44);
+	gf_bs_write_u32(bs, 0x00040004);
+	gf_bs_write_u32(bs, 0x010189C3);
+	gf_bs_write_u8(bs, 0xF8);
+}
+
+static void gb_ps_ts(GF_BitStream *bs, u32 prefix, u64 ts)
+{
+	gf_bs_write_int(bs, prefix, 4);
+	gf_bs_write_long_int(bs, (ts>>30) & 0x7, 3);
+	gf_bs_write_int(bs, 1, 1);
+	gf_bs_write_long_int(bs, (ts>>15) & 0x7FFF, 15);
+	gf_bs_write_int(bs, 1, 1);
+	gf_bs_write_long_int(bs, ts & 0x7FFF, 15);
+	gf_bs_write_int(bs, 1, 1);
+}
+
+static void gb_ps_pes(GF_BitStream *bs, u32 stream_id, char *data, u32 size, Bool has_ts, Bool has_dts, u64 ts)
+{
+	u32 hdr_len = has_ts ? (has_dts ? 10 : 5) : 0;
+	gb_ps_pack(bs);
+	gf_bs_write_u32(bs, 0x00000100 | stream_id);
+	gf_bs_write_u16(bs, 3 + hdr_len + size);
+	gf_bs_write_u8(bs, 0x80);
+	gf_bs_write_u8(bs, has_ts ? (has_dts ? 0xC0 : 0x80) : 0);
+	gf_bs_write_u8(bs, hdr_len);
+	if (has_ts) gb_ps_ts(bs, has_dts ? 3 : 2, ts);
+	if (has_dts) gb_ps_ts(bs, 1, ts);
+	gf_bs_write_data(bs, data, size);
+}
+
+static void gb_make_ps(GPACBench *gb, u32 nb_frames, u32 nb_audio)
+{
+	u32 i, j, k, size;
+	char *es, audio[576];
+	u64 audio_ts;
+	GF_BitStream *bs, *vbs;
+	FILE *f = gf_f64_open(gb->ps_name, "wb");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", gb->ps_name);
+		exit(1);
+	}
+	bs = gf_bs_from_file(f, GF_BITSTREAM_WRITE);
+	audio_ts = 0;
+	for (i=0; i<nb_frames; i++) {
+		vbs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
+		if (!(i%12)) {
+			/*sequence header: 720x576, 4:3, 25 fps*/
+			gf_bs_write_u32(vbs, 0x000001B3);
+			gf_bs_write_int(vbs, 720, 12);
+			gf_bs_write_int(vbs, 576, 12);
+			gf_bs_write_int(vbs, 2, 4);
+			gf_bs_write_int(vbs, 3, 4);
+			gf_bs_write_int(vbs, 12500, 18);
+			gf_bs_write_int(vbs, 1, 1);
+			gf_bs_write_int(vbs, 112, 10);
+			gf_bs_write_int(vbs, 0, 3);
+			/*sequence extension: main profile, 4:2:0*/
+			gf_bs_write_u32(vbs, 0x000001B5);
+			gf_bs_write_int(vbs, 1, 4);
+			gf_bs_write_int(vbs, 0x48, 8);
+			gf_bs_write_int(vbs, 0, 1);
+			gf_bs_write_int(vbs, 1, 2);
+			gf_bs_write_int(vbs, 0, 16);
+			gf_bs_write_int(vbs, 1, 1);
+			gf_bs_write_int(vbs, 0, 16);
+			/*GOP*/
+			gf_bs_write_u32(vbs, 0x000001B8);
+			gf_bs_write_u32(vbs, 0x00080000);
+		}
+		/*I or P picture header*/
+		gf_bs_write_u32(vbs, 0x00000100);
+		gf_bs_write_int(vbs, i%12, 10);
+		gf_bs_write_int(vbs, (i%12) ? 2 : 1, 3);
+		gf_bs_write_int(vbs, 0xFFFF, 16);
+		if (i%12) gf_bs_write_int(vbs, 0x7, 4);
+		gf_bs_align(vbs);
+		/*slice data, without start code emulation*/
+		gf_bs_write_u32(vbs, 0x00000101);
+		size = (i%12) ? 1000 + gb_rand() % 3000 : 12000;
+		for (j=0; j<size; j++) gf_bs_write_u8(vbs, 1 + gb_rand() % 255);
+		es = NULL;
+		gf_bs_get_content(vbs, &es, &size);
+		gf_bs_del(vbs);
+
+		for (j=0; j<size; j+=GB_PS_PES_SIZE) {
+			gb_ps_pes(bs, 0xE0, es + j, MIN(GB_PS_PES_SIZE, size - j), !j, !j, 9000 + 3600*i);
+		}
+		gf_free(es);
+
+		/*48 kHz 192 kbps stereo frames up to the next video frame*/
+		while (audio_ts < (u64) 3600*(i+1)) {
+			for (k=0; k<nb_audio; k++) {
+				audio[0] = (char) 0xFF;
+				audio[1] = (char) 0xFD;
+				audio[2] = (char) 0xA4;
+				audio[3] = 0x04;
+				for (j=4; j<576; j++) audio[j] = gb_rand() % 200;
+				gb_ps_pes(bs, 0xC0 + k, audio, 576, 1, 0, 9000 + audio_ts);
+			}
+			audio_ts += 2160;
+		}
+	}
+	gf_bs_write_u32(bs, 0x000001B9);
+	gf_bs_del(bs);
+	fclose(f);
+}
+
+/*same as MP4Box -add file.mpg: probe the file then import each track*/
+static GF_Err gb_test_ps_import(GPACBench *gb, u64 *bytes)
+{
+	GF_Err e;
+	u32 i, nb_tracks;
+	GF_MediaImporter import;
+	char szName[GF_MAX_PATH];
+	GF_ISOFile *file;
+
+	*bytes = gb_file_size(gb->ps_name);
+	memset(&import, 0, sizeof(GF_MediaImporter));
+	import.in_name = gb->ps_name;
+	import.flags = GF_IMPORT_PROBE_ONLY;
+	e = gf_media_import(&import);
+	if (e) return e;
+	nb_tracks = import.nb_tracks;
+	if (!nb_tracks) return GF_NON_COMPLIANT_BITSTREAM;
+
+	sprintf(szName, "%s/gpacbench_ps.mp4", gb->dir);
+	file = gf_isom_open(szName, GF_ISOM_WRITE_EDIT, gb->dir);
+	if (!file) return gf_isom_last_error(NULL);
+	for (i=0; i<nb_tracks; i++) {
+		memset(&import, 0, sizeof(GF_MediaImporter));
+		import.dest = file;
+		import.in_name = gb->ps_name;
+		import.trackID = i+1;
+		e = gf_media_import(&import);
+		if (e) {
+			gf_isom_delete(file);
+			return e;
+		}
+	}
+	if (gf_isom_get_track_count(file) != nb_tracks) {
+		gf_isom_delete(file);
+		return GF_NON_COMPLIANT_BITSTREAM;
+	}
+	return gf_isom_close(file);
+}
+
+
+/*
+		scene coding
+*/
+
+static void gb_make_bt(GPACBench *gb, u32 nb_shapes, u32 nb_frames)
+{
+	u32 i, j;
+	FILE *f = gf_f64_open(gb->bt_name, "wt");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", gb->bt_name);
+		exit(1);
+	}
+	fprintf(f, "InitialObjectDescriptor {\n objectDescriptorID 1\n esDescr [\n  ES_Descriptor {\n   ES_ID 1\n   decConfigDescr DecoderConfigDescriptor {\n    streamType 3\n    decSpecificInfo BIFSConfig {\n     isCommandStream true\n     pixelMetric true\n     pixelWidth 320\n     pixelHeight 240\n    }\n   }\n  }\n ]\n}\n\n");
+	fprintf(f, "OrderedGroup {\n children [\n");
+	for (i=0; i<nb_shapes; i++) {
+		fprintf(f, "  DEF T%d Transform2D {\n   translation %d %d\n   rotationAngle %g\n   children [\n", i, (s32) (gb_rand()%320) - 160, (s32) (gb_rand()%240) - 120, (gb_rand()%628) / 100.0);
+		fprintf(f, "    Shape {\n     appearance Appearance {\n      material Material2D {\n       emissiveColor %g %g %g\n       filled TRUE\n      }\n     }\n", (gb_rand()%256) / 255.0, (gb_rand()%256) / 255.0, (gb_rand()%256) / 255.0);
+		if (i%2) {
+			fprintf(f, "     geometry Rectangle {\n      size %d %d\n     }\n    }\n   ]\n  }\n", 5 + gb_rand()%40, 5 + gb_rand()%40);
+		} else {
+			fprintf(f, "     geometry Curve2D {\n      point Coordinate2D {\n       point [");
+			for (j=0; j<8; j++) fprintf(f, " %d %d", (s32) (gb_rand()%60) - 30, (s32) (gb_rand()%60) - 30);
+			fprintf(f, " ]\n      }\n      type [0 1 2 1 2 1]\n     }\n    }\n   ]\n  }\n");
+		}
+	}
+	fprintf(f, " ]\n}\n\n");
+	for (i=1; i<=nb_frames; i++) {
+		fprintf(f, "AT %d {\n", i*40);
+		for (j=0; j<nb_shapes; j+=10) {
+			fprintf(f, " REPLACE T%d.translation BY %d %d\n", (j + i) % nb_shapes, (s32) (gb_rand()%320) - 160, (s32) (gb_rand()%240) - 120);
+		}
+		fprintf(f, "}\n");
+	}
+	fclose(f);
+}
+
+static void gb_make_xsr(GPACBench *gb, u32 nb_shapes, u32 nb_frames)
+{
+	u32 i, j;
+	FILE *f = gf_f64_open(gb->xsr_name, "wt");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", gb->xsr_name);
+		exit(1);
+	}
+	fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<saf:SAFSession xmlns:saf=\"urn:mpeg:mpeg4:SAF:2005\" xmlns:lsr=\"urn:mpeg:mpeg4:LASeR:2005\" xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n");
+	fprintf(f, "<saf:sceneHeader>\n<lsr:LASeRHeader/>\n</saf:sceneHeader>\n<saf:sceneUnit>\n<lsr:NewScene>\n<svg width=\"320\" height=\"240\" viewBox=\"0 0 320 240\">\n");
+	for (i=0; i<nb_shapes; i++) {
+		if (i%2) {
+			fprintf(f, "<rect id=\"r%d\" x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#%02X%02X%02X\"/>\n", i, gb_rand()%320, gb_rand()%240, 5 + gb_rand()%40, 5 + gb_rand()%40, gb_rand()%256, gb_rand()%256, gb_rand()%256);
+		} else {
+			fprintf(f, "<path id=\"r%d\" transform=\"translate(%d,%d)\" d=\"M 0 0", i, gb_rand()%320, gb_rand()%240);
+			for (j=0; j<3; j++) fprintf(f, " Q %d %d %d %d", (s32) (gb_rand()%60) - 30, (s32) (gb_rand()%60) - 30, (s32) (gb_rand()%60) - 30, (s32) (gb_rand()%60) - 30);
+			fprintf(f, " z\" fill=\"#%02X%02X%02X\"/>\n", gb_rand()%256, gb_rand()%256, gb_rand()%256);
+		}
+	}
+	fprintf(f, "</svg>\n</lsr:NewScene>\n</saf:sceneUnit>\n");
+	for (i=1; i<=nb_frames; i++) {
+		fprintf(f, "<saf:sceneUnit time=\"%d\">\n", i*40);
+		for (j=1; j<nb_shapes; j+=20) {
+			fprintf(f, "<lsr:Replace ref=\"r%d\" attributeName=\"fill\" value=\"#%02X%02X%02X\"/>\n", j, gb_rand()%256, gb_rand()%256, gb_rand()%256);
+		}
+		fprintf(f, "</saf:sceneUnit>\n");
+	}
+	fprintf(f, "<saf:endOfSAFSession/>\n</saf:SAFSession>\n");
+	fclose(f);
+}
+
+/*scenes USEing nodes and declaring routes before the nodes are DEFed*/
+static void gb_make_fwd_bt(GPACBench *gb, u32 nb_nodes)
+{
+	u32 i;
+	FILE *f = gf_f64_open(gb->fwd_bt_name, "wt");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", gb->fwd_bt_name);
+		exit(1);
+	}
+	fprintf(f, "InitialObjectDescriptor {\n objectDescriptorID 1\n esDescr [\n  ES_Descriptor {\n   ES_ID 1\n   decConfigDescr DecoderConfigDescriptor {\n    streamType 3\n    decSpecificInfo BIFSConfig {\n     isCommandStream true\n     pixelMetric true\n     pixelWidth 320\n     pixelHeight 240\n    }\n   }\n  }\n ]\n}\n\n");
+	fprintf(f, "OrderedGroup {\n children [\n  DEF G Group {\n   children [\n    Transform2D {\n     children [\n");
+	for (i=0; i<nb_nodes; i++) fprintf(f, "      USE S%d\n", i);
+	fprintf(f, "     ]\n    }\n");
+	for (i=0; i<nb_nodes; i++) fprintf(f, "    DEF S%d Shape {\n     geometry Circle {\n      radius %d\n     }\n    }\n", i, 1 + gb_rand()%40);
+	fprintf(f, "   ]\n  }\n ]\n}\n\nAT 0 {\n");
+	for (i=0; i<nb_nodes; i++) fprintf(f, " INSERT ROUTE TS%d.fraction_changed TO PI%d.set_fraction\n", i, i);
+	for (i=0; i<nb_nodes; i++) {
+		fprintf(f, " APPEND TO G.children DEF TS%d TimeSensor {\n  cycleInterval %d\n }\n", i, 1 + gb_rand()%10);
+		fprintf(f, " APPEND TO G.children DEF PI%d PositionInterpolator2D {\n  key [0 1]\n  keyValue [0 0 %d %d]\n }\n", i, gb_rand()%320, gb_rand()%240);
+	}
+	fprintf(f, "}\n");
+	fclose(f);
+}
+
+static void gb_make_fwd_xmt(GPACBench *gb, u32 nb_nodes)
+{
+	u32 i;
+	FILE *f = gf_f64_open(gb->fwd_xmt_name, "wt");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", gb->fwd_xmt_name);
+		exit(1);
+	}
+	fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<XMT-A xmlns=\"urn:mpeg:mpeg4:xmta:schema:2002\">\n<Header>\n<InitialObjectDescriptor objectDescriptorID=\"od1\">\n<Descr><esDescr><ES_Descriptor ES_ID=\"es1\"><decConfigDescr><DecoderConfigDescriptor streamType=\"3\"><decSpecificInfo><BIFSConfig><commandStream pixelMetric=\"true\"><size pixelWidth=\"320\" pixelHeight=\"240\"/></commandStream></BIFSConfig></decSpecificInfo></DecoderConfigDescriptor></decConfigDescr></ES_Descriptor></esDescr></Descr>\n</InitialObjectDescriptor>\n</Header>\n");
+	fprintf(f, "<Body>\n<Replace>\n<Scene>\n<OrderedGroup>\n<children>\n<Transform2D>\n<children>\n");
+	for (i=0; i<nb_nodes; i++) fprintf(f, "<Shape USE=\"S%d\"/>\n", i);
+	fprintf(f, "</children>\n</Transform2D>\n");
+	for (i=0; i<nb_nodes; i++) fprintf(f, "<Shape DEF=\"S%d\"><geometry><Circle radius=\"%d\"/></geometry></Shape>\n", i, 1 + gb_rand()%40);
+	fprintf(f, "</children>\n</OrderedGroup>\n</Scene>\n</Replace>\n</Body>\n</XMT-A>\n");
+	fclose(f);
+}
+
+static GF_Err gb_load_scene(GPACBench *gb, const char *src)
+{
+	GF_Err e;
+	GF_SceneLoader load;
+	GF_SceneManager *ctx;
+	GF_SceneGraph *sg;
+
+	sg = gf_sg_new();
+	ctx = gf_sm_new(sg);
+	memset(&load, 0, sizeof(GF_SceneLoader));
+	load.fileName = src;
+	load.ctx = ctx;
+	load.flags = GF_SM_LOAD_MPEG4_STRICT;
+	e = gf_sm_load_init(&load);
+	if (e>=0) e = gf_sm_load_run(&load);
+	gf_sm_load_done(&load);
+	gf_sm_del(ctx);
+	gf_sg_del(sg);
+	/*loaders may return GF_EOS once done*/
+	return (e<0) ? e : GF_OK;
+}
+
+static GF_Err gb_encode_scene(GPACBench *gb, const char *src, const char *dst)
+{
+	GF_Err e;
+	GF_SceneLoader load;
+	GF_SceneManager *ctx;
+	GF_SceneGraph *sg;
+	GF_ISOFile *file;
+	GF_SMEncodeOptions opts;
+
+	sg = gf_sg_new();
+	ctx = gf_sm_new(sg);
+	memset(&load, 0, sizeof(GF_SceneLoader));
+	load.fileName = src;
+	load.ctx = ctx;
+	load.flags = GF_SM_LOAD_MPEG4_STRICT;
+	e = gf_sm_load_init(&load);
+	if (e>=0) e = gf_sm_load_run(&load);
+	gf_sm_load_done(&load);
+
+	/*loaders may return GF_EOS once done*/
+	if (e>=0) {
+		file = gf_isom_open(dst, GF_ISOM_WRITE_EDIT, gb->dir);
+		if (!file) {
+			e = gf_isom_last_error(NULL);
+		} else {
+			memset(&opts, 0, sizeof(GF_SMEncodeOptions));
+			e = gf_sm_encode_to_file(ctx, file, &opts);
+			if (e) gf_isom_delete(file);
+			else e = gf_isom_close(file);
+		}
+	}
+	gf_sm_del(ctx);
+	gf_sg_del(sg);
+	return e;
+}
+
+static GF_Err gb_decode_scene(GPACBench *gb, const char *src)
+{
+	GF_Err e;
+	GF_SceneLoader load;
+	GF_SceneManager *ctx;
+	GF_SceneGraph *sg;
+	GF_ISOFile *file = gf_isom_open(src, GF_ISOM_OPEN_READ, NULL);
+	if (!file) return gf_isom_last_error(NULL);
+
+	sg = gf_sg_new();
+	ctx = gf_sm_new(sg);
+	memset(&load, 0, sizeof(GF_SceneLoader));
+	load.isom = file;
+	load.ctx = ctx;
+	e = gf_sm_load_init(&load);
+	if (e>=0) e = gf_sm_load_run(&load);
+	gf_sm_load_done(&load);
+	gf_sm_del(ctx);
+	gf_sg_del(sg);
+	gf_isom_close(file);
+	return (e<0) ? e : GF_OK;
+}
+
+static GF_Err gb_test_bifs_enc(GPACBench *gb, u64 *bytes)
+{
+	char szName[GF_MAX_PATH];
+	sprintf(szName, "%s/gpacbench_bifs_enc.mp4", gb->dir);
+	*bytes = gb_file_size(gb->bt_name);
+	return gb_encode_scene(gb, gb->bt_name, szName);
+}
+
+static GF_Err gb_test_bt_load(GPACBench *gb, u64 *bytes)
+{
+	*bytes = gb_file_size(gb->fwd_bt_name);
+	return gb_load_scene(gb, gb->fwd_bt_name);
+}
+
+static GF_Err gb_test_xmt_load(GPACBench *gb, u64 *bytes)
+{
+	*bytes = gb_file_size(gb->fwd_xmt_name);
+	return gb_load_scene(gb, gb->fwd_xmt_name);
+}
+
+static GF_Err gb_test_bifs_dec(GPACBench *gb, u64 *bytes)
+{
+	*bytes = gb_file_size(gb->bifs_name);
+	return gb_decode_scene(gb, gb->bifs_name);
+}
+
+static GF_Err gb_test_laser_enc(GPACBench *gb, u64 *bytes)
+{
+	char szName[GF_MAX_PATH];
+	sprintf(szName, "%s/gpacbench_laser_enc.mp4", gb->dir);
+	*bytes = gb_file_size(gb->xsr_name);
+	return gb_encode_scene(gb, gb->xsr_name, szName);
+}
+
+static GF_Err gb_test_laser_dec(GPACBench *gb, u64 *bytes)
+{
+	*bytes = gb_file_size(gb->laser_name);
+	return gb_decode_scene(gb, gb->laser_name);
+}
+
+
+/*
+		XML
+*/
+
+static void gb_make_svg(GPACBench *gb, u32 nb_elts)
+{
+	u32 i;
+	FILE *f = gf_f64_open(gb->svg_name, "wt");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", gb->svg_name);
+		exit(1);
+	}
+	fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\"320\" height=\"240\">\n");
+	for (i=0; i<nb_elts; i++) {
+		switch (i%4) {
+		case 0:
+			fprintf(f, "<g id=\"g%d\" transform=\"translate(%d,%d) rotate(%d)\">\n", i, gb_rand()%320, gb_rand()%240, gb_rand()%360);
+			break;
+		case 1:
+			fprintf(f, " <rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#%02X%02X%02X\" stroke=\"black\"/>\n", gb_rand()%320, gb_rand()%240, gb_rand()%50, gb_rand()%50, gb_rand()%256, gb_rand()%256, gb_rand()%256);
+			break;
+		case 2:
+			fprintf(f, " <text x=\"%d\" y=\"%d\" font-size=\"12\">Text &amp; element %d</text>\n", gb_rand()%320, gb_rand()%240, i);
+			break;
+		default:
+			fprintf(f, " <path d=\"M %d %d L %d %d C %d %d %d %d %d %d z\" fill=\"none\" stroke=\"#%02X%02X%02X\"/>\n</g>\n", gb_rand()%320, gb_rand()%240, gb_rand()%320, gb_rand()%240, gb_rand()%320, gb_rand()%240, gb_rand()%320, gb_rand()%240, gb_rand()%320, gb_rand()%240, gb_rand()%256, gb_rand()%256, gb_rand()%256);
+			break;
+		}
+	}
+	if (nb_elts%4) fprintf(f, "</g>\n");
+	fprintf(f, "</svg>\n");
+	fclose(f);
+}
+
+static GF_Err gb_test_xml_parse(GPACBench *gb, u64 *bytes)
+{
+	GF_Err e;
+	GF_DOMParser *dom = gf_xml_dom_new();
+	if (!dom) return GF_OUT_OF_MEM;
+	e = gf_xml_dom_parse(dom, gb->svg_name, NULL, NULL);
+	gf_xml_dom_del(dom);
+	*bytes = gb_file_size(gb->svg_name);
+	return (e<0) ? e : GF_OK;
+}
+
+
+/*
+		software rasterizer
+*/
+
+#define GB_RASTER_WIDTH		640
+#define GB_RASTER_HEIGHT	480
+
+/*the raster module reads its options when creating a surface*/
+static GF_SURFACE gb_raster_surface_new(GPACBench *gb, Bool accum, char *pixels)
+{
+	GF_SURFACE surf;
+	GF_Raster2D *r2d = gb->raster;
+	const char *opt = gf_cfg_get_key(gb->cfg, "SoftRaster", "AccumulationBuffer");
+	char *prev = opt ? gf_strdup(opt) : NULL;
+
+	gf_cfg_set_key(gb->cfg, "SoftRaster", "AccumulationBuffer", accum ? "yes" : "no");
+	surf = r2d->surface_new(r2d, 1);
+	gf_cfg_set_key(gb->cfg, "SoftRaster", "AccumulationBuffer", prev);
+	if (prev) gf_free(prev);
+	else if (!gf_cfg_get_key_count(gb->cfg, "SoftRaster")) gf_cfg_del_section(gb->cfg, "SoftRaster");
+	if (!surf) return NULL;
+
+	if (r2d->surface_attach_to_buffer(surf, pixels, GB_RASTER_WIDTH, GB_RASTER_HEIGHT, 4, 4*GB_RASTER_WIDTH, GF_PIXEL_ARGB) != GF_OK) {
+		r2d->surface_delete(surf);
+		return NULL;
+	}
+	r2d->surface_set_raster_level(surf, GF_RASTER_HIGH_QUALITY);
+	r2d->surface_clear(surf, NULL, 0xFFFFFFFF);
+	return surf;
+}
+
+static GF_Err gb_raster_shapes(GPACBench *gb, Bool accum, u64 *bytes)
+{
+	u32 i;
+	GF_SURFACE surf;
+	GF_STENCIL solid, linear, radial;
+	GF_Path *ellipse, *rect, *curve;
+	GF_Matrix2D mx;
+	Fixed pos[2];
+	GF_Color col[2];
+	GF_Raster2D *r2d = gb->raster;
+	u32 nb_shapes = 300*gb->scale;
+
+	if (!r2d) return GF_NOT_SUPPORTED;
+
+	surf = gb_raster_surface_new(gb, accum, gb->pixels);
+	if (!surf) return GF_IO_ERR;
+
+	solid = r2d->stencil_new(r2d, GF_STENCIL_SOLID);
+	linear = r2d->stencil_new(r2d, GF_STENCIL_LINEAR_GRADIENT);
+	radial = r2d->stencil_new(r2d, GF_STENCIL_RADIAL_GRADIENT);
+	pos[0] = 0;
+	pos[1] = FIX_ONE;
+	col[0] = 0xFFFF0000;
+	col[1] = 0x800000FF;
+	r2d->stencil_set_linear_gradient(linear, -INT2FIX(40), 0, INT2FIX(40), 0);
+	r2d->stencil_set_gradient_interpolation(linear, pos, col, 2);
+	r2d->stencil_set_radial_gradient(radial, 0, 0, 0, 0, INT2FIX(40), INT2FIX(40));
+	r2d->stencil_set_gradient_interpolation(radial, pos, col, 2);
+
+	ellipse = gf_path_new();
+	gf_path_add_ellipse(ellipse, 0, 0, INT2FIX(80), INT2FIX(50));
+	rect = gf_path_new();
+	gf_path_add_rect_center(rect, 0, 0, INT2FIX(70), INT2FIX(40));
+	curve = gf_path_new();
+	gf_path_add_move_to(curve, -INT2FIX(40), 0);
+	gf_path_add_cubic_to(curve, -INT2FIX(20), INT2FIX(60), INT2FIX(20), -INT2FIX(60), INT2FIX(40), 0);
+	gf_path_add_quadratic_to(curve, 0, INT2FIX(40), -INT2FIX(40), 0);
+	gf_path_close(curve);
+
+	for (i=0; i<nb_shapes; i++) {
+		GF_STENCIL sten;
+		gf_mx2d_init(mx);
+		gf_mx2d_add_rotation(&mx, 0, 0, INT2FIX(i%63) / 10);
+		gf_mx2d_add_translation(&mx, INT2FIX((s32) (i*37 % GB_RASTER_WIDTH) - GB_RASTER_WIDTH/2), INT2FIX((s32) (i*53 % GB_RASTER_HEIGHT) - GB_RASTER_HEIGHT/2));
+		r2d->surface_set_matrix(surf, &mx);
+		switch (i%3) {
+		case 0:
+			r2d->surface_set_path(surf, ellipse);
+			sten = radial;
+			break;
+		case 1:
+			r2d->surface_set_path(surf, rect);
+			r2d->stencil_set_brush_color(solid, 0x80000000 | (i*0x10305));
+			sten = solid;
+			break;
+		default:
+			r2d->surface_set_path(surf, curve);
+			sten = linear;
+			break;
+		}
+		if (sten != solid) r2d->stencil_set_matrix(sten, &mx);
+		r2d->surface_fill(surf, sten);
+	}
+	if (r2d->surface_flush) r2d->surface_flush(surf);
+
+	gf_path_del(ellipse);
+	gf_path_del(rect);
+	gf_path_del(curve);
+	r2d->stencil_delete(solid);
+	r2d->stencil_delete(linear);
+	r2d->stencil_delete(radial);
+	r2d->surface_detach(surf);
+	r2d->surface_delete(surf);
+	*bytes = 4 * GB_RASTER_WIDTH * GB_RASTER_HEIGHT;
+	return GF_OK;
+}
+
+/*map-like content: a single path made of many small random contours covering the surface, so that
+each scanline crosses hundreds of edges*/
+static GF_Err gb_raster_map(GPACBench *gb, Bool accum, u64 *bytes)
+{
+	u32 i, j, k, prev_seed;
+	GF_SURFACE surf;
+	GF_STENCIL solid;
+	GF_Path *map;
+	GF_Matrix2D mx;
+	GF_Raster2D *r2d = gb->raster;
+	u32 nb_draw = 10*gb->scale;
+
+	if (!r2d) return GF_NOT_SUPPORTED;
+
+	surf = gb_raster_surface_new(gb, accum, gb->pixels);
+	if (!surf) return GF_IO_ERR;
+	solid = r2d->stencil_new(r2d, GF_STENCIL_SOLID);
+
+	/*same path for all runs and modes*/
+	prev_seed = gb_seed;
+	gb_seed = 3;
+	map = gf_path_new();
+	for (i=0; i<1500; i++) {
+		s32 x = (s32) (gb_rand() % GB_RASTER_WIDTH) - GB_RASTER_WIDTH/2;
+		s32 y = (s32) (gb_rand() % GB_RASTER_HEIGHT) - GB_RASTER_HEIGHT/2;
+		gf_path_add_move_to(map, INT2FIX(x), INT2FIX(y));
+		for (j=0; j<12; j++) {
+			x += (s32) (gb_rand() % 41) - 20;
+			y += (s32) (gb_rand() % 41) - 20;
+			gf_path_add_line_to(map, INT2FIX(x), INT2FIX(y));
+		}
+		gf_path_close(map);
+	}
+	gb_seed = prev_seed;
+
+	for (k=0; k<nb_draw; k++) {
+		gf_mx2d_init(mx);
+		gf_mx2d_add_rotation(&mx, 0, 0, INT2FIX(k%7) / 50);
+		r2d->surface_set_matrix(surf, &mx);
+		r2d->surface_set_path(surf, map);
+		r2d->stencil_set_brush_color(solid, 0x80000000 | (k*0x10305));
+		r2d->surface_fill(surf, solid);
+	}
+	if (r2d->surface_flush) r2d->surface_flush(surf);
+
+	gf_path_del(map);
+	r2d->stencil_delete(solid);
+	r2d->surface_detach(surf);
+	r2d->surface_delete(surf);
+	*bytes = 4 * GB_RASTER_WIDTH * GB_RASTER_HEIGHT;
+	return GF_OK;
+}
+
+static GF_Err gb_test_raster(GPACBench *gb, u64 *bytes)
+{
+	return gb_raster_shapes(gb, 0, bytes);
+}
+
+static GF_Err gb_test_raster_acc(GPACBench *gb, u64 *bytes)
+{
+	return gb_raster_shapes(gb, 1, bytes);
+}
+
+static GF_Err gb_test_raster_map(GPACBench *gb, u64 *bytes)
+{
+	return gb_raster_map(gb, 0, bytes);
+}
+
+static GF_Err gb_test_raster_map_acc(GPACBench *gb, u64 *bytes)
+{
+	return gb_raster_map(gb, 1, bytes);
+}
+
+
+static GBTest gb_tests[] =
+{
+	{"avc_import", "AVC|H264 Annex B import to ISO file", gb_test_avc_import},
+	{"iso_open", "ISO file open and parse", gb_test_iso_open},
+	{"iso_samples", "ISO sample iteration", gb_test_iso_samples},
+	{"iso_remux", "ISO to ISO track import", gb_test_iso_remux},
+	{"dash", "DASH segmentation (0.5s fragments, 1s segments)", gb_test_dash},
+	{"ts_mux", "MPEG-2 TS mux of AVC stream", gb_test_ts_mux},
+	{"ts_demux", "MPEG-2 TS demux with PES reassembly", gb_test_ts_demux},
+	{"ps_import", "MPEG-2 PS import of 1 video and 4 audio tracks", gb_test_ps_import},
+	{"bifs_enc", "BT parse and BIFS encode", gb_test_bifs_enc},
+	{"bt_load", "BT parse with forward USE and ROUTE", gb_test_bt_load},
+	{"xmt_load", "XMT parse with forward USE", gb_test_xmt_load},
+	{"bifs_dec", "BIFS decode from ISO file", gb_test_bifs_dec},
+	{"laser_enc", "XSR parse and LASeR encode", gb_test_laser_enc},
+	{"laser_dec", "LASeR decode from ISO file", gb_test_laser_dec},
+	{"xml_parse", "XML DOM parse of SVG document", gb_test_xml_parse},
+	{"raster", "software rasterizer fill (solid and gradients)", gb_test_raster},
+	{"raster_acc", "software rasterizer fill, accumulation buffer", gb_test_raster_acc},
+	{"raster_map", "software rasterizer fill of map-like path", gb_test_raster_map},
+	{"raster_map_acc", "software rasterizer fill of map-like path, accumulation buffer", gb_test_raster_map_acc},
+};
+
+
+/*
+		bulk ISO sample copy check: gf_isom_copy_samples shall give the same file as adding the samples one by one
+*/
+
+/*sizes are constant up to sample nb_const then vary, sync samples every 10 samples, composition offsets every 4 samples
+and, if asked, redundant samples (signaled in sdtp) every 7 samples. Sample data never contains box types*/
+static GF_Err gb_make_copy_src(GPACBench *gb, const char *name, u32 nb_samples, u32 nb_const, Bool redundant)
+{
+	u32 i, j, track, di;
+	GF_Err e;
+	GF_ISOSample *samp;
+	GF_ESD *esd;
+	char data[600];
+	GF_ISOFile *file = gf_isom_open(name, GF_ISOM_WRITE_EDIT, gb->dir);
+	if (!file) return gf_isom_last_error(NULL);
+
+	esd = gf_odf_desc_esd_new(2);
+	esd->decoderConfig->streamType = GF_STREAM_VISUAL;
+	esd->decoderConfig->objectTypeIndication = GPAC_OTI_VIDEO_MPEG4_PART2;
+	track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_VISUAL, 1000);
+	e = track ? gf_isom_new_mpeg4_description(file, track, esd, NULL, NULL, &di) : gf_isom_last_error(file);
+	gf_odf_desc_del((GF_Descriptor *) esd);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	samp = gf_isom_sample_new();
+	samp->data = data;
+	for (i=0; i<nb_samples; i++) {
+		samp->dataLength = (i<nb_const) ? 100 : 50 + gb_rand() % 500;
+		for (j=0; j<samp->dataLength; j++) data[j] = (char) ((i+j) % 16);
+		samp->IsRAP = (i%10) ? 0 : 1;
+		if (redundant && (i%7 == 3)) samp->IsRAP = 2;
+		samp->CTS_Offset = (i%4 == 1) ? 2000 : 0;
+		e = gf_isom_add_sample(file, track, di, samp);
+		if (e) break;
+		samp->DTS += (i < nb_samples/2) ? 1000 : 1500;
+	}
+	samp->data = NULL;
+	gf_isom_sample_del(&samp);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+/*copies ranges (source index, first sample, number of samples) of the sources one after the other*/
+static GF_Err gb_copy_ranges(GPACBench *gb, const char *dst, char **srcs, u32 nb_srcs, const u32 *ranges, u32 nb_ranges, Bool bulk)
+{
+	u32 i, n, track, di, sdi;
+	GF_Err e;
+	GF_ISOFile *src[2];
+	GF_ISOFile *file;
+
+	for (i=0; i<nb_srcs; i++) src[i] = gf_isom_open(srcs[i], GF_ISOM_OPEN_READ, NULL);
+	file = gf_isom_open(dst, GF_ISOM_WRITE_EDIT, gb->dir);
+	track = file ? gf_isom_new_track(file, 0, GF_ISOM_MEDIA_VISUAL, 1000) : 0;
+	e = track ? gf_isom_clone_sample_description(file, track, src[0], 1, 1, NULL, NULL, &di) : GF_IO_ERR;
+	for (i=0; !e && (i<nb_ranges); i++) {
+		GF_ISOFile *orig = src[ranges[3*i]];
+		if (bulk) {
+			e = gf_isom_copy_samples(file, track, di, orig, 1, ranges[3*i+1], ranges[3*i+2]);
+			continue;
+		}
+		for (n=ranges[3*i+1]; n<ranges[3*i+1]+ranges[3*i+2]; n++) {
+			GF_ISOSample *samp = gf_isom_get_sample(orig, 1, n, &sdi);
+			if (!samp) {
+				e = gf_isom_last_error(orig);
+				break;
+			}
+			e = gf_isom_add_sample(file, track, di, samp);
+			gf_isom_sample_del(&samp);
+			if (e) break;
+		}
+	}
+	for (i=0; i<nb_srcs; i++) gf_isom_close(src[i]);
+	if (!file) return GF_IO_ERR;
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+/*loads a file, with creation and modification times of movie, tracks and media set to 0*/
+static char *gb_load_iso_file(const char *name, u32 *size)
+{
+	u32 i, j;
+	char *data;
+	const char *types[] = {"mvhd", "tkhd", "mdhd"};
+	FILE *f = gf_f64_open(name, "rb");
+	if (!f) return NULL;
+	gf_f64_seek(f, 0, SEEK_END);
+	*size = (u32) gf_f64_tell(f);
+	gf_f64_seek(f, 0, SEEK_SET);
+	data = gf_malloc(*size);
+	if (fread(data, 1, *size, f) != *size) {
+		gf_free(data);
+		data = NULL;
+	}
+	fclose(f);
+	if (!data) return NULL;
+	for (i=0; i+12<*size; i++) {
+		for (j=0; j<3; j++) {
+			if (memcmp(data+i, types[j], 4)) continue;
+			/*version 1 boxes have 64 bit times*/
+			memset(data+i+8, 0, data[i+4] ? 16 : 8);
+		}
+	}
+	return data;
+}
+
+static Bool gb_check_iso_copy(GPACBench *gb)
+{
+	u32 i, size_bulk, size_ref;
+	Bool ok = 1;
+	char *srcs[2];
+	char szSrc1[GF_MAX_PATH], szSrc2[GF_MAX_PATH], szBulk[GF_MAX_PATH], szRef[GF_MAX_PATH];
+	/*source 1 has 60 samples and variable sizes after 20, source 2 has 30 samples of constant size*/
+	static const struct {
+		const char *desc;
+		Bool redundant;
+		u32 nb_ranges;
+		u32 ranges[9];
+	} checks[] = {
+		{"constant then variable sizes in one copy", 0, 1, {0, 1, 60}},
+		{"constant then variable sizes in two copies", 0, 2, {0, 1, 20, 0, 21, 40}},
+		{"size switch inside a copy", 0, 3, {0, 1, 10, 0, 11, 25, 0, 36, 25}},
+		{"constant size track then variable sizes", 0, 2, {1, 1, 30, 0, 41, 20}},
+		{"redundant samples (sdtp) in one copy", 1, 1, {0, 1, 60}},
+		{"redundant samples (sdtp) in several copies", 1, 3, {0, 1, 17, 0, 18, 4, 0, 22, 39}},
+	};
+
+	sprintf(szSrc1, "%s/gpacbench_copy_src1.mp4", gb->dir);
+	sprintf(szSrc2, "%s/gpacbench_copy_src2.mp4", gb->dir);
+	sprintf(szBulk, "%s/gpacbench_copy_bulk.mp4", gb->dir);
+	sprintf(szRef, "%s/gpacbench_copy_ref.mp4", gb->dir);
+	srcs[0] = szSrc1;
+	srcs[1] = szSrc2;
+
+	for (i=0; i<sizeof(checks)/sizeof(checks[0]); i++) {
+		GF_Err e;
+		char *bulk, *ref;
+		gb_seed = 0x47504143;
+		e = gb_make_copy_src(gb, szSrc1, 60, 20, checks[i].redundant);
+		if (!e) e = gb_make_copy_src(gb, szSrc2, 30, 30, 0);
+		if (!e) e = gb_copy_ranges(gb, szRef, srcs, 2, checks[i].ranges, checks[i].nb_ranges, 0);
+		/*GF_NOT_SUPPORTED means the bulk copy was not used*/
+		if (!e) e = gb_copy_ranges(gb, szBulk, srcs, 2, checks[i].ranges, checks[i].nb_ranges, 1);
+		if (e) {
+			fprintf(stdout, "%-45s failed: %s\n", checks[i].desc, gf_error_to_string(e));
+			ok = 0;
+			continue;
+		}
+		bulk = gb_load_iso_file(szBulk, &size_bulk);
+		ref = gb_load_iso_file(szRef, &size_ref);
+		if (!bulk || !ref || (size_bulk != size_ref) || memcmp(bulk, ref, size_ref)) {
+			fprintf(stdout, "%-45s FAILED: bulk copy differs from per-sample copy\n", checks[i].desc);
+			ok = 0;
+		} else {
+			fprintf(stdout, "%-45s OK\n", checks[i].desc);
+		}
+		if (bulk) gf_free(bulk);
+		if (ref) gf_free(ref);
+	}
+	gf_delete_file(szSrc1);
+	gf_delete_file(szSrc2);
+	gf_delete_file(szBulk);
+	gf_delete_file(szRef);
+	return ok;
+}
+
+
+/*
+		raster accumulation buffer check: each path shall give the same pixels as with the cell sweep
+*/
+
+#define GB_RASTER_CHECK_PATHS	3000
+
+static Fixed gb_rand_fix(s32 min, s32 max)
+{
+	return INT2FIX(min + (s32) (gb_rand() % (u32) (max - min + 1)));
+}
+
+/*ellipses, rects, curves, self-intersecting polygons, many small contours and far off-screen coordinates*/
+static GF_Path *gb_make_check_path(u32 type)
+{
+	u32 i, j, nb_pts;
+	GF_Path *path = gf_path_new();
+	switch (type) {
+	case 0:
+		gf_path_add_ellipse(path, gb_rand_fix(-200, 200), gb_rand_fix(-200, 200), gb_rand_fix(1, 400), gb_rand_fix(1, 400));
+		break;
+	case 1:
+		gf_path_add_rect_center(path, gb_rand_fix(-200, 200), gb_rand_fix(-200, 200), gb_rand_fix(1, 500), gb_rand_fix(1, 500));
+		break;
+	case 2:
+		gf_path_add_move_to(path, gb_rand_fix(-300, 300), gb_rand_fix(-300, 300));
+		for (i=0; i<4; i++) {
+			gf_path_add_cubic_to(path, gb_rand_fix(-300, 300), gb_rand_fix(-300, 300), gb_rand_fix(-300, 300), gb_rand_fix(-300, 300), gb_rand_fix(-300, 300), gb_rand_fix(-300, 300));
+			gf_path_add_quadratic_to(path, gb_rand_fix(-300, 300), gb_rand_fix(-300, 300), gb_rand_fix(-300, 300), gb_rand_fix(-300, 300));
+		}
+		gf_path_close(path);
+		break;
+	case 3:
+		nb_pts = 5 + gb_rand() % 20;
+		gf_path_add_move_to(path, gb_rand_fix(-300, 300), gb_rand_fix(-300, 300));
+		for (i=0; i<nb_pts; i++) gf_path_add_line_to(path, gb_rand_fix(-300, 300), gb_rand_fix(-300, 300));
+		gf_path_close(path);
+		break;
+	case 4:
+		for (j=0; j<100; j++) {
+			s32 x = (s32) (gb_rand() % GB_RASTER_WIDTH) - GB_RASTER_WIDTH/2;
+			s32 y = (s32) (gb_rand() % GB_RASTER_HEIGHT) - GB_RASTER_HEIGHT/2;
+			gf_path_add_move_to(path, INT2FIX(x), INT2FIX(y));
+			for (i=0; i<5; i++) gf_path_add_line_to(path, INT2FIX(x) + gb_rand_fix(-15, 15), INT2FIX(y) + gb_rand_fix(-15, 15));
+			gf_path_close(path);
+		}
+		break;
+	default:
+		nb_pts = 3 + gb_rand() % 6;
+		gf_path_add_move_to(path, gb_rand_fix(-20000, 20000), gb_rand_fix(-20000, 20000));
+		for (i=0; i<nb_pts; i++) gf_path_add_line_to(path, gb_rand_fix(-20000, 20000), gb_rand_fix(-20000, 20000));
+		gf_path_close(path);
+		break;
+	}
+	if (gb_rand() % 2) path->flags |= GF_PATH_FILL_ZERO_NONZERO;
+	return path;
+}
+
+static Bool gb_check_raster_accum(GPACBench *gb)
+{
+	u32 i, nb_diff;
+	GF_SURFACE surf, surf_acc;
+	GF_STENCIL solid;
+	char *pixels_acc;
+	GF_Raster2D *r2d = gb->raster;
+	const char *desc = "raster accumulation buffer against cell sweep";
+
+	if (!r2d) {
+		fprintf(stdout, "%-45s skipped: GPAC 2D Raster module not found\n", desc);
+		return 1;
+	}
+	pixels_acc = gf_malloc(4 * GB_RASTER_WIDTH * GB_RASTER_HEIGHT);
+	surf = gb_raster_surface_new(gb, 0, gb->pixels);
+	surf_acc = gb_raster_surface_new(gb, 1, pixels_acc);
+	solid = r2d->stencil_new(r2d, GF_STENCIL_SOLID);
+	if (!surf || !surf_acc || !solid) {
+		fprintf(stdout, "%-45s failed: cannot create surfaces\n", desc);
+		if (surf) r2d->surface_delete(surf);
+		if (surf_acc) r2d->surface_delete(surf_acc);
+		if (solid) r2d->stencil_delete(solid);
+		gf_free(pixels_acc);
+		return 0;
+	}
+	r2d->stencil_set_brush_color(solid, 0xFF000000);
+
+	gb_seed = 0x47504143;
+	nb_diff = 0;
+	for (i=0; i<GB_RASTER_CHECK_PATHS; i++) {
+		GF_IRect rc, *clip;
+		GF_Matrix2D mx;
+		GF_Path *path = gb_make_check_path(i % 6);
+
+		gf_mx2d_init(mx);
+		gf_mx2d_add_scale(&mx, INT2FIX(20 + gb_rand() % 280) / 100, INT2FIX(20 + gb_rand() % 280) / 100);
+		gf_mx2d_add_rotation(&mx, 0, 0, INT2FIX(gb_rand() % 628) / 100);
+		gf_mx2d_add_translation(&mx, gb_rand_fix(-GB_RASTER_WIDTH/2, GB_RASTER_WIDTH/2), gb_rand_fix(-GB_RASTER_HEIGHT/2, GB_RASTER_HEIGHT/2));
+
+		/*clipper in top-left pixel coordinates, converted to the centered coordinates of the surfaces*/
+		clip = NULL;
+		if (gb_rand() % 2) {
+			u32 x = gb_rand() % (GB_RASTER_WIDTH-1);
+			u32 y = gb_rand() % (GB_RASTER_HEIGHT-1);
+			rc.width = 1 + gb_rand() % (GB_RASTER_WIDTH - x);
+			rc.height = 1 + gb_rand() % (GB_RASTER_HEIGHT - y);
+			rc.x = (s32) x - GB_RASTER_WIDTH/2;
+			rc.y = GB_RASTER_HEIGHT/2 - (s32) y;
+			clip = &rc;
+		}
+
+		r2d->surface_clear(surf, NULL, 0xFFFFFFFF);
+		r2d->surface_clear(surf_acc, NULL, 0xFFFFFFFF);
+		r2d->surface_set_clipper(surf, clip);
+		r2d->surface_set_clipper(surf_acc, clip);
+		r2d->surface_set_matrix(surf, &mx);
+		r2d->surface_set_matrix(surf_acc, &mx);
+		r2d->surface_set_path(surf, path);
+		r2d->surface_set_path(surf_acc, path);
+		r2d->surface_fill(surf, solid);
+		r2d->surface_fill(surf_acc, solid);
+		if (r2d->surface_flush) {
+			r2d->surface_flush(surf);
+			r2d->surface_flush(surf_acc);
+		}
+		gf_path_del(path);
+
+		if (memcmp(gb->pixels, pixels_acc, 4 * GB_RASTER_WIDTH * GB_RASTER_HEIGHT)) {
+			if (nb_diff < 10) fprintf(stderr, "Path %d (type %d): pixels differ\n", i, i % 6);
+			nb_diff++;
+		}
+	}
+	if (nb_diff) fprintf(stdout, "%-45s FAILED: %d paths out of %d differ\n", desc, nb_diff, GB_RASTER_CHECK_PATHS);
+	else fprintf(stdout, "%-45s OK (%d paths)\n", desc, GB_RASTER_CHECK_PATHS);
+
+	r2d->stencil_delete(solid);
+	r2d->surface_detach(surf);
+	r2d->surface_detach(surf_acc);
+	r2d->surface_delete(surf);
+	r2d->surface_delete(surf_acc);
+	gf_free(pixels_acc);
+	return nb_diff ? 0 : 1;
+}
+
+static Bool gb_test_selected(const char *name, const char *filter)
+{
+	char *sep;
+	u32 len = strlen(name);
+	if (!filter) return 1;
+	while (filter) {
+		sep = strchr(filter, ',');
+		if ((sep ? (u32) (sep - filter) : strlen(filter)) == len && !strncmp(filter, name, len)) return 1;
+		filter = sep ? sep+1 : NULL;
+	}
+	return 0;
+}
+
+static int gb_cmp_u64(const void *a, const void *b)
+{
+	u64 v1 = *(const u64 *)a;
+	u64 v2 = *(const u64 *)b;
+	return (v1<v2) ? -1 : ((v1>v2) ? 1 : 0);
+}
+
+static void gb_stats(GBResult *res, u64 *times, u32 nb_runs)
+{
+	u32 i, p95;
+	u64 tot = 0;
+	qsort(times, nb_runs, sizeof(u64), gb_cmp_u64);
+	for (i=0; i<nb_runs; i++) tot += times[i];
+	res->runs = nb_runs;
+	res->min = times[0];
+	res->max = times[nb_runs-1];
+	res->mean = tot / nb_runs;
+	res->median = (nb_runs%2) ? times[nb_runs/2] : (times[nb_runs/2 - 1] + times[nb_runs/2]) / 2;
+	/*nearest rank*/
+	p95 = (95*nb_runs + 99) / 100;
+	res->p95 = times[p95 ? p95-1 : 0];
+}
+
+
+/*
+		setup
+*/
+
+static Bool gb_cleanup_file(void *cbck, char *item_name, char *item_path)
+{
+	if (!strncmp(item_name, "gpacbench_", 10)) gf_delete_file(item_path);
+	return 0;
+}
+
+static void gb_load_raster(GPACBench *gb)
+{
+	const char *opt;
+	gb->cfg = gf_cfg_init(NULL, NULL);
+	opt = gb->cfg ? gf_cfg_get_key(gb->cfg, "General", "ModulesDirectory") : NULL;
+	if (opt) {
+		gb->modules = gf_modules_new(opt, gb->cfg);
+		if (gb->modules) gb->raster = (GF_Raster2D *) gf_modules_load_interface_by_name(gb->modules, "GPAC 2D Raster", GF_RASTER_2D_INTERFACE);
+	}
+	gb->pixels = gf_malloc(4 * GB_RASTER_WIDTH * GB_RASTER_HEIGHT);
+}
+
+static void gb_unload_raster(GPACBench *gb)
+{
+	if (gb->raster) gf_modules_close_interface((GF_BaseInterface *) gb->raster);
+	if (gb->modules) gf_modules_del(gb->modules);
+	if (gb->cfg) gf_cfg_del(gb->cfg);
+	gf_free(gb->pixels);
+}
+
+static void gb_setup(GPACBench *gb)
+{
+	GF_Err e;
+	u64 bytes;
+
+	sprintf(gb->es_name, "%s/gpacbench_src.264", gb->dir);
+	sprintf(gb->mp4_name, "%s/gpacbench_src.mp4", gb->dir);
+	sprintf(gb->bt_name, "%s/gpacbench_src.bt", gb->dir);
+	sprintf(gb->xsr_name, "%s/gpacbench_src.xsr", gb->dir);
+	sprintf(gb->svg_name, "%s/gpacbench_src.svg", gb->dir);
+	sprintf(gb->bifs_name, "%s/gpacbench_bifs.mp4", gb->dir);
+	sprintf(gb->laser_name, "%s/gpacbench_laser.mp4", gb->dir);
+	sprintf(gb->ps_name, "%s/gpacbench_src.mpg", gb->dir);
+	sprintf(gb->fwd_bt_name, "%s/gpacbench_fwd.bt", gb->dir);
+	sprintf(gb->fwd_xmt_name, "%s/gpacbench_fwd.xmt", gb->dir);
+
+	fprintf(stdout, "Generating synthetic inputs (scale %d)\n", gb->scale);
+	gb_make_avc(gb, 2500*gb->scale, 25);
+	gb_write_file(gb->es_name, gb->es, gb->es_size);
+	e = gb_import_avc(gb, gb->mp4_name);
+	if (e) fprintf(stderr, "Cannot import %s: %s\n", gb->es_name, gf_error_to_string(e));
+
+	/*muxed once so that the demux test has an input*/
+	gb_test_ts_mux(gb, &bytes);
+
+	gb_make_ps(gb, 1500*gb->scale, 4);
+
+	gb_make_bt(gb, 200*gb->scale, 100);
+	e = gb_encode_scene(gb, gb->bt_name, gb->bifs_name);
+	if (e) fprintf(stderr, "Cannot encode %s: %s\n", gb->bt_name, gf_error_to_string(e));
+	gb_make_xsr(gb, 200*gb->scale, 100);
+	e = gb_encode_scene(gb, gb->xsr_name, gb->laser_name);
+	if (e) fprintf(stderr, "Cannot encode %s: %s\n", gb->xsr_name, gf_error_to_string(e));
+	gb_make_fwd_bt(gb, 1000*gb->scale);
+	gb_make_fwd_xmt(gb, 1000*gb->scale);
+	gb_make_svg(gb, 5000*gb->scale);
+
+	gb_load_raster(gb);
+	if (!gb->raster) fprintf(stderr, "GPAC 2D Raster module not found - raster test disabled\n");
+}
+
+static void gb_cleanup(GPACBench *gb)
+{
+	gb_unload_raster(gb);
+	gf_free(gb->es);
+	gf_free(gb->au_offsets);
+	gf_free(gb->au_sizes);
+	gf_free(gb->au_rap);
+	if (gb->ts) gf_free(gb->ts);
+	gf_enum_directory(gb->dir, 0, gb_cleanup_file, gb, NULL);
+}
+
+
+/*
+		JSON report and comparison
+*/
+
+static void gb_write_json(const char *name, GPACBench *gb, GBResult *results, u32 nb_results, u32 warmup, u32 repeat)
+{
+	u32 i;
+	FILE *f = gf_f64_open(name, "wt");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", name);
+		return;
+	}
+	fprintf(f, "{\n \"version\": \"%s\",\n \"scale\": %d,\n \"warmup\": %d,\n \"repeat\": %d,\n \"tests\": [\n", GPAC_FULL_VERSION, gb->scale, warmup, repeat);
+	for (i=0; i<nb_results; i++) {
+		GBResult *r = &results[i];
+		fprintf(f, "  {\"name\": \"%s\", \"runs\": %d, \"bytes\": "LLU", \"min_us\": "LLU", \"mean_us\": "LLU", \"median_us\": "LLU", \"p95_us\": "LLU", \"max_us\": "LLU"}%s\n",
+			r->name, r->runs, r->bytes, r->min, r->mean, r->median, r->p95, r->max, (i+1<nb_results) ? "," : "");
+	}
+	fprintf(f, " ]\n}\n");
+	fclose(f);
+	fprintf(stdout, "Results written to %s\n", name);
+}
+
+/*minimal scanner for the files written above: looks for "median_us" after each test name*/
+static Bool gb_json_median(char *json, const char *test, Double *median)
+{
+	char szName[100];
+	char *pos;
+	sprintf(szName, "\"name\": \"%s\"", test);
+	pos = strstr(json, szName);
+	if (!pos) return 0;
+	pos = strstr(pos, "\"median_us\":");
+	if (!pos) return 0;
+	*median = atof(pos + 12);
+	return 1;
+}
+
+static char *gb_load_json(const char *name)
+{
+	char *data;
+	u64 size = gb_file_size(name);
+	FILE *f = gf_f64_open(name, "rb");
+	if (!f || !size) {
+		if (f) fclose(f);
+		fprintf(stderr, "Cannot open %s\n", name);
+		return NULL;
+	}
+	data = gf_malloc((u32) size + 1);
+	size = fread(data, 1, (u32) size, f);
+	data[size] = 0;
+	fclose(f);
+	return data;
+}
+
+static int gb_compare(const char *ref_name, const char *name)
+{
+	u32 i;
+	Double m1, m2;
+	char *ref = gb_load_json(ref_name);
+	char *res = gb_load_json(name);
+	if (!ref || !res) {
+		if (ref) gf_free(ref);
+		if (res) gf_free(res);
+		return 1;
+	}
+	fprintf(stdout, "%-12s %14s %14s %8s\n", "test", "median (ref)", "median (new)", "speedup");
+	for (i=0; i<sizeof(gb_tests)/sizeof(GBTest); i++) {
+		if (!gb_json_median(ref, gb_tests[i].name, &m1) || !gb_json_median(res, gb_tests[i].name, &m2)) continue;
+		fprintf(stdout, "%-12s %11.3f ms %11.3f ms %7.2fx\n", gb_tests[i].name, m1/1000, m2/1000, m2 ? m1/m2 : 0);
+	}
+	gf_free(ref);
+	gf_free(res);
+	return 0;
+}
+
+
+static void usage()
+{
+	u32 i;
+	fprintf(stdout, "gpac-bench [options]\n"
+		"\t-t test1[,test2]   runs only the given tests\n"
+		"\t-warmup W          untimed runs before measuring (default 2)\n"
+		"\t-repeat N          timed runs per test (default 10)\n"
+		"\t-scale S           multiplies synthetic input sizes by S (default 1)\n"
+		"\t-dir path          directory for temporary files (default current)\n"
+		"\t-json file         writes results as JSON\n"
+		"\t-compare ref new   compares medians of two JSON result files\n"
+		"\t-check             checks that bulk ISO sample copy gives the same files as per-sample copy, and that\n"
+		"\t                   the raster accumulation buffer gives the same pixels as the cell sweep\n"
+		"\nAvailable tests:\n");
+	for (i=0; i<sizeof(gb_tests)/sizeof(GBTest); i++) {
+		fprintf(stdout, "\t%-12s %s\n", gb_tests[i].name, gb_tests[i].desc);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, warmup, repeat, nb_results;
+	const char *filter, *json;
+	Bool check;
+	u64 times[GB_MAX_RUNS];
+	GBResult results[sizeof(gb_tests)/sizeof(GBTest)];
+	GPACBench gb;
+
+	memset(&gb, 0, sizeof(GPACBench));
+	gb.scale = 1;
+	gb.dir = ".";
+	warmup = 2;
+	repeat = 10;
+	filter = json = NULL;
+	check = 0;
+	for (i=1; i<(u32)argc; i++) {
+		if (!strcmp(argv[i], "-t") && (i+1<(u32)argc)) filter = argv[++i];
+		else if (!strcmp(argv[i], "-warmup") && (i+1<(u32)argc)) warmup = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-repeat") && (i+1<(u32)argc)) repeat = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-scale") && (i+1<(u32)argc)) gb.scale = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-dir") && (i+1<(u32)argc)) gb.dir = argv[++i];
+		else if (!strcmp(argv[i], "-json") && (i+1<(u32)argc)) json = argv[++i];
+		else if (!strcmp(argv[i], "-compare") && (i+2<(u32)argc)) return gb_compare(argv[i+1], argv[i+2]);
+		else if (!strcmp(argv[i], "-check")) check = 1;
+		else {
+			usage();
+			return 0;
+		}
+	}
+	if (!repeat) repeat = 1;
+	if (repeat > GB_MAX_RUNS) repeat = GB_MAX_RUNS;
+	if (!gb.scale) gb.scale = 1;
+
+	gf_sys_init(0);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+	gf_set_progress_callback(NULL, gb_quiet_progress);
+	if (check) {
+		Bool ok = gb_check_iso_copy(&gb);
+		gb_load_raster(&gb);
+		if (!gb_check_raster_accum(&gb)) ok = 0;
+		gb_unload_raster(&gb);
+		gf_sys_close();
+		return ok ? 0 : 1;
+	}
+	gb_setup(&gb);
+
+	fprintf(stdout, "GPAC %s - %d warm-up runs, %d timed runs\n", GPAC_FULL_VERSION, warmup, repeat);
+	fprintf(stdout, "%-12s %11s %11s %11s %11s %10s\n", "test", "min (ms)", "median (ms)", "p95 (ms)", "mean (ms)", "MB/s");
+
+	nb_results = 0;
+	for (i=0; i<sizeof(gb_tests)/sizeof(GBTest); i++) {
+		GF_Err e = GF_OK;
+		u64 bytes = 0;
+		GBResult *res = &results[nb_results];
+		if (!gb_test_selected(gb_tests[i].name, filter)) continue;
+
+		for (j=0; j<warmup; j++) {
+			e = gb_tests[i].run(&gb, &bytes);
+			if (e) break;
+		}
+		for (j=0; !e && (j<repeat); j++) {
+			u64 now = gf_sys_clock_high_res();
+			e = gb_tests[i].run(&gb, &bytes);
+			times[j] = gf_sys_clock_high_res() - now;
+		}
+		if (e) {
+			fprintf(stdout, "%-12s failed: %s\n", gb_tests[i].name, gf_error_to_string(e));
+			continue;
+		}
+		res->name = gb_tests[i].name;
+		res->bytes = bytes;
+		gb_stats(res, times, repeat);
+		nb_results++;
+
+		fprintf(stdout, "%-12s %11.3f %11.3f %11.3f %11.3f", res->name, res->min/1000.0, res->median/1000.0, res->p95/1000.0, res->mean/1000.0);
+		if (bytes && res->median) fprintf(stdout, " %10.2f\n", (Double) (s64) bytes / (Double) (s64) res->median);
+		else fprintf(stdout, " %10s\n", "-");
+	}
+
+	if (json) gb_write_json(json, &gb, results, nb_results, warmup, repeat);
+
+	gb_cleanup(&gb);
+	gf_sys_close();
+	return 0;
+}
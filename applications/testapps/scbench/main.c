@@ -0,0 +1,151 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Copyright (c) Jean Le Feuvre 2000-2005
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / start code search benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures start code search throughput on a synthetic elementary stream: random payload with
+emulation prevention applied, and a 0x00000001 start code every nal_size bytes on average.
+Results of gf_media_next_start_code are checked against a byte per byte search*/
+
+#include <gpac/avparse.h>
+
+/*byte per byte 32 bit window search, as done by the parsers before the shared search*/
+static u32 scbench_ref_next_start_code(const u8 *data, u32 size)
+{
+	u32 i, v = 0xFFFFFFFF;
+	for (i=0; i<size; i++) {
+		v = (v<<8) | data[i];
+		if ((v & 0x00FFFFFF) == 0x00000001) return i-2;
+	}
+	return size;
+}
+
+static u32 scbench_count(const u8 *data, u32 size, Bool use_ref)
+{
+	u32 pos = 0, count = 0;
+	while (pos < size) {
+		u32 sc = use_ref ? scbench_ref_next_start_code(data+pos, size-pos) : gf_media_next_start_code(data+pos, size-pos);
+		if (pos+sc >= size) break;
+		count++;
+		pos += sc + 3;
+	}
+	return count;
+}
+
+static u8 *scbench_make_stream(u32 size, u32 nal_size)
+{
+	u32 i, zeros;
+	u8 *data = (u8*)gf_malloc(sizeof(u8) * size);
+	zeros = 0;
+	for (i=0; i<size; i++) {
+		u8 c;
+		if (!(rand() % nal_size) && (i+4 < size)) {
+			data[i] = data[i+1] = data[i+2] = 0;
+			data[i+3] = 1;
+			i += 3;
+			zeros = 0;
+			continue;
+		}
+		/*biased towards null bytes to exercise the prefix checks*/
+		c = (rand() % 4) ? (u8) rand() : 0;
+		/*emulation prevention*/
+		if ((zeros>=2) && (c<=3)) c = 3;
+		data[i] = c;
+		zeros = c ? 0 : zeros+1;
+	}
+	return data;
+}
+
+static void usage()
+{
+	fprintf(stdout, "scbench [-s size_in_MB] [-n avg_nal_size] [-l nb_loops]\n");
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, size, nal_size, nb_loops, count, ref_count, now, pos, sc, ref_sc;
+	Double ms, ref_ms;
+	u8 *data;
+
+	size = 64;
+	nal_size = 2000;
+	nb_loops = 10;
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-s") && (i+1<(u32)argc)) size = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-n") && (i+1<(u32)argc)) nal_size = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-l") && (i+1<(u32)argc)) nb_loops = atoi(argv[++i]);
+		else {
+			usage();
+			return 0;
+		}
+	}
+	if (!nal_size) nal_size = 1;
+	size *= 1024*1024;
+	gf_sys_init(0);
+	srand(1);
+	data = scbench_make_stream(size, nal_size);
+
+	/*check all offsets against the reference search, including unaligned starts and short spans*/
+	pos = 0;
+	while (1) {
+		sc = gf_media_next_start_code(data+pos, size-pos);
+		ref_sc = scbench_ref_next_start_code(data+pos, size-pos);
+		if (sc != ref_sc) {
+			fprintf(stderr, "Start code mismatch at offset %d: found %d expected %d\n", pos, sc, ref_sc);
+			return 1;
+		}
+		if (pos+sc >= size) break;
+		pos += sc + 1 + (pos % 3);
+	}
+	for (i=0; i<4096; i++) {
+		u32 len = i % 67;
+		u32 off = (i * 7919) % (size - len);
+		if (gf_media_next_start_code(data+off, len) != scbench_ref_next_start_code(data+off, len)) {
+			fprintf(stderr, "Start code mismatch at offset %d size %d\n", off, len);
+			return 1;
+		}
+	}
+
+	ref_count = 0;
+	now = gf_sys_clock();
+	for (i=0; i<nb_loops; i++) ref_count = scbench_count(data, size, 1);
+	now = gf_sys_clock() - now;
+	ref_ms = now ? now : 1;
+
+	count = 0;
+	now = gf_sys_clock();
+	for (i=0; i<nb_loops; i++) count = scbench_count(data, size, 0);
+	now = gf_sys_clock() - now;
+	ms = now ? now : 1;
+
+	if (count != ref_count) {
+		fprintf(stderr, "Start code count mismatch: found %d expected %d\n", count, ref_count);
+		return 1;
+	}
+	fprintf(stdout, "%d MB - %d start codes - %d loops\n", size/(1024*1024), count, nb_loops);
+	fprintf(stdout, "byte loop: %.2f GB/s\n", (Double) size * nb_loops / ref_ms / (1000.0*1000.0));
+	fprintf(stdout, "gf_media_next_start_code: %.2f GB/s\n", (Double) size * nb_loops / ms / (1000.0*1000.0));
+
+	gf_free(data);
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Copyright (c) Jean Le Feuvre 2000-2005
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / scene graph benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures route cascade throughput: one TimeSensor fans out fraction_changed to N interpolators,
+each interpolator drives a Transform2D. Extra routes are declared on other TimeSensor events to
+measure the cost of routes which are not triggered by the cascade*/
+
+#include <gpac/scenegraph_vrml.h>
+#include <gpac/nodes_mpeg4.h>
+
+/*interpolators are only initialized when a node callback is set*/
+static void sgbench_node_callback(void *user_priv, u32 type, GF_Node *node, void *ctxdata)
+{
+}
+
+static GF_Node *sgbench_new_node(GF_SceneGraph *sg, u32 tag, GF_Node *parent)
+{
+	GF_Node *n = gf_node_new(sg, tag);
+	gf_node_register(n, parent);
+	if (parent) gf_node_list_add_child(& ((GF_ParentNode *)parent)->children, n);
+	gf_node_init(n);
+	return n;
+}
+
+static u32 sgbench_field_index(GF_Node *n, char *name)
+{
+	GF_FieldInfo info;
+	if (gf_node_get_field_by_name(n, name, &info) != GF_OK) {
+		fprintf(stderr, "Cannot find field %s\n", name);
+		exit(1);
+	}
+	return info.fieldIndex;
+}
+
+static void usage()
+{
+	fprintf(stdout, "sgbench [-n nb_interpolators] [-x nb_extra_routes] [-f nb_frames]\n");
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_interp, nb_extra, nb_frames, now, fraction_idx, set_fraction_idx, value_idx, translation_idx, cycle_idx, in_time_idx;
+	GF_SceneGraph *sg;
+	GF_Node *root, *ts, *valuator;
+	GF_FieldInfo fraction;
+	Double ms;
+
+	nb_interp = 64;
+	nb_extra = 64;
+	nb_frames = 20000;
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-n") && (i+1<(u32)argc)) nb_interp = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-x") && (i+1<(u32)argc)) nb_extra = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && (i+1<(u32)argc)) nb_frames = atoi(argv[++i]);
+		else {
+			usage();
+			return 0;
+		}
+	}
+
+	gf_sys_init(0);
+	sg = gf_sg_new();
+	gf_sg_set_node_callback(sg, sgbench_node_callback);
+	root = gf_node_new(sg, TAG_MPEG4_OrderedGroup);
+	gf_node_register(root, NULL);
+	gf_sg_set_root_node(sg, root);
+
+	ts = sgbench_new_node(sg, TAG_MPEG4_TimeSensor, NULL);
+	gf_node_set_id(ts, 1, "TS");
+	fraction_idx = sgbench_field_index(ts, "fraction_changed");
+	cycle_idx = sgbench_field_index(ts, "cycleTime");
+	gf_node_get_field(ts, fraction_idx, &fraction);
+
+	for (i=0; i<nb_interp; i++) {
+		GF_Node *interp = sgbench_new_node(sg, TAG_MPEG4_PositionInterpolator2D, NULL);
+		GF_Node *tr = sgbench_new_node(sg, TAG_MPEG4_Transform2D, root);
+		M_PositionInterpolator2D *pi = (M_PositionInterpolator2D *)interp;
+		gf_node_set_id(interp, 2+2*i, NULL);
+		gf_node_set_id(tr, 3+2*i, NULL);
+
+		gf_sg_vrml_mf_alloc(&pi->key, GF_SG_VRML_MFFLOAT, 2);
+		pi->key.vals[0] = 0;
+		pi->key.vals[1] = FIX_ONE;
+		gf_sg_vrml_mf_alloc(&pi->keyValue, GF_SG_VRML_MFVEC2F, 2);
+		pi->keyValue.vals[1].x = pi->keyValue.vals[1].y = INT2FIX(i);
+
+		set_fraction_idx = sgbench_field_index(interp, "set_fraction");
+		value_idx = sgbench_field_index(interp, "value_changed");
+		translation_idx = sgbench_field_index(tr, "translation");
+		gf_sg_route_new(sg, ts, fraction_idx, interp, set_fraction_idx);
+		gf_sg_route_new(sg, interp, value_idx, tr, translation_idx);
+	}
+
+	/*routes on another event of the TimeSensor, never triggered during the benchmark*/
+	valuator = sgbench_new_node(sg, TAG_MPEG4_Valuator, NULL);
+	gf_node_set_id(valuator, 2+2*nb_interp, NULL);
+	in_time_idx = sgbench_field_index(valuator, "inSFTime");
+	for (i=0; i<nb_extra; i++) {
+		gf_sg_route_new(sg, ts, cycle_idx, valuator, in_time_idx);
+	}
+
+	now = gf_sys_clock();
+	for (i=0; i<nb_frames; i++) {
+		*(SFFloat *)fraction.far_ptr = INT2FIX(i%100) / 100;
+		gf_node_event_out(ts, fraction_idx);
+		gf_sg_activate_routes(sg);
+	}
+	now = gf_sys_clock() - now;
+	ms = now ? now : 1;
+
+	fprintf(stdout, "%d interpolators - %d extra routes - %d frames in %d ms\n", nb_interp, nb_extra, nb_frames, now);
+	fprintf(stdout, "%.2f frames/s - %.2f route activations/s\n", 1000.0*nb_frames/ms, 1000.0*nb_frames*2*nb_interp/ms);
+
+	gf_sg_del(sg);
+	gf_sys_close();
+	return 0;
+}
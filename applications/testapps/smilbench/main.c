@@ -0,0 +1,262 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Copyright (c) Jean Le Feuvre 2000-2005
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / SMIL timing benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures the per-frame cost of SMIL timing in SVG scenes: an SVG document with N animated rectangles
+is generated, with staggered begin lists and restarts. A given percentage of the animations only begin
+at the end of the document, so that most timed elements are waiting at any time. The scene is rendered
+offline through the software compositor and the "Raw Video Output" driver, stepping the clocks by one
+frame duration as done by MP4Client -bgr*/
+
+#include <gpac/terminal.h>
+#include <gpac/options.h>
+#include <gpac/internal/terminal_dev.h>
+#include <gpac/internal/compositor_dev.h>
+
+static Bool smilbench_error = 0;
+
+static void smilbench_on_progress(const void *cbk, const char *title, u64 done, u64 total)
+{
+}
+
+/*the compositor logs the time spent in each step of its cycle through the RTI logs; the SMIL timing
+and drawing times are accumulated during the measured frames*/
+static Bool smilbench_measure = 0;
+static u32 smilbench_smil_time = 0;
+static u32 smilbench_draw_time = 0;
+static u32 smilbench_outline_hits = 0;
+static u32 smilbench_outline_misses = 0;
+
+static void smilbench_on_log(void *cbk, u32 log_level, u32 log_tool, const char* fmt, va_list vlist)
+{
+	char szMsg[2048];
+	char *sep;
+	u32 i;
+	if (log_tool != GF_LOG_RTI) {
+		if (log_level==GF_LOG_ERROR) vfprintf(stderr, fmt, vlist);
+		return;
+	}
+	if (!smilbench_measure || strncmp(fmt, "[RTI]\tCompositor Cycle Log", 26)) return;
+	vsnprintf(szMsg, 2048, fmt, vlist);
+	szMsg[2047] = 0;
+	/*skip the log header, then fields are networks, decoders, frame, immediate, config, events, routes, smil timing, ... indirect draw,
+	..., cycle, outline cache hits and misses*/
+	sep = szMsg;
+	for (i=0; i<21; i++) {
+		sep = strchr(sep, '\t');
+		if (!sep) break;
+		sep++;
+		if (i==8) smilbench_smil_time += atoi(sep);
+		else if (i==15) smilbench_draw_time += atoi(sep);
+		else if (i==19) smilbench_outline_hits += atoi(sep);
+		else if (i==20) smilbench_outline_misses += atoi(sep);
+	}
+}
+
+static Bool smilbench_event_proc(void *ptr, GF_Event *evt)
+{
+	if ((evt->type==GF_EVENT_MESSAGE) && evt->message.error) {
+		fprintf(stderr, "%s: %s\n", evt->message.message ? evt->message.message : "Error", gf_error_to_string(evt->message.error));
+		smilbench_error = 1;
+	}
+	return 0;
+}
+
+static Bool smilbench_write_svg(char *path, u32 nb_elts, u32 pc_waiting, u32 nb_frames, u32 fps, Bool stroke)
+{
+	u32 i, cols;
+	Double dur, doc_dur;
+	FILE *svg = gf_f64_open(path, "wt");
+	if (!svg) return 0;
+
+	doc_dur = ((Double) nb_frames) / fps;
+	cols = 1;
+	while (cols*cols < nb_elts) cols++;
+
+	fprintf(svg, "<?xml version=\"1.0\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"320\" height=\"240\" viewBox=\"0 0 320 240\">\n");
+	for (i=0; i<nb_elts; i++) {
+		Double x = 4 + (312.0 * (i%cols)) / cols;
+		Double y = 4 + (232.0 * (i/cols)) / cols;
+		Double start = (0.01 * (i % 97));
+		dur = 0.2 + 0.05 * (i % 7);
+		fprintf(svg, "<rect x=\"%g\" y=\"%g\" width=\"2\" height=\"2\" fill=\"blue\"", x, y);
+		/*stroked elements share a few outline shapes*/
+		if (stroke) fprintf(svg, " rx=\"0.5\" stroke=\"black\" stroke-width=\"%g\" stroke-dasharray=\"0.5 0.25\"", 0.2 + 0.1 * (i % 3));
+		fprintf(svg, ">");
+		/*waiting animations: begin after the last rendered frame*/
+		if ((i % 100) < pc_waiting) {
+			fprintf(svg, "<animate attributeName=\"x\" from=\"%g\" to=\"%g\" begin=\"%gs\" dur=\"%gs\"/>", x, x+2, doc_dur + 1 + start, dur);
+		}
+		/*restarting animations: one begin value per second of document*/
+		else {
+			Double t = start;
+			fprintf(svg, "<animate attributeName=\"y\" from=\"%g\" to=\"%g\" begin=\"", y, y+2);
+			while (t < doc_dur) {
+				fprintf(svg, "%s%gs", (t==start) ? "" : ";", t);
+				t += 0.5 + 0.1 * (i % 5);
+			}
+			fprintf(svg, "\" dur=\"%gs\" restart=\"%s\" fill=\"%s\"/>", dur, (i%3) ? "always" : "whenNotActive", (i%2) ? "freeze" : "remove");
+		}
+		fprintf(svg, "</rect>\n");
+	}
+	fprintf(svg, "</svg>\n");
+	fclose(svg);
+	return 1;
+}
+
+static void usage()
+{
+	fprintf(stdout, "smilbench [-n nb_elements] [-w percent_waiting] [-f nb_frames] [-fps rate] [-stroke] [-svg file] [-c config]\n");
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_elts, pc_waiting, nb_frames, fps, time, next_time, now;
+	char *svg_file, *cfg_file;
+	Bool stroke;
+	const char *opt;
+	char *prev_driver;
+	GF_Config *cfg;
+	GF_User user;
+	GF_Terminal *term;
+	Double ms;
+
+	nb_elts = 2000;
+	pc_waiting = 90;
+	nb_frames = 250;
+	fps = 25;
+	svg_file = "smilbench.svg";
+	cfg_file = NULL;
+	stroke = 0;
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-n") && (i+1<(u32)argc)) nb_elts = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-w") && (i+1<(u32)argc)) pc_waiting = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && (i+1<(u32)argc)) nb_frames = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-fps") && (i+1<(u32)argc)) fps = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-stroke")) stroke = 1;
+		else if (!strcmp(argv[i], "-svg") && (i+1<(u32)argc)) svg_file = argv[++i];
+		else if (!strcmp(argv[i], "-c") && (i+1<(u32)argc)) cfg_file = argv[++i];
+		else {
+			usage();
+			return 0;
+		}
+	}
+	if (!nb_elts || !nb_frames || !fps || (pc_waiting>100)) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(0);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+	gf_log_set_tool_level(GF_LOG_RTI, GF_LOG_DEBUG);
+	gf_log_set_callback(NULL, smilbench_on_log);
+	gf_set_progress_callback(NULL, smilbench_on_progress);
+
+	if (!smilbench_write_svg(svg_file, nb_elts, pc_waiting, nb_frames, fps, stroke)) {
+		fprintf(stderr, "Cannot create %s\n", svg_file);
+		gf_sys_close();
+		return 1;
+	}
+
+	cfg = gf_cfg_init(cfg_file, NULL);
+	if (!cfg) {
+		fprintf(stderr, "Configuration File not found\n");
+		gf_sys_close();
+		return 1;
+	}
+	/*offline rendering through the software rasterizer, no display needed*/
+	opt = gf_cfg_get_key(cfg, "Video", "DriverName");
+	prev_driver = opt ? gf_strdup(opt) : NULL;
+	gf_cfg_set_key(cfg, "Video", "DriverName", "Raw Video Output");
+
+	memset(&user, 0, sizeof(GF_User));
+	opt = gf_cfg_get_key(cfg, "General", "ModulesDirectory");
+	user.modules = opt ? gf_modules_new((const unsigned char *) opt, cfg) : NULL;
+	if (!user.modules || !gf_modules_get_count(user.modules)) {
+		fprintf(stderr, "No modules found\n");
+		if (user.modules) gf_modules_del(user.modules);
+		gf_cfg_del(cfg);
+		gf_sys_close();
+		return 1;
+	}
+	user.config = cfg;
+	user.EventProc = smilbench_event_proc;
+	user.opaque = user.modules;
+	user.init_flags = GF_TERM_NO_AUDIO | GF_TERM_NO_DECODER_THREAD | GF_TERM_NO_COMPOSITOR_THREAD | GF_TERM_NO_REGULATION | GF_TERM_INIT_HIDE;
+
+	term = gf_term_new(&user);
+	if (!term) {
+		fprintf(stderr, "Cannot load terminal\n");
+		gf_modules_del(user.modules);
+		gf_cfg_del(cfg);
+		gf_sys_close();
+		return 1;
+	}
+
+	now = gf_sys_clock();
+	gf_term_connect_from_time(term, svg_file, 0, 1);
+	while (!term->compositor->scene
+		|| term->compositor->msg_type
+		|| (gf_term_get_option(term, GF_OPT_PLAY_STATE) == GF_STATE_STEP_PAUSE)
+	) {
+		if (smilbench_error) break;
+		gf_term_process_flush(term);
+		gf_sleep(1);
+	}
+	now = gf_sys_clock() - now;
+	fprintf(stdout, "%d elements (%d%% waiting) - scene loaded in %d ms\n", nb_elts, pc_waiting, now);
+
+	if (!smilbench_error) {
+		smilbench_measure = 1;
+		now = gf_sys_clock();
+		time = 0;
+		for (i=0; i<nb_frames; i++) {
+			while ((gf_term_get_option(term, GF_OPT_PLAY_STATE) == GF_STATE_STEP_PAUSE)) {
+				gf_term_process_flush(term);
+			}
+			/*frame times are computed from the frame count to avoid rounding drift*/
+			next_time = (u32) ( ((u64) i+1) * 1000 / fps);
+			gf_term_step_clocks(term, next_time - time);
+			time = next_time;
+		}
+		now = gf_sys_clock() - now;
+		smilbench_measure = 0;
+		ms = now ? now : 1;
+		fprintf(stdout, "%d frames in %d ms - %.3f ms/frame - %.2f frames/s\n", nb_frames, now, ms/nb_frames, 1000.0*nb_frames/ms);
+		fprintf(stdout, "SMIL timing %d ms (%.3f ms/frame) - indirect drawing %d ms (%.3f ms/frame)\n", smilbench_smil_time, ((Double)smilbench_smil_time)/nb_frames, smilbench_draw_time, ((Double)smilbench_draw_time)/nb_frames);
+		if (smilbench_outline_hits + smilbench_outline_misses) {
+			fprintf(stdout, "outline cache %d hits - %d misses (%.1f%% hit rate)\n", smilbench_outline_hits, smilbench_outline_misses, 100.0*smilbench_outline_hits/(smilbench_outline_hits + smilbench_outline_misses));
+		}
+	}
+
+	gf_term_disconnect(term);
+	gf_term_del(term);
+	gf_modules_del(user.modules);
+	if (prev_driver) {
+		gf_cfg_set_key(cfg, "Video", "DriverName", prev_driver);
+		gf_free(prev_driver);
+	}
+	gf_cfg_del(cfg);
+	gf_sys_close();
+	return smilbench_error ? 1 : 0;
+}
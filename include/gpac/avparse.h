@@ -79,6 +79,12 @@ GF_Err gf_m4v_rewrite_par(char **o_data, u32 *o_dataLen, s32 par_n, s32 par_d);
 /*returns readable description of profile*/
 const char *gf_m4v_get_profile_name(u8 video_pl);
 
+/*locates the first 0x000001 start code prefix in the given memory span. Returns the offset of the prefix, or size if not found*/
+u32 gf_media_next_start_code(const u8 *data, u32 size);
+/*locates the first 0x0000XX prefix in the given memory span, where (XX & sc_mask) == sc_value (for example mask 0xFC
+value 0x80 for H263 picture start codes). Returns the offset of the prefix, or size if not found*/
+u32 gf_media_next_start_code_ex(const u8 *data, u32 size, u8 sc_mask, u8 sc_value);
+
 #ifndef GPAC_DISABLE_AV_PARSERS
 s32 gf_mv12_next_start_code(unsigned char *pbuffer, u32 buflen, u32 *optr, u32 *scode);
 s32 gf_mv12_next_slice_start(unsigned char *pbuffer, u32 startoffset, u32 buflen, u32 *slice_offset);
@@ -92,6 +92,14 @@ u8 gf_bifs_encoder_get_version(GF_BifsEncoder *codec, u16 ESID);
 /*Encodes current graph as a scene replace*/
 GF_Err gf_bifs_encoder_get_rap(GF_BifsEncoder *codec, char **out_data, u32 *out_data_length);
 
+/*enables caching of encoded nodes: the bits of each subtree are kept on the node and reused as long as the
+subtree is not modified. This is meant for live encoders sending the same scene several times (carousels),
+which MUST call gf_bifs_encoder_node_changed whenever a node is modified. The cache uses the node private 
+stack, nodes already using it are never cached*/
+void gf_bifs_encoder_enable_node_cache(GF_BifsEncoder *codec, Bool enable);
+/*discards the cached bits of the node and of all its parents*/
+void gf_bifs_encoder_node_changed(GF_BifsEncoder *codec, GF_Node *node);
+
 #endif /*GPAC_DISABLE_BIFS_ENC*/
 
 #endif /*GPAC_DISABLE_BIFS*/
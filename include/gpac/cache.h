@@ -233,6 +233,32 @@ extern "C" {
 	u64 gf_cache_get_start_range( const DownloadedCacheEntry entry );
 	u64 gf_cache_get_end_range( const DownloadedCacheEntry entry );
 
+    /*
+     * Memory cache functions
+     */
+
+    /**
+     * Tells whether the entry data is kept in memory rather than in its cache file
+     * \param entry The entry
+     * \return 1 if the entry is a memory entry
+     */
+    Bool gf_cache_entry_is_in_memory(const DownloadedCacheEntry entry);
+
+    /**
+     * Get the amount of memory used by the data of a memory entry
+     * \param entry The entry
+     * \return the allocated size in bytes, 0 for disk entries
+     */
+    u32 gf_cache_get_memory_size(const DownloadedCacheEntry entry);
+
+    /**
+     * Writes the data of a memory entry to its cache file. The entry is then handled as a regular disk entry,
+     * and a download in progress goes on in the cache file.
+     * \param entry The entry
+     * \return GF_OK if the entry is stored on disk, GF_IO_ERR if the cache file cannot be written
+     */
+    GF_Err gf_cache_entry_persist(const DownloadedCacheEntry entry);
+
 #ifdef __cplusplus
 }
 #endif
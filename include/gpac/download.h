@@ -105,6 +105,17 @@ extern "C" {
      */
     void gf_dm_del(GF_DownloadManager *dm);
 
+    /*!
+     *\brief connection pool statistics
+     *
+     *Gets the statistics of the keep-alive connection pool of the download manager
+     *\param dm the download manager object
+     *\param nb_hits set to the number of connections reused from the pool - optional
+     *\param nb_misses set to the number of connections opened because no idle connection was available - optional
+     *\param nb_pipelined set to the number of pipelined requests - optional
+     */
+    void gf_dm_get_pool_stats(GF_DownloadManager *dm, u32 *nb_hits, u32 *nb_misses, u32 *nb_pipelined);
+
     /*!
      *\brief callback function for authentication
      *
@@ -164,11 +175,15 @@ extern "C" {
 		or the function gf_dm_sess_process- if the session is threaded, the user must call gf_dm_sess_process to start the session*/
         GF_NETIO_SESSION_NOT_THREADED	=	1,
         /*! session data is live, e.g. data will be sent to the user if threaded mode (live streams like radios & co)
-				Whether the data is cached or not to disk cannot be controlled by the user at the current time.
+				The data is kept in the memory cache of the download manager if enabled, and only written to disk
+				by gf_dm_sess_persist_cache.
 		*/
         GF_NETIO_SESSION_NOT_CACHED	=	1<<1,
 		/*indicates that the connection to the server should be kept once the download is successfully completed*/
         GF_NETIO_SESSION_PERSISTENT =	1<<2,
+		/*! the resource is cached but kept in the memory cache of the download manager if enabled. The cache file is only written
+				by gf_dm_sess_persist_cache or gf_dm_persist_cached_file_entry_session, or when the resource is evicted from the memory cache*/
+        GF_NETIO_SESSION_MEMORY_CACHE =	1<<3,
     };
 
 
@@ -320,14 +335,36 @@ extern "C" {
      *\note this can only be used when the session is not threaded
      */
 	GF_Err gf_dm_sess_set_range(GF_DownloadSession *sess, u64 start_range, u64 end_range);
+    /*!
+     *\brief pipelines a byte range request
+     *
+     *Sends the request for the given byte range of the current URL while the current reply is being received, so that the
+     *server does not wait for the next request. The pipelined reply is used if the session is set up again for the same URL and range
+     *once the current download is done, otherwise the connection is closed.
+     *\param sess the download session, which must be persistent and downloading a byte range
+     *\param start_range HTTP download start range in byte
+     *\param end_range HTTP download end range in byte
+     *\return error if any
+     */
+	GF_Err gf_dm_sess_pipeline_range(GF_DownloadSession *sess, u64 start_range, u64 end_range);
     /*!
      *\brief get cache file name
      *
-     * Gets the cache file name for the session.
+     * Gets the cache file name for the session. If the resource is kept in the memory cache, the file does not exist until
+     * gf_dm_sess_persist_cache is called.
      *\param sess the download session
      *\return the absolute path of the cache file, or NULL if the session is not cached*/
     const char *gf_dm_sess_get_cache_name(GF_DownloadSession * sess);
 
+    /*!
+     *\brief writes cache file
+     *
+     * Writes the resource of the session to its cache file if it is kept in the memory cache. A download in progress goes on in the cache file.
+     *\param sess the download session
+     *\return error if any
+     */
+    GF_Err gf_dm_sess_persist_cache(GF_DownloadSession * sess);
+
     /*!
      * \brief Marks the cache file to be deleted once the file is not used anymore by any session
      * \param entry The cache entry to delete
@@ -340,6 +377,17 @@ extern "C" {
      */
     void gf_dm_delete_cached_file_entry_session(const GF_DownloadSession * dm, const char * url);
 
+    /*!
+     * Writes the cache file of a resource kept in the memory cache, once the session has moved on to another resource
+     * \param sess The session
+     * \param url The URL of the resource
+     * \param start_range The start of the downloaded byte range, 0 if none
+     * \param end_range The end of the downloaded byte range, 0 if none
+     * \return GF_URL_ERROR if the resource is not in the cache, other error if any
+     * \see gf_dm_sess_persist_cache
+     */
+    GF_Err gf_dm_persist_cached_file_entry_session(const GF_DownloadSession * sess, const char * url, u64 start_range, u64 end_range);
+
     /*!
      * Get a range of a cache entry file
      * \param entry The session
@@ -190,6 +190,12 @@ struct __tag_bifs_enc
 	/*keep track of DEF/USE*/
 	GF_List *encoded_nodes;
 	Bool is_encoding_command;
+
+	/*encoded node cache for live encoding - set when the node being encoded depends on the encoder state
+	(USE, QP, protos...) and its bits cannot be reused*/
+	Bool use_node_cache, node_cache_tainted;
+	/*incremented whenever the encoded node list is reset*/
+	u32 encoded_gen;
 };
 
 GF_Err gf_bifs_enc_commands(GF_BifsEncoder *codec, GF_List *comList, GF_BitStream *bs);
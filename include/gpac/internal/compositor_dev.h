@@ -275,6 +275,10 @@ struct __tag_compositor
 	GF_List *visuals;
 	/*all outlines cached*/
 	GF_List *strike_bank;
+	/*outlines shared by geometry and pen settings*/
+	struct _outline_cache *outline_cache;
+	/*outline cache hits and misses since last cycle log*/
+	u32 outline_cache_hits, outline_cache_misses;
 
 	/*main visual manager - the one managing the primary video output*/
 	GF_VisualManager *visual;
@@ -41,6 +41,7 @@ typedef void (*mcryptfunc)(void*,void*);
 typedef GF_Err (*mcrypt_setkeystream)(void *, const void *, int, const void *, int);
 typedef GF_Err (*mcrypt_setkeyblock) (void *, const void *, int);
 typedef GF_Err (*mcrypt_docrypt) (void *, const void *, int);
+typedef void (*mcryptblocksfunc)(void*,void*,int);
 
 /*private - do not use*/
 typedef struct _tag_crypt_stream
@@ -66,10 +67,16 @@ typedef struct _tag_crypt_stream
 	GF_Err (*_mdecrypt) (void *, void *, int, int, void *, mcryptfunc func, mcryptfunc func2);
 	GF_Err (*_mcrypt_set_state) (void *, void *, int );
 	GF_Err (*_mcrypt_get_state) (void *, void *, int *);
+	/*optional modes access processing many blocks per call, used when the algo has block functions*/
+	GF_Err (*_mcrypt_blocks) (void *, void *, int, int, void *, mcryptblocksfunc func, mcryptblocksfunc func2);
+	GF_Err (*_mdecrypt_blocks) (void *, void *, int, int, void *, mcryptblocksfunc func, mcryptblocksfunc func2);
 	/*algo access*/
 	void *a_encrypt;
 	void *a_decrypt;
 	void *a_set_key;
+	/*optional algo access on several consecutive blocks*/
+	void *a_encrypt_blocks;
+	void *a_decrypt_blocks;
 
 	u32 algo_size;
 	u32 algo_block_size;
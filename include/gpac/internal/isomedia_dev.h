@@ -2117,6 +2117,11 @@ struct __tag_isom {
 	u64 root_sidx_offset;
 	u32 root_sidx_index;
 
+	/*streamed segments: fragments are written as soon as they are complete, the segment header (styp, sidx) 
+	is written in a space reserved at the segment start*/
+	Bool stream_segments, stream_segments_sidx;
+	u32 segment_frags_hint, segment_header_reserved;
+
 	Bool is_index_segment;
 #endif
 
@@ -2183,6 +2188,8 @@ GF_Err stbl_GetSampleRAP(GF_SyncSampleBox *stss, u32 SampleNumber, u8 *IsRAP, u3
 /*same as above but only look for open-gop RAPs and GDR (roll)*/
 GF_Err stbl_SearchSAPs(GF_SampleTableBox *stbl, u32 SampleNumber, u8 *IsRAP, u32 *prevRAP, u32 *nextRAP);
 GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *chunkNumber, u32 *descIndex, u8 *isEdited);
+/*same as above, and gets the number of samples stored after this one in the same chunk, this sample included*/
+GF_Err stbl_GetSampleRunInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *descIndex, u8 *isEdited, u32 *nb_samples);
 GF_Err stbl_GetSampleShadow(GF_ShadowSyncBox *stsh, u32 *sampleNumber, u32 *syncNum);
 GF_Err stbl_GetPaddingBits(GF_PaddingBitsBox *padb, u32 SampleNumber, u8 *PadBits);
 u32 stbl_GetSampleFragmentCount(GF_SampleFragmentBox *stsf, u32 sampleNumber);
@@ -2227,6 +2234,9 @@ GF_Err stbl_AddSize(GF_SampleSizeBox *stsz, u32 sampleNumber, u32 size);
 GF_Err stbl_AddRAP(GF_SyncSampleBox *stss, u32 sampleNumber);
 GF_Err stbl_AddShadow(GF_ShadowSyncBox *stsh, u32 sampleNumber, u32 shadowNumber);
 GF_Err stbl_AddChunkOffset(GF_MediaBox *mdia, u32 sampleNumber, u32 StreamDescIndex, u64 offset);
+/*appends nb_samples samples of the src sample table, starting at first_sample, at the end of the sample table of mdia.
+Same as Media_AddSample for each sample, the sample data being stored contiguously at data_offset*/
+GF_Err stbl_AppendSampleRange(GF_MediaBox *mdia, GF_SampleTableBox *src, u32 first_sample, u32 nb_samples, u32 StreamDescIndex, u64 data_offset);
 /*NB - no add for padding, this is done only through SetPaddingBits*/
 
 GF_Err stbl_AddSampleFragment(GF_SampleTableBox *stbl, u32 sampleNumber, u16 size);
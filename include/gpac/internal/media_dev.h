@@ -50,6 +50,8 @@ u32 AVC_IsStartCode(GF_BitStream *bs);
 u32 AVC_NextStartCode(GF_BitStream *bs);
 /*returns NAL unit type - bitstream must be sync'ed!!*/
 u8 AVC_NALUType(GF_BitStream *bs);
+/*copies nal_size bytes of NAL data to buffer_dst without emulation prevention bytes, returns the number of bytes copied*/
+u32 AVC_RemoveEmulationBytes(const char *buffer_src, char *buffer_dst, u32 nal_size);
 Bool SVC_NALUIsSlice(u8 type);
 
 
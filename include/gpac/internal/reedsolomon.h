@@ -55,6 +55,12 @@ int check_syndrome (void);
 void decode_data (unsigned char data[], int nbytes);
 void encode_data (unsigned char msg[], int nbytes, unsigned char dst[]);
 
+/* decodes a frame stored column-wise (rows bytes per column): data_cols data columns followed by NPAR parity columns.
+Non-zero entries in the optional data_err/parity_err arrays (same layout) flag erased bytes.
+Rows are corrected in place; returns the number of rows which could not be corrected */
+int decode_frame (unsigned char *data, int data_cols, unsigned char *parity, int rows,
+		  unsigned int *data_err, unsigned int *parity_err, int *nb_corrected);
+
 
 /* galois arithmetic tables */
 extern int gexp[];
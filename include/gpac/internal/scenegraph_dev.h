@@ -89,11 +89,23 @@ typedef struct _parent_list
 #define GF_NODE_INTERNAL_FLAGS	0xE0000000
 #endif
 
+/*routes starting from a given field of a node*/
+typedef struct
+{
+	u32 fieldIndex;
+	/*routes from this field, in declaration order*/
+	GF_List *routes;
+} GF_FieldRoutes;
+
 struct _node_interactive_ext
 {
 	/*routes on eventOut, ISed routes, ... for VRML-based scene graphs
 	THIS IS DYNAMICALLY CREATED*/
 	GF_List *routes;
+	/*dispatch table of the routes starting from this node, sorted by field index - THIS IS DYNAMICALLY CREATED
+	it is maintained by gf_node_add_route/gf_node_remove_route, which must be used to modify the above route list*/
+	GF_FieldRoutes *field_routes;
+	u32 nb_field_routes;
 
 #ifdef GPAC_HAS_SPIDERMONKEY
 	/*JS bindings if any - THIS IS DYNAMICALLY CREATED
@@ -138,6 +150,8 @@ typedef struct _nodepriv
 typedef struct __tag_node_id
 {
 	struct __tag_node_id *next;
+	/*previous item, for constant-time removal*/
+	struct __tag_node_id *prev;
 	GF_Node *node;
 
 	/*node ID*/
@@ -153,13 +167,44 @@ typedef struct
 	u32 xmlns_id;
 } GF_XMLNS;
 
+/*open-addressing hash index (linear probing). Items are not owned by the index, and several items
+may share the same key: lookups enumerate all slots matching the key hash and the caller checks the key*/
+typedef struct
+{
+	/*key hash, never 0 for used slots*/
+	u32 hash;
+	/*indexed item, NULL for empty (hash==0) or deleted (hash!=0) slots*/
+	void *item;
+} GF_SGIndexSlot;
+
+typedef struct
+{
+	GF_SGIndexSlot *slots;
+	/*number of slots (power of 2), number of items, number of non-empty slots (items + deleted)*/
+	u32 size, count, used;
+} GF_SGIndex;
+
+void gf_sg_index_reset(GF_SGIndex *idx);
+void gf_sg_index_add(GF_SGIndex *idx, u32 hash, void *item);
+Bool gf_sg_index_remove(GF_SGIndex *idx, u32 hash, void *item);
+/*enumerates items indexed with the given hash - pos shall be set to 0 before the first call*/
+void *gf_sg_index_enum(GF_SGIndex *idx, u32 hash, u32 *pos);
+
+u32 gf_sg_hash_int(u32 val);
+u32 gf_sg_hash_ptr(void *ptr);
+u32 gf_sg_hash_string(const char *str);
+
 struct __tag_scene_graph 
 {
 	/*used to discriminate between node and scenegraph*/
 	u64 __reserved_null;
 
-	/*all DEF nodes (explicit)*/
+	/*all DEF nodes (explicit), sorted by ID*/
 	NodeIDedItem *id_node, *id_node_last;
+	/*number of distinct IDs in the DEF list*/
+	u32 nb_def_ids;
+	/*hash indexes of the DEF nodes list by node ID, node name and node pointer*/
+	GF_SGIndex def_by_id, def_by_name, def_by_node;
 
 	/*pointer to the root node*/
 	GF_Node *RootNode;
@@ -215,6 +260,8 @@ struct __tag_scene_graph
 
 	/*all routes available*/
 	GF_List *Routes;
+	/*hash indexes of routes by ID and name*/
+	GF_SGIndex routes_by_id, routes_by_name;
 
 	/*when a proto is instanciated it creates its own scene graph. BIFS/VRML specify that the namespace is the same 
 	(eg cannot reuse a NodeID or route name/ID), but this could be done differently by some other stds
@@ -266,7 +313,11 @@ struct __tag_scene_graph
 	u32 dom_evt_filter;
 
 	GF_List *xlink_hrefs;
+	/*timed elements notified of the scene time at each frame, sorted by begin of their current interval*/
 	GF_List *smil_timed_elements;
+	/*timed elements waiting for the begin of their current interval, binary min-heap on this begin*/
+	struct _smil_timing_rti **smil_waiting_elements;
+	u32 nb_smil_waiting, smil_waiting_alloc;
 	GF_List *modified_smil_timed_elements;
 	Bool update_smil_timing;
 
@@ -316,6 +367,9 @@ void gf_node_dirty_parent_graph(GF_Node *node);
 /*BASE node (GF_Node) destructor*/
 void gf_node_free(GF_Node *node);
 
+/*destroys the node route list and route dispatch table*/
+void gf_node_reset_routes(GF_Node *node);
+
 /*node destructor dispatcher: redirects destruction for each graph type: VRML/MPEG4, X3D, SVG...)*/
 void gf_node_del(GF_Node *node);
 
@@ -344,6 +398,11 @@ struct _route
 	GF_FieldInfo ToField;
 };
 
+/*adds/removes the route to/from the node route list, updating the node dispatch table*/
+void gf_node_add_route(GF_Node *node, GF_Route *r);
+void gf_node_remove_route(GF_Node *node, GF_Route *r);
+/*returns the routes starting from the given field of the node, or NULL if none*/
+GF_List *gf_node_get_field_routes(GF_Node *node, u32 fieldIndex);
 void gf_sg_route_unqueue(GF_SceneGraph *sg, GF_Route *r);
 /*returns TRUE if route modified destination node*/
 Bool gf_sg_route_activate(GF_Route *r);
@@ -672,6 +731,17 @@ enum {
 	SMIL_STATUS_DONE
 };
 
+/*scheduling state of a timed element in the rootmost scene graph*/
+enum
+{
+	/*not notified until modified*/
+	SMIL_SCHED_NONE = 0,
+	/*notified at each frame*/
+	SMIL_SCHED_AWAKE,
+	/*notified once the begin of its current interval is reached*/
+	SMIL_SCHED_WAITING
+};
+
 typedef struct {
 	u32 activation_cycle;
 	u32 nb_iterations;
@@ -732,6 +802,11 @@ struct _smil_timing_rti
 
 	/* shortcut when this rti corresponds to an animation */
 	struct _smil_anim_rti *rai;
+
+	/* scheduling state (SMIL_SCHED_*), position in the waiting heap and begin time used as heap key */
+	u8 sched_state;
+	u32 sched_index;
+	Double sched_time;
 };
 
 void gf_smil_timing_init_runtime_info(GF_Node *timed_elt);
@@ -739,6 +814,12 @@ void gf_smil_timing_delete_runtime_info(GF_Node *timed_elt, SMIL_Timing_RTI *rti
 Fixed gf_smil_timing_get_normalized_simple_time(SMIL_Timing_RTI *rti, Double scene_time, Bool *force_end);
 /*returns 1 if an animation changed a value in the rendering tree */
 s32 gf_smil_timing_notify_time(SMIL_Timing_RTI *rti, Double scene_time);
+/*removes the timed element from scene time notifications, returns 1 if it was scheduled*/
+Bool gf_smil_timing_unschedule(SMIL_Timing_RTI *rti);
+/*notifies the scene time to the timed element at next frame*/
+void gf_smil_timing_wake(SMIL_Timing_RTI *rti);
+/*removes from the scheduler of the rootmost graph all timed elements of the given scene graph*/
+void gf_smil_timing_remove_graph(GF_SceneGraph *root, GF_SceneGraph *sg);
 
 
 /* SMIL Animation Structures */
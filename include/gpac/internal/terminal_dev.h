@@ -46,6 +46,7 @@ typedef struct _object_clock GF_Clock;
 typedef struct _es_channel GF_Channel;
 typedef struct _generic_codec GF_Codec;
 typedef struct _composition_memory GF_CompositionMemory;
+typedef struct _image_cache GF_ImageCache;
 
 
 struct _net_service
@@ -367,6 +368,14 @@ struct _tag_terminal
 	u32 cumulated_priority;
 	/*frame duration*/
 	u32 frame_duration;
+	/*image decoder pool: threads decoding image streams (single unit composition memories) outside
+	of the media manager thread, and the list of image codecs they handle*/
+	GF_Thread **image_threads;
+	u32 nb_image_threads;
+	GF_List *image_codecs;
+	GF_Mutex *image_mx;
+	/*decoded images shared between scenes*/
+	GF_ImageCache *image_cache;
 
 	/*net services*/
 	GF_List *net_services;
@@ -779,10 +788,16 @@ struct _generic_codec
 	u32 last_unit_dts;
 	/*last processed CTS on base layer - seeking detection*/
 	u32 last_unit_cts;
-	/*SHA signature for the last processed unit. Only for images (Capacity==1)*/
-	u8 last_unit_signature[20];
+	/*size and hash of the last processed unit. Only for images (Capacity==1)*/
+	u32 last_unit_size;
+	u64 last_unit_signature;
+	/*image of the terminal image cache currently in the composition memory, if any. Image properties are
+	then given by the cached image rather than by the decoder*/
+	struct _cached_image *cached_image;
 	/*in case the codec performs temporal re-ordering itself*/
 	Bool is_reordering;
+	/*number of frames flushed from a re-ordering codec at end of stream*/
+	u32 nb_flushed_frames;
 	u32 prev_au_size;
 	u32 bytes_per_sec;
 	Double fps;
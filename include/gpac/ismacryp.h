@@ -87,6 +87,8 @@ typedef struct
 	u32 TextualHeadersLen;
 	char TransactionID[17];
 
+	/*number of threads used to encrypt the samples - 0 or 1 means serial encryption*/
+	u32 nb_threads;
 } GF_TrackCryptInfo;
 
 #if !defined(GPAC_DISABLE_MCRYPT) && !defined(GPAC_DISABLE_ISOM_WRITE)
@@ -105,9 +107,10 @@ GF_Err gf_ismacryp_decrypt_file(GF_ISOFile *mp4file, const char *drm_file);
 
 /*Crypt a the file 
 @drm_file: location of DRM data.
-@LogMsg: redirection for message or NULL for stdout
+@nb_threads: number of threads used to encrypt each track, 0 or 1 for serial encryption. The output
+does not depend on the number of threads
 */
-GF_Err gf_ismacryp_crypt_file(GF_ISOFile *mp4file, const char *drm_file);
+GF_Err gf_ismacryp_crypt_file(GF_ISOFile *mp4file, const char *drm_file, u32 nb_threads);
 
 #endif /*!defined(GPAC_DISABLE_MCRYPT) && !defined(GPAC_DISABLE_ISOM_WRITE)*/
 
@@ -796,6 +796,14 @@ you MUST have created a StreamDescription with URL or URN specifying your refere
 Use streamDescriptionIndex to specify the desired stream (if several)*/
 GF_Err gf_isom_add_sample_reference(GF_ISOFile *the_file, u32 trackNumber, u32 StreamDescriptionIndex, GF_ISOSample *sample, u64 dataOffset);
 
+/*copies nbSamples samples, starting at firstSample, from a track of another file at the end of the track. This gives the 
+same result as getting each sample and adding it with gf_isom_add_sample, but sample data is copied by blocks of chunks 
+and the sample tables are updated from the source tables. 
+Use streamDescriptionIndex to specify the desired stream, or 0 to use the sample description index of each source sample.
+Returns GF_NOT_SUPPORTED, without adding any sample, if the samples must be added one by one (OD tracks, samples with 
+decreasing or equal DTS, empty samples, sync shadows, data in other files, switch to 64 bit chunk offsets...)*/
+GF_Err gf_isom_copy_samples(GF_ISOFile *the_file, u32 trackNumber, u32 StreamDescriptionIndex, GF_ISOFile *orig_file, u32 origTrackNumber, u32 firstSample, u32 nbSamples);
+
 /*set the duration of the last media sample. If not set, the duration of the last sample is the
 duration of the previous one if any, or media TimeScale (default value).*/
 GF_Err gf_isom_set_last_sample_duration(GF_ISOFile *the_file, u32 trackNumber, u32 duration);
@@ -1176,6 +1184,14 @@ frags_per_sidx, daisy_chain_sidx and frags_per_segment are currently ignored and
 if not NULL, start_range and end_range will contain the byte range of the SIDX box in the movie*/
 GF_Err gf_isom_allocate_sidx(GF_ISOFile *movie, s32 subsegs_per_sidx, Bool daisy_chain_sidx, u32 nb_segs, u32 *frags_per_segment, u32 *start_range, u32 *end_range);
 
+/*enables streamed segment writing: each fragment is written to the segment as soon as it is complete rather than kept 
+in memory until gf_isom_close_segment, so that memory usage is bounded by the fragment size. The segment header (styp and sidx) 
+is written in a space reserved at the segment start, and only the sidx is rewritten when closing the segment.
+nb_frags_hint is the expected number of fragments per segment, used to size the reserved space. use_sidx indicates 
+whether a sidx will be used. Only a single sidx per segment (or the sidx allocated through gf_isom_allocate_sidx) is supported 
+in this mode, subsegs_per_sidx and daisy_chain_sidx are ignored by gf_isom_close_segment*/
+GF_Err gf_isom_enable_segment_streaming(GF_ISOFile *movie, u32 nb_frags_hint, Bool use_sidx);
+
 enum
 {
 	/*indicates that the track fragment has no samples but still has a duration
@@ -1217,6 +1233,17 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *the_file, u32 TrackID, GF_ISOSamp
 								 u32 Duration,
 								 u8 PaddingBits, u16 DegradationPriority);
 
+/*same as gf_isom_fragment_add_sample, but the sample data is copied by range from the media data of track in the orig file, 
+without loading the sample in memory. sample and data_offset are obtained through gf_isom_get_sample_info, the data field 
+of the sample is ignored. The data is read from the data reference used by the last sample fetched on the track, which
+is always correct for tracks with a single sample description
+CANNOT be used with OD tracks*/
+GF_Err gf_isom_fragment_add_sample_from_track(GF_ISOFile *the_file, u32 TrackID, GF_ISOSample *sample, 
+								 u32 StreamDescriptionIndex, 
+								 u32 Duration,
+								 u8 PaddingBits, u16 DegradationPriority, 
+								 GF_ISOFile *orig, u32 track, u64 data_offset);
+
 /*appends data into last sample of track for video fragments/other media
 CANNOT be used with OD tracks*/
 GF_Err gf_isom_fragment_append_data(GF_ISOFile *the_file, u32 TrackID, char *data, u32 data_size, u8 PaddingBits);
@@ -340,6 +340,12 @@ GF_RTPHinter *gf_hinter_track_new(GF_ISOFile *file, u32 TrackNum,
 void gf_hinter_track_del(GF_RTPHinter *tkHinter);
 /*hints all samples in the media track*/
 GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint);
+/*hints all samples of several media tracks of the same file, as done by gf_hinter_track_process on each hinter.
+The RTP packetizers of the different tracks run on nb_threads threads (0 or 1 for serial hinting), reading media
+samples and writing hint samples being serialized on the file. The hinted file does not depend on the number of threads
+	@errors: array of nb_hinters error codes, receives the result of each track
+*/
+GF_Err gf_hinter_process_tracks(GF_RTPHinter **tkHinters, u32 nb_hinters, u32 nb_threads, GF_Err *errors);
 /*returns media bandwidth in kbps*/
 u32 gf_hinter_track_get_bandwidth(GF_RTPHinter *tkHinter);
 /*retrieves hinter flags*/
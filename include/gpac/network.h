@@ -215,6 +215,15 @@ GF_Err gf_sk_bind(GF_Socket *sock, const char *local_ip, u16 port, const char *p
  *\param local_ip the local (client) address (IP or DNS) if any, NULL otherwise.
  */
 GF_Err gf_sk_connect(GF_Socket *sock, const char *peer_name, u16 port, const char *local_ip);
+/*!
+ *\brief gets non-blocking connection status
+ *
+ *Checks whether a connection started by \ref gf_sk_connect on a non-blocking socket is established. When the socket is
+ *non-blocking, \ref gf_sk_connect returns GF_IP_SOCK_WOULD_BLOCK while the connection is in progress.
+ *\param sock the socket object
+ *\return GF_OK once connected, GF_IP_SOCK_WOULD_BLOCK if the connection is still in progress, or an error if it failed
+ */
+GF_Err gf_sk_get_connect_status(GF_Socket *sock);
 /*!
  *\brief data emission
  *
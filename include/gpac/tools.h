@@ -671,6 +671,14 @@ void gf_sys_close();
  */
 u32 gf_sys_clock();
 
+/*!
+ *	\brief High resolution system clock query
+ *
+ *	Gets the system clock time with microsecond resolution, for profiling purposes.
+ *	\return System clock value since initialization in microseconds.
+ */
+u64 gf_sys_clock_high_res();
+
 /*!
  *	\brief Sleeps thread/process
  *
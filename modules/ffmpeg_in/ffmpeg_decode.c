@@ -25,6 +25,12 @@
 #include "ffmpeg_in.h"
 #include <gpac/avparse.h>
 
+#if defined(WIN32)
+#include <windows.h>
+#elif !defined(__SYMBIAN32__)
+#include <unistd.h>
+#endif
+
 #ifndef FFMPEG_OLD_HEADERS
 
 #if (LIBAVCODEC_VERSION_MAJOR <= 52) && (LIBAVCODEC_VERSION_MINOR <= 20)
@@ -83,6 +89,58 @@ static AVCodec *ffmpeg_get_codec(u32 codec_4cc)
 }
 
 
+static u32 ffmpeg_get_cpu_count()
+{
+#if defined(WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long nb_cpu = sysconf(_SC_NPROCESSORS_ONLN);
+	return (nb_cpu>0) ? (u32) nb_cpu : 1;
+#else
+	return 1;
+#endif
+}
+
+/*setup multithreaded decoding - this must be done before opening the codec*/
+static void FFDEC_SetupThreads(GF_BaseDecoder *plug, AVCodecContext *ctx)
+{
+	u32 nb_threads;
+	const char *sOpt;
+	FFDec *ffd = (FFDec *)plug->privateStack;
+
+	/*only for video, images are decoded once*/
+	if ((ffd->st!=GF_STREAM_VISUAL) || ffd->is_image) return;
+
+	sOpt = gf_modules_get_option((GF_BaseInterface *)plug, "FFMPEG", "NumThreads");
+	if (!sOpt) {
+		gf_modules_set_option((GF_BaseInterface *)plug, "FFMPEG", "NumThreads", "auto");
+		sOpt = "auto";
+	}
+	nb_threads = !stricmp(sOpt, "auto") ? ffmpeg_get_cpu_count() : atoi(sOpt);
+	/*libavcodec doesn't use more than 16 threads*/
+	if (nb_threads > 16) nb_threads = 16;
+	if (nb_threads <= 1) return;
+
+#ifdef FF_THREAD_FRAME
+	sOpt = gf_modules_get_option((GF_BaseInterface *)plug, "FFMPEG", "ThreadingType");
+	if (!sOpt) {
+		gf_modules_set_option((GF_BaseInterface *)plug, "FFMPEG", "ThreadingType", "Both");
+		sOpt = "Both";
+	}
+	/*frame threading adds one frame of delay per thread, which ends up as CU delay since the codec does the re-ordering*/
+	if (!stricmp(sOpt, "Frame")) ctx->thread_type = FF_THREAD_FRAME;
+	else if (!stricmp(sOpt, "Slice")) ctx->thread_type = FF_THREAD_SLICE;
+	else ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+	ctx->thread_count = nb_threads;
+#else
+	/*old libavcodec: slice threading only*/
+	avcodec_thread_init(ctx, nb_threads);
+#endif
+	GF_LOG(GF_LOG_INFO, GF_LOG_CODEC, ("[FFMPEG Decoder] Using %d decoding threads\n", nb_threads));
+}
+
 static void FFDEC_LoadDSI(FFDec *ffd, GF_BitStream *bs, AVCodec *codec, AVCodecContext *ctx, Bool from_ff_demux)
 {
 	u32 dsi_size;
@@ -317,6 +375,7 @@ static GF_Err FFDEC_AttachStream(GF_BaseDecoder *plug, GF_ESD *esd)
 		(*ctx)->pix_fmt = ffd->raw_pix_fmt;
 		if ((*ctx)->extradata && strstr((*ctx)->extradata, "BottomUp")) ffd->flipped = 1;
 	} else {
+		FFDEC_SetupThreads(plug, *ctx);
 		if (avcodec_open((*ctx), (*codec) )<0) return GF_NON_COMPLIANT_BITSTREAM;
 	}
 
@@ -868,15 +927,31 @@ redecode:
 		pict.linesize[0] = 3*ctx->width;
 		pix_out = PIX_FMT_RGB24;
 	} else {
+		/*chroma planes are rounded up for odd sizes - sizes are made even above, so this matches the output size*/
+		s32 chroma_w = (ctx->width+1)/2;
+		s32 chroma_h = (ctx->height+1)/2;
 		pict.data[0] = outBuffer;
 		pict.data[1] = outBuffer + ctx->width * ctx->height;
-		pict.data[2] = outBuffer + 5 * ctx->width * ctx->height / 4;
+		pict.data[2] = pict.data[1] + chroma_w * chroma_h;
 		pict.linesize[0] = ctx->width;
-		pict.linesize[1] = pict.linesize[2] = ctx->width/2;
+		pict.linesize[1] = pict.linesize[2] = chroma_w;
 		pix_out = PIX_FMT_YUV420P;
 		if (!mmlevel && frame->interlaced_frame) {
 			avpicture_deinterlace((AVPicture *) frame, (AVPicture *) frame, ctx->pix_fmt, ctx->width, ctx->height);
 		}
+		/*same layout as the composition memory, copy the planes rather than going through the scaler*/
+		if (ctx->pix_fmt == PIX_FMT_YUV420P) {
+			s32 i;
+			for (i=0; i<ctx->height; i++) {
+				memcpy(pict.data[0] + i*pict.linesize[0], frame->data[0] + i*frame->linesize[0], ctx->width);
+			}
+			for (i=0; i<chroma_h; i++) {
+				memcpy(pict.data[1] + i*pict.linesize[1], frame->data[1] + i*frame->linesize[1], chroma_w);
+				memcpy(pict.data[2] + i*pict.linesize[2], frame->data[2] + i*frame->linesize[2], chroma_w);
+			}
+			*outBufferLength = ffd->out_size;
+			return GF_OK;
+		}
 	}
 	pict.data[3] = 0;
 	pict.linesize[3] = 0;
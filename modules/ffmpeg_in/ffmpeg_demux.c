@@ -601,7 +601,9 @@ static GF_Err FFD_ConnectService(GF_InputService *plug, GF_ClientService *serv,
 			if (ffd->buffer_used == ffd->buffer_size) break;
 		}
 		if (e==GF_EOS) {
-			const char *cache_file = gf_dm_sess_get_cache_name(ffd->dnload);
+			const char *cache_file;
+			gf_dm_sess_persist_cache(ffd->dnload);
+			cache_file = gf_dm_sess_get_cache_name(ffd->dnload);
 			res = open_file(&ffd->ctx, cache_file, av_in);
 		} else {
 			pd.filename = szName;
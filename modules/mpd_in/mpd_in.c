@@ -51,13 +51,24 @@ typedef enum {
 	MPD_STATE_CONNECTING,
 } MPD_STATE;
 
-GF_Err MPD_downloadWithRetry( GF_ClientService * service, GF_DownloadSession ** sess, const char *url, gf_dm_user_io user_io,  void *usr_cbk, u64 start_range, u64 end_range, Bool persistent);
+GF_Err MPD_downloadWithRetry( GF_ClientService * service, GF_DownloadSession ** sess, const char *url, gf_dm_user_io user_io,  void *usr_cbk, u64 start_range, u64 end_range, u32 flags);
+
+typedef enum
+{
+	GF_MPD_RESOLVE_URL_MEDIA,
+	GF_MPD_RESOLVE_URL_INIT,
+	GF_MPD_RESOLVE_URL_INDEX,
+} GF_MPDURLResolveType;
+
+GF_Err MPD_ResolveURL(GF_MPD *mpd, GF_MPD_Representation *rep, GF_MPD_AdaptationSet *set, GF_MPD_Period *period, char *mpd_url, GF_MPDURLResolveType resolve_type, u32 item_index, char **out_url, u64 *out_range_start, u64 *out_range_end, u64 *segment_duration);
 
 typedef struct
 {
     char *cache;
     char *url;
 	u64 start_range, end_range;
+	/*byte range of the download, used to locate the resource in the memory cache of the downloader*/
+	u64 dl_start_range, dl_end_range;
 } segment_cache_entry;
 
 /*this structure Group is the implementation of the adaptationSet element of the MPD.*/
@@ -98,6 +109,8 @@ typedef struct __mpd_group
     u32 nb_segments_done;
 
     Bool segment_must_be_streamed;
+	/*set while downloading a byte range of a media segment, the next range of the same resource is then pipelined*/
+	Bool pipeline_next;
 
 	/* Service really managing the segments */
     GF_InputService *input_module;
@@ -228,7 +241,20 @@ void MPD_NetIO_Segment(void *cbk, GF_NETIO_Parameter *param)
 	}
 
 	e = param->error;
-	if (param->msg_type == GF_NETIO_PARSE_REPLY) {
+	if ((param->msg_type == GF_NETIO_WAIT_FOR_REPLY) && group->pipeline_next) {
+		char *next_url;
+		u64 start_range, end_range, duration;
+		GF_MPD_Representation *rep = gf_list_get(group->adaptation_set->representations, group->active_rep_index);
+		group->pipeline_next = 0;
+		/*request the next segment while receiving this one when both are ranges of the same resource*/
+		if (MPD_ResolveURL(group->mpd_in->mpd, rep, group->adaptation_set, group->period, group->mpd_in->url, GF_MPD_RESOLVE_URL_MEDIA, group->download_segment_index + 1, &next_url, &start_range, &end_range, &duration) == GF_OK) {
+			if (end_range && !strcmp(next_url, gf_dm_sess_get_resource_name(group->segment_dnload))) {
+				gf_dm_sess_pipeline_range(group->segment_dnload, start_range, end_range);
+			}
+			gf_free(next_url);
+		}
+	}
+	else if (param->msg_type == GF_NETIO_PARSE_REPLY) {
 		if (! gf_dm_sess_can_be_cached_on_disk(group->segment_dnload)) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_MODULE,
 				("[MPD_IN] Segment %s cannot be cached on disk, will use direct streaming\n", gf_dm_sess_get_resource_name(group->segment_dnload)));
@@ -641,6 +667,9 @@ static GF_Err MPD_ClientQuery(GF_InputService *ifce, GF_NetworkCommand *param)
 			group->nb_cached_segments--;
 		}
 
+        /*segments are kept in the memory cache of the downloader until played*/
+        if (!group->local_files && !group->segment_must_be_streamed)
+            gf_dm_persist_cached_file_entry_session(group->segment_dnload, group->cached[0].url, group->cached[0].dl_start_range, group->cached[0].dl_end_range);
         param->url_query.next_url = group->cached[0].cache;
 		param->url_query.start_range = group->cached[0].start_range;
 		param->url_query.end_range = group->cached[0].end_range;
@@ -706,7 +735,7 @@ static GF_Err MPD_LoadMediaService(GF_MPD_In *mpdin, GF_MPD_Group *group, const
  * Parameters are identical to the ones of gf_term_download_new.
  * \see gf_term_download_new()
  */
-GF_Err MPD_downloadWithRetry( GF_ClientService * service, GF_DownloadSession **sess, const char *url, gf_dm_user_io user_io,  void *usr_cbk, u64 start_range, u64 end_range, Bool persistent)
+GF_Err MPD_downloadWithRetry( GF_ClientService * service, GF_DownloadSession **sess, const char *url, gf_dm_user_io user_io,  void *usr_cbk, u64 start_range, u64 end_range, u32 flags)
 {
 	Bool had_sess = 0;
     GF_Err e;
@@ -714,9 +743,7 @@ GF_Err MPD_downloadWithRetry( GF_ClientService * service, GF_DownloadSession **s
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_MODULE, ("[MPD_IN] Downloading %s...\n", url));
 
 	if (! *sess) {
-		u32 flags = GF_NETIO_SESSION_NOT_THREADED;
-		if (persistent) flags |= GF_NETIO_SESSION_PERSISTENT; 
-		*sess = gf_term_download_new(service, url, flags, user_io, usr_cbk);
+		*sess = gf_term_download_new(service, url, GF_NETIO_SESSION_NOT_THREADED | flags, user_io, usr_cbk);
 		if (!(*sess)){
 			assert(0);
 			GF_LOG(GF_LOG_ERROR, GF_LOG_MODULE, ("[MPD_IN] Cannot try to download %s... OUT of memory ?\n", url));
@@ -731,13 +758,14 @@ GF_Err MPD_downloadWithRetry( GF_ClientService * service, GF_DownloadSession **s
 		}
 
 	}
-	if (end_range) {
+	/*a reused session must not keep the range of the previous download*/
+	if (end_range || had_sess) {
 		e = gf_dm_sess_set_range(*sess, start_range, end_range);
 		if (e) {
 			if (had_sess) {
 				gf_term_download_del(*sess);
 				*sess = NULL;
-				return MPD_downloadWithRetry(service, sess, url, user_io, usr_cbk, start_range, end_range, persistent);
+				return MPD_downloadWithRetry(service, sess, url, user_io, usr_cbk, start_range, end_range, flags);
 			}
 
 
@@ -753,7 +781,7 @@ GF_Err MPD_downloadWithRetry( GF_ClientService * service, GF_DownloadSession **s
         gf_term_download_del(*sess);
         GF_LOG(GF_LOG_WARNING, GF_LOG_MODULE,
                ("[MPD_IN] failed to download, retrying once with %s...\n", url));
-        *sess = gf_term_download_new(service, url, GF_NETIO_SESSION_NOT_THREADED, user_io, usr_cbk);
+        *sess = gf_term_download_new(service, url, GF_NETIO_SESSION_NOT_THREADED | flags, user_io, usr_cbk);
         if (!(*sess)){
 	    GF_LOG(GF_LOG_ERROR, GF_LOG_MODULE, ("[MPD_IN] Cannot retry to download %s... OUT of memory ?\n", url));
             return GF_OUT_OF_MEM;
@@ -1012,13 +1040,6 @@ static void MPD_ResolveDuration(GF_MPD_Representation *rep, GF_MPD_AdaptationSet
 
 }
 
-typedef enum
-{
-	GF_MPD_RESOLVE_URL_MEDIA,
-	GF_MPD_RESOLVE_URL_INIT,
-	GF_MPD_RESOLVE_URL_INDEX,
-} GF_MPDURLResolveType;
-
 
 GF_Err MPD_ResolveURL(GF_MPD *mpd, GF_MPD_Representation *rep, GF_MPD_AdaptationSet *set, GF_MPD_Period *period, char *mpd_url, GF_MPDURLResolveType resolve_type, u32 item_index, char **out_url, u64 *out_range_start, u64 *out_range_end, u64 *segment_duration)
 {
@@ -1408,8 +1429,8 @@ static GF_Err MPD_DownloadInitSegment(GF_MPD_In *mpdin, GF_MPD_Group *group)
 
 	group->max_bitrate = 0;
 	group->min_bitrate = (u32)-1;
-	/*use persistent connection for segment downloads*/
-    e = MPD_downloadWithRetry(mpdin->service, &(group->segment_dnload), base_init_url, MPD_NetIO_Segment, group, start_range, end_range, 1);
+	/*use persistent connection for segment downloads, and keep them in memory until played*/
+    e = MPD_downloadWithRetry(mpdin->service, &(group->segment_dnload), base_init_url, MPD_NetIO_Segment, group, start_range, end_range, GF_NETIO_SESSION_PERSISTENT | GF_NETIO_SESSION_MEMORY_CACHE);
 
 	if ((e==GF_OK) && group->force_switch_bandwidth && !mpdin->auto_switch_count) {
 		MPD_SwitchGroupRepresentation(mpdin, group);
@@ -1432,7 +1453,7 @@ static GF_Err MPD_DownloadInitSegment(GF_MPD_In *mpdin, GF_MPD_Group *group)
         GF_LOG(GF_LOG_WARNING, GF_LOG_MODULE, ("Download of first segment failed... retrying with second one : %s\n", base_init_url));
         nb_segment_read = 2;
 		/*use persistent connection for segment downloads*/
-        e = MPD_downloadWithRetry(mpdin->service, &(group->segment_dnload), base_init_url, MPD_NetIO_Segment, group, 0, 0, 1);
+        e = MPD_downloadWithRetry(mpdin->service, &(group->segment_dnload), base_init_url, MPD_NetIO_Segment, group, 0, 0, GF_NETIO_SESSION_PERSISTENT | GF_NETIO_SESSION_MEMORY_CACHE);
     } /* end of 404 */
 
     if (e!= GF_OK && !group->segment_must_be_streamed) {
@@ -1493,6 +1514,8 @@ static GF_Err MPD_DownloadInitSegment(GF_MPD_In *mpdin, GF_MPD_Group *group)
             group->segment_local_url = gf_dm_sess_get_resource_name(group->segment_dnload);
             e = GF_OK;
         } else {
+            /*the service is loaded from the cache file right away*/
+            gf_dm_sess_persist_cache(group->segment_dnload);
             group->segment_local_url = gf_dm_sess_get_cache_name(group->segment_dnload);
         }
 
@@ -1735,11 +1758,13 @@ restart_period:
 
 				group->max_bitrate = 0;
 				group->min_bitrate = (u32)-1;
-				/*use persistent connection for segment downloads*/
+				/*use persistent connection for segment downloads, and keep them in memory until played*/
 				if (use_byterange) {
-					e = MPD_downloadWithRetry(mpdin->service, &(group->segment_dnload), new_base_seg_url, MPD_NetIO_Segment, group, start_range, end_range, 1);
+					group->pipeline_next = (group->download_segment_index + 1 < group->nb_segments_in_rep) ? 1 : 0;
+					e = MPD_downloadWithRetry(mpdin->service, &(group->segment_dnload), new_base_seg_url, MPD_NetIO_Segment, group, start_range, end_range, GF_NETIO_SESSION_PERSISTENT | GF_NETIO_SESSION_MEMORY_CACHE);
+					group->pipeline_next = 0;
 				} else {
-					e = MPD_downloadWithRetry(mpdin->service, &(group->segment_dnload), new_base_seg_url, MPD_NetIO_Segment, group, 0, 0, 1);
+					e = MPD_downloadWithRetry(mpdin->service, &(group->segment_dnload), new_base_seg_url, MPD_NetIO_Segment, group, 0, 0, GF_NETIO_SESSION_PERSISTENT | GF_NETIO_SESSION_MEMORY_CACHE);
 				}
 
 				if ((e==GF_OK) && group->force_switch_bandwidth) {
@@ -1803,6 +1828,8 @@ restart_period:
 				group->cached[group->nb_cached_segments].url = gf_strdup( resource_name );
 				group->cached[group->nb_cached_segments].start_range = 0;
 				group->cached[group->nb_cached_segments].end_range = 0;
+				group->cached[group->nb_cached_segments].dl_start_range = use_byterange ? start_range : 0;
+				group->cached[group->nb_cached_segments].dl_end_range = use_byterange ? end_range : 0;
 				if (group->local_files && use_byterange) {
 					group->cached[group->nb_cached_segments].start_range = start_range;
 					group->cached[group->nb_cached_segments].end_range = end_range;
@@ -2380,7 +2407,7 @@ GF_Err MPD_ConnectService(GF_InputService *plug, GF_ClientService *serv, const c
         }
     } else if (strstr(url, "://")) {
 		/*use non-persistent connection for MPD downloads*/
-        e = MPD_downloadWithRetry(mpdin->service, &(mpdin->mpd_dnload), url, MPD_NetIO, mpdin, 0, 0, 1);
+        e = MPD_downloadWithRetry(mpdin->service, &(mpdin->mpd_dnload), url, MPD_NetIO, mpdin, 0, 0, GF_NETIO_SESSION_PERSISTENT);
         if (e!=GF_OK) {
             GF_LOG(GF_LOG_ERROR, GF_LOG_MODULE, ("[MPD_IN] Error - cannot connect service: MPD downloading problem %s for %s\n", gf_error_to_string(e), url));
             gf_term_on_connect(mpdin->service, NULL, GF_IO_ERR);
@@ -62,6 +62,9 @@
 		* moved span data memoru to dynamic allocation
 		* bypassed Y-sorting of cells by using an array of scanlines: a bit more consuming
 		in memory, but faster cell sorting (X-sorting only)
+		* optional accumulation buffer mode: cells are summed in a dense buffer covering a band
+		of scanlines, and coverage is resolved by a prefix sum on each line - no cell sorting and
+		no per-cell allocation, which is faster for complex outlines with many cells per line
 */
 
 #include "rast_soft.h"
@@ -129,11 +132,39 @@ typedef struct
 } AAScanline;
 
 
+/*max number of cells in the accumulation buffer - outlines taller than max_cells/width lines are
+rendered in several bands*/
+#define AA_ACCUM_MAX_CELLS	(256*1024)
+
+/*vectorized prefix sum of the accumulation buffer lines, 4 cells at a time - cells are 32 bit*/
+#if (UINT_MAX != 0xFFFFU)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP>=2))
+#include <emmintrin.h>
+#define GF_ACC_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GF_ACC_SIMD_NEON
+#endif
+#endif
+
 typedef struct  TRaster_
 {
 	AAScanline *scanlines;
 	int max_lines;
 	TPos min_ex, max_ex, min_ey, max_ey;
+	/*lines being rendered: the full clipper in cell mode, the current band in accumulation mode*/
+	TPos band_min_ey, band_max_ey;
+
+	/*accumulation buffer mode: band_height lines of acc_width cells, the first cell of each line holding
+	cells clipped on the left. Lines are kept zeroed between renders, only the touched range of each line
+	([acc_first, acc_last]) is swept and reset*/
+	Bool use_accum;
+	TArea *acc_area;
+	int *acc_cover;
+	int acc_alloc, acc_width;
+	int *acc_first, *acc_last;
+	int acc_lines_alloc;
+
 	TCoord ex, ey;
 	TPos x,  y, last_ey;
 	TArea area;
@@ -151,8 +182,30 @@ typedef struct  TRaster_
 
 #define AA_CELL_STEP_ALLOC	8
 
+static GFINLINE void gray_accumulate_cell( TRaster *raster )
+{
+	int x, idx;
+	int y = raster->ey - raster->band_min_ey;
+	if ((y<0) || (raster->ey>=raster->band_max_ey)) return;
+
+	/*clip cell */
+	if (raster->ex<raster->min_ex) x = 0;
+	else if (raster->ex>raster->max_ex) x = (int) (raster->max_ex - raster->min_ex + 1);
+	else x = (int) (raster->ex - raster->min_ex + 1);
+
+	idx = y*raster->acc_width + x;
+	raster->acc_area[idx] += raster->area;
+	raster->acc_cover[idx] += raster->cover;
+	if (x < raster->acc_first[y]) raster->acc_first[y] = x;
+	if (x > raster->acc_last[y]) raster->acc_last[y] = x;
+}
+
 static GFINLINE void gray_record_cell( TRaster *raster ) 
 {
+	if (raster->use_accum) {
+		if (raster->area | raster->cover) gray_accumulate_cell(raster);
+		return;
+	}
 	if (( raster->area | raster->cover) && (raster->ey<raster->max_ey)) {
 		AACell *cell;
 		int y = raster->ey - raster->min_ey;
@@ -355,7 +408,7 @@ static GFINLINE void gray_render_line(TRaster *raster, TPos  to_x, TPos  to_y, i
 		min = ey2;
 		max = ey1;
 	}
-	if ( min >= raster->max_ey || max < raster->min_ey ) goto End;
+	if ( min >= raster->band_max_ey || max < raster->band_min_ey ) goto End;
 
 	/* everything is on a single scanline */
 	if ( ey1 == ey2 ) {
@@ -696,6 +749,157 @@ static void gray_sweep_line( TRaster *raster, AAScanline *sl, int y, Bool zero_n
 	raster->render_span(y + raster->min_ey, raster->num_gray_spans, raster->gray_spans, raster->render_span_data );
 }
 
+/*sweeps line y of the current band in accumulation mode and resets it*/
+static void gray_sweep_accum_line( TRaster *raster, int y, Bool zero_non_zero_rule)
+{
+	int x, start, first, last, cover;
+	TArea val;
+	TArea *area = raster->acc_area + y*raster->acc_width;
+	int *covers = raster->acc_cover + y*raster->acc_width;
+	TCoord line = (TCoord) (raster->band_min_ey - raster->min_ey + y);
+
+	first = raster->acc_first[y];
+	last = raster->acc_last[y];
+
+	/*resolve the coverage of each pixel: the prefix sum of the cell covers minus the pixel area.
+	This is the value the cell sweep gives to the pixel, either as a gray pixel or as part of a span.
+	Sums wrap around in 32 bit in both the vector and scalar code, as when the scalar result is stored*/
+	cover = 0;
+	x = first;
+#if defined(GF_ACC_SIMD_SSE2)
+	if (x + 4 <= last + 1) {
+		__m128i sum = _mm_setzero_si128();
+		for (; x + 4 <= last + 1; x += 4) {
+			__m128i c = _mm_loadu_si128((const __m128i *) (covers + x));
+			/*in-register scan, then add the sum of the previous cells*/
+			c = _mm_add_epi32(c, _mm_slli_si128(c, 4));
+			c = _mm_add_epi32(c, _mm_slli_si128(c, 8));
+			c = _mm_add_epi32(c, sum);
+			sum = _mm_shuffle_epi32(c, _MM_SHUFFLE(3, 3, 3, 3));
+			c = _mm_sub_epi32(_mm_slli_epi32(c, PIXEL_BITS + 1), _mm_loadu_si128((const __m128i *) (area + x)));
+			_mm_storeu_si128((__m128i *) (area + x), c);
+		}
+		cover = _mm_cvtsi128_si32(sum);
+	}
+#elif defined(GF_ACC_SIMD_NEON)
+	if (x + 4 <= last + 1) {
+		int32x4_t zero = vdupq_n_s32(0);
+		int32x4_t sum = zero;
+		for (; x + 4 <= last + 1; x += 4) {
+			int32x4_t c = vld1q_s32((const int32_t *) (covers + x));
+			c = vaddq_s32(c, vextq_s32(zero, c, 3));
+			c = vaddq_s32(c, vextq_s32(zero, c, 2));
+			c = vaddq_s32(c, sum);
+			sum = vdupq_n_s32(vgetq_lane_s32(c, 3));
+			c = vsubq_s32(vshlq_n_s32(c, PIXEL_BITS + 1), vld1q_s32((const int32_t *) (area + x)));
+			vst1q_s32((int32_t *) (area + x), c);
+		}
+		cover = vgetq_lane_s32(sum, 0);
+	}
+#endif
+	for (; x<=last; x++) {
+		cover += covers[x];
+		area[x] = cover * ( ONE_PIXEL * 2 ) - area[x];
+	}
+
+	/*emit runs of identical values - the first cell only holds the cells clipped on the left
+	and the last one the cells clipped on the right*/
+	raster->num_gray_spans = 0;
+	x = first ? first : 1;
+	if (last > raster->acc_width - 2) last = raster->acc_width - 2;
+	while (x <= last) {
+		start = x;
+		val = area[x];
+		while ((++x <= last) && (area[x]==val)) ;
+		if (val) gray_hline( raster, start - 1, line, val, x - start, zero_non_zero_rule);
+	}
+	raster->render_span(line + raster->min_ey, raster->num_gray_spans, raster->gray_spans, raster->render_span_data );
+
+	last = raster->acc_last[y];
+	memset(area + first, 0, sizeof(TArea) * (last - first + 1));
+	memset(covers + first, 0, sizeof(int) * (last - first + 1));
+	raster->acc_first[y] = raster->acc_width;
+	raster->acc_last[y] = -1;
+}
+
+/*vertical extent of the outline, in pixels*/
+static void gray_get_outline_lines(TRaster *raster, EVG_Outline *outline, TPos *min_ey, TPos *max_ey)
+{
+	int i;
+	TPos y;
+	TCoord ey, ymin, ymax;
+#ifdef INLINE_POINT_CONVERSION
+	TPos x;
+#endif
+	ymin = INT_MAX;
+	ymax = INT_MIN;
+	for (i=0; i<outline->n_points; i++) {
+#ifdef INLINE_POINT_CONVERSION
+		evg_translate_point(raster->mx, &outline->points[i], &x, &y);
+#else
+		y = UPSCALE(outline->points[i].y);
+#endif
+		ey = TRUNC(y);
+		if (ey < ymin) ymin = ey;
+		if (ey > ymax) ymax = ey;
+	}
+	*min_ey = ymin;
+	*max_ey = ymax + 1;
+}
+
+static void gray_render_accum(TRaster *raster, EVG_Outline *outline, Bool zero_non_zero_rule)
+{
+	int i, size, band_height;
+	TPos min_ey, max_ey;
+
+	gray_get_outline_lines(raster, outline, &min_ey, &max_ey);
+	if (min_ey < raster->min_ey) min_ey = raster->min_ey;
+	if (max_ey > raster->max_ey) max_ey = raster->max_ey;
+	if (min_ey >= max_ey) return;
+
+	raster->acc_width = (int) (raster->max_ex - raster->min_ex + 2);
+	band_height = AA_ACCUM_MAX_CELLS / raster->acc_width;
+	if (!band_height) band_height = 1;
+	if (band_height > max_ey - min_ey) band_height = (int) (max_ey - min_ey);
+
+	/*the buffer is always zeroed outside of the sweep, no need to keep its content*/
+	size = band_height * raster->acc_width;
+	if (raster->acc_alloc < size) {
+		if (raster->acc_area) gf_free(raster->acc_area);
+		if (raster->acc_cover) gf_free(raster->acc_cover);
+		raster->acc_area = (TArea*)gf_malloc(sizeof(TArea)*size);
+		raster->acc_cover = (int*)gf_malloc(sizeof(int)*size);
+		memset(raster->acc_area, 0, sizeof(TArea)*size);
+		memset(raster->acc_cover, 0, sizeof(int)*size);
+		raster->acc_alloc = size;
+	}
+	if (raster->acc_lines_alloc < band_height) {
+		raster->acc_first = (int*)gf_realloc(raster->acc_first, sizeof(int)*band_height);
+		raster->acc_last = (int*)gf_realloc(raster->acc_last, sizeof(int)*band_height);
+		raster->acc_lines_alloc = band_height;
+	}
+	for (i=0; i<band_height; i++) {
+		raster->acc_first[i] = raster->acc_width;
+		raster->acc_last[i] = -1;
+	}
+
+	for (raster->band_min_ey = min_ey; raster->band_min_ey < max_ey; raster->band_min_ey += band_height) {
+		raster->band_max_ey = raster->band_min_ey + band_height;
+		if (raster->band_max_ey > max_ey) raster->band_max_ey = max_ey;
+
+		raster->ex = (TCoord) raster->max_ex+1;
+		raster->ey = (TCoord) raster->max_ey+1;
+		raster->cover = 0;
+		raster->area = 0;
+		EVG_Outline_Decompose(outline, raster);
+		gray_record_cell( raster );
+
+		for (i=0; i<raster->band_max_ey - raster->band_min_ey; i++) {
+			if (raster->acc_last[i] >= 0) gray_sweep_accum_line(raster, i, zero_non_zero_rule);
+		}
+	}
+}
+
 
 int evg_raster_render(EVG_Raster raster, EVG_Raster_Params*  params)
 {
@@ -718,6 +922,16 @@ int evg_raster_render(EVG_Raster raster, EVG_Raster_Params*  params)
 	raster->mx = params->mx;
 #endif
 
+	/*store odd/even rule*/
+	zero_non_zero_rule = (outline->flags & GF_PATH_FILL_ZERO_NONZERO) ? 1 : 0;
+
+	if (raster->use_accum) {
+		gray_render_accum(raster, outline, zero_non_zero_rule);
+		return 0;
+	}
+	raster->band_min_ey = raster->min_ey;
+	raster->band_max_ey = raster->max_ey;
+
 	size_y = raster->max_ey - raster->min_ey;
     if (raster->max_lines < size_y) {
 		raster->scanlines = (AAScanline*)gf_realloc(raster->scanlines, sizeof(AAScanline)*size_y);
@@ -731,9 +945,6 @@ int evg_raster_render(EVG_Raster raster, EVG_Raster_Params*  params)
 	raster->area = 0;
 	EVG_Outline_Decompose(outline, raster);
     gray_record_cell( raster );
-	
-	/*store odd/even rule*/
-	zero_non_zero_rule = (outline->flags & GF_PATH_FILL_ZERO_NONZERO) ? 1 : 0;
 
 	/* sort each scanline and render it*/
 	for (i=0; i<size_y; i++) {
@@ -764,6 +975,11 @@ EVG_Raster evg_raster_new()
 	return raster;
 }
 
+void evg_raster_set_accumulation(EVG_Raster raster, Bool use_accum)
+{
+	raster->use_accum = use_accum;
+}
+
 void evg_raster_del(EVG_Raster raster)
 {
 	int i;
@@ -771,6 +987,10 @@ void evg_raster_del(EVG_Raster raster)
 		gf_free(raster->scanlines[i].cells);
 	}
 	gf_free(raster->scanlines);
+	if (raster->acc_area) gf_free(raster->acc_area);
+	if (raster->acc_cover) gf_free(raster->acc_cover);
+	if (raster->acc_first) gf_free(raster->acc_first);
+	if (raster->acc_last) gf_free(raster->acc_last);
     gf_free(raster);
 }
 
@@ -111,6 +111,8 @@ typedef struct EVG_Raster_Params_
 
 EVG_Raster evg_raster_new();
 void evg_raster_del(EVG_Raster raster);
+/*uses a dense accumulation buffer instead of sorted cells - the output is identical*/
+void evg_raster_set_accumulation(EVG_Raster raster, Bool use_accum);
 int evg_raster_render(EVG_Raster raster, EVG_Raster_Params *params);
 
 /*the surface object - currently only ARGB/RGB32, RGB/BGR and RGB555/RGB565 supported*/
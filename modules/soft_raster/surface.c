@@ -45,6 +45,10 @@ GF_SURFACE evg_surface_new(GF_Raster2D *_dr, Bool center_coords)
 		_this->ftparams.source = &_this->ftoutline;
 		_this->ftparams.user = _this;
 		_this->raster = evg_raster_new();
+		if (_this->raster) {
+			const char *opt = gf_modules_get_option((GF_BaseInterface *)_dr, "SoftRaster", "AccumulationBuffer");
+			if (opt && !strcmp(opt, "yes")) evg_raster_set_accumulation(_this->raster, 1);
+		}
 	}
 	return _this;
 }
@@ -851,6 +851,7 @@ GF_Err gf_bifs_enc_commands(GF_BifsEncoder *codec, GF_List *comList, GF_BitStrea
 		{
 			/*reset node context*/
 			while (gf_list_count(codec->encoded_nodes)) gf_list_rem(codec->encoded_nodes, 0);
+			codec->encoded_gen++;
 			GF_BIFS_WRITE_INT(codec, bs, 3, 2, "SceneReplace", NULL);
 		
 			if (!com->aggregated) {
@@ -954,10 +955,13 @@ GF_Err gf_bifs_encoder_get_rap(GF_BifsEncoder *codec, char **out_data, u32 *out_
 	GF_BitStream *bs;
 	GF_Err e;
 	GF_List *ctx_bck;
+	Bool use_node_cache;
 
-	/*reset context for RAP encoding*/
+	/*reset context for RAP encoding - the node cache tracks the current context only*/
 	ctx_bck = codec->encoded_nodes;
 	codec->encoded_nodes = gf_list_new();
+	use_node_cache = codec->use_node_cache;
+	codec->use_node_cache = 0;
 
 	if (!codec->info) codec->info = (BIFSStreamInfo*)gf_list_get(codec->streamInfo, 0);
 
@@ -973,6 +977,7 @@ GF_Err gf_bifs_encoder_get_rap(GF_BifsEncoder *codec, char **out_data, u32 *out_
 	/*restore context*/
 	gf_list_del(codec->encoded_nodes);
 	codec->encoded_nodes = ctx_bck;
+	codec->use_node_cache = use_node_cache;
 
 	return e;
 }
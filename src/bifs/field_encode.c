@@ -521,19 +521,67 @@ exit:
 	return e;
 }
 
+/*encoded bits of a node, stored in the node private stack*/
+typedef struct
+{
+	GF_BifsEncoder *codec;
+	BIFSStreamInfo *info;
+	u32 NDT_Tag;
+	char *data;
+	u32 nb_bits;
+	/*DEF'd nodes of the subtree, registered for DEF/USE when the bits are reused*/
+	GF_Node **defs;
+	u32 nb_defs;
+	/*DEF'd node only: the node is in the encoded node list if this matches the encoder generation*/
+	u32 encoded_gen;
+} BENodeCache;
+
+static void BE_NodeCacheDel(BENodeCache *nc)
+{
+	if (nc->data) gf_free(nc->data);
+	if (nc->defs) gf_free(nc->defs);
+	gf_free(nc);
+}
+
+static void BE_NodeCacheDestroy(GF_Node *node, void *rs, Bool is_destroy)
+{
+	BENodeCache *nc;
+	if (!is_destroy) return;
+	nc = (BENodeCache *) gf_node_get_private(node);
+	if (nc) BE_NodeCacheDel(nc);
+	gf_node_set_private(node, NULL);
+}
+
+static BENodeCache *BE_GetNodeCache(GF_BifsEncoder *codec, GF_Node *node)
+{
+	BENodeCache *nc;
+	if (node->sgprivate->UserCallback != BE_NodeCacheDestroy) return NULL;
+	nc = (BENodeCache *) gf_node_get_private(node);
+	if (!nc || (nc->codec != codec)) return NULL;
+	return nc;
+}
+
 Bool BE_NodeIsUSE(GF_BifsEncoder * codec, GF_Node *node)
 {
 	u32 i, count;
+	BENodeCache *nc;
 	if (!node || !gf_node_get_id(node) ) return 0;
-	count = gf_list_count(codec->encoded_nodes);
-	for (i=0; i<count; i++) {
-		if (gf_list_get(codec->encoded_nodes, i) == node) return 1;
+	/*cached nodes know whether they have been encoded, no need to browse the list*/
+	nc = codec->use_node_cache ? BE_GetNodeCache(codec, node) : NULL;
+	if (nc) {
+		if (nc->encoded_gen == codec->encoded_gen) return 1;
+		nc->encoded_gen = codec->encoded_gen;
+	} else {
+		count = gf_list_count(codec->encoded_nodes);
+		for (i=0; i<count; i++) {
+			if (gf_list_get(codec->encoded_nodes, i) == node) return 1;
+		}
 	}
 	gf_list_add(codec->encoded_nodes, node);
 	return 0;
 }
 
-GF_Err gf_bifs_enc_node(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_BitStream *bs)
+static GF_Err BE_EncNode(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_BitStream *bs)
 {
 	u32 NDTBits, node_type, node_tag, BVersion, node_id;
 	const char *node_name;
@@ -635,5 +683,170 @@ GF_Err gf_bifs_enc_node(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_B
 	return GF_OK;
 }
 
+static Bool BE_NodeIsCachable(GF_Node *node)
+{
+	if (node->sgprivate->UserCallback) {
+		if (node->sgprivate->UserCallback != BE_NodeCacheDestroy) return 0;
+	} else if (gf_node_get_private(node)) {
+		return 0;
+	}
+	if (node->sgprivate->tag > GF_NODE_RANGE_LAST_MPEG4) return 0;
+
+	switch (node->sgprivate->tag) {
+	/*modify the encoder state (QP, QP14) for the following nodes*/
+	case TAG_MPEG4_QuantizationParameter:
+	case TAG_MPEG4_Coordinate:
+	case TAG_MPEG4_Coordinate2D:
+	/*depend on proto or command context*/
+	case TAG_ProtoNode:
+	case TAG_MPEG4_Script:
+	case TAG_MPEG4_Conditional:
+	/*modifications of these nodes are not signaled by the scene graph*/
+	case TAG_MPEG4_ColorInterpolator: 
+	case TAG_MPEG4_CoordinateInterpolator: 
+	case TAG_MPEG4_CoordinateInterpolator2D: 
+	case TAG_MPEG4_NormalInterpolator: 
+	case TAG_MPEG4_OrientationInterpolator: 
+	case TAG_MPEG4_PositionInterpolator: 
+	case TAG_MPEG4_PositionInterpolator2D: 
+	case TAG_MPEG4_ScalarInterpolator: 
+	case TAG_MPEG4_Valuator:
+	case TAG_MPEG4_PositionInterpolator4D:
+	case TAG_MPEG4_CoordinateInterpolator4D:
+	case TAG_MPEG4_PositionAnimator:
+	case TAG_MPEG4_PositionAnimator2D:
+	case TAG_MPEG4_ScalarAnimator:
+		return 0;
+	}
+	return 1;
+}
+
+static void BE_WriteBits(GF_BitStream *bs, char *data, u32 nb_bits)
+{
+	u32 i, nb_bytes, rem;
+	nb_bytes = nb_bits / 8;
+	if (!gf_bs_get_bit_position(bs)) {
+		gf_bs_write_data(bs, data, nb_bytes);
+	} else {
+		for (i=0; i<nb_bytes; i++) gf_bs_write_int(bs, (u8) data[i], 8);
+	}
+	rem = nb_bits % 8;
+	if (rem) gf_bs_write_int(bs, ((u8) data[nb_bytes]) >> (8 - rem), rem);
+}
+
+GF_Err gf_bifs_enc_node(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_BitStream *bs)
+{
+	u32 i, nb_bits, size, first_def;
+	char *data;
+	Bool tainted;
+	BENodeCache *nc;
+	GF_BitStream *node_bs;
+	GF_Err e;
+
+	if (!codec->use_node_cache || !node) return BE_EncNode(codec, node, NDT_Tag, bs);
+
+	/*the bits of this node depend on the encoder state*/
+	if (codec->ActiveQP || codec->encoding_proto || !BE_NodeIsCachable(node)) {
+		codec->node_cache_tainted = 1;
+		return BE_EncNode(codec, node, NDT_Tag, bs);
+	}
+
+	/*unmodified subtree, reuse its bits unless one of its DEF'd nodes has already been encoded (USE)*/
+	nc = BE_GetNodeCache(codec, node);
+	if (nc && (nc->info==codec->info) && (nc->NDT_Tag==NDT_Tag)) {
+		for (i=0; i<nc->nb_defs; i++) {
+			BENodeCache *def_nc = BE_GetNodeCache(codec, nc->defs[i]);
+			if (def_nc) {
+				if (def_nc->encoded_gen == codec->encoded_gen) break;
+			} else if (gf_list_find(codec->encoded_nodes, nc->defs[i])>=0) {
+				break;
+			}
+		}
+		if (i==nc->nb_defs) {
+			for (i=0; i<nc->nb_defs; i++) {
+				BENodeCache *def_nc = BE_GetNodeCache(codec, nc->defs[i]);
+				if (def_nc) def_nc->encoded_gen = codec->encoded_gen;
+				gf_list_add(codec->encoded_nodes, nc->defs[i]);
+			}
+			BE_WriteBits(bs, nc->data, nc->nb_bits);
+			return GF_OK;
+		}
+	}
+
+	/*encode the node in its own bitstream and keep the result*/
+	tainted = codec->node_cache_tainted;
+	codec->node_cache_tainted = 0;
+	first_def = gf_list_count(codec->encoded_nodes);
+
+	node_bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
+	e = BE_EncNode(codec, node, NDT_Tag, node_bs);
+	nb_bits = (u32) gf_bs_get_bit_offset(node_bs);
+	data = NULL;
+	size = 0;
+	gf_bs_get_content(node_bs, &data, &size);
+	gf_bs_del(node_bs);
+	if (!e && data) BE_WriteBits(bs, data, nb_bits);
+
+	/*node encoded as a USE*/
+	if (data && (data[0] & 0x80)) codec->node_cache_tainted = 1;
+
+	if (e || !data || codec->node_cache_tainted) {
+		if (data) gf_free(data);
+		codec->node_cache_tainted = 1;
+		return e;
+	}
+	codec->node_cache_tainted = tainted;
+
+	if (!nc) {
+		GF_SAFEALLOC(nc, BENodeCache);
+		if (!nc) {
+			gf_free(data);
+			return GF_OK;
+		}
+		gf_node_set_callback_function(node, BE_NodeCacheDestroy);
+		gf_node_set_private(node, nc);
+	}
+	/*a DEF'd node has just been added to the encoded node list*/
+	nc->encoded_gen = codec->encoded_gen;
+	if (nc->data) gf_free(nc->data);
+	if (nc->defs) gf_free(nc->defs);
+	nc->codec = codec;
+	nc->info = codec->info;
+	nc->NDT_Tag = NDT_Tag;
+	nc->data = data;
+	nc->nb_bits = nb_bits;
+	nc->nb_defs = gf_list_count(codec->encoded_nodes) - first_def;
+	nc->defs = NULL;
+	if (nc->nb_defs) {
+		nc->defs = (GF_Node **) gf_malloc(sizeof(GF_Node *) * nc->nb_defs);
+		for (i=0; i<nc->nb_defs; i++) nc->defs[i] = (GF_Node *) gf_list_get(codec->encoded_nodes, first_def+i);
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+void gf_bifs_encoder_enable_node_cache(GF_BifsEncoder *codec, Bool enable)
+{
+	codec->use_node_cache = enable;
+}
+
+GF_EXPORT
+void gf_bifs_encoder_node_changed(GF_BifsEncoder *codec, GF_Node *node)
+{
+	u32 i, count;
+	BENodeCache *nc;
+	if (!node || (node->sgprivate->UserCallback != BE_NodeCacheDestroy)) return;
+	nc = (BENodeCache *) gf_node_get_private(node);
+	/*parents of a node which is not cached are not cached either*/
+	if (!nc) return;
+	BE_NodeCacheDel(nc);
+	gf_node_set_private(node, NULL);
+
+	count = gf_node_get_parent_count(node);
+	for (i=0; i<count; i++) {
+		gf_bifs_encoder_node_changed(codec, gf_node_get_parent(node, i));
+	}
+}
+
 
 #endif /*GPAC_DISABLE_BIFS_ENC*/
@@ -849,12 +849,17 @@ GF_Err BM_SceneReplace(GF_BifsDecoder *codec, GF_BitStream *bs, GF_List *com_lis
 	GF_Command *com;
 	GF_Node *backup_root;
 	GF_List *backup_routes;
+	GF_SGIndex backup_routes_by_id, backup_routes_by_name;
 	GF_Err BD_DecSceneReplace(GF_BifsDecoder * codec, GF_BitStream *bs, GF_List *proto_list);
 
 	backup_routes = codec->scenegraph->Routes;
+	backup_routes_by_id = codec->scenegraph->routes_by_id;
+	backup_routes_by_name = codec->scenegraph->routes_by_name;
 	backup_root = codec->scenegraph->RootNode;
 	com = gf_sg_command_new(codec->current_graph, GF_SG_SCENE_REPLACE);
 	codec->scenegraph->Routes = gf_list_new();
+	memset(&codec->scenegraph->routes_by_id, 0, sizeof(GF_SGIndex));
+	memset(&codec->scenegraph->routes_by_name, 0, sizeof(GF_SGIndex));
 	codec->current_graph = codec->scenegraph;
 	codec->LastError = BD_DecSceneReplace(codec, bs, com->new_proto_list);
 	com->use_names = codec->UseName;
@@ -879,6 +884,10 @@ GF_Err BM_SceneReplace(GF_BifsDecoder *codec, GF_BitStream *bs, GF_List *com_lis
 	}
 	gf_list_del(codec->scenegraph->Routes);
 	codec->scenegraph->Routes = backup_routes;
+	gf_sg_index_reset(&codec->scenegraph->routes_by_id);
+	gf_sg_index_reset(&codec->scenegraph->routes_by_name);
+	codec->scenegraph->routes_by_id = backup_routes_by_id;
+	codec->scenegraph->routes_by_name = backup_routes_by_name;
 	return codec->LastError;
 }
 
@@ -322,6 +322,10 @@ static char *gf_af_fetch_frame(void *callback, u32 *size, u32 audio_delay_ms)
 {
 	GF_AudioFilterItem *af = (GF_AudioFilterItem *)callback;
 
+	/*no active filter, pass the source frame as is*/
+	if (!af->filter_chain.enable_filters)
+		return af->src->FetchFrame(af->src->callback, size, audio_delay_ms);
+
 	*size = 0;
 	if (!af->nb_used) {
 		/*force filling the filter chain output until no data is available, otherwise we may end up
@@ -347,6 +351,10 @@ static char *gf_af_fetch_frame(void *callback, u32 *size, u32 audio_delay_ms)
 static void gf_af_release_frame(void *callback, u32 nb_bytes)
 {
 	GF_AudioFilterItem *af = (GF_AudioFilterItem *)callback;
+	if (!af->filter_chain.enable_filters) {
+		af->src->ReleaseFrame(af->src->callback, nb_bytes);
+		return;
+	}
 	/*mark used bytes of filter output*/
 	af->nb_used += nb_bytes;
 	if (af->nb_used==af->nb_filled) {
@@ -387,6 +395,8 @@ static Bool gf_af_get_config(GF_AudioInterface *ai, Bool for_reconf)
 	af->input.ch_cfg = af->src->ch_cfg;
 	af->input.chan = af->src->chan;
 
+	/*filtered data pending from the previous configuration is dropped*/
+	af->nb_used = af->nb_filled = 0;
 	if (gf_afc_setup(&af->filter_chain, af->input.bps, af->input.samplerate, af->src->chan, af->src->ch_cfg, &af->input.chan, &af->input.ch_cfg)!=GF_OK) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_AUDIO, ("[Audio Input] Failed to configure audio filter chain\n"));
 
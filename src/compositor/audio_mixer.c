@@ -437,6 +437,18 @@ static GFINLINE void gf_mixer_map_channels(s32 *inChan, u32 nb_in, u32 in_cfg, u
 }
 
 
+/*checks if the source data can be copied as is in the mixer output. Volume, speed and mute are checked by the caller*/
+static GFINLINE Bool gf_mixer_is_passthrough(GF_AudioMixer *am, MixerInput *in)
+{
+	/*this happens if input SR cannot be mapped to output audio hardware*/
+	if (in->src->samplerate != am->sample_rate) return 0;
+	if (in->src->chan != am->nb_channels) return 0;
+	if (in->src->bps != am->bits_per_sample) return 0;
+	/*mono and stereo layouts are implied by the number of channels*/
+	if ((in->src->chan>2) && (in->src->ch_cfg != am->channel_cfg)) return 0;
+	return 1;
+}
+
 static void gf_mixer_fetch_input(GF_AudioMixer *am, MixerInput *in, u32 audio_delay)
 {
 	u32 i, j, in_ch, out_ch, prev, next, src_samp, ratio, src_size;
@@ -577,11 +589,7 @@ u32 gf_mixer_get_output(GF_AudioMixer *am, void *buffer, u32 buffer_size, u32 de
 		return 0;
 	}
 
-	/*this happens if input SR cannot be mapped to output audio hardware*/
-	if (single_source->src->samplerate != am->sample_rate) goto do_mix;
-	/*note we don't check output cfg: if the number of channel is the same then the channel cfg is the 
-	same*/
-	if (single_source->src->chan != am->nb_channels) goto do_mix;
+	if (!gf_mixer_is_passthrough(am, single_source)) goto do_mix;
 	if (single_source->src->GetSpeed(single_source->src->callback)!=FIX_ONE) goto do_mix;
 	if (single_source->src->GetChannelVolume(single_source->src->callback, pan)) goto do_mix;
 
@@ -662,9 +670,7 @@ do_mix:
 			} else {
 				if (!in->src->GetChannelVolume(in->src->callback, in->pan)) {
 					/*track first active source with same cfg as mixer*/
-					if (!single_source && (in->src->samplerate == am->sample_rate) 
-						&& (in->src->chan == am->nb_channels) && (in->speed == FIX_ONE) 
-					) 
+					if (!single_source && (in->speed == FIX_ONE) && gf_mixer_is_passthrough(am, in)) 
 						single_source = in;
 				}
 			}
@@ -76,7 +76,7 @@ GF_Err gf_afc_setup(GF_AudioFilterChain *afc, u32 bps, u32 sr, u32 chan, u32 ch_
 	struct _audiofilterentry *entry;
 	u32 block_len;
 	u32 och, ocfg, in_ch;
-	Bool not_in_place;
+	Bool not_in_place, has_filter;
 
 	if (afc->tmp_block1) gf_free(afc->tmp_block1);
 	afc->tmp_block1 = NULL;
@@ -89,6 +89,8 @@ GF_Err gf_afc_setup(GF_AudioFilterChain *afc, u32 bps, u32 sr, u32 chan, u32 ch_
 	afc->delay_ms = 0;
 
 	not_in_place = 0;
+	has_filter = 0;
+	afc->enable_filters = 0;
 
 	entry = afc->filters;
 	while (entry) {
@@ -107,6 +109,7 @@ GF_Err gf_afc_setup(GF_AudioFilterChain *afc, u32 bps, u32 sr, u32 chan, u32 ch_
 			if (afc->max_block_size < out_block_size) afc->max_block_size = out_block_size;
 
 			entry->enable = 1;
+			has_filter = 1;
 			chan = och;
 			ch_cfg = ocfg;
 
@@ -139,7 +142,8 @@ GF_Err gf_afc_setup(GF_AudioFilterChain *afc, u32 bps, u32 sr, u32 chan, u32 ch_
 	}
 	*ch_out = chan;
 	*ch_cfg_out = ch_cfg;
-	afc->enable_filters = 1;
+	/*no filter accepted the format, data goes straight from the mixer to the output*/
+	afc->enable_filters = has_filter;
 	return GF_OK;
 }
 
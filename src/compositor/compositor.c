@@ -299,8 +299,9 @@ static GF_Err gf_sc_create(GF_Compositor *compositor)
 {
 	const char *sOpt;
 
-	/*load video out*/
-	sOpt = gf_cfg_get_key(compositor->user->config, "Video", "DriverName");
+	/*load video out - a driver forced for this session only (never saved) overrides the configured one*/
+	sOpt = gf_cfg_get_key(compositor->user->config, "Temp", "VideoDriverName");
+	if (!sOpt) sOpt = gf_cfg_get_key(compositor->user->config, "Video", "DriverName");
 	if (sOpt) {
 		compositor->video_out = (GF_VideoOutput *) gf_modules_load_interface_by_name(compositor->user->modules, sOpt, GF_VIDEO_OUTPUT_INTERFACE);
 		if (compositor->video_out) {
@@ -506,7 +507,7 @@ GF_Compositor *gf_sc_new(GF_User *user, Bool self_threaded, GF_Terminal *term)
 	gf_sc_load_opengl_extensions(tmp, 0);
 #endif
 
-	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTI, ("[RTI]\tCompositor Cycle Log\tNetworks\tDecoders\tFrame\tDirect Draw\tVisual Config\tEvent\tRoute\tSMIL Timing\tTime node\tTexture\tSMIL Anim\tTraverse setup\tTraverse (and direct Draw)\tTraverse (and direct Draw) without anim\tIndirect Draw\tTraverse And Draw (Indirect or Not)\tFlush\tCycle\n"));
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTI, ("[RTI]\tCompositor Cycle Log\tNetworks\tDecoders\tFrame\tDirect Draw\tVisual Config\tEvent\tRoute\tSMIL Timing\tTime node\tTexture\tSMIL Anim\tTraverse setup\tTraverse (and direct Draw)\tTraverse (and direct Draw) without anim\tIndirect Draw\tTraverse And Draw (Indirect or Not)\tFlush\tCycle\tOutline Cache Hits\tOutline Cache Misses\n"));
 	return tmp;
 }
 
@@ -548,6 +549,7 @@ void gf_sc_del(GF_Compositor *compositor)
 	if (compositor->previous_sensors) gf_list_del(compositor->previous_sensors);
 	if (compositor->visuals) gf_list_del(compositor->visuals);
 	if (compositor->strike_bank) gf_list_del(compositor->strike_bank);
+	drawable_outline_cache_del(compositor);
 	if (compositor->hit_use_stack) gf_list_del(compositor->hit_use_stack);
 	if (compositor->prev_hit_use_stack) gf_list_del(compositor->prev_hit_use_stack);
 	if (compositor->focus_ancestors) gf_list_del(compositor->focus_ancestors);
@@ -1071,6 +1073,10 @@ void gf_sc_reload_config(GF_Compositor *compositor)
 	sOpt = gf_cfg_get_key(compositor->user->config, "Compositor", "DisablePartialHardwareBlit");
 	compositor->disable_partial_hw_blit = (sOpt && !stricmp(sOpt, "yes") ) ? 1 : 0;
 
+	/*outline cache size in kilobytes*/
+	sOpt = gf_cfg_get_key(compositor->user->config, "Compositor", "OutlineCacheSize");
+	drawable_outline_cache_set_size(compositor, 1024 * (sOpt ? atoi(sOpt) : 2048));
+
 
 	sOpt = gf_cfg_get_key(compositor->user->config, "Compositor", "StressMode");
 	gf_sc_set_option(compositor, GF_OPT_STRESS_MODE, (sOpt && !stricmp(sOpt, "yes") ) ? 1 : 0);
@@ -2221,7 +2227,7 @@ void gf_sc_simulation_tick(GF_Compositor *compositor)
 	compositor->last_frame_time = gf_sys_clock();
 	end_time = compositor->last_frame_time - in_time;
 
-	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTI, ("[RTI]\tCompositor Cycle Log\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\n", 
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTI, ("[RTI]\tCompositor Cycle Log\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\n", 
 		compositor->networks_time, 
 		compositor->decoders_time, 
 		compositor->frame_number, 
@@ -2239,7 +2245,10 @@ void gf_sc_simulation_tick(GF_Compositor *compositor)
 		compositor->indirect_draw_time,
 		traverse_time, 
 		flush_time, 
-		end_time));
+		end_time,
+		compositor->outline_cache_hits,
+		compositor->outline_cache_misses));
+	compositor->outline_cache_hits = compositor->outline_cache_misses = 0;
 
 	if (frame_drawn) {
 		compositor->current_frame = (compositor->current_frame+1) % GF_SR_FPS_COMPUTE_SIZE;
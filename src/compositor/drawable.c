@@ -1081,10 +1081,10 @@ StrikeInfo2D *drawable_get_strikeinfo(GF_Compositor *compositor, Drawable *drawa
 		}
 
 		if (path) {
-			si->outline = gf_path_get_outline(path, asp->pen_props);
+			si->outline = drawable_get_outline(compositor, path, &asp->pen_props);
 			si->original = path;
 		} else {
-			si->outline = gf_path_get_outline(drawable->path, asp->pen_props);
+			si->outline = drawable_get_outline(compositor, drawable->path, &asp->pen_props);
 		}
 		/*restore*/
 		asp->pen_props.width = w;
@@ -1099,6 +1099,226 @@ StrikeInfo2D *drawable_get_strikeinfo(GF_Compositor *compositor, Drawable *drawa
 	return si;
 }
 
+
+/*
+	outline cache: outlines are shared by all drawables of the compositor and looked up by path geometry
+	and pen settings, so that identical shapes and shapes only repainted are stroked once.
+	Geometry is compared as is: translating a cached outline is not exact and would change the rendering
+*/
+
+#define OUTLINE_CACHE_BUCKETS	1024
+
+typedef struct _outline_cache_entry
+{
+	struct _outline_cache_entry *next_in_bucket;
+	/*LRU list, most recent first*/
+	struct _outline_cache_entry *prev, *next;
+	u32 hash, size;
+
+	/*source path*/
+	u32 n_points, n_contours;
+	GF_Point2D *points;
+	u8 *tags;
+	u32 *contours;
+	s32 flags;
+	Fixed fineness;
+
+	/*pen settings, with their own copy of the dashes*/
+	GF_PenSettings pen;
+	u32 num_dash;
+	Fixed *dashes;
+
+	/*outline of the source path*/
+	GF_Path *outline;
+} OutlineCacheEntry;
+
+typedef struct _outline_cache
+{
+	OutlineCacheEntry *buckets[OUTLINE_CACHE_BUCKETS];
+	OutlineCacheEntry *first, *last;
+	u32 size, max_size;
+} GF_OutlineCache;
+
+#define OUTLINE_HASH(_h, _v)	_h = (_h ^ (u32) (_v)) * 0x01000193
+
+static GFINLINE u32 outline_fixed_bits(Fixed v)
+{
+	union {
+		Fixed f;
+		u32 u;
+	} bits;
+	bits.u = 0;
+	bits.f = v;
+	return bits.u;
+}
+
+static u32 outline_cache_hash(GF_Path *path, GF_PenSettings *pen)
+{
+	u32 i;
+	GF_Point2D *pt;
+	u32 h = 0x811C9DC5;
+
+	OUTLINE_HASH(h, path->n_points);
+	OUTLINE_HASH(h, path->n_contours);
+	OUTLINE_HASH(h, outline_fixed_bits(pen->width));
+	OUTLINE_HASH(h, (pen->cap<<24) | (pen->join<<16) | (pen->align<<8) | pen->dash);
+	OUTLINE_HASH(h, outline_fixed_bits(pen->dash_offset));
+	pt = path->points;
+	for (i=0; i<path->n_points; i++) {
+		OUTLINE_HASH(h, outline_fixed_bits(pt->x));
+		OUTLINE_HASH(h, outline_fixed_bits(pt->y));
+		pt++;
+	}
+	return h;
+}
+
+static Bool outline_cache_match(OutlineCacheEntry *ent, GF_Path *path, GF_PenSettings *pen)
+{
+	if ((ent->n_points != path->n_points) || (ent->n_contours != path->n_contours)) return 0;
+	if ((ent->flags != (path->flags & ~GF_PATH_BBOX_DIRTY)) || (ent->fineness != path->fineness)) return 0;
+	if ((ent->pen.width != pen->width) || (ent->pen.cap != pen->cap) || (ent->pen.join != pen->join)
+		|| (ent->pen.align != pen->align) || (ent->pen.dash != pen->dash) || (ent->pen.miterLimit != pen->miterLimit)
+		|| (ent->pen.dash_offset != pen->dash_offset) || (ent->pen.path_length != pen->path_length)
+	) {
+		return 0;
+	}
+	if (ent->num_dash != (pen->dash_set ? pen->dash_set->num_dash : 0)) return 0;
+	if (ent->num_dash && memcmp(ent->dashes, pen->dash_set->dashes, sizeof(Fixed)*ent->num_dash)) return 0;
+	if (memcmp(ent->contours, path->contours, sizeof(u32)*ent->n_contours)) return 0;
+	if (memcmp(ent->tags, path->tags, sizeof(u8)*ent->n_points)) return 0;
+	if (memcmp(ent->points, path->points, sizeof(GF_Point2D)*ent->n_points)) return 0;
+	return 1;
+}
+
+static void outline_cache_entry_del(OutlineCacheEntry *ent)
+{
+	gf_free(ent->points);
+	gf_free(ent->tags);
+	if (ent->contours) gf_free(ent->contours);
+	if (ent->dashes) gf_free(ent->dashes);
+	gf_path_del(ent->outline);
+	gf_free(ent);
+}
+
+static void outline_cache_remove(GF_OutlineCache *cache, OutlineCacheEntry *ent)
+{
+	OutlineCacheEntry **prev = &cache->buckets[ent->hash % OUTLINE_CACHE_BUCKETS];
+	while (*prev != ent) prev = &(*prev)->next_in_bucket;
+	*prev = ent->next_in_bucket;
+
+	if (ent->prev) ent->prev->next = ent->next;
+	else cache->first = ent->next;
+	if (ent->next) ent->next->prev = ent->prev;
+	else cache->last = ent->prev;
+
+	cache->size -= ent->size;
+	outline_cache_entry_del(ent);
+}
+
+void drawable_outline_cache_set_size(GF_Compositor *compositor, u32 max_size)
+{
+	GF_OutlineCache *cache = compositor->outline_cache;
+	if (!cache) {
+		if (!max_size) return;
+		GF_SAFEALLOC(cache, GF_OutlineCache);
+		if (!cache) return;
+		compositor->outline_cache = cache;
+	}
+	cache->max_size = max_size;
+	while (cache->last && (cache->size > cache->max_size))
+		outline_cache_remove(cache, cache->last);
+}
+
+void drawable_outline_cache_del(GF_Compositor *compositor)
+{
+	GF_OutlineCache *cache = compositor->outline_cache;
+	if (!cache) return;
+	while (cache->last) outline_cache_remove(cache, cache->last);
+	gf_free(cache);
+	compositor->outline_cache = NULL;
+}
+
+GF_Path *drawable_get_outline(GF_Compositor *compositor, GF_Path *path, GF_PenSettings *pen)
+{
+	u32 hash;
+	OutlineCacheEntry *ent;
+	GF_Path *outline;
+	GF_OutlineCache *cache = compositor ? compositor->outline_cache : NULL;
+
+	/*stress mode recomputes all outlines at each frame*/
+	if (!cache || !cache->max_size || !path->n_points || compositor->stress_mode) return gf_path_get_outline(path, *pen);
+
+	hash = outline_cache_hash(path, pen);
+	ent = cache->buckets[hash % OUTLINE_CACHE_BUCKETS];
+	while (ent) {
+		if ((ent->hash == hash) && outline_cache_match(ent, path, pen)) break;
+		ent = ent->next_in_bucket;
+	}
+	if (ent) {
+		compositor->outline_cache_hits++;
+		/*move to front of LRU*/
+		if (ent->prev) {
+			ent->prev->next = ent->next;
+			if (ent->next) ent->next->prev = ent->prev;
+			else cache->last = ent->prev;
+			ent->prev = NULL;
+			ent->next = cache->first;
+			cache->first->prev = ent;
+			cache->first = ent;
+		}
+		return gf_path_clone(ent->outline);
+	}
+
+	compositor->outline_cache_misses++;
+	outline = gf_path_get_outline(path, *pen);
+	if (!outline) return NULL;
+
+	GF_SAFEALLOC(ent, OutlineCacheEntry);
+	if (!ent) return outline;
+	ent->size = sizeof(OutlineCacheEntry) + sizeof(GF_Path)
+		+ (sizeof(GF_Point2D) + sizeof(u8)) * (path->n_points + outline->n_points)
+		+ sizeof(u32) * (path->n_contours + outline->n_contours);
+	/*too big, don't cache*/
+	if (ent->size > cache->max_size / 4) {
+		gf_free(ent);
+		return outline;
+	}
+
+	ent->hash = hash;
+	ent->outline = gf_path_clone(outline);
+	ent->n_points = path->n_points;
+	ent->n_contours = path->n_contours;
+	ent->flags = path->flags & ~GF_PATH_BBOX_DIRTY;
+	ent->fineness = path->fineness;
+	ent->points = (GF_Point2D *) gf_malloc(sizeof(GF_Point2D)*path->n_points);
+	ent->tags = (u8 *) gf_malloc(sizeof(u8)*path->n_points);
+	memcpy(ent->tags, path->tags, sizeof(u8)*path->n_points);
+	memcpy(ent->points, path->points, sizeof(GF_Point2D)*path->n_points);
+	if (path->n_contours) {
+		ent->contours = (u32 *) gf_malloc(sizeof(u32)*path->n_contours);
+		memcpy(ent->contours, path->contours, sizeof(u32)*path->n_contours);
+	}
+	ent->pen = *pen;
+	ent->pen.dash_set = NULL;
+	if (pen->dash_set && pen->dash_set->num_dash) {
+		ent->num_dash = pen->dash_set->num_dash;
+		ent->dashes = (Fixed *) gf_malloc(sizeof(Fixed)*ent->num_dash);
+		memcpy(ent->dashes, pen->dash_set->dashes, sizeof(Fixed)*ent->num_dash);
+	}
+
+	ent->next_in_bucket = cache->buckets[ent->hash % OUTLINE_CACHE_BUCKETS];
+	cache->buckets[ent->hash % OUTLINE_CACHE_BUCKETS] = ent;
+	ent->next = cache->first;
+	if (cache->first) cache->first->prev = ent;
+	else cache->last = ent;
+	cache->first = ent;
+	cache->size += ent->size;
+	while (cache->size > cache->max_size)
+		outline_cache_remove(cache, cache->last);
+
+	return outline;
+}
+
 void drawable_reset_path_outline(Drawable *st)
 {
 	StrikeInfo2D *si = st->outline;
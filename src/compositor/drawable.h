@@ -308,6 +308,13 @@ typedef struct _strikeinfo2d
 } StrikeInfo2D;
 
 void delete_strikeinfo2d(StrikeInfo2D *info);
+
+/*gets the outline of the path for the given pen through the compositor outline cache - the returned path
+belongs to the caller*/
+GF_Path *drawable_get_outline(GF_Compositor *compositor, GF_Path *path, GF_PenSettings *pen);
+/*sets the outline cache size in bytes, 0 disables the cache*/
+void drawable_outline_cache_set_size(GF_Compositor *compositor, u32 max_size);
+void drawable_outline_cache_del(GF_Compositor *compositor);
 /*get strike and manage any scale change&co. This avoids recomputing outline at each frame...*/
 StrikeInfo2D *drawable_get_strikeinfo(GF_Compositor *compositor, Drawable *drawable, DrawAspect2D *asp, GF_Node *appear, GF_Path *path, u32 svg_flags, GF_TraverseState *tr_state);
 
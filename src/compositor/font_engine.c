@@ -824,7 +824,7 @@ static void span_strike_3d(GF_TextSpan *span, GF_TraverseState *tr_state, DrawAs
 		span->ext->outline = new_mesh();
 #ifdef GPAC_HAS_GLU
 		if (vect_outline) {
-			GF_Path *outline = gf_path_get_outline(path, asp->pen_props);
+			GF_Path *outline = drawable_get_outline(tr_state->visual->compositor, path, &asp->pen_props);
 			gf_mesh_tesselate_path(span->ext->outline, outline, asp->line_texture ? 2 : 1);
 			gf_path_del(outline);
 		} else {
@@ -80,7 +80,7 @@ static void draw_clipper(GF_VisualManager *visual, struct _drawable_context *ctx
 
 	clippath = gf_path_new();
 	gf_path_add_rect_center(clippath, ctx->bi->unclip.x + ctx->bi->unclip.width/2, ctx->bi->unclip.y - ctx->bi->unclip.height/2, ctx->bi->unclip.width, ctx->bi->unclip.height);
-	cliper = gf_path_get_outline(clippath, clipset);
+	cliper = drawable_get_outline(visual->compositor, clippath, &clipset);
 	gf_path_del(clippath);
 	raster->surface_set_matrix(visual->raster_surface, NULL);
 	raster->surface_set_clipper(visual->raster_surface, NULL);
@@ -621,7 +621,7 @@ void visual_2d_fill_rect(GF_VisualManager *visual, DrawableContext *ctx, GF_Rect
 		pen.join = GF_LINE_JOIN_BEVEL;
 		pen.dash = GF_DASH_STYLE_DOT;
 		raster->stencil_set_brush_color(visual->raster_brush, strike_color);
-		outline = gf_path_get_outline(path,  pen);	
+		outline = drawable_get_outline(visual->compositor, path, &pen);
 		outline->flags &= ~GF_PATH_FILL_ZERO_NONZERO;
 		raster->surface_set_path(visual->raster_surface, outline);
 		visual_2d_fill_path(visual, ctx, visual->raster_brush, tr_state);
@@ -675,7 +675,7 @@ void visual_2d_fill_irect(GF_VisualManager *visual, GF_IRect *rc, u32 fill, u32
 		pen.width = 2;
 		pen.align = GF_PATH_LINE_INSIDE;
 		pen.join = GF_LINE_JOIN_BEVEL;
-		outline = gf_path_get_outline(path, pen);	
+		outline = drawable_get_outline(visual->compositor, path, &pen);
 		outline->flags &= ~GF_PATH_FILL_ZERO_NONZERO;
 
 		raster->surface_set_path(visual->raster_surface, outline);
@@ -47,6 +47,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rmdir) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cleanup_dir) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sys_clock) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sys_clock_high_res) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sys_get_rti) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sys_get_battery_state) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_get_default_cache_directory) )
@@ -201,6 +202,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_get_handle) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_bind) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_connect) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_get_connect_status) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_send) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_listen) )
@@ -275,6 +277,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_process) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_get_cache_name) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_persist_cache) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_get_stats) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_fetch_data) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_last_error) )
@@ -297,12 +300,15 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_cache_set_mime_type) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cache_get_cache_filename_range) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_delete_cached_file_entry_session) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dm_persist_cached_file_entry_session) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_url_info_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_get_url_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_url_info_init) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_is_thread_dead) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_abort) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_set_range) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_pipeline_range) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dm_get_pool_stats) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_setup_from_url) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_get_file_memory) )
 
@@ -713,6 +719,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_append_sample_data) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_refresh_size_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_add_sample_reference) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_copy_samples) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_last_sample_duration) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_track_reference) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_remove_track_reference) )
@@ -862,6 +869,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_start_fragment) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_fragment_option) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_fragment_add_sample) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_fragment_add_sample_from_track) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_enable_segment_streaming) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_fragment_append_data) )
 #endif
 
@@ -1041,6 +1050,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_process) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_hinter_process_tracks) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_finalize) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_finalize) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_get_bandwidth) )
@@ -1230,6 +1240,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_get_config) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_get_version) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_get_rap) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_enable_node_cache) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_node_changed) )
 #endif
 #endif /*GPAC_DISABLE_BIFS*/
 
@@ -835,6 +835,198 @@ GF_Err gf_isom_add_sample_reference(GF_ISOFile *movie, u32 trackNumber, u32 Stre
 
 }
 
+/*max size of sample data read and written at once by gf_isom_copy_samples*/
+#define GF_ISOM_COPY_BLOCK_SIZE	(1024*1024)
+
+static GF_Err gf_isom_copy_data_block(GF_MediaBox *src_mdia, u64 offset, u32 size, GF_MediaBox *mdia, char **buffer, u32 *buffer_size)
+{
+	GF_Err e;
+	u32 bytes;
+	while (size) {
+		bytes = MIN(size, GF_ISOM_COPY_BLOCK_SIZE);
+		if (*buffer_size < bytes) {
+			*buffer = (char*)gf_realloc(*buffer, bytes);
+			if (! *buffer) return GF_OUT_OF_MEM;
+			*buffer_size = bytes;
+		}
+		if (gf_isom_datamap_get_data(src_mdia->information->dataHandler, *buffer, bytes, offset) < bytes) return GF_IO_ERR;
+		e = gf_isom_datamap_add_data(mdia->information->dataHandler, *buffer, bytes);
+		if (e) return e;
+		offset += bytes;
+		size -= bytes;
+	}
+	return GF_OK;
+}
+
+//Copy samples from a track of another file. Use streamDescriptionIndex to specify the desired stream, 0 to use the source one
+GF_EXPORT
+GF_Err gf_isom_copy_samples(GF_ISOFile *movie, u32 trackNumber, u32 StreamDescriptionIndex, GF_ISOFile *orig, u32 origTrackNumber, u32 firstSample, u32 nbSamples)
+{
+	GF_Err e, e2;
+	GF_TrackBox *trak, *src_trak;
+	GF_SampleTableBox *stbl, *src;
+	GF_SampleEntryBox *entry;
+	GF_DataEntryURLBox *Dentry;
+	u32 i, n, k, left, descIndex, src_descIndex, dataRefIndex, src_dataRefIndex, size, buffer_size;
+	u32 block_dataRefIndex, block_size;
+	u64 DTS, offset, data_offset, block_offset, file_size;
+	u8 isEdited, block_isEdited;
+	char *buffer;
+
+	e = CanAccessMovie(movie, GF_ISOM_OPEN_WRITE);
+	if (e) return e;
+
+	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	src_trak = gf_isom_get_track_from_file(orig, origTrackNumber);
+	if (!trak || !src_trak || !firstSample) return GF_BAD_PARAM;
+	src = src_trak->Media->information->sampleTable;
+	if (firstSample + nbSamples - 1 > src->SampleSize->sampleCount) return GF_BAD_PARAM;
+	if (!nbSamples) return GF_OK;
+
+	/*samples rewritten or with properties not kept in the copied tables must be added one by one*/
+	if ((trak->Media->handler->handlerType == GF_ISOM_MEDIA_OD) || (src_trak->Media->handler->handlerType == GF_ISOM_MEDIA_OD))
+		return GF_NOT_SUPPORTED;
+	if (orig->convert_streaming_text && ((src_trak->Media->handler->handlerType == GF_ISOM_MEDIA_TEXT) || (src_trak->Media->handler->handlerType == GF_ISOM_MEDIA_SUBT)) )
+		return GF_NOT_SUPPORTED;
+	if (src->ShadowSync) return GF_NOT_SUPPORTED;
+	/*sample data in other files*/
+	for (i=0; i<gf_list_count(src->SampleDescription->boxList); i++) {
+		if (!Media_IsSelfContained(src_trak->Media, i+1)) return GF_NOT_SUPPORTED;
+	}
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	if (src_trak->sample_count_at_seg_start || src_trak->dts_at_seg_start) return GF_NOT_SUPPORTED;
+#endif
+	/*empty samples cannot be added*/
+	if (!src->SampleSize->sampleSize) {
+		for (i=firstSample; i<firstSample+nbSamples; i++) {
+			if (!src->SampleSize->sizes[i-1]) return GF_NOT_SUPPORTED;
+		}
+	}
+
+	e = FlushCaptureMode(movie);
+	if (e) return e;
+	e = unpack_track(trak);
+	if (e) return e;
+	stbl = trak->Media->information->sampleTable;
+
+	/*switching to 64 bit chunk offsets is left to the per-sample path*/
+	if (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
+		u64 range_size = 0;
+		if (src->SampleSize->sampleSize) {
+			range_size = (u64) nbSamples * src->SampleSize->sampleSize;
+		} else {
+			for (i=firstSample; i<firstSample+nbSamples; i++) range_size += src->SampleSize->sizes[i-1];
+		}
+		if (!movie->editFileMap || (gf_isom_datamap_get_offset(movie->editFileMap) + range_size > 0xFFFFFFFF)) return GF_NOT_SUPPORTED;
+	}
+	/*samples are appended with increasing DTS*/
+	if (stbl->SampleToChunk->nb_entries != stbl->SampleSize->sampleCount) return GF_NOT_SUPPORTED;
+	if (stbl->TimeToSample->w_currentSampleNum != stbl->SampleSize->sampleCount) return GF_NOT_SUPPORTED;
+	if (stbl->CompositionOffset && (stbl->CompositionOffset->unpack_mode || (stbl->CompositionOffset->w_LastSampleNumber > stbl->SampleSize->sampleCount)) )
+		return GF_NOT_SUPPORTED;
+	e = stbl_GetSampleDTS(src->TimeToSample, firstSample, &DTS);
+	if (e) return e;
+	if (stbl->SampleSize->sampleCount ? (DTS <= stbl->TimeToSample->w_LastDTS) : (DTS != 0)) return GF_NOT_SUPPORTED;
+	i = src->TimeToSample->r_currentEntryIndex;
+	if (i >= src->TimeToSample->nb_entries) return GF_NOT_SUPPORTED;
+	left = src->TimeToSample->r_FirstSampleInEntry + src->TimeToSample->entries[i].sampleCount - firstSample;
+	n = nbSamples;
+	while (1) {
+		k = MIN(left, n);
+		n -= k;
+		/*the duration of the last sample is not used*/
+		if (!src->TimeToSample->entries[i].sampleDelta && (k > (n ? 0 : 1))) return GF_NOT_SUPPORTED;
+		if (!n) break;
+		i++;
+		if (i >= src->TimeToSample->nb_entries) return GF_NOT_SUPPORTED;
+		left = src->TimeToSample->entries[i].sampleCount;
+	}
+
+	/*copy each chunk in the range, merging chunks contiguous in the source file in a single read and write*/
+	buffer = NULL;
+	buffer_size = 0;
+	descIndex = 0;
+	data_offset = 0;
+	block_size = 0;
+	block_offset = 0;
+	block_dataRefIndex = 0;
+	block_isEdited = 0;
+	for (n=0; n<nbSamples; n+=k) {
+		e = stbl_GetSampleRunInfos(src, firstSample + n, &offset, &src_descIndex, &isEdited, &k);
+		if (e) break;
+		if (!k) {
+			e = GF_ISOM_INVALID_FILE;
+			break;
+		}
+		if (k > nbSamples - n) k = nbSamples - n;
+
+		if (src->SampleSize->sampleSize) {
+			size = k * src->SampleSize->sampleSize;
+		} else {
+			size = 0;
+			for (i=0; i<k; i++) size += src->SampleSize->sizes[firstSample + n + i - 1];
+		}
+
+		/*same checks as gf_isom_add_sample*/
+		if (!descIndex || (!StreamDescriptionIndex && (src_descIndex != descIndex)) ) {
+			descIndex = StreamDescriptionIndex ? StreamDescriptionIndex : src_descIndex;
+			e = Media_GetSampleDesc(trak->Media, descIndex, &entry, &dataRefIndex);
+			if (e) break;
+			if (!entry || !dataRefIndex) {
+				e = GF_BAD_PARAM;
+				break;
+			}
+			Dentry = (GF_DataEntryURLBox*)gf_list_get(trak->Media->information->dataInformation->dref->boxList, dataRefIndex - 1);
+			if (!Dentry || Dentry->flags != 1) {
+				e = GF_BAD_PARAM;
+				break;
+			}
+			e = gf_isom_datamap_open(trak->Media, dataRefIndex, 1);
+			if (e) break;
+			//all self-contained data goes to the edit file
+			if (!n) data_offset = gf_isom_datamap_get_offset(trak->Media->information->dataHandler);
+			trak->Media->information->sampleTable->currentEntryIndex = descIndex;
+		}
+		e = Media_GetSampleDesc(src_trak->Media, src_descIndex, &entry, &src_dataRefIndex);
+		if (e) break;
+
+		if (block_size && ((src_dataRefIndex != block_dataRefIndex) || (isEdited != block_isEdited) || (offset != block_offset + block_size) || (block_size + size > GF_ISOM_COPY_BLOCK_SIZE)) ) {
+			e = gf_isom_copy_data_block(src_trak->Media, block_offset, block_size, trak->Media, &buffer, &buffer_size);
+			if (e) break;
+			data_offset += block_size;
+			block_size = 0;
+		}
+		if (!block_size) {
+			e = gf_isom_datamap_open(src_trak->Media, src_dataRefIndex, isEdited);
+			if (e) break;
+			block_offset = offset;
+			block_dataRefIndex = src_dataRefIndex;
+			block_isEdited = isEdited;
+		}
+		/*don't add samples which cannot be read*/
+		file_size = gf_bs_get_size(src_trak->Media->information->dataHandler->bs);
+		if (offset + size > file_size) {
+			file_size = gf_bs_get_refreshed_size(src_trak->Media->information->dataHandler->bs);
+			if (offset + size > file_size) {
+				e = GF_ISOM_INCOMPLETE_FILE;
+				break;
+			}
+		}
+		e = stbl_AppendSampleRange(trak->Media, src, firstSample + n, k, descIndex, data_offset + block_size);
+		if (e) break;
+		block_size += size;
+	}
+	if (block_size) {
+		e2 = gf_isom_copy_data_block(src_trak->Media, block_offset, block_size, trak->Media, &buffer, &buffer_size);
+		if (!e) e = e2;
+	}
+	if (buffer) gf_free(buffer);
+	if (e) return e;
+
+	trak->Media->mediaHeader->modificationTime = gf_isom_get_mp4time();
+	return SetTrackDuration(trak);
+}
+
 //set the duration of the last media sample. If not set, the duration of the last sample is the
 //duration of the previous one if any, or 1000 (default value).
 GF_EXPORT
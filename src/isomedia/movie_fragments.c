@@ -719,6 +719,8 @@ GF_Err StoreFragment(GF_ISOFile *movie, Bool load_mdat_only, s32 data_offset_dif
 		gf_bs_write_u32(bs, (u32) mdat_size);
 		gf_bs_write_u32(bs, GF_ISOM_BOX_TYPE_MDAT);
 		gf_bs_seek(bs, moof_start);
+		/*remember mdat size for the segment index*/
+		if (movie->stream_segments) movie->moof->mdat_size = mdat_size;
 	}
 
 	/*estimate moof size and shift trun offsets*/
@@ -866,6 +868,215 @@ typedef struct
 	u64 start_offset, end_offset;
 } SIDXEntry;
 
+/*copies the segment written in the temp file at the end of the movie file*/
+static void FlushAppendedSegment(GF_ISOFile *movie)
+{
+	char bloc[1024];
+	u32 seg_size = (u32) gf_bs_get_size(movie->editFileMap->bs);
+	gf_bs_seek(movie->editFileMap->bs, 0);
+	while (seg_size) {
+		u32 size = gf_bs_read_data(movie->editFileMap->bs, bloc, (seg_size>1024) ? 1024 : seg_size);
+		gf_bs_write_data(movie->movieFileMap->bs, bloc, size);
+		seg_size -= size;
+	}
+	gf_isom_datamap_del(movie->editFileMap);
+	movie->editFileMap = gf_isom_fdm_new_temp(NULL);
+}
+
+static u32 GetSIDXSize(u32 nb_refs)
+{
+	u32 size;
+	GF_SegmentIndexBox *sidx = (GF_SegmentIndexBox *)gf_isom_box_new(GF_ISOM_BOX_TYPE_SIDX);
+	sidx->nb_refs = nb_refs;
+	gf_isom_box_size((GF_Box *) sidx);
+	size = (u32) sidx->size;
+	sidx->nb_refs = 0;
+	gf_isom_box_del((GF_Box *) sidx);
+	return size;
+}
+
+/*reserves space for styp and sidx at the start of a streamed segment*/
+static GF_Err ReserveSegmentHeader(GF_ISOFile *movie)
+{
+	GF_Err e;
+	u32 size = 0;
+	GF_BitStream *bs = movie->editFileMap->bs;
+
+	movie->segment_header_reserved = 0;
+	/*styp is always written when the segment is in its own file - the "lmsg" brand is not known yet*/
+	if (!movie->append_segment && !movie->segment_start) {
+		gf_isom_modify_alternate_brand(movie, GF_4CC('m','s','i','x'), 1);
+		e = gf_isom_box_size((GF_Box *) movie->brand);
+		if (e) return e;
+		size += (u32) movie->brand->size;
+	}
+	/*the sidx allocated by gf_isom_allocate_sidx is already written*/
+	if (movie->stream_segments_sidx && !movie->root_sidx) 
+		size += GetSIDXSize(movie->segment_frags_hint);
+
+	if (!size) return GF_OK;
+	gf_bs_write_u32(bs, size);
+	gf_bs_write_u32(bs, GF_ISOM_BOX_TYPE_FREE);
+	gf_bs_write_byte(bs, 0, size-8);
+	movie->segment_header_reserved = size;
+	return GF_OK;
+}
+
+/*moves the data in [start, end[ by shift bytes towards the end of the file, copying blocks from the end*/
+static GF_Err ShiftSegmentData(GF_BitStream *bs, u64 start, u64 end, u32 shift)
+{
+	char block[4096];
+	u64 pos = end;
+
+	/*grow the file first, so that all blocks are written inside the file*/
+	gf_bs_seek(bs, end);
+	gf_bs_write_byte(bs, 0, shift);
+	while (pos > start) {
+		u32 size = (pos - start > sizeof(block)) ? sizeof(block) : (u32) (pos - start);
+		pos -= size;
+		gf_bs_seek(bs, pos);
+		if (gf_bs_read_data(bs, block, size) != size) return GF_IO_ERR;
+		gf_bs_seek(bs, pos + shift);
+		gf_bs_write_data(bs, block, size);
+	}
+	return gf_bs_seek(bs, end + shift);
+}
+
+/*closes a streamed segment: all fragments are already written after the reserved header, only the header 
+(styp, sidx) is written. If the reserved space is too small, the fragments are moved*/
+static GF_Err CloseStreamedSegment(GF_ISOFile *movie, u32 referenceTrackID, u64 ref_track_decode_time, u64 ref_track_next_cts, Bool last_segment, u64 *index_start_range, u64 *index_end_range)
+{
+	GF_Err e;
+	u32 i, count, ref_idx, header_size, reserved;
+	u64 seg_end, cur_dur, prev_earliest_cts, sidx_start;
+	Bool write_styp;
+	GF_SegmentIndexBox *sidx = NULL;
+	GF_MovieFragmentBox *moof;
+	GF_TrackBox *trak = NULL;
+	GF_BitStream *bs = movie->editFileMap->bs;
+
+	/*store last fragment*/
+	if (movie->moof) {
+		e = StoreFragment(movie, 0, 0, NULL);
+		if (e) return e;
+		movie->moof = NULL;
+	}
+	count = gf_list_count(movie->moof_list);
+	seg_end = gf_bs_get_position(bs);
+
+	header_size = 0;
+	/*write STYP if we write to a different file or if we write the last segment*/
+	write_styp = ((!movie->append_segment && !movie->segment_start) || last_segment) ? 1 : 0;
+	if (write_styp) {
+		gf_isom_modify_alternate_brand(movie, GF_4CC('m','s','i','x'), 1);
+		if (last_segment) {
+			gf_isom_modify_alternate_brand(movie, GF_4CC('l','m','s','g'), 1);
+		}
+		movie->brand->type = GF_ISOM_BOX_TYPE_STYP;
+		e = gf_isom_box_size((GF_Box *) movie->brand);
+		if (e) return e;
+		header_size += (u32) movie->brand->size;
+	}
+
+	if (referenceTrackID) trak = gf_isom_get_track_from_id(movie->moov, referenceTrackID);
+	if (trak) {
+		prev_earliest_cts = ref_track_decode_time + moof_get_earliest_cts(gf_list_get(movie->moof_list, 0), referenceTrackID);
+
+		/*one reference per segment in the preallocated sidx, one reference per fragment otherwise*/
+		if (movie->root_sidx) {
+			sidx = movie->root_sidx;
+			if (!movie->root_sidx_index) sidx->earliest_presentation_time = prev_earliest_cts;
+		} else {
+			sidx = (GF_SegmentIndexBox *)gf_isom_box_new(GF_ISOM_BOX_TYPE_SIDX);
+			sidx->earliest_presentation_time = prev_earliest_cts;
+			sidx->nb_refs = count;
+			sidx->refs = gf_malloc(sizeof(GF_SIDXReference)*sidx->nb_refs);
+			memset(sidx->refs, 0, sizeof(GF_SIDXReference)*sidx->nb_refs);
+		}
+		sidx->reference_ID = referenceTrackID;
+		sidx->timescale = trak->Media->mediaHeader->timeScale;
+		/*we don't write anything between sidx and following moov*/
+		sidx->first_offset = 0;
+
+		ref_idx = movie->root_sidx ? movie->root_sidx_index : 0;
+		cur_dur = 0;
+		for (i=0; i<count; i++) {
+			moof = gf_list_get(movie->moof_list, i);
+			if (!movie->root_sidx && i) {
+				u64 first_cts = ref_track_decode_time + cur_dur + moof_get_earliest_cts(moof, referenceTrackID);
+				sidx->refs[ref_idx].subsegment_duration = (u32) (first_cts - prev_earliest_cts);
+				prev_earliest_cts = first_cts;
+				ref_idx++;
+			}
+			sidx->refs[ref_idx].reference_type = 0;
+			if (!sidx->refs[ref_idx].SAP_type) {
+				sidx->refs[ref_idx].SAP_type = moof_get_sap_info(moof, referenceTrackID, & sidx->refs[ref_idx].SAP_delta_time, & sidx->refs[ref_idx].starts_with_SAP);
+			}
+			cur_dur += moof_get_duration(moof, referenceTrackID);
+			sidx->refs[ref_idx].reference_size += (u32) (moof->size + moof->mdat_size);
+		}
+		sidx->refs[ref_idx].subsegment_duration = (u32) (ref_track_next_cts - prev_earliest_cts);
+
+		if (movie->root_sidx) {
+			movie->root_sidx_index++;
+		} else {
+			e = gf_isom_box_size((GF_Box *) sidx);
+			if (e) return e;
+			header_size += (u32) sidx->size;
+		}
+	}
+
+	/*not enough space reserved (or not enough to insert a free box), move the fragments*/
+	reserved = movie->segment_header_reserved;
+	if ((header_size > reserved) || ((header_size < reserved) && (header_size + 8 > reserved))) {
+		u32 shift = (header_size > reserved) ? (header_size - reserved) : (header_size + 8 - reserved);
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[iso file] Segment header does not fit in reserved space, moving segment data by %d bytes\n", shift));
+		e = ShiftSegmentData(bs, movie->segment_start + reserved, seg_end, shift);
+		if (e) return e;
+		reserved += shift;
+		seg_end += shift;
+	}
+
+	gf_bs_seek(bs, movie->segment_start);
+	if (write_styp) {
+		e = gf_isom_box_write((GF_Box *) movie->brand, bs);
+		if (e) return e;
+	}
+	if (reserved > header_size) {
+		gf_bs_write_u32(bs, reserved - header_size);
+		gf_bs_write_u32(bs, GF_ISOM_BOX_TYPE_FREE);
+		gf_bs_write_byte(bs, 0, reserved - header_size - 8);
+	}
+	if (sidx && !movie->root_sidx) {
+		sidx_start = gf_bs_get_position(bs);
+		e = gf_isom_box_write((GF_Box *) sidx, bs);
+		if (index_start_range) *index_start_range = sidx_start;
+		if (index_end_range) *index_end_range = gf_bs_get_position(bs);
+		gf_isom_box_del((GF_Box *) sidx);
+		if (e) return e;
+	}
+	gf_bs_seek(bs, seg_end);
+
+	if (movie->root_sidx && last_segment) {
+		assert(movie->root_sidx_index == movie->root_sidx->nb_refs);
+		sidx_rewrite(movie->root_sidx, bs, movie->root_sidx_offset);
+		gf_isom_box_del((GF_Box*) movie->root_sidx);
+		movie->root_sidx = NULL;
+	}
+
+	while (gf_list_count(movie->moof_list)) {
+		moof = gf_list_last(movie->moof_list);
+		gf_list_rem_last(movie->moof_list);
+		gf_isom_box_del((GF_Box *) moof);
+	}
+	/*size next reservation on this segment*/
+	movie->segment_frags_hint = count;
+	movie->segment_header_reserved = 0;
+
+	if (movie->append_segment) FlushAppendedSegment(movie);
+	return GF_OK;
+}
+
 GF_Err gf_isom_close_segment(GF_ISOFile *movie, s32 subsegments_per_sidx, u32 referenceTrackID, u64 ref_track_decode_time, u64 ref_track_next_cts, Bool daisy_chain_sidx, Bool last_segment, u64 *index_start_range, u64 *index_end_range)
 {
 	GF_SegmentIndexBox *sidx=NULL;
@@ -901,6 +1112,12 @@ GF_Err gf_isom_close_segment(GF_ISOFile *movie, s32 subsegments_per_sidx, u32 re
 
 	count = gf_list_count(movie->moof_list);
 	if (!count) return GF_OK;
+
+	if (movie->stream_segments) {
+		if (subsegments_per_sidx < 0) referenceTrackID = 0;
+		return CloseStreamedSegment(movie, referenceTrackID, ref_track_decode_time, ref_track_next_cts, last_segment, index_start_range, index_end_range);
+	}
+
 	/*store fragment*/
 	if (movie->moof) {
 		e = StoreFragment(movie, 1, 0, NULL);
@@ -1286,18 +1503,7 @@ GF_Err gf_isom_close_segment(GF_ISOFile *movie, s32 subsegments_per_sidx, u32 re
 		if (index_end_range) *index_end_range = sidx_end;
 	}
 
-	if (movie->append_segment) {
-		char bloc[1024];
-		u32 seg_size = (u32) gf_bs_get_size(movie->editFileMap->bs);
-		gf_bs_seek(movie->editFileMap->bs, 0);
-		while (seg_size) {
-			u32 size = gf_bs_read_data(movie->editFileMap->bs, bloc, (seg_size>1024) ? 1024 : seg_size);
-			gf_bs_write_data(movie->movieFileMap->bs, bloc, size);
-			seg_size -= size;
-		}
-		gf_isom_datamap_del(movie->editFileMap);
-		movie->editFileMap = gf_isom_fdm_new_temp(NULL);
-	}
+	if (movie->append_segment) FlushAppendedSegment(movie);
 
 	return e;
 }
@@ -1311,6 +1517,19 @@ GF_Err gf_isom_close_fragments(GF_ISOFile *movie)
 	}
 }
 
+GF_EXPORT
+GF_Err gf_isom_enable_segment_streaming(GF_ISOFile *movie, u32 nb_frags_hint, Bool use_sidx)
+{
+	if (!movie || !(movie->FragmentsFlags & GF_ISOM_FRAG_WRITE_READY) ) return GF_BAD_PARAM;
+	if (movie->openMode != GF_ISOM_OPEN_WRITE) return GF_ISOM_INVALID_MODE;
+	if (!movie->use_segments || movie->moof || gf_list_count(movie->moof_list)) return GF_BAD_PARAM;
+
+	movie->stream_segments = 1;
+	movie->stream_segments_sidx = use_sidx;
+	movie->segment_frags_hint = nb_frags_hint ? nb_frags_hint : 1;
+	return GF_OK;
+}
+
 GF_Err gf_isom_start_segment(GF_ISOFile *movie, char *SegName)
 {
 	GF_Err e;
@@ -1358,9 +1577,14 @@ GF_Err gf_isom_start_fragment(GF_ISOFile *movie, Bool moof_first)
 	if (movie->use_segments) moof_first = 1;
 	movie->moof_first = moof_first;
 
-	//store existing fragment
+	//store existing fragment - in streamed segments, it is directly written
 	if (movie->moof) {
-		e = StoreFragment(movie, movie->use_segments ? 1 : 0, 0, NULL);
+		e = StoreFragment(movie, (movie->use_segments && !movie->stream_segments) ? 1 : 0, 0, NULL);
+		if (e) return e;
+	}
+	/*first fragment of a streamed segment, reserve the segment header*/
+	if (movie->stream_segments && !gf_list_count(movie->moof_list)) {
+		e = ReserveSegmentHeader(movie);
 		if (e) return e;
 	}
  	
@@ -1406,19 +1630,17 @@ u32 GetRunSize(GF_TrackFragmentRunBox *trun)
 }
 
 
-GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, u32 TrackID, GF_ISOSample *sample, u32 DescIndex, 
-								 u32 Duration,
-								 u8 PaddingBits, u16 DegradationPriority)
+/*creates the trun entry for a new sample and returns the traf/trun where the sample data shall be written*/
+static GF_Err FragmentAddSampleEntry(GF_ISOFile *movie, u32 TrackID, GF_ISOSample *sample, u32 DescIndex, 
+								 u32 Duration, u8 PaddingBits, u16 DegradationPriority, 
+								 GF_TrackFragmentBox **out_traf, GF_TrackFragmentRunBox **out_trun)
 {
 	u32 count, buffer_size;
 	char *buffer;
 	u64 pos;
-	GF_ISOSample *od_sample = NULL;
 	GF_TrunEntry *ent;
 	GF_TrackFragmentBox *traf, *traf_2;
 	GF_TrackFragmentRunBox *trun;
-	if (!movie->moof || !(movie->FragmentsFlags & GF_ISOM_FRAG_WRITE_READY) || !sample) 
-		return GF_BAD_PARAM;
 
 	traf = GetTraf(movie, TrackID);
 	if (!traf) 
@@ -1513,6 +1735,25 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, u32 TrackID, GF_ISOSample
 	
 	trun->sample_count += 1;
 
+	*out_traf = traf;
+	*out_trun = trun;
+	return GF_OK;
+}
+
+GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, u32 TrackID, GF_ISOSample *sample, u32 DescIndex, 
+								 u32 Duration,
+								 u8 PaddingBits, u16 DegradationPriority)
+{
+	GF_Err e;
+	GF_ISOSample *od_sample = NULL;
+	GF_TrackFragmentBox *traf;
+	GF_TrackFragmentRunBox *trun;
+	if (!movie->moof || !(movie->FragmentsFlags & GF_ISOM_FRAG_WRITE_READY) || !sample) 
+		return GF_BAD_PARAM;
+
+	e = FragmentAddSampleEntry(movie, TrackID, sample, DescIndex, Duration, PaddingBits, DegradationPriority, &traf, &trun);
+	if (e) return e;
+
 	//rewrite OD frames
 	if (traf->trex->track->Media->handler->handlerType == GF_ISOM_MEDIA_OD) {
 		//this may fail if depandancies are not well done ...
@@ -1532,6 +1773,51 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, u32 TrackID, GF_ISOSample
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_isom_fragment_add_sample_from_track(GF_ISOFile *movie, u32 TrackID, GF_ISOSample *sample, u32 DescIndex, 
+								 u32 Duration, u8 PaddingBits, u16 DegradationPriority, 
+								 GF_ISOFile *orig, u32 track, u64 data_offset)
+{
+	GF_Err e;
+	u32 size;
+	char block[4096];
+	GF_DataMap *map;
+	GF_BitStream *bs;
+	GF_TrackBox *trak;
+	GF_TrackFragmentBox *traf;
+	GF_TrackFragmentRunBox *trun;
+	if (!movie->moof || !(movie->FragmentsFlags & GF_ISOM_FRAG_WRITE_READY) || !sample) 
+		return GF_BAD_PARAM;
+
+	/*data map opened by the last sample access on this track*/
+	trak = gf_isom_get_track_from_file(orig, track);
+	if (!trak || !trak->Media->information->dataHandler) return GF_BAD_PARAM;
+	map = trak->Media->information->dataHandler;
+
+	traf = GetTraf(movie, TrackID);
+	if (!traf) return GF_BAD_PARAM;
+	/*OD frames must be rewritten*/
+	if (traf->trex->track->Media->handler->handlerType == GF_ISOM_MEDIA_OD) return GF_BAD_PARAM;
+
+	e = FragmentAddSampleEntry(movie, TrackID, sample, DescIndex, Duration, PaddingBits, DegradationPriority, &traf, &trun);
+	if (e) return e;
+
+	if (!traf->DataCache) bs = movie->editFileMap->bs;
+	else if (trun->cache) bs = trun->cache;
+	else return GF_BAD_PARAM;
+
+	/*copy the sample by blocks*/
+	size = sample->dataLength;
+	while (size) {
+		u32 to_read = (size > sizeof(block)) ? sizeof(block) : size;
+		if (gf_isom_datamap_get_data(map, block, to_read, data_offset) != to_read) 
+			return GF_ISOM_INCOMPLETE_FILE;
+		gf_bs_write_data(bs, block, to_read);
+		data_offset += to_read;
+		size -= to_read;
+	}
+	return GF_OK;
+}
 
 
 GF_Err gf_isom_fragment_append_data(GF_ISOFile *movie, u32 TrackID, char *data, u32 data_size, u8 PaddingBits)
@@ -1760,6 +2046,18 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *the_file, u32 TrackID, GF_ISOSamp
 	return GF_NOT_SUPPORTED;
 }
 
+GF_Err gf_isom_fragment_add_sample_from_track(GF_ISOFile *movie, u32 TrackID, GF_ISOSample *sample, u32 DescIndex, 
+								 u32 Duration, u8 PaddingBits, u16 DegradationPriority, 
+								 GF_ISOFile *orig, u32 track, u64 data_offset)
+{
+	return GF_NOT_SUPPORTED;
+}
+
+GF_Err gf_isom_enable_segment_streaming(GF_ISOFile *movie, u32 nb_frags_hint, Bool use_sidx)
+{
+	return GF_NOT_SUPPORTED;
+}
+
 
 GF_EXPORT
 u32 gf_isom_is_track_fragmented(GF_ISOFile *the_file, u32 TrackID)
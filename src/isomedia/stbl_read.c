@@ -482,6 +482,28 @@ sample_found:
 	return GF_OK;
 }
 
+//same as above, also gets the number of samples from this sample to the end of its chunk
+GF_Err stbl_GetSampleRunInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *descIndex, u8 *isEdited, u32 *nb_samples)
+{
+	GF_Err e;
+	u32 chunkNumber;
+	GF_StscEntry *ent;
+
+	*nb_samples = 0;
+	e = stbl_GetSampleInfos(stbl, sampleNumber, offset, &chunkNumber, descIndex, isEdited);
+	if (e) return e;
+
+	//one sample per chunk
+	if (stbl->SampleToChunk->nb_entries == stbl->SampleSize->sampleCount) {
+		*nb_samples = 1;
+		return GF_OK;
+	}
+	//the cache is now on the chunk of our sample
+	ent = &stbl->SampleToChunk->entries[stbl->SampleToChunk->currentIndex];
+	*nb_samples = stbl->SampleToChunk->firstSampleInCurrentChunk + ent->samplesPerChunk - sampleNumber;
+	return GF_OK;
+}
+
 
 GF_Err stbl_GetSampleShadow(GF_ShadowSyncBox *stsh, u32 *sampleNumber, u32 *syncNum)
 {
@@ -1239,6 +1239,249 @@ GF_Err stbl_SampleSizeAppend(GF_SampleSizeBox *stsz, u32 data_size)
 	return GF_OK;
 }
 
+
+static GF_Err stbl_AddCTSRun(GF_CompositionOffsetBox *ctts, u32 offset, u32 count)
+{
+	if (!count) return GF_OK;
+	if (ctts->nb_entries && (ctts->entries[ctts->nb_entries-1].decodingOffset==offset)) {
+		ctts->entries[ctts->nb_entries-1].sampleCount += count;
+	} else {
+		if (ctts->alloc_size==ctts->nb_entries) {
+			ALLOC_INC(ctts->alloc_size);
+			ctts->entries = gf_realloc(ctts->entries, sizeof(GF_DttsEntry)*ctts->alloc_size);
+			if (!ctts->entries) return GF_OUT_OF_MEM;
+			memset(&ctts->entries[ctts->nb_entries], 0, sizeof(GF_DttsEntry)*(ctts->alloc_size-ctts->nb_entries) );
+		}
+		ctts->entries[ctts->nb_entries].decodingOffset = offset;
+		ctts->entries[ctts->nb_entries].sampleCount = count;
+		ctts->nb_entries++;
+	}
+	ctts->w_LastSampleNumber += count;
+	return GF_OK;
+}
+
+//appends a range of samples of another sample table: this gives the same tables as adding the samples one by one,
+//but works on the entries of the source tables (runs of durations, sizes, CTS offsets) instead of on each sample.
+//The destination must be in edit mode (1 sample per chunk) and the samples must be added in increasing DTS order
+GF_Err stbl_AppendSampleRange(GF_MediaBox *mdia, GF_SampleTableBox *src, u32 first_sample, u32 nb_samples, u32 StreamDescIndex, u64 data_offset)
+{
+	GF_Err e;
+	u32 i, j, k, n, left, size, delta, first_num, sampleNumber, nb_chunks;
+	u32 dependsOn, dependedOn, redundant;
+	u64 DTS, offset;
+	u8 isRAP, isEdited;
+	GF_SttsEntry *ent;
+	GF_StscEntry *sc_ent;
+	GF_SampleTableBox *stbl = mdia->information->sampleTable;
+	GF_TimeToSampleBox *stts = stbl->TimeToSample;
+	GF_SampleSizeBox *stsz = stbl->SampleSize;
+	GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+	GF_CompositionOffsetBox *src_ctts = src->CompositionOffset;
+	GF_SyncSampleBox *src_stss = src->SyncSample;
+	GF_ChunkOffsetBox *stco;
+	GF_ChunkLargeOffsetBox *co64;
+
+	if (!nb_samples) return GF_OK;
+	if (first_sample + nb_samples - 1 > src->SampleSize->sampleCount) return GF_BAD_PARAM;
+	first_num = stsz->sampleCount + 1;
+	if (stsc->nb_entries + 1 != first_num) return GF_BAD_PARAM;
+
+	//DTS: each run of samples with the same duration extends the last entry once the first sample of the run is added
+	e = stbl_GetSampleDTS(src->TimeToSample, first_sample, &DTS);
+	if (e) return e;
+	i = src->TimeToSample->r_currentEntryIndex;
+	if (i >= src->TimeToSample->nb_entries) return GF_ISOM_INVALID_FILE;
+	left = src->TimeToSample->r_FirstSampleInEntry + src->TimeToSample->entries[i].sampleCount - first_sample;
+	for (n=0; n<nb_samples; ) {
+		while (!left) {
+			i++;
+			if (i >= src->TimeToSample->nb_entries) return GF_ISOM_INVALID_FILE;
+			left = src->TimeToSample->entries[i].sampleCount;
+		}
+		delta = src->TimeToSample->entries[i].sampleDelta;
+		k = MIN(left, nb_samples - n);
+		left -= k;
+		n += k;
+		while (k) {
+			ent = stts->nb_entries ? &stts->entries[stts->nb_entries-1] : NULL;
+			if (ent && (ent->sampleDelta == delta) && (DTS == stts->w_LastDTS + delta)) {
+				ent->sampleCount += k;
+				stts->w_currentSampleNum += k;
+				stts->w_LastDTS = DTS + (u64) (k-1) * delta;
+				stts->r_FirstSampleInEntry = 0;
+				DTS += (u64) k * delta;
+				break;
+			}
+			e = stbl_AddDTS(stbl, DTS, &sampleNumber, mdia->mediaHeader->timeScale);
+			if (e) return e;
+			DTS += delta;
+			k--;
+		}
+	}
+
+	//sizes
+	if (src->SampleSize->sampleSize && !stsz->sizes && stsz->sampleCount && (stsz->sampleSize == src->SampleSize->sampleSize)) {
+		stsz->sampleCount += nb_samples;
+	} else {
+		n = 0;
+		//constant size until the first different one
+		while (!stsz->sizes && (n<nb_samples)) {
+			size = src->SampleSize->sampleSize ? src->SampleSize->sampleSize : src->SampleSize->sizes[first_sample + n - 1];
+			e = stbl_AddSize(stsz, stsz->sampleCount + 1, size);
+			if (e) return e;
+			n++;
+		}
+		if (n<nb_samples) {
+			if (!stsz->alloc_size) stsz->alloc_size = stsz->sampleCount;
+			if (stsz->sampleCount + nb_samples - n > stsz->alloc_size) {
+				while (stsz->sampleCount + nb_samples - n > stsz->alloc_size) ALLOC_INC(stsz->alloc_size);
+				stsz->sizes = gf_realloc(stsz->sizes, sizeof(u32)*stsz->alloc_size);
+				if (!stsz->sizes) return GF_OUT_OF_MEM;
+				memset(&stsz->sizes[stsz->sampleCount], 0, sizeof(u32)*(stsz->alloc_size - stsz->sampleCount) );
+			}
+			for (; n<nb_samples; n++) {
+				size = src->SampleSize->sampleSize ? src->SampleSize->sampleSize : src->SampleSize->sizes[first_sample + n - 1];
+				stsz->sizes[stsz->sampleCount] = size;
+				stsz->sampleCount++;
+			}
+		}
+	}
+
+	//CTS offsets: the table is only created with the first non-0 offset, previous samples getting a 0 offset
+	i = 0;
+	left = 0;
+	if (src_ctts) {
+		u32 cts;
+		stbl_GetSampleCTS(src_ctts, first_sample, &cts);
+		i = src_ctts->r_currentEntryIndex;
+		if (i < src_ctts->nb_entries) left = src_ctts->r_FirstSampleInEntry + src_ctts->entries[i].sampleCount - first_sample;
+	}
+	for (n=0; n<nb_samples; n+=k) {
+		u32 cts = 0;
+		k = nb_samples - n;
+		if (src_ctts && (i < src_ctts->nb_entries)) {
+			if (!left) {
+				i++;
+				if (i < src_ctts->nb_entries) left = src_ctts->entries[i].sampleCount;
+				k = 0;
+				continue;
+			}
+			cts = src_ctts->entries[i].decodingOffset;
+			k = MIN(left, k);
+			left -= k;
+		}
+		if (!cts && !stbl->CompositionOffset) continue;
+		if (!stbl->CompositionOffset) stbl->CompositionOffset = (GF_CompositionOffsetBox *) gf_isom_box_new(GF_ISOM_BOX_TYPE_CTTS);
+		if (stbl->CompositionOffset->w_LastSampleNumber < first_num + n - 1) {
+			e = stbl_AddCTSRun(stbl->CompositionOffset, 0, first_num + n - 1 - stbl->CompositionOffset->w_LastSampleNumber);
+			if (e) return e;
+		}
+		e = stbl_AddCTSRun(stbl->CompositionOffset, cts, k);
+		if (e) return e;
+	}
+
+	//sync samples, only needed when a non-sync sample is found
+	if (src_stss || src->SampleDep || stbl->SyncSample) {
+		//locate the first sync sample of the range
+		i = 0;
+		if (src_stss) {
+			j = src_stss->nb_entries;
+			while (i<j) {
+				k = (i+j)/2;
+				if (src_stss->sampleNumbers[k] < first_sample) i = k+1;
+				else j = k;
+			}
+		}
+		for (n=0; n<nb_samples; n++) {
+			sampleNumber = first_num + n;
+			isRAP = 1;
+			if (src_stss) {
+				while ((i<src_stss->nb_entries) && (src_stss->sampleNumbers[i] < first_sample + n)) i++;
+				isRAP = ((i<src_stss->nb_entries) && (src_stss->sampleNumbers[i] == first_sample + n)) ? 1 : 0;
+			}
+			//as done when reading samples
+			if (src->SampleDep && !stbl_GetSampleDepType(src->SampleDep, first_sample + n, &dependsOn, &dependedOn, &redundant)) {
+				if (dependsOn==1) isRAP = 0;
+				else if (dependsOn==2) isRAP = 1;
+				if ((dependedOn==2) && (redundant==1)) isRAP = 2;
+			}
+			if (isRAP) {
+				if (stbl->SyncSample) {
+					e = stbl_AddRAP(stbl->SyncSample, sampleNumber);
+					if (e) return e;
+				}
+				if (isRAP==2) {
+					e = stbl_AddRedundant(stbl, sampleNumber);
+					if (e) return e;
+				}
+			} else if (!stbl->SyncSample) {
+				stbl->SyncSample = (GF_SyncSampleBox *) gf_isom_box_new(GF_ISOM_BOX_TYPE_STSS);
+				for (j=1; j<sampleNumber; j++) {
+					e = stbl_AddRAP(stbl->SyncSample, j);
+					if (e) return e;
+				}
+			}
+		}
+	}
+
+	//chunks, one per sample - 32 bit offsets never overflow here, the caller leaves the switch to 64 bits to the per-sample path
+	offset = data_offset;
+	if (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
+		stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
+		nb_chunks = stco->nb_entries;
+		if (!stco->alloc_size) stco->alloc_size = stco->nb_entries;
+		if (stco->nb_entries + nb_samples > stco->alloc_size) {
+			while (stco->nb_entries + nb_samples > stco->alloc_size) ALLOC_INC(stco->alloc_size);
+			stco->offsets = (u32*)gf_realloc(stco->offsets, sizeof(u32) * stco->alloc_size);
+			if (!stco->offsets) return GF_OUT_OF_MEM;
+		}
+		for (n=0; n<nb_samples; n++) {
+			stco->offsets[stco->nb_entries] = (u32) offset;
+			stco->nb_entries++;
+			offset += src->SampleSize->sampleSize ? src->SampleSize->sampleSize : src->SampleSize->sizes[first_sample + n - 1];
+		}
+	} else {
+		co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
+		nb_chunks = co64->nb_entries;
+		if (!co64->alloc_size) co64->alloc_size = co64->nb_entries;
+		if (co64->nb_entries + nb_samples > co64->alloc_size) {
+			while (co64->nb_entries + nb_samples > co64->alloc_size) ALLOC_INC(co64->alloc_size);
+			co64->offsets = (u64*)gf_realloc(co64->offsets, sizeof(u64) * co64->alloc_size);
+			if (!co64->offsets) return GF_OUT_OF_MEM;
+		}
+		for (n=0; n<nb_samples; n++) {
+			co64->offsets[co64->nb_entries] = offset;
+			co64->nb_entries++;
+			offset += src->SampleSize->sampleSize ? src->SampleSize->sampleSize : src->SampleSize->sizes[first_sample + n - 1];
+		}
+	}
+	if (nb_chunks + 1 != first_num) return GF_BAD_PARAM;
+
+	isEdited = Media_IsSelfContained(mdia, StreamDescIndex) ? 1 : 0;
+	if (stsc->nb_entries + nb_samples > stsc->alloc_size) {
+		while (stsc->nb_entries + nb_samples > stsc->alloc_size) ALLOC_INC(stsc->alloc_size);
+		stsc->entries = gf_realloc(stsc->entries, sizeof(GF_StscEntry)*stsc->alloc_size);
+		if (!stsc->entries) return GF_OUT_OF_MEM;
+	}
+	if (stsc->nb_entries) stsc->entries[stsc->nb_entries-1].nextChunk = first_num;
+	for (n=0; n<nb_samples; n++) {
+		sc_ent = &stsc->entries[stsc->nb_entries];
+		sc_ent->isEdited = isEdited;
+		sc_ent->sampleDescriptionIndex = StreamDescIndex;
+		sc_ent->samplesPerChunk = 1;
+		sc_ent->firstChunk = first_num + n;
+		sc_ent->nextChunk = first_num + n + 1;
+		stsc->nb_entries++;
+	}
+	//last chunk and cache as set by stbl_AddChunkOffset
+	sc_ent->nextChunk = sc_ent->firstChunk;
+	stsc->currentIndex = stsc->nb_entries - 1;
+	stsc->firstSampleInCurrentChunk = sc_ent->firstChunk;
+	stsc->currentChunk = sc_ent->firstChunk;
+	stsc->ghostNumber = 1;
+	return GF_OK;
+}
+
 #endif	/*GPAC_DISABLE_ISOM_WRITE*/
 
 
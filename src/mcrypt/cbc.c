@@ -19,7 +19,7 @@
 
 #include <gpac/internal/crypt_dev.h>
 
-#if !defined(GPAC_CRYPT_ISMA_ONLY) && !defined(GPAC_DISABLE_MCRYPT)
+#if !defined(GPAC_DISABLE_MCRYPT)
 
 typedef struct cbc_buf {
 	u32 *previous_ciphertext;
@@ -147,6 +147,52 @@ static GF_Err _mdecrypt( CBC_BUFFER* buf, void *ciphertext, int len, int blocksi
 	return GF_OK;
 }
 
+static GF_Err _mcrypt_blocks( CBC_BUFFER* buf, void *plaintext, int len, int blocksize, void* akey, mcryptblocksfunc func, mcryptblocksfunc func2)
+{
+	u8 *plain = plaintext;
+	int dlen, j;
+
+	/*each block depends on the previous ciphertext*/
+	dlen = len / blocksize;
+	for (j = 0; j < dlen ; j++) {
+		memxor(plain, (u8 *) buf->previous_ciphertext, blocksize);
+		func(akey, plain, 1);
+		memcpy(buf->previous_ciphertext, plain, blocksize);
+		plain += blocksize;
+	}
+	if (j==0 && len!=0) return GF_BAD_PARAM;
+	return GF_OK;
+}
+
+/*number of blocks decrypted per call of the algo*/
+#define CBC_NB_BLOCKS	64
+
+static GF_Err _mdecrypt_blocks( CBC_BUFFER* buf, void *ciphertext, int len, int blocksize, void* akey, mcryptblocksfunc func, mcryptblocksfunc func2)
+{
+	u8 saved[CBC_NB_BLOCKS*32];
+	u8 *cipher = ciphertext;
+	int i, dlen, nb_blocks;
+
+	if (blocksize > 32) return GF_NOT_SUPPORTED;
+	dlen = len / blocksize;
+	if (!dlen && len) return GF_BAD_PARAM;
+
+	/*blocks are decrypted independently, then xored with the previous ciphertext*/
+	while (dlen) {
+		nb_blocks = (dlen > CBC_NB_BLOCKS) ? CBC_NB_BLOCKS : dlen;
+		memcpy(saved, cipher, nb_blocks*blocksize);
+		func2(akey, cipher, nb_blocks);
+		memxor(cipher, (u8 *) buf->previous_ciphertext, blocksize);
+		for (i = 1; i < nb_blocks; i++) {
+			memxor(cipher + i*blocksize, saved + (i-1)*blocksize, blocksize);
+		}
+		memcpy(buf->previous_ciphertext, saved + (nb_blocks-1)*blocksize, blocksize);
+		cipher += nb_blocks*blocksize;
+		dlen -= nb_blocks;
+	}
+	return GF_OK;
+}
+
 void gf_crypt_register_cbc(GF_Crypt *td)
 {
 	td->mode_name = "CBC";
@@ -156,6 +202,8 @@ void gf_crypt_register_cbc(GF_Crypt *td)
 	td->_mdecrypt = _mdecrypt;
 	td->_mcrypt_get_state = _mcrypt_get_state;
 	td->_mcrypt_set_state = _mcrypt_set_state;
+	td->_mcrypt_blocks = _mcrypt_blocks;
+	td->_mdecrypt_blocks = _mdecrypt_blocks;
 
 	td->has_IV = 1;
 	td->is_block_mode = 1;
@@ -164,4 +212,4 @@ void gf_crypt_register_cbc(GF_Crypt *td)
 	td->mode_version = 20010801;
 }
 
-#endif /*!defined(GPAC_CRYPT_ISMA_ONLY) && !defined(GPAC_DISABLE_MCRYPT)*/
+#endif /*!defined(GPAC_DISABLE_MCRYPT)*/
@@ -218,6 +218,54 @@ GF_Err _mdecrypt(void * buf,void *plaintext, int len, int blocksize, void* akey,
 	return _mcrypt( buf, plaintext, len, blocksize, akey, func, func2);
 }
 
+/*number of counter blocks encrypted per call of the algo*/
+#define CTR_NB_BLOCKS	64
+
+static GF_Err _mcrypt_blocks(void * _buf, void *plaintext, int len, int blocksize, void* akey, mcryptblocksfunc func, mcryptblocksfunc func2)
+{				/* plaintext can be any size */
+	u8 keystream[CTR_NB_BLOCKS*32];
+	u8 *plain = (u8 *)plaintext;
+	CTR_BUFFER *buf = (CTR_BUFFER *)_buf;
+	int i, nb_blocks;
+
+	if (blocksize > 32) return GF_NOT_SUPPORTED;
+
+	/*end of the current counter block*/
+	if (buf->c_counter_pos) {
+		int size = blocksize - buf->c_counter_pos;
+		if (size > len) size = len;
+		memxor(plain, &buf->enc_counter[buf->c_counter_pos], size);
+		buf->c_counter_pos += size;
+		plain += size;
+		len -= size;
+		if (buf->c_counter_pos < blocksize) return GF_OK;
+		increase_counter(buf->c_counter, blocksize);
+		buf->c_counter_pos = 0;
+	}
+
+	while (len >= blocksize) {
+		nb_blocks = len / blocksize;
+		if (nb_blocks > CTR_NB_BLOCKS) nb_blocks = CTR_NB_BLOCKS;
+		for (i = 0; i < nb_blocks; i++) {
+			memcpy(&keystream[i*blocksize], buf->c_counter, blocksize);
+			increase_counter(buf->c_counter, blocksize);
+		}
+		func(akey, keystream, nb_blocks);
+		memxor(plain, keystream, nb_blocks*blocksize);
+		plain += nb_blocks*blocksize;
+		len -= nb_blocks*blocksize;
+	}
+
+	/*start of the next counter block, the counter is increased once the block is used*/
+	if (len) {
+		memcpy(buf->enc_counter, buf->c_counter, blocksize);
+		func(akey, buf->enc_counter, 1);
+		memxor(plain, buf->enc_counter, len);
+		buf->c_counter_pos = len;
+	}
+	return GF_OK;
+}
+
 void gf_crypt_register_ctr(GF_Crypt *td)
 {
 	td->mode_name = "CTR";
@@ -227,6 +275,9 @@ void gf_crypt_register_ctr(GF_Crypt *td)
 	td->_mdecrypt = _mdecrypt;
 	td->_mcrypt_get_state = _mcrypt_get_state;
 	td->_mcrypt_set_state = _mcrypt_set_state;
+	/*encryption and decryption are the same in CTR*/
+	td->_mcrypt_blocks = _mcrypt_blocks;
+	td->_mdecrypt_blocks = _mcrypt_blocks;
 
 	td->has_IV = 1;
 	td->is_block_mode = 1;
@@ -42,8 +42,8 @@ static Bool gf_crypt_assign_algo(GF_Crypt *td, const char *algorithm)
 static Bool gf_crypt_assign_mode(GF_Crypt *td, const char *mode)
 {
 	if (!stricmp(mode, "CTR")) { gf_crypt_register_ctr(td); return 1; }
-#ifndef GPAC_CRYPT_ISMA_ONLY
 	else if (!stricmp(mode, "CBC")) { gf_crypt_register_cbc(td); return 1; }
+#ifndef GPAC_CRYPT_ISMA_ONLY
 	else if (!stricmp(mode, "CFB")) { gf_crypt_register_cfb(td); return 1; }
 	else if (!stricmp(mode, "ECB")) { gf_crypt_register_ecb(td); return 1; }
 	else if (!stricmp(mode, "nCFB")) { gf_crypt_register_ncfb(td); return 1; }
@@ -255,6 +255,8 @@ GF_EXPORT
 GF_Err gf_crypt_encrypt(GF_Crypt *td, void *plaintext, int len)
 {
 	if (!td) return GF_BAD_PARAM;
+	if (td->_mcrypt_blocks && td->a_encrypt_blocks)
+		return td->_mcrypt_blocks(td->abuf, plaintext, len, gf_crypt_get_block_size(td), td->akey, (mcryptblocksfunc) td->a_encrypt_blocks, (mcryptblocksfunc) td->a_decrypt_blocks);
 	return td->_mcrypt(td->abuf, plaintext, len, gf_crypt_get_block_size(td), td->akey, (mcryptfunc) td->a_encrypt, (mcryptfunc) td->a_decrypt);
 }
 
@@ -262,6 +264,8 @@ GF_EXPORT
 GF_Err gf_crypt_decrypt(GF_Crypt *td, void *ciphertext, int len)
 {
 	if (!td) return GF_BAD_PARAM;
+	if (td->_mdecrypt_blocks && td->a_encrypt_blocks && td->a_decrypt_blocks)
+		return td->_mdecrypt_blocks(td->abuf, ciphertext, len, gf_crypt_get_block_size(td), td->akey, (mcryptblocksfunc) td->a_encrypt_blocks, (mcryptblocksfunc) td->a_decrypt_blocks);
 	return td->_mdecrypt(td->abuf, ciphertext, len, gf_crypt_get_block_size(td), td->akey, (mcryptfunc) td->a_encrypt, (mcryptfunc) td->a_decrypt);
 }
 
@@ -25,11 +25,25 @@
 
 #if !defined(GPAC_DISABLE_MCRYPT)
 
+/*AES-NI instructions, used when the CPU supports them*/
+#if !defined(GPAC_DISABLE_AESNI) && (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define GPAC_HAS_AESNI
+#define AESNI_FUNC __attribute__((target("aes,sse2")))
+#include <wmmintrin.h>
+#include <cpuid.h>
+#elif !defined(GPAC_DISABLE_AESNI) && defined(_MSC_VER) && (_MSC_VER >= 1600) && (defined(_M_X64) || defined(_M_IX86))
+#define GPAC_HAS_AESNI
+#define AESNI_FUNC
+#include <wmmintrin.h>
+#include <intrin.h>
+#endif
+
 typedef struct rijndael_instance {
 	int Nk,Nb,Nr;
 	u8 fi[24],ri[24];
 	u32 fkey[120];
 	u32 rkey[120];
+	int use_aesni;
 } RI;
 
 /* rotates x one bit to the left */
@@ -51,8 +65,14 @@ static u8 rbsub[256];
 static u8 ptab[256], ltab[256];
 static u32 ftable[256];
 static u32 rtable[256];
+/*ftable and rtable pre-rotated by 8, 16 and 24 bits*/
+static u32 ftable1[256], ftable2[256], ftable3[256];
+static u32 rtable1[256], rtable2[256], rtable3[256];
 static u32 rco[30];
 static int tables_ok = 0;
+#ifdef GPAC_HAS_AESNI
+static int aesni_ok = -1;
+#endif
 /* Parameter-dependent data */
 
 /* in "rijndael.h" */
@@ -195,8 +215,97 @@ static void _mcrypt_rijndael_gentables(void)
 		b[0] = bmul(InCo[3], y);
 		rtable[i] = pack(b);
 	}
+	for (i = 0; i < 256; i++) {
+		ftable1[i] = ROTL8(ftable[i]);
+		ftable2[i] = ROTL16(ftable[i]);
+		ftable3[i] = ROTL24(ftable[i]);
+		rtable1[i] = ROTL8(rtable[i]);
+		rtable2[i] = ROTL16(rtable[i]);
+		rtable3[i] = ROTL24(rtable[i]);
+	}
+}
+
+#ifdef GPAC_HAS_AESNI
+static int _mcrypt_rijndael_has_aesni(void)
+{
+	if (aesni_ok < 0) {
+#if defined(_MSC_VER)
+		int regs[4];
+		__cpuid(regs, 1);
+		aesni_ok = ((regs[2] & (1<<25)) && (regs[3] & (1<<26))) ? 1 : 0;
+#else
+		unsigned int a, b, c, d;
+		aesni_ok = (__get_cpuid(1, &a, &b, &c, &d) && (c & (1<<25)) && (d & (1<<26))) ? 1 : 0;
+#endif
+	}
+	return aesni_ok;
+}
+
+/*round keys are stored as little-endian words, which is the byte order AES-NI expects. The decryption keys
+are the ones of the equivalent inverse cipher, as used by AESDEC*/
+AESNI_FUNC static void _mcrypt_aesni_encrypt_blocks(RI * rinst, u8 * buff, int nb_blocks)
+{
+	int i, r, nr = rinst->Nr;
+	__m128i rk[15], b0, b1, b2, b3;
+
+	for (r = 0; r <= nr; r++) rk[r] = _mm_loadu_si128((const __m128i *) &rinst->fkey[4*r]);
+
+	/*4 blocks at once to hide the latency of AESENC*/
+	for (i = 0; i + 4 <= nb_blocks; i += 4, buff += 64) {
+		b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) buff), rk[0]);
+		b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (buff+16)), rk[0]);
+		b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (buff+32)), rk[0]);
+		b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (buff+48)), rk[0]);
+		for (r = 1; r < nr; r++) {
+			b0 = _mm_aesenc_si128(b0, rk[r]);
+			b1 = _mm_aesenc_si128(b1, rk[r]);
+			b2 = _mm_aesenc_si128(b2, rk[r]);
+			b3 = _mm_aesenc_si128(b3, rk[r]);
+		}
+		_mm_storeu_si128((__m128i *) buff, _mm_aesenclast_si128(b0, rk[nr]));
+		_mm_storeu_si128((__m128i *) (buff+16), _mm_aesenclast_si128(b1, rk[nr]));
+		_mm_storeu_si128((__m128i *) (buff+32), _mm_aesenclast_si128(b2, rk[nr]));
+		_mm_storeu_si128((__m128i *) (buff+48), _mm_aesenclast_si128(b3, rk[nr]));
+	}
+	for (; i < nb_blocks; i++, buff += 16) {
+		b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) buff), rk[0]);
+		for (r = 1; r < nr; r++) b0 = _mm_aesenc_si128(b0, rk[r]);
+		_mm_storeu_si128((__m128i *) buff, _mm_aesenclast_si128(b0, rk[nr]));
+	}
 }
 
+AESNI_FUNC static void _mcrypt_aesni_decrypt_blocks(RI * rinst, u8 * buff, int nb_blocks)
+{
+	int i, r, nr = rinst->Nr;
+	__m128i rk[15], b0, b1, b2, b3;
+
+	for (r = 0; r <= nr; r++) rk[r] = _mm_loadu_si128((const __m128i *) &rinst->rkey[4*r]);
+
+	for (i = 0; i + 4 <= nb_blocks; i += 4, buff += 64) {
+		b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) buff), rk[0]);
+		b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (buff+16)), rk[0]);
+		b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (buff+32)), rk[0]);
+		b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (buff+48)), rk[0]);
+		for (r = 1; r < nr; r++) {
+			b0 = _mm_aesdec_si128(b0, rk[r]);
+			b1 = _mm_aesdec_si128(b1, rk[r]);
+			b2 = _mm_aesdec_si128(b2, rk[r]);
+			b3 = _mm_aesdec_si128(b3, rk[r]);
+		}
+		_mm_storeu_si128((__m128i *) buff, _mm_aesdeclast_si128(b0, rk[nr]));
+		_mm_storeu_si128((__m128i *) (buff+16), _mm_aesdeclast_si128(b1, rk[nr]));
+		_mm_storeu_si128((__m128i *) (buff+32), _mm_aesdeclast_si128(b2, rk[nr]));
+		_mm_storeu_si128((__m128i *) (buff+48), _mm_aesdeclast_si128(b3, rk[nr]));
+	}
+	for (; i < nb_blocks; i++, buff += 16) {
+		b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) buff), rk[0]);
+		for (r = 1; r < nr; r++) b0 = _mm_aesdec_si128(b0, rk[r]);
+		_mm_storeu_si128((__m128i *) buff, _mm_aesdeclast_si128(b0, rk[nr]));
+	}
+}
+#endif
+
+
 static int _mcrypt_set_key(RI * rinst, u8 * key, int nk)
 {				/* blocksize=32*nb bits. Key=32*nk bits */
 	/* currently nb,bk = 4, 6 or 8          */
@@ -296,105 +405,128 @@ static int _mcrypt_set_key(RI * rinst, u8 * key, int nk)
 	}
 	for (j = N - rinst->Nb; j < N; j++)
 		rinst->rkey[j - N + rinst->Nb] = rinst->fkey[j];
+
+#ifdef GPAC_HAS_AESNI
+	rinst->use_aesni = _mcrypt_rijndael_has_aesni();
+#else
+	rinst->use_aesni = 0;
+#endif
 	return 0;
 }
 
 
-/* There is an obvious time/space trade-off possible here.     *
- * Instead of just one ftable[], I could have 4, the other     *
- * 3 pre-rotated to save the ROTL8, ROTL16 and ROTL24 overhead */
+/* The block size is fixed to 128 bits (Nb=4): the rounds are unrolled with
+ * the values of fi[] hard-coded, and use the 4 pre-rotated tables        */
 
 static  void _mcrypt_encrypt(RI * rinst, u8 * buff)
 {
-	int i, j, k, m;
-	u32 a[8], b[8], *x, *y, *t;
+	int i;
+	u32 a0, a1, a2, a3, b0, b1, b2, b3;
+	u32 *k = rinst->fkey;
 
-	for (i = j = 0; i < rinst->Nb; i++, j += 4) {
-		a[i] = pack(&buff[j]);
-		a[i] ^= rinst->fkey[i];
+#ifdef GPAC_HAS_AESNI
+	if (rinst->use_aesni) {
+		_mcrypt_aesni_encrypt_blocks(rinst, buff, 1);
+		return;
 	}
-	k = rinst->Nb;
-	x = a;
-	y = b;
+#endif
+	a0 = pack(&buff[0]) ^ k[0];
+	a1 = pack(&buff[4]) ^ k[1];
+	a2 = pack(&buff[8]) ^ k[2];
+	a3 = pack(&buff[12]) ^ k[3];
+	k += 4;
 
-/* State alternates between a and b */
 	for (i = 1; i < rinst->Nr; i++) {	/* rinst->Nr is number of rounds. May be odd. */
-
-/* if rinst->Nb is fixed - unroll this next 
-   loop and hard-code in the values of fi[]  */
-
-		for (m = j = 0; j < rinst->Nb; j++, m += 3) {	/* deal with each 32-bit element of the State */
-			/* This is the time-critical bit */
-			y[j] = rinst->fkey[k++] ^ ftable[(u8) x[j]] ^
-			    ROTL8(ftable[(u8) (x[rinst->fi[m]] >> 8)]) ^
-			    ROTL16(ftable
-				   [(u8) (x[rinst->fi[m + 1]] >> 16)]) ^
-			    ROTL24(ftable[x[rinst->fi[m + 2]] >> 24]);
-		}
-		t = x;
-		x = y;
-		y = t;		/* swap pointers */
+		b0 = k[0] ^ ftable[(u8) a0] ^ ftable1[(u8) (a1 >> 8)] ^ ftable2[(u8) (a2 >> 16)] ^ ftable3[a3 >> 24];
+		b1 = k[1] ^ ftable[(u8) a1] ^ ftable1[(u8) (a2 >> 8)] ^ ftable2[(u8) (a3 >> 16)] ^ ftable3[a0 >> 24];
+		b2 = k[2] ^ ftable[(u8) a2] ^ ftable1[(u8) (a3 >> 8)] ^ ftable2[(u8) (a0 >> 16)] ^ ftable3[a1 >> 24];
+		b3 = k[3] ^ ftable[(u8) a3] ^ ftable1[(u8) (a0 >> 8)] ^ ftable2[(u8) (a1 >> 16)] ^ ftable3[a2 >> 24];
+		a0 = b0;
+		a1 = b1;
+		a2 = b2;
+		a3 = b3;
+		k += 4;
 	}
 
-/* Last Round - unroll if possible */
-	for (m = j = 0; j < rinst->Nb; j++, m += 3) {
-		y[j] = rinst->fkey[k++] ^ (u32) fbsub[(u8) x[j]] ^
-		    ROTL8((u32) fbsub[(u8) (x[rinst->fi[m]] >> 8)]) ^
-		    ROTL16((u32)
-			   fbsub[(u8) (x[rinst->fi[m + 1]] >> 16)]) ^
-		    ROTL24((u32) fbsub[x[rinst->fi[m + 2]] >> 24]);
-	}
-	for (i = j = 0; i < rinst->Nb; i++, j += 4) {
-		unpack(y[i], &buff[j]);
-		x[i] = y[i] = 0;	/* clean up stack */
-	}
-	return;
+/* Last Round */
+	b0 = k[0] ^ (u32) fbsub[(u8) a0] ^ ((u32) fbsub[(u8) (a1 >> 8)] << 8) ^ ((u32) fbsub[(u8) (a2 >> 16)] << 16) ^ ((u32) fbsub[a3 >> 24] << 24);
+	b1 = k[1] ^ (u32) fbsub[(u8) a1] ^ ((u32) fbsub[(u8) (a2 >> 8)] << 8) ^ ((u32) fbsub[(u8) (a3 >> 16)] << 16) ^ ((u32) fbsub[a0 >> 24] << 24);
+	b2 = k[2] ^ (u32) fbsub[(u8) a2] ^ ((u32) fbsub[(u8) (a3 >> 8)] << 8) ^ ((u32) fbsub[(u8) (a0 >> 16)] << 16) ^ ((u32) fbsub[a1 >> 24] << 24);
+	b3 = k[3] ^ (u32) fbsub[(u8) a3] ^ ((u32) fbsub[(u8) (a0 >> 8)] << 8) ^ ((u32) fbsub[(u8) (a1 >> 16)] << 16) ^ ((u32) fbsub[a2 >> 24] << 24);
+	unpack(b0, &buff[0]);
+	unpack(b1, &buff[4]);
+	unpack(b2, &buff[8]);
+	unpack(b3, &buff[12]);
 }
 
 static  void _mcrypt_decrypt(RI * rinst, u8 * buff)
 {
-	int i, j, k, m;
-	u32 a[8], b[8], *x, *y, *t;
+	int i;
+	u32 a0, a1, a2, a3, b0, b1, b2, b3;
+	u32 *k = rinst->rkey;
 
-	for (i = j = 0; i < rinst->Nb; i++, j += 4) {
-		a[i] = pack(&buff[j]);
-		a[i] ^= rinst->rkey[i];
+#ifdef GPAC_HAS_AESNI
+	if (rinst->use_aesni) {
+		_mcrypt_aesni_decrypt_blocks(rinst, buff, 1);
+		return;
 	}
-	k = rinst->Nb;
-	x = a;
-	y = b;
+#endif
+	a0 = pack(&buff[0]) ^ k[0];
+	a1 = pack(&buff[4]) ^ k[1];
+	a2 = pack(&buff[8]) ^ k[2];
+	a3 = pack(&buff[12]) ^ k[3];
+	k += 4;
 
-/* State alternates between a and b */
 	for (i = 1; i < rinst->Nr; i++) {	/* rinst->Nr is number of rounds. May be odd. */
+		b0 = k[0] ^ rtable[(u8) a0] ^ rtable1[(u8) (a3 >> 8)] ^ rtable2[(u8) (a2 >> 16)] ^ rtable3[a1 >> 24];
+		b1 = k[1] ^ rtable[(u8) a1] ^ rtable1[(u8) (a0 >> 8)] ^ rtable2[(u8) (a3 >> 16)] ^ rtable3[a2 >> 24];
+		b2 = k[2] ^ rtable[(u8) a2] ^ rtable1[(u8) (a1 >> 8)] ^ rtable2[(u8) (a0 >> 16)] ^ rtable3[a3 >> 24];
+		b3 = k[3] ^ rtable[(u8) a3] ^ rtable1[(u8) (a2 >> 8)] ^ rtable2[(u8) (a1 >> 16)] ^ rtable3[a0 >> 24];
+		a0 = b0;
+		a1 = b1;
+		a2 = b2;
+		a3 = b3;
+		k += 4;
+	}
 
-/* if rinst->Nb is fixed - unroll this next 
-   loop and hard-code in the values of ri[]  */
+/* Last Round */
+	b0 = k[0] ^ (u32) rbsub[(u8) a0] ^ ((u32) rbsub[(u8) (a3 >> 8)] << 8) ^ ((u32) rbsub[(u8) (a2 >> 16)] << 16) ^ ((u32) rbsub[a1 >> 24] << 24);
+	b1 = k[1] ^ (u32) rbsub[(u8) a1] ^ ((u32) rbsub[(u8) (a0 >> 8)] << 8) ^ ((u32) rbsub[(u8) (a3 >> 16)] << 16) ^ ((u32) rbsub[a2 >> 24] << 24);
+	b2 = k[2] ^ (u32) rbsub[(u8) a2] ^ ((u32) rbsub[(u8) (a1 >> 8)] << 8) ^ ((u32) rbsub[(u8) (a0 >> 16)] << 16) ^ ((u32) rbsub[a3 >> 24] << 24);
+	b3 = k[3] ^ (u32) rbsub[(u8) a3] ^ ((u32) rbsub[(u8) (a2 >> 8)] << 8) ^ ((u32) rbsub[(u8) (a1 >> 16)] << 16) ^ ((u32) rbsub[a0 >> 24] << 24);
+	unpack(b0, &buff[0]);
+	unpack(b1, &buff[4]);
+	unpack(b2, &buff[8]);
+	unpack(b3, &buff[12]);
+}
 
-		for (m = j = 0; j < rinst->Nb; j++, m += 3) {	/* This is the time-critical bit */
-			y[j] = rinst->rkey[k++] ^ rtable[(u8) x[j]] ^
-			    ROTL8(rtable[(u8) (x[rinst->ri[m]] >> 8)]) ^
-			    ROTL16(rtable
-				   [(u8) (x[rinst->ri[m + 1]] >> 16)]) ^
-			    ROTL24(rtable[x[rinst->ri[m + 2]] >> 24]);
-		}
-		t = x;
-		x = y;
-		y = t;		/* swap pointers */
+/*several consecutive blocks, in place*/
+static void _mcrypt_encrypt_blocks(RI * rinst, u8 * buff, int nb_blocks)
+{
+#ifdef GPAC_HAS_AESNI
+	if (rinst->use_aesni) {
+		_mcrypt_aesni_encrypt_blocks(rinst, buff, nb_blocks);
+		return;
+	}
+#endif
+	while (nb_blocks--) {
+		_mcrypt_encrypt(rinst, buff);
+		buff += 16;
 	}
+}
 
-/* Last Round - unroll if possible */
-	for (m = j = 0; j < rinst->Nb; j++, m += 3) {
-		y[j] = rinst->rkey[k++] ^ (u32) rbsub[(u8) x[j]] ^
-		    ROTL8((u32) rbsub[(u8) (x[rinst->ri[m]] >> 8)]) ^
-		    ROTL16((u32)
-			   rbsub[(u8) (x[rinst->ri[m + 1]] >> 16)]) ^
-		    ROTL24((u32) rbsub[x[rinst->ri[m + 2]] >> 24]);
+static void _mcrypt_decrypt_blocks(RI * rinst, u8 * buff, int nb_blocks)
+{
+#ifdef GPAC_HAS_AESNI
+	if (rinst->use_aesni) {
+		_mcrypt_aesni_decrypt_blocks(rinst, buff, nb_blocks);
+		return;
 	}
-	for (i = j = 0; i < rinst->Nb; i++, j += 4) {
-		unpack(y[i], &buff[j]);
-		x[i] = y[i] = 0;	/* clean up stack */
+#endif
+	while (nb_blocks--) {
+		_mcrypt_decrypt(rinst, buff);
+		buff += 16;
 	}
-	return;
 }
 
 void gf_crypt_register_rijndael_128(GF_Crypt *td)
@@ -402,6 +534,8 @@ void gf_crypt_register_rijndael_128(GF_Crypt *td)
 	td->a_encrypt = (void *)_mcrypt_encrypt;
 	td->a_decrypt = (void *)_mcrypt_decrypt;
 	td->a_set_key = (void *)_mcrypt_set_key;
+	td->a_encrypt_blocks = (void *)_mcrypt_encrypt_blocks;
+	td->a_decrypt_blocks = (void *)_mcrypt_decrypt_blocks;
 	td->algo_name = "Rijndael-128";
 	td->algo_version = 20010801;
 	td->num_key_sizes = 3;
@@ -98,6 +98,116 @@ const char *gf_m4v_get_profile_name(u8 video_pl)
 	}
 }
 
+/*
+	start code search, shared by AVC, MPEG-1/2/4 video, H263 and TS reframers
+*/
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GF_SC_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP>=2))
+#include <emmintrin.h>
+#define GF_SC_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GF_SC_SIMD_NEON
+#endif
+
+#if defined(GF_SC_SIMD_AVX2) || defined(GF_SC_SIMD_SSE2) || defined(GF_SC_SIMD_NEON)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+/*index of lowest set bit, mask is never 0*/
+static GFINLINE u32 sc_first_bit(u64 mask)
+{
+#if defined(__GNUC__)
+	return (u32) __builtin_ctzll(mask);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long idx;
+	_BitScanForward64(&idx, mask);
+	return (u32) idx;
+#else
+	u32 idx = 0;
+	while (!(mask & 1)) { mask >>= 1; idx++; }
+	return idx;
+#endif
+}
+#endif
+
+GF_EXPORT
+u32 gf_media_next_start_code_ex(const u8 *data, u32 size, u8 sc_mask, u8 sc_value)
+{
+	u32 pos = 0;
+	u8 c;
+
+#if defined(GF_SC_SIMD_AVX2)
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i vmask = _mm256_set1_epi8((char) sc_mask);
+	const __m256i vval = _mm256_set1_epi8((char) sc_value);
+	while (pos + 34 <= size) {
+		__m256i b0 = _mm256_loadu_si256((const __m256i *) (data+pos));
+		__m256i b1 = _mm256_loadu_si256((const __m256i *) (data+pos+1));
+		__m256i b2 = _mm256_loadu_si256((const __m256i *) (data+pos+2));
+		__m256i m = _mm256_and_si256(_mm256_cmpeq_epi8(b0, zero), _mm256_cmpeq_epi8(b1, zero));
+		u32 bits = (u32) _mm256_movemask_epi8(m);
+		if (bits) {
+			bits &= (u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(b2, vmask), vval));
+			if (bits) return pos + sc_first_bit(bits);
+		}
+		pos += 32;
+	}
+#elif defined(GF_SC_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i vmask = _mm_set1_epi8((char) sc_mask);
+	const __m128i vval = _mm_set1_epi8((char) sc_value);
+	while (pos + 18 <= size) {
+		__m128i b0 = _mm_loadu_si128((const __m128i *) (data+pos));
+		__m128i b1 = _mm_loadu_si128((const __m128i *) (data+pos+1));
+		u32 bits = (u32) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)));
+		if (bits) {
+			__m128i b2 = _mm_loadu_si128((const __m128i *) (data+pos+2));
+			bits &= (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(b2, vmask), vval));
+			if (bits) return pos + sc_first_bit(bits);
+		}
+		pos += 16;
+	}
+#elif defined(GF_SC_SIMD_NEON)
+	const uint8x16_t vmask = vdupq_n_u8(sc_mask);
+	const uint8x16_t vval = vdupq_n_u8(sc_value);
+	while (pos + 18 <= size) {
+		uint8x16_t b0 = vld1q_u8(data+pos);
+		uint8x16_t b1 = vld1q_u8(data+pos+1);
+		uint8x16_t b2 = vld1q_u8(data+pos+2);
+		uint8x16_t m = vandq_u8(vceqq_u8(vorrq_u8(b0, b1), vdupq_n_u8(0)), vceqq_u8(vandq_u8(b2, vmask), vval));
+		/*narrow each byte of the match mask to 4 bits*/
+		u64 bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+		if (bits) return pos + (sc_first_bit(bits)>>2);
+		pos += 16;
+	}
+#endif
+
+	/*scalar search (and tail of the vector search): test the third byte first so that we can skip
+	up to 3 bytes at once in non-null data*/
+	while (pos + 2 < size) {
+		c = data[pos+2];
+		if (c) {
+			if (((c & sc_mask) == sc_value) && !data[pos] && !data[pos+1]) return pos;
+			/*non-null third byte cannot be part of a prefix starting at pos+1 or pos+2*/
+			pos += 3;
+			continue;
+		}
+		if (!sc_value && !data[pos] && !data[pos+1]) return pos;
+		pos += data[pos+1] ? 2 : 1;
+	}
+	return size;
+}
+
+GF_EXPORT
+u32 gf_media_next_start_code(const u8 *data, u32 size)
+{
+	return gf_media_next_start_code_ex(data, size, 0xFF, 0x01);
+}
+
 
 #ifndef GPAC_DISABLE_AV_PARSERS
 
@@ -114,24 +224,15 @@ const char *gf_m4v_get_profile_name(u8 video_pl)
 
 s32 gf_mv12_next_start_code(unsigned char *pbuffer, u32 buflen, u32 *optr, u32 *scode)
 {
-  u32 value;
-  u32 offset;
-
-  if (buflen < 4) return -1;
-  for (offset = 0; offset < buflen - 3; offset++, pbuffer++) {
-#ifdef GPAC_BIG_ENDIAN
-	value = *(u32 *)pbuffer >> 8;
-#else
-	value = (pbuffer[0] << 16) | (pbuffer[1] << 8) | (pbuffer[2] << 0); 
-#endif
+	u32 offset;
 
-	if (value == MPEG12_START_CODE_PREFIX) {
-	  *optr = offset;
-	  *scode = (value << 8) | pbuffer[3];
-	  return 0;
-	}
-  }
-  return -1;
+	if (buflen < 4) return -1;
+	/*the start code value byte must be in the buffer*/
+	offset = gf_media_next_start_code(pbuffer, buflen - 1);
+	if (offset == buflen - 1) return -1;
+	*optr = offset;
+	*scode = (MPEG12_START_CODE_PREFIX << 8) | pbuffer[offset+3];
+	return 0;
 }
 
 s32 gf_mv12_next_slice_start(unsigned char *pbuffer, u32 startoffset, u32 buflen, u32 *slice_offset)
@@ -1471,31 +1572,36 @@ u32 AVC_IsStartCode(GF_BitStream *bs)
 #define AVC_CACHE_SIZE	4096
 u32 AVC_NextStartCode(GF_BitStream *bs)
 {
-	u32 v, bpos;
-	char avc_cache[AVC_CACHE_SIZE];
+	u32 avail, sc_pos;
+	u8 avc_cache[AVC_CACHE_SIZE];
 	u64 end, cache_start, load_size;
 	u64 start = gf_bs_get_position(bs);
 	if (start<3) return 0;
 	
-	load_size = 0;
-	bpos = 0;
-	cache_start = 0;
+	avail = 0;
+	cache_start = start;
 	end = 0;
-	v = 0xffffffff;
-	while (!end) {
+	while (1) {
 		/*refill cache*/
-		if (bpos == (u32) load_size) {
-			if (!gf_bs_available(bs)) break;
-			load_size = gf_bs_available(bs);
-			if (load_size>AVC_CACHE_SIZE) load_size=AVC_CACHE_SIZE;
-			bpos = 0;
-			cache_start = gf_bs_get_position(bs);
-			gf_bs_read_data(bs, avc_cache, (u32) load_size);
+		load_size = gf_bs_available(bs);
+		if (!load_size) break;
+		if (load_size > AVC_CACHE_SIZE - avail) load_size = AVC_CACHE_SIZE - avail;
+		gf_bs_read_data(bs, (char *) avc_cache + avail, (u32) load_size);
+		avail += (u32) load_size;
+
+		sc_pos = gf_media_next_start_code(avc_cache, avail);
+		if (sc_pos < avail) {
+			end = cache_start + sc_pos;
+			/*0x00000001 start code*/
+			if (sc_pos && !avc_cache[sc_pos-1]) end--;
+			break;
+		}
+		/*keep the last 3 bytes so that start codes spanning two loads are detected*/
+		if (avail > 3) {
+			memmove(avc_cache, avc_cache + avail - 3, 3);
+			cache_start += avail - 3;
+			avail = 3;
 		}
-		v = ( (v<<8) & 0xFFFFFF00) | ((u32) avc_cache[bpos]);
-		bpos++;
-		if (v == 0x00000001) end = cache_start+bpos-4;
-		else if ( (v & 0x00FFFFFF) == 0x00000001) end = cache_start+bpos-3;
 	}
 	gf_bs_seek(bs, start);
 	if (!end) end = gf_bs_get_size(bs);
@@ -1689,6 +1795,11 @@ static u32 avc_remove_emulation_bytes(const unsigned char *buffer_src, unsigned
 	return nal_size-emulation_bytes_count; 
 } 
 
+u32 AVC_RemoveEmulationBytes(const char *buffer_src, char *buffer_dst, u32 nal_size)
+{
+	return avc_remove_emulation_bytes((const unsigned char *) buffer_src, (unsigned char *) buffer_dst, nal_size);
+}
+
 s32 AVC_ReadSeqInfo(char *sps_data, u32 sps_size, AVCState *avc, u32 subseq_sps, u32 *vui_flag_pos)
 {
 	AVC_SPS *sps;
@@ -768,61 +768,20 @@ void encode_fec(MPE_FEC_FRAME * mff)
 /*decode the MPE_FEC_FRAME*/
 void decode_fec(MPE_FEC_FRAME * mff)
 {
-	u32 i,ML,offset;
-	u8 *data;
-	u8 linebuffer[255];
+	int nb_failed, nb_corrected;
 
-	//printf("Starting FEC decoding ...\n");
-	
-	data = gf_malloc((mff->rows*191)*sizeof(char));
-	memset(data,0,sizeof(data));
-
-	initialize_ecc ();
-	ML = 255;
-	memset(linebuffer, 0, 255);
-	offset = 0;
-
-	/*printf("ADT data\n");
-	print_bytes(mff->p_adt, 32, 1, 0);
-	print_bytes(mff->p_adt+512, 32, 1, 0);
-	print_bytes(mff->p_adt+512+512, 32, 1, 0);
-	print_bytes(mff->p_adt+512+512+512, 32, 1, 1);
-	printf("RS data\n");
-	print_bytes(mff->p_rs, 32, 1, 0);
-	print_bytes(mff->p_rs+512, 32, 1, 0);
-	print_bytes(mff->p_rs+512+512, 32, 1, 0);
-	print_bytes(mff->p_rs+512+512+512, 32, 1, 1);*/
-
-	for ( i = 0; i < mff->rows; i ++ )	{
-		u8 tmp[255];
-
-		getRowFromADT(mff, i, linebuffer);
-		getRowFromRS(mff, i, linebuffer + mff->col_adt);
-
-		encode_data(linebuffer, 191, tmp);
-
-		decode_data(linebuffer, ML);
-		if (check_syndrome () != 0) {
-			u32 nerasures = 0;
-			u32 *erasures = NULL;
-
-			/* TODO: set the erasures and errors based on the MFF */
-			if(correct_errors_erasures (linebuffer, ML, nerasures,  erasures) == 0)
-			{
-				//printf("Correction Error line %d \n", i);
-			}		
+	/*the ADT and RS tables are stored column by column, the frame is corrected in place, one
+	row-codeword at a time; rows with a zero syndrome are left untouched. Unreceived sections
+	of the tables are used as erasures*/
+	nb_failed = decode_frame(mff->p_adt, mff->col_adt, mff->p_rs, mff->rows, mff->p_error_adt, mff->p_error_rs, &nb_corrected);
 
-			/* TODO: replace the current line in MFF */
-		} 
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPE-FEC] Frame decoded - %d rows corrected - %d rows uncorrectable\n", nb_corrected, nb_failed));
 
-	memcpy(data+offset,linebuffer,sizeof(data));
-	offset += 191;
+	/*all holes in the ADT have been recovered*/
+	if (!nb_failed && nb_corrected && gf_list_count(mff->mpe_holes)) {
+		memset(mff->p_error_adt, 0, mff->col_adt * mff->rows*sizeof(u32));
+		empty_list(mff->mpe_holes);
 	}
-	//printf("FEC decoding done.\n");
-	memcpy(mff->p_adt,data,sizeof(data));
-	//gf_m2ts_ipdatagram_reader(mff->p_adt,ip_datagram);
-
-
 }
 
 
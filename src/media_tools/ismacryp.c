@@ -30,6 +30,7 @@
 #include <gpac/constants.h>
 #include <gpac/internal/isomedia_dev.h>
 #include <gpac/crypt.h>
+#include <gpac/thread.h>
 
 
 typedef struct 
@@ -547,14 +548,159 @@ GF_Err gf_ismacryp_decrypt_file(GF_ISOFile *mp4, const char *drm_file)
 	return e;
 }
 
+/*max number of samples and bytes fetched at once when encrypting with several threads*/
+#define ISMA_ENC_BATCH_SAMPLES	512
+#define ISMA_ENC_BATCH_SIZE		(16*1024*1024)
+/*number of samples a worker takes at once from the batch*/
+#define ISMA_ENC_WORKER_SAMPLES	16
+
+/*CTR counter of a sample only depends on its BSO, so samples can be encrypted independently by resyncing
+the key stream on each one, giving the same output as the serial path*/
+typedef struct
+{
+	GF_Mutex *mx;
+	GF_Semaphore *has_job, *job_done;
+	GF_List *workers;
+	char *salt;
+	/*current batch*/
+	GF_ISOSample **samps;
+	GF_ISMASample **isamps;
+	u32 nb_samples, next_sample;
+	Bool done;
+} ISMAEncPool;
+
+typedef struct
+{
+	ISMAEncPool *pool;
+	GF_Thread *th;
+	GF_Crypt *mc;
+} ISMAEncWorker;
+
+static GF_Crypt *isma_enc_open_crypt(GF_TrackCryptInfo *tci)
+{
+	GF_Err e;
+	char IV[16];
+	GF_Crypt *mc;
+
+	memset(IV, 0, sizeof(char)*16);
+	memcpy(IV, tci->salt, sizeof(char)*8);
+	mc = gf_crypt_open("AES-128", "CTR");
+	if (!mc) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[ISMA E&A] Cannot open AES-128 CTR\n"));
+		return NULL;
+	}
+	e = gf_crypt_init(mc, tci->key, 16, IV);
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[ISMA E&A] Cannot initialize AES-128 CTR (%s)\n", gf_error_to_string(e)) );
+		gf_crypt_close(mc);
+		return NULL;
+	}
+	return mc;
+}
+
+static void isma_enc_pool_process(ISMAEncPool *pool, GF_Crypt *mc)
+{
+	u32 idx, end;
+	while (1) {
+		gf_mx_p(pool->mx);
+		idx = pool->next_sample;
+		end = MIN(idx + ISMA_ENC_WORKER_SAMPLES, pool->nb_samples);
+		pool->next_sample = end;
+		gf_mx_v(pool->mx);
+		if (idx >= end) break;
+
+		for (; idx<end; idx++) {
+			if (!(pool->isamps[idx]->flags & GF_ISOM_ISMA_IS_ENCRYPTED)) continue;
+			resync_IV(mc, pool->isamps[idx]->IV, pool->salt);
+			gf_crypt_encrypt(mc, pool->samps[idx]->data, pool->samps[idx]->dataLength);
+		}
+	}
+}
+
+static u32 isma_enc_worker_run(void *par)
+{
+	ISMAEncWorker *w = (ISMAEncWorker *)par;
+	ISMAEncPool *pool = w->pool;
+
+	/*signal startup is done*/
+	gf_sema_notify(pool->job_done, 1);
+	while (1) {
+		gf_sema_wait(pool->has_job);
+		if (pool->done) break;
+		isma_enc_pool_process(pool, w->mc);
+		gf_sema_notify(pool->job_done, 1);
+	}
+	return 0;
+}
+
+static void isma_enc_pool_del(ISMAEncPool *pool)
+{
+	u32 i, count = gf_list_count(pool->workers);
+	pool->done = 1;
+	gf_sema_notify(pool->has_job, count);
+	for (i=0; i<count; i++) {
+		ISMAEncWorker *w = (ISMAEncWorker *)gf_list_get(pool->workers, i);
+		gf_th_stop(w->th);
+		gf_th_del(w->th);
+		gf_crypt_close(w->mc);
+		gf_free(w);
+	}
+	gf_list_del(pool->workers);
+	gf_sema_del(pool->has_job);
+	gf_sema_del(pool->job_done);
+	gf_mx_del(pool->mx);
+	gf_free(pool);
+}
+
+/*creates nb_threads-1 workers, the calling thread acting as the last one*/
+static ISMAEncPool *isma_enc_pool_new(GF_TrackCryptInfo *tci, u32 nb_threads)
+{
+	u32 i;
+	ISMAEncPool *pool;
+	GF_SAFEALLOC(pool, ISMAEncPool);
+	pool->salt = tci->salt;
+	pool->workers = gf_list_new();
+	pool->mx = gf_mx_new("ISMAEncPool");
+	pool->has_job = gf_sema_new(nb_threads, 0);
+	pool->job_done = gf_sema_new(nb_threads, 0);
+	for (i=1; i<nb_threads; i++) {
+		ISMAEncWorker *w;
+		GF_Crypt *mc = isma_enc_open_crypt(tci);
+		if (!mc) break;
+		GF_SAFEALLOC(w, ISMAEncWorker);
+		w->pool = pool;
+		w->mc = mc;
+		w->th = gf_th_new("ISMAEncWorker");
+		gf_list_add(pool->workers, w);
+		gf_th_run(w->th, isma_enc_worker_run, w);
+	}
+	for (i=0; i<gf_list_count(pool->workers); i++) gf_sema_wait(pool->job_done);
+
+	if (!gf_list_count(pool->workers)) {
+		isma_enc_pool_del(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+/*encrypts the current batch with all workers and the calling thread*/
+static void isma_enc_pool_run(ISMAEncPool *pool, GF_Crypt *mc)
+{
+	u32 i, count = gf_list_count(pool->workers);
+	pool->next_sample = 0;
+	gf_sema_notify(pool->has_job, count);
+	isma_enc_pool_process(pool, mc);
+	for (i=0; i<count; i++) gf_sema_wait(pool->job_done);
+}
+
 GF_EXPORT
 GF_Err gf_ismacryp_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*progress)(void *cbk, u64 done, u64 total), void *cbk)
 {
-	char IV[16];
-	GF_ISOSample *samp;
-	GF_ISMASample *isamp;
+	GF_ISOSample *samp, **samps;
+	GF_ISMASample *isamp, **isamps;
 	GF_Crypt *mc;
-	u32 i, count, di, track, IV_size, rand, avc_size_length;
+	ISMAEncPool *pool;
+	u32 i, j, count, di, track, IV_size, rand, avc_size_length, nb_samps, batch_size;
 	u64 BSO, range_end;
 	GF_ESD *esd;
 	GF_IPMPPtr *ipmpdp;
@@ -616,19 +762,8 @@ GF_Err gf_ismacryp_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (
 	GF_LOG(GF_LOG_INFO, GF_LOG_AUTHOR, ("[ISMA E&A] Encrypting track ID %d - KMS: %s%s\n", tci->trackID, tci->KMS_URI, tci->sel_enc_type ? " - Selective Encryption" : ""));
 
 	/*init crypto*/
-	memset(IV, 0, sizeof(char)*16);
-	memcpy(IV, tci->salt, sizeof(char)*8);
-	mc = gf_crypt_open("AES-128", "CTR");
-	if (!mc) {
-		GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[ISMA E&A] Cannot open AES-128 CTR\n"));
-		return GF_IO_ERR;
-	}
-	e = gf_crypt_init(mc, tci->key, 16, IV);
-	if (e) {
-		GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[ISMA E&A] Cannot initialize AES-128 CTR (%s)\n", gf_error_to_string(e)) );
-		gf_crypt_close(mc);
-		return GF_IO_ERR;
-	}
+	mc = isma_enc_open_crypt(tci);
+	if (!mc) return GF_IO_ERR;
 	if (!stricmp(tci->KMS_URI, "self")) {
 		char Data[100], d64[100];
 		u32 s64;
@@ -671,89 +806,136 @@ GF_Err gf_ismacryp_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (
 	if (gf_isom_has_time_offset(mp4, track)) gf_isom_set_cts_packing(mp4, track, 1);
 
 	count = gf_isom_get_sample_count(mp4, track);
-	for (i = 0; i < count; i++) {
-		samp = gf_isom_get_sample(mp4, track, i+1, &di); 
-
-		isamp = gf_isom_ismacryp_new_sample();
-		isamp->IV_length = IV_size;
-		isamp->KI_length = 0;
 
-		switch (tci->sel_enc_type) {
-		case GF_ISMACRYP_SELENC_RAP:
-			if (samp->IsRAP) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
-			break;
-		case GF_ISMACRYP_SELENC_NON_RAP:
-			if (!samp->IsRAP) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
-			break;
-		/*random*/
-		case GF_ISMACRYP_SELENC_RAND:
-			rand = gf_rand();
-			if (rand%2) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
-			break;
-		/*random every sel_freq samples*/
-		case GF_ISMACRYP_SELENC_RAND_RANGE:
-			if (!(i%tci->sel_enc_range)) has_crypted_samp = 0;
-			if (!has_crypted_samp) {
+	pool = NULL;
+	batch_size = 1;
+	if (tci->nb_threads>1) {
+		pool = isma_enc_pool_new(tci, tci->nb_threads);
+		if (pool) {
+			batch_size = ISMA_ENC_BATCH_SAMPLES;
+			GF_LOG(GF_LOG_INFO, GF_LOG_AUTHOR, ("[ISMA E&A] Encrypting with %d threads\n", gf_list_count(pool->workers)+1));
+		}
+		/*thread startup reseeds the random generator*/
+		if ((tci->sel_enc_type==GF_ISMACRYP_SELENC_RAND) || (tci->sel_enc_type==GF_ISMACRYP_SELENC_RAND_RANGE)) {
+			gf_rand_init(1);
+		}
+	}
+	samps = (GF_ISOSample **)gf_malloc(sizeof(GF_ISOSample *)*batch_size);
+	isamps = (GF_ISMASample **)gf_malloc(sizeof(GF_ISMASample *)*batch_size);
+
+	for (i = 0; i < count; ) {
+		u32 batch_bytes = 0;
+		nb_samps = 0;
+		/*fetch samples - selective encryption decisions are made in sample order so that random modes
+		give the same result whatever the number of threads*/
+		while ((i < count) && (nb_samps < batch_size) && (batch_bytes < ISMA_ENC_BATCH_SIZE)) {
+			samp = gf_isom_get_sample(mp4, track, i+1, &di); 
+
+			isamp = gf_isom_ismacryp_new_sample();
+			isamp->IV_length = IV_size;
+			isamp->KI_length = 0;
+
+			switch (tci->sel_enc_type) {
+			case GF_ISMACRYP_SELENC_RAP:
+				if (samp->IsRAP) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
+				break;
+			case GF_ISMACRYP_SELENC_NON_RAP:
+				if (!samp->IsRAP) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
+				break;
+			/*random*/
+			case GF_ISMACRYP_SELENC_RAND:
 				rand = gf_rand();
-				if (!(rand%tci->sel_enc_range)) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
-
-				if (!(isamp->flags & GF_ISOM_ISMA_IS_ENCRYPTED) && !( (1+i)%tci->sel_enc_range)) {
+				if (rand%2) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
+				break;
+			/*random every sel_freq samples*/
+			case GF_ISMACRYP_SELENC_RAND_RANGE:
+				if (!(i%tci->sel_enc_range)) has_crypted_samp = 0;
+				if (!has_crypted_samp) {
+					rand = gf_rand();
+					if (!(rand%tci->sel_enc_range)) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
+
+					if (!(isamp->flags & GF_ISOM_ISMA_IS_ENCRYPTED) && !( (1+i)%tci->sel_enc_range)) {
+						isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
+					}
+					has_crypted_samp = (isamp->flags & GF_ISOM_ISMA_IS_ENCRYPTED);
+				}
+				break;
+			/*every sel_freq samples*/
+			case GF_ISMACRYP_SELENC_RANGE:
+				if (!(i%tci->sel_enc_type)) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
+				break;
+			case GF_ISMACRYP_SELENC_PREVIEW:
+				if (samp->DTS + samp->CTS_Offset >= range_end) 
 					isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
+				break;
+			case 0:
+				isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
+				break;
+			default:
+				break;
+			}
+			if (tci->sel_enc_type) isamp->flags |= GF_ISOM_ISMA_USE_SEL_ENC;
+
+			/*isma e&a stores AVC1 in AVC/H264 annex B bitstream fashion, with 0x00000001 start codes*/
+			if (avc_size_length) {
+				u32 done = 0;
+				u8 *d = samp->data;
+				while (done < samp->dataLength) {
+					u32 nal_size = GF_4CC(d[0], d[1], d[2], d[3]);
+					d[0] = d[1] = d[2] = 0; d[3] = 1;
+					d += 4 + nal_size;
+					done += 4 + nal_size;
 				}
-				has_crypted_samp = (isamp->flags & GF_ISOM_ISMA_IS_ENCRYPTED);
 			}
-			break;
-		/*every sel_freq samples*/
-		case GF_ISMACRYP_SELENC_RANGE:
-			if (!(i%tci->sel_enc_type)) isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
-			break;
-		case GF_ISMACRYP_SELENC_PREVIEW:
-			if (samp->DTS + samp->CTS_Offset >= range_end) 
-				isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
-			break;
-		case 0:
-			isamp->flags |= GF_ISOM_ISMA_IS_ENCRYPTED;
-			break;
-		default:
-			break;
-		}
-		if (tci->sel_enc_type) isamp->flags |= GF_ISOM_ISMA_USE_SEL_ENC;
-
-		/*isma e&a stores AVC1 in AVC/H264 annex B bitstream fashion, with 0x00000001 start codes*/
-		if (avc_size_length) {
-			u32 done = 0;
-			u8 *d = samp->data;
-			while (done < samp->dataLength) {
-				u32 nal_size = GF_4CC(d[0], d[1], d[2], d[3]);
-				d[0] = d[1] = d[2] = 0; d[3] = 1;
-				d += 4 + nal_size;
-				done += 4 + nal_size;
+
+			if (isamp->flags & GF_ISOM_ISMA_IS_ENCRYPTED) {
+				/*resync IV*/
+				if (!pool) {
+					if (!prev_sample_encryped) resync_IV(mc, BSO, tci->salt);
+					gf_crypt_encrypt(mc, samp->data, samp->dataLength);
+				}
+				prev_sample_encryped = 1;
+			} else {
+				prev_sample_encryped = 0;
 			}
-		}
 
-		if (isamp->flags & GF_ISOM_ISMA_IS_ENCRYPTED) {
-			/*resync IV*/
-			if (!prev_sample_encryped) resync_IV(mc, BSO, tci->salt);
-			gf_crypt_encrypt(mc, samp->data, samp->dataLength);
-			prev_sample_encryped = 1;
-		} else {
-			prev_sample_encryped = 0;
+			isamp->IV = BSO;
+			BSO += samp->dataLength;
+			batch_bytes += samp->dataLength;
+			samps[nb_samps] = samp;
+			isamps[nb_samps] = isamp;
+			nb_samps++;
+			i++;
 		}
 
+		/*encrypt the batch*/
+		if (pool) {
+			pool->samps = samps;
+			pool->isamps = isamps;
+			pool->nb_samples = nb_samps;
+			isma_enc_pool_run(pool, mc);
+		}
 
-		isamp->IV = BSO;
-		BSO += samp->dataLength;
-		isamp->data = samp->data;
-		isamp->dataLength = samp->dataLength;
-		samp->data = NULL;
-		samp->dataLength = 0;
-
-		gf_isom_ismacryp_sample_to_sample(isamp, samp);
-		gf_isom_ismacryp_delete_sample(isamp);
-		gf_isom_update_sample(mp4, track, i+1, samp, 1);
-		gf_isom_sample_del(&samp);
-		gf_set_progress("ISMA Encrypt", i+1, count);
+		/*and commit samples in order*/
+		for (j=0; j<nb_samps; j++) {
+			u32 samp_num = i - nb_samps + j + 1;
+			samp = samps[j];
+			isamp = isamps[j];
+			isamp->data = samp->data;
+			isamp->dataLength = samp->dataLength;
+			samp->data = NULL;
+			samp->dataLength = 0;
+
+			gf_isom_ismacryp_sample_to_sample(isamp, samp);
+			gf_isom_ismacryp_delete_sample(isamp);
+			gf_isom_update_sample(mp4, track, samp_num, samp, 1);
+			gf_isom_sample_del(&samp);
+			gf_set_progress("ISMA Encrypt", samp_num, count);
+		}
 	}
+	gf_free(samps);
+	gf_free(isamps);
+	if (pool) isma_enc_pool_del(pool);
 	gf_isom_set_cts_packing(mp4, track, 0);
 	gf_crypt_close(mc);
 
@@ -831,7 +1013,7 @@ GF_Err gf_ismacryp_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (
 }
 
 GF_EXPORT
-GF_Err gf_ismacryp_crypt_file(GF_ISOFile *mp4, const char *drm_file)
+GF_Err gf_ismacryp_crypt_file(GF_ISOFile *mp4, const char *drm_file, u32 nb_threads)
 {
 	GF_Err e;
 	u32 i, count, nb_tracks, common_idx, idx;
@@ -871,6 +1053,7 @@ GF_Err gf_ismacryp_crypt_file(GF_ISOFile *mp4, const char *drm_file)
 
 		/*default to FILE uri*/
 		if (!strlen(tci->KMS_URI)) strcpy(tci->KMS_URI, drm_file);
+		tci->nb_threads = nb_threads;
 
 		e = gf_ismacryp_encrypt_track(mp4, tci, NULL, NULL);
 		if (e) break;
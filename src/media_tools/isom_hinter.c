@@ -28,6 +28,7 @@
 #include <gpac/constants.h>
 #include <gpac/math.h>
 #include <gpac/ietf.h>
+#include <gpac/thread.h>
 
 #ifndef GPAC_DISABLE_ISOM
 
@@ -85,6 +86,18 @@ void gf_media_get_sample_average_infos(GF_ISOFile *file, u32 Track, u32 *avgSize
 
 #ifndef GPAC_DISABLE_ISOM_HINTING
 
+/*tracks hinted concurrently: hinters are picked by the worker threads, sample fetching and hint sample
+insertion are serialized on the file through the pool mutex*/
+typedef struct
+{
+	GF_Mutex *mx;
+	GF_RTPHinter **hinters;
+	GF_Err *errors;
+	u32 nb_hinters, next_hinter;
+	/*stats, for progress*/
+	u32 nb_samples, nb_done;
+} GF_HinterPool;
+
 /*RTP track hinter*/
 struct __tag_isom_hinter
 {
@@ -110,8 +123,20 @@ struct __tag_isom_hinter
 
 	/*stats*/
 	u32 TotalSample, CurrentSample;
+
+	/*set when hinted concurrently with other tracks of the file*/
+	GF_HinterPool *pool;
 };
 
+static GFINLINE void hinter_lock(GF_RTPHinter *tkHint)
+{
+	if (tkHint->pool) gf_mx_p(tkHint->pool->mx);
+}
+static GFINLINE void hinter_unlock(GF_RTPHinter *tkHint)
+{
+	if (tkHint->pool) gf_mx_v(tkHint->pool->mx);
+}
+
 
 /*
 	offset for group ID for hint tracks in SimpleAV mode when all media data
@@ -218,7 +243,11 @@ void MP4T_OnNewPacket(void *cbk, GF_RTPHeader *header)
 	/*do we need a new sample*/
 	if (!tkHint->HintSample || (tkHint->RTPTime != header->TimeStamp)) {
 		/*close current sample*/
-		if (tkHint->HintSample) gf_isom_end_hint_sample(tkHint->file, tkHint->HintTrack, tkHint->SampleIsRAP);
+		if (tkHint->HintSample) {
+			hinter_lock(tkHint);
+			gf_isom_end_hint_sample(tkHint->file, tkHint->HintTrack, tkHint->SampleIsRAP);
+			hinter_unlock(tkHint);
+		}
 
 		/*start new sample: We use DTS as the sampling instant (RTP TS) to make sure
 		all packets are sent in order*/
@@ -661,8 +690,12 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 	
 	e = GF_OK;
 	for (i=0; i<tkHint->TotalSample; i++) {
+		hinter_lock(tkHint);
 		samp = gf_isom_get_sample(tkHint->file, tkHint->TrackNum, i+1, &descIndex);
-		if (!samp) return GF_IO_ERR;
+		if (!samp) {
+			hinter_unlock(tkHint);
+			return GF_IO_ERR;
+		}
 
 		//setup SL
 		tkHint->CurrentSample = i + 1;
@@ -705,6 +738,7 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 		}
 		
 		duration = gf_isom_get_sample_duration(tkHint->file, tkHint->TrackNum, i+1);
+		hinter_unlock(tkHint);
 		ts = (u32) (ft * (s64) (duration));
 
 		/*unpack nal units*/
@@ -738,7 +772,14 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 		tkHint->rtp_p->sl_header.packetSequenceNumber += 1;
 
 		//signal some progress
-		gf_set_progress("Hinting", tkHint->CurrentSample, tkHint->TotalSample);
+		if (tkHint->pool) {
+			gf_mx_p(tkHint->pool->mx);
+			tkHint->pool->nb_done++;
+			gf_set_progress("Hinting", tkHint->pool->nb_done, tkHint->pool->nb_samples);
+			gf_mx_v(tkHint->pool->mx);
+		} else {
+			gf_set_progress("Hinting", tkHint->CurrentSample, tkHint->TotalSample);
+		}
 
 		tkHint->rtp_p->sl_header.AU_sequenceNumber += 1;
 		gf_isom_sample_del(&samp);
@@ -749,10 +790,89 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 	//flush
 	gf_rtp_builder_process(tkHint->rtp_p, NULL, 0, 1, 0, 0, 0);
 
+	hinter_lock(tkHint);
 	gf_isom_end_hint_sample(tkHint->file, tkHint->HintTrack, (u8) tkHint->SampleIsRAP);
+	hinter_unlock(tkHint);
 	return GF_OK;
 }
 
+static void hinter_pool_process(GF_HinterPool *pool)
+{
+	u32 idx;
+	while (1) {
+		gf_mx_p(pool->mx);
+		idx = pool->next_hinter;
+		if (idx < pool->nb_hinters) pool->next_hinter++;
+		gf_mx_v(pool->mx);
+		if (idx >= pool->nb_hinters) break;
+
+		pool->errors[idx] = gf_hinter_track_process(pool->hinters[idx]);
+	}
+}
+
+static u32 hinter_worker_run(void *par)
+{
+	hinter_pool_process((GF_HinterPool *)par);
+	return 0;
+}
+
+GF_EXPORT
+GF_Err gf_hinter_process_tracks(GF_RTPHinter **tkHinters, u32 nb_hinters, u32 nb_threads, GF_Err *errors)
+{
+	u32 i;
+	GF_Err e;
+	GF_HinterPool pool;
+	GF_Thread **threads;
+
+	if (!tkHinters || !nb_hinters || !errors) return GF_BAD_PARAM;
+	for (i=1; i<nb_hinters; i++) {
+		if (tkHinters[i]->file != tkHinters[0]->file) return GF_BAD_PARAM;
+	}
+
+	/*serial hinting*/
+	if (nb_threads > nb_hinters) nb_threads = nb_hinters;
+	if (nb_threads <= 1) {
+		e = GF_OK;
+		for (i=0; i<nb_hinters; i++) {
+			errors[i] = gf_hinter_track_process(tkHinters[i]);
+			if (!e) e = errors[i];
+		}
+		return e;
+	}
+
+	memset(&pool, 0, sizeof(GF_HinterPool));
+	pool.mx = gf_mx_new("HinterPool");
+	pool.hinters = tkHinters;
+	pool.nb_hinters = nb_hinters;
+	pool.errors = errors;
+	for (i=0; i<nb_hinters; i++) {
+		tkHinters[i]->pool = &pool;
+		pool.nb_samples += gf_isom_get_sample_count(tkHinters[i]->file, tkHinters[i]->TrackNum);
+		errors[i] = GF_OK;
+	}
+
+	/*the calling thread acts as the last worker*/
+	threads = (GF_Thread **) gf_malloc(sizeof(GF_Thread *) * (nb_threads-1));
+	for (i=0; i<nb_threads-1; i++) {
+		threads[i] = gf_th_new("Hinter");
+		gf_th_run(threads[i], hinter_worker_run, &pool);
+	}
+	hinter_pool_process(&pool);
+	for (i=0; i<nb_threads-1; i++) {
+		gf_th_stop(threads[i]);
+		gf_th_del(threads[i]);
+	}
+	gf_free(threads);
+	gf_mx_del(pool.mx);
+
+	e = GF_OK;
+	for (i=0; i<nb_hinters; i++) {
+		tkHinters[i]->pool = NULL;
+		if (!e) e = errors[i];
+	}
+	return e;
+}
+
 
 
 GF_EXPORT
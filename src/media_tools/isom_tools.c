@@ -674,8 +674,16 @@ typedef struct
 	u32 TimeScale, MediaType, DefaultDuration, InitialTSOffset;
 	u64 last_sample_cts, next_sample_dts;
 	Bool all_sample_raps;
+	/*sample data is copied by range from the input rather than loaded*/
+	Bool copy_by_range;
 } TrackFragmenter;
 
+static GF_ISOSample *fragmenter_get_sample(GF_ISOFile *input, TrackFragmenter *tf, u32 sample_num, u32 *descIndex, u64 *data_offset)
+{
+	if (tf->copy_by_range) return gf_isom_get_sample_info(input, tf->OriginalTrack, sample_num, descIndex, data_offset);
+	return gf_isom_get_sample(input, tf->OriginalTrack, sample_num, descIndex);
+}
+
 static u64 get_next_sap_time(GF_ISOFile *input, u32 track, u32 sample_count, u32 sample_num)
 {
 	GF_ISOSample *samp;
@@ -734,6 +742,7 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, const
 	Bool simulation_pass = 0;
 	u64 last_ref_cts = 0;
 	u64 start_range, end_range, file_size, init_seg_size, ref_track_first_dts, ref_track_next_cts;
+	u64 data_offset, next_data_offset;
 	u32 tfref_timescale = 0;
 	u32 bandwidth = 0;
 	TrackFragmenter *tf, *tfref;
@@ -753,6 +762,7 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, const
 
 	SegmentDuration = 0;
 	nb_samp = 0;
+	data_offset = next_data_offset = 0;
 	fragmenters = NULL;
 	if (!seg_ext) seg_ext = "m4s";
 
@@ -889,6 +899,9 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, const
 		tf->TimeScale = gf_isom_get_media_timescale(input, i+1);
 		tf->MediaType = gf_isom_get_media_type(input, i+1);
 		tf->DefaultDuration = defaultDuration;
+		/*a single sample description implies a single data reference for all samples*/
+		if ((mtype != GF_ISOM_MEDIA_OD) && (gf_isom_get_sample_description_count(input, i+1)==1))
+			tf->copy_by_range = 1;
 
 		if (gf_isom_get_sync_point_count(input, i+1)>nb_sync) { 
 			tfref = tf;
@@ -1006,6 +1019,16 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, const
 #ifndef GPAC_DISABLE_ISOM_FRAGMENTS
 	e = gf_isom_finalize_for_fragment(output, dash_mode ? 1 : 0);
 	if (e) goto err_exit;
+
+	/*with a single sidx per segment, fragments are written as soon as they are done rather than kept in memory until the segment is closed*/
+	if (dash_mode && !daisy_chain_sidx && (subsegs_per_sidx<=0)) {
+		u32 nb_frags = 1;
+		if (MaxFragmentDuration && (MaxSegmentDuration > MaxFragmentDuration)) {
+			nb_frags = MaxSegmentDuration / MaxFragmentDuration;
+			if (nb_frags * MaxFragmentDuration < MaxSegmentDuration) nb_frags++;
+		}
+		gf_isom_enable_segment_streaming(output, nb_frags, (subsegs_per_sidx<0) ? 0 : 1);
+	}
 #endif
 
 	start_range = 0;
@@ -1155,7 +1178,7 @@ restart_fragmentation_pass:
 
 				/*first sample*/
 				if (!sample) {
-					sample = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 1, &descIndex);
+					sample = fragmenter_get_sample(input, tf, tf->SampleNum + 1, &descIndex, &data_offset);
 					if (!sample) {
 						e = gf_isom_last_error(input);
 						goto err_exit;
@@ -1175,7 +1198,7 @@ restart_fragmentation_pass:
 				}
 				gf_isom_get_sample_padding_bits(input, tf->OriginalTrack, tf->SampleNum+1, &NbBits);
 
-				next = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 2, &j);
+				next = fragmenter_get_sample(input, tf, tf->SampleNum + 2, &j, &next_data_offset);
 				if (next) {
 					defaultDuration = (u32) (next->DTS - sample->DTS);
 				} else {
@@ -1209,8 +1232,13 @@ restart_fragmentation_pass:
 				} else {
 					/*override descIndex with final index used in file*/
 					descIndex = tf->finalSampleDescriptionIndex;
-					e = gf_isom_fragment_add_sample(output, tf->TrackID, sample, descIndex,
+					if (tf->copy_by_range) {
+						e = gf_isom_fragment_add_sample_from_track(output, tf->TrackID, sample, descIndex,
+									 defaultDuration, NbBits, 0, input, tf->OriginalTrack, data_offset);
+					} else {
+						e = gf_isom_fragment_add_sample(output, tf->TrackID, sample, descIndex,
 									 defaultDuration, NbBits, 0);
+					}
 					if (e) 
 						goto err_exit;
 
@@ -1228,6 +1256,7 @@ restart_fragmentation_pass:
 
 				gf_isom_sample_del(&sample);
 				sample = next;
+				data_offset = next_data_offset;
 				tf->FragmentLength += defaultDuration;
 				tf->SampleNum += 1;
 
@@ -1257,7 +1257,7 @@ static GF_Err MP4T_CopyTrack(GF_MediaExporter *dumper, GF_ISOFile *infile, u32 i
 {
 	GF_ESD *esd;
 	GF_InitialObjectDescriptor *iod;
-	u32 TrackID, newTk, descIndex, i, ts, rate, pos, di, count, msubtype;
+	u32 TrackID, newTk, descIndex, i, j, ts, rate, pos, di, count, nb_samples, size, msubtype;
 	u64 dur;
 	GF_ISOSample *samp;
 
@@ -1318,20 +1318,28 @@ static GF_Err MP4T_CopyTrack(GF_MediaExporter *dumper, GF_ISOFile *infile, u32 i
 	rate = 0;
 	ts = gf_isom_get_media_timescale(infile, inTrackNum);
 	count = gf_isom_get_sample_count(infile, inTrackNum); 
-	for (i=0; i<count; i++) {
-		samp = gf_isom_get_sample(infile, inTrackNum, i+1, &di);
-		gf_isom_add_sample(outfile, newTk, descIndex, samp);
+	for (i=0; i<count; i+=nb_samples) {
+		/*copy samples by blocks, or one by one if they have to be rewritten*/
+		nb_samples = MIN(count - i, 1000);
+		if (gf_isom_copy_samples(outfile, newTk, descIndex, infile, inTrackNum, i+1, nb_samples) == GF_NOT_SUPPORTED) {
+			nb_samples = 1;
+			samp = gf_isom_get_sample(infile, inTrackNum, i+1, &di);
+			gf_isom_add_sample(outfile, newTk, descIndex, samp);
+			gf_isom_sample_del(&samp);
+		}
 		if (esd) {
-			rate += samp->dataLength;
-			esd->decoderConfig->avgBitrate += samp->dataLength;
-			if (esd->decoderConfig->bufferSizeDB<samp->dataLength) esd->decoderConfig->bufferSizeDB = samp->dataLength;
-			if (samp->DTS - pos > ts) {
-				if (esd->decoderConfig->maxBitrate<rate) esd->decoderConfig->maxBitrate = rate;
-				rate = 0;
-				pos = 0;
+			for (j=i; j<i+nb_samples; j++) {
+				size = gf_isom_get_sample_size(infile, inTrackNum, j+1);
+				rate += size;
+				esd->decoderConfig->avgBitrate += size;
+				if (esd->decoderConfig->bufferSizeDB<size) esd->decoderConfig->bufferSizeDB = size;
+				if (gf_isom_get_sample_dts(infile, inTrackNum, j+1) - pos > ts) {
+					if (esd->decoderConfig->maxBitrate<rate) esd->decoderConfig->maxBitrate = rate;
+					rate = 0;
+					pos = 0;
+				}
 			}
 		}
-		gf_isom_sample_del(&samp);
 		gf_set_progress("ISO File Export", i, count);
 	}
 	gf_set_progress("ISO File Export", count, count);
@@ -1533,11 +1533,14 @@ exit:
 #endif /*GPAC_DISABLE_AVILIB*/
 
 
+/*number of samples copied at once between progress and abort checks*/
+#define ISO_IMPORT_BLOCK_SAMPLES	1000
+
 GF_Err gf_import_isomedia(GF_MediaImporter *import)
 {
 	GF_Err e;
 	u64 offset, sampDTS, duration;
-	u32 track, di, trackID, track_in, i, num_samples, mtype, stype, w, h, sr, sbr_sr, ch, mstype;
+	u32 track, di, trackID, track_in, i, j, num_samples, nb_samples, mtype, stype, w, h, sr, sbr_sr, ch, mstype;
 	s32 trans_x, trans_y;
 	s16 layer;
 	u8 bps;
@@ -1750,7 +1753,9 @@ GF_Err gf_import_isomedia(GF_MediaImporter *import)
 	duration = (u64) (((Double)import->duration * gf_isom_get_media_timescale(import->orig, track_in)) / 1000);
 
 	num_samples = gf_isom_get_sample_count(import->orig, track_in);
-	for (i=0; i<num_samples; i++) {
+	i = 0;
+	while (i<num_samples) {
+		nb_samples = 1;
 		if (import->flags & GF_IMPORT_USE_DATAREF) {
 			samp = gf_isom_get_sample_info(import->orig, track_in, i+1, &di, &offset);
 			if (!samp) {
@@ -1758,21 +1763,41 @@ GF_Err gf_import_isomedia(GF_MediaImporter *import)
 				goto exit;
 			}
 			e = gf_isom_add_sample_reference(import->dest, track, di, samp, offset);
+			sampDTS = samp->DTS;
+			gf_isom_sample_del(&samp);
 		} else {
-			samp = gf_isom_get_sample(import->orig, track_in, i+1, &di);
-			if (!samp) {
-				/*couldn't get the sample, but still move on*/
-				goto exit;
+			/*copy samples by blocks, stopping after the first sample beyond the import duration*/
+			nb_samples = MIN(num_samples - i, ISO_IMPORT_BLOCK_SAMPLES);
+			if (duration) {
+				for (j=0; j<nb_samples; j++) {
+					if (gf_isom_get_sample_dts(import->orig, track_in, i+j+1) > duration) {
+						nb_samples = j+1;
+						break;
+					}
+				}
 			}
-			/*if not first sample and same DTS as previous sample, force DTS++*/
-			if (i && (samp->DTS==sampDTS)) {
-				samp->DTS++;
+			e = gf_isom_copy_samples(import->dest, track, 0, import->orig, track_in, i+1, nb_samples);
+			if (!e) {
+				sampDTS = gf_isom_get_sample_dts(import->orig, track_in, i+nb_samples);
+			} else if (e==GF_NOT_SUPPORTED) {
+				nb_samples = 1;
+				samp = gf_isom_get_sample(import->orig, track_in, i+1, &di);
+				if (!samp) {
+					/*couldn't get the sample, but still move on*/
+					e = GF_OK;
+					goto exit;
+				}
+				/*if not first sample and same DTS as previous sample, force DTS++*/
+				if (i && (samp->DTS==sampDTS)) {
+					samp->DTS++;
+				}
+				e = gf_isom_add_sample(import->dest, track, di, samp);
+				sampDTS = samp->DTS;
+				gf_isom_sample_del(&samp);
 			}
-			e = gf_isom_add_sample(import->dest, track, di, samp);
 		}
-		sampDTS = samp->DTS;
-		gf_isom_sample_del(&samp);
-		gf_set_progress("Importing ISO File", i+1, num_samples);
+		i += nb_samples;
+		gf_set_progress("Importing ISO File", i, num_samples);
 		if (duration && (sampDTS > duration) ) break;
 		if (import->flags & GF_IMPORT_DO_ABORT) break;
 		if (e) goto exit;
@@ -3530,31 +3555,36 @@ Bool H263_IsStartCode(GF_BitStream *bs)
 #define H263_CACHE_SIZE	4096
 u32 H263_NextStartCode(GF_BitStream *bs)
 {
-	u32 v, bpos;
+	u32 avail, sc_pos;
 	unsigned char h263_cache[H263_CACHE_SIZE];
 	u64 end, cache_start, load_size;
 	u64 start = gf_bs_get_position(bs);
 
 	/*skip 16b header*/
 	gf_bs_read_u16(bs);
-	bpos = 0;
-	load_size = 0;
-	cache_start = 0;
+	avail = 0;
+	cache_start = gf_bs_get_position(bs);
 	end = 0;
-	v = 0xffffffff;
-	while (!end) {
+	while (1) {
 		/*refill cache*/
-		if (bpos == (u32) load_size) {
-			if (!gf_bs_available(bs)) break;
-			load_size = gf_bs_available(bs);
-			if (load_size>H263_CACHE_SIZE) load_size=H263_CACHE_SIZE;
-			bpos = 0;
-			cache_start = gf_bs_get_position(bs);
-			gf_bs_read_data(bs, h263_cache, (u32) load_size);
-		}
-		v = (v<<8) | h263_cache[bpos];
-		bpos++;
-		if ((v >> (32-22)) == 0x20) end = cache_start+bpos-4;
+		load_size = gf_bs_available(bs);
+		if (!load_size) break;
+		if (load_size > H263_CACHE_SIZE - avail) load_size = H263_CACHE_SIZE - avail;
+		gf_bs_read_data(bs, (char *) h263_cache + avail, (u32) load_size);
+		avail += (u32) load_size;
+
+		/*22 bits PSC 0000 0000 0000 0000 1000 00, only checked once the following byte is loaded*/
+		sc_pos = gf_media_next_start_code_ex(h263_cache, avail - 1, 0xFC, 0x80);
+		if (sc_pos < avail - 1) {
+			end = cache_start + sc_pos;
+			break;
+		}
+		/*keep the last 3 bytes so that start codes spanning two loads are detected*/
+		if (avail > 3) {
+			memmove(h263_cache, h263_cache + avail - 3, 3);
+			cache_start += avail - 3;
+			avail = 3;
+		}
 	}
 	gf_bs_seek(bs, start);
 	if (!end) end = gf_bs_get_size(bs);
@@ -3741,10 +3771,234 @@ GF_Err gf_media_avc_rewrite_samples(GF_ISOFile *file, u32 track, u32 prev_size,
 
 #ifndef GPAC_DISABLE_AV_PARSERS
 
+/*size of the AVC import read-ahead buffer - the buffer grows if a NAL unit does not fit in it*/
+#define AVC_IMPORT_READ_SIZE	0x100000
+/*number of bytes of each NAL unit inspected by AVC_ParseNALU. The slice header fields it checks always fit
+in this, even with emulation prevention bytes*/
+#define AVC_IMPORT_HDR_SIZE		256
+/*max number of samples waiting to be written to the destination file*/
+#define AVC_IMPORT_MAX_PENDING	64
+
+typedef struct
+{
+	FILE *in;
+	char *data;
+	u32 alloc_size, size, pos;
+	/*file offset of data[0]*/
+	u64 data_offset;
+	Bool eof;
+} AVCImportReader;
+
+static void avc_import_reader_fill(AVCImportReader *r)
+{
+	u32 read;
+	/*discard consumed data*/
+	if (r->pos) {
+		memmove(r->data, r->data + r->pos, r->size - r->pos);
+		r->data_offset += r->pos;
+		r->size -= r->pos;
+		r->pos = 0;
+	}
+	if (r->size == r->alloc_size) {
+		r->alloc_size *= 2;
+		r->data = (char*)gf_realloc(r->data, sizeof(char)*r->alloc_size);
+	}
+	read = (u32) fread(r->data + r->size, 1, r->alloc_size - r->size, r->in);
+	if (!read) r->eof = 1;
+	r->size += read;
+}
+
+static u32 avc_import_reader_available(AVCImportReader *r)
+{
+	if ((r->pos == r->size) && !r->eof) avc_import_reader_fill(r);
+	return r->size - r->pos;
+}
+
+/*returns size of start code (3 or 4 bytes) at current position and skips it, 0 if no start code*/
+static u32 avc_import_reader_start_code(AVCImportReader *r)
+{
+	u8 *p;
+	u32 avail;
+	while ((r->size - r->pos < 4) && !r->eof) avc_import_reader_fill(r);
+	p = (u8 *) r->data + r->pos;
+	avail = r->size - r->pos;
+	if ((avail>=3) && !p[0] && !p[1] && (p[2]==0x01)) {
+		r->pos += 3;
+		return 3;
+	}
+	if ((avail>=4) && !p[0] && !p[1] && !p[2] && (p[3]==0x01)) {
+		r->pos += 4;
+		return 4;
+	}
+	return 0;
+}
+
+/*gets the NAL unit at current position, ending at the next start code or at the end of the file. The NAL
+is not copied and is only valid until the next call*/
+static u32 avc_import_reader_next_nal(AVCImportReader *r, char **nal, u64 *nal_offset)
+{
+	u32 scan, sc_pos, end;
+	scan = r->pos;
+	while (1) {
+		sc_pos = scan + gf_media_next_start_code((u8 *) r->data + scan, r->size - scan);
+		if (sc_pos < r->size) {
+			end = sc_pos;
+			/*0x00000001 start code*/
+			if ((end > r->pos) && !r->data[end-1]) end--;
+			break;
+		}
+		if (r->eof) {
+			end = r->size;
+			break;
+		}
+		/*rescan the last 2 bytes once reloaded, in case a start code spans two reads*/
+		scan = (r->size - r->pos > 2) ? r->size - 2 - r->pos : 0;
+		avc_import_reader_fill(r);
+	}
+	*nal = r->data + r->pos;
+	*nal_offset = r->data_offset + r->pos;
+	scan = end - r->pos;
+	r->pos = end;
+	return scan;
+}
+
+typedef struct
+{
+	GF_ISOSample *samp;
+	u32 sample_num;
+	/*0: none, 1: roll recovery group, 2: rap group*/
+	u32 group_type;
+	s16 roll_distance;
+} AVCImportJob;
+
+/*writes samples to the destination file while the importer parses the next NAL units. Any other access to the
+destination track must be done after avc_import_writer_sync*/
+typedef struct
+{
+	GF_ISOFile *dest;
+	u32 track, di;
+	GF_Thread *th;
+	GF_Mutex *mx;
+	GF_Semaphore *has_job, *has_room, *synced;
+	GF_List *jobs;
+	u32 nb_pending;
+	Bool sync_wait;
+	GF_Err e;
+} AVCImportWriter;
+
+static u32 avc_import_writer_run(void *par)
+{
+	AVCImportJob *job;
+	GF_Err e;
+	AVCImportWriter *w = (AVCImportWriter *)par;
+
+	while (1) {
+		gf_sema_wait(w->has_job);
+		gf_mx_p(w->mx);
+		job = (AVCImportJob*)gf_list_get(w->jobs, 0);
+		if (job) gf_list_rem(w->jobs, 0);
+		e = w->e;
+		gf_mx_v(w->mx);
+		if (!job) break;
+
+		if (!e) {
+			e = gf_isom_add_sample(w->dest, w->track, w->di, job->samp);
+			if (!e && (job->group_type==1))
+				e = gf_isom_set_sample_roll_group(w->dest, w->track, job->sample_num, job->roll_distance);
+			else if (!e && (job->group_type==2))
+				e = gf_isom_set_sample_rap_group(w->dest, w->track, job->sample_num, 0);
+		}
+		gf_isom_sample_del(&job->samp);
+		gf_free(job);
+
+		gf_mx_p(w->mx);
+		if (e) w->e = e;
+		w->nb_pending--;
+		if (!w->nb_pending && w->sync_wait) {
+			w->sync_wait = 0;
+			gf_sema_notify(w->synced, 1);
+		}
+		gf_mx_v(w->mx);
+		gf_sema_notify(w->has_room, 1);
+	}
+	return 0;
+}
+
+static AVCImportWriter *avc_import_writer_new(GF_ISOFile *dest, u32 track, u32 di)
+{
+	AVCImportWriter *w;
+	GF_SAFEALLOC(w, AVCImportWriter);
+	w->dest = dest;
+	w->track = track;
+	w->di = di;
+	w->jobs = gf_list_new();
+	w->mx = gf_mx_new("AVCImportWriter");
+	w->has_job = gf_sema_new(AVC_IMPORT_MAX_PENDING + 1, 0);
+	w->has_room = gf_sema_new(AVC_IMPORT_MAX_PENDING, AVC_IMPORT_MAX_PENDING);
+	w->synced = gf_sema_new(1, 0);
+	w->th = gf_th_new("AVCImportWriter");
+	gf_th_run(w->th, avc_import_writer_run, w);
+	return w;
+}
+
+/*queues the sample for writing, the writer owns the sample*/
+static GF_Err avc_import_writer_push(AVCImportWriter *w, GF_ISOSample *samp, u32 sample_num, u32 group_type, s16 roll_distance)
+{
+	GF_Err e;
+	AVCImportJob *job;
+	GF_SAFEALLOC(job, AVCImportJob);
+	job->samp = samp;
+	job->sample_num = sample_num;
+	job->group_type = group_type;
+	job->roll_distance = roll_distance;
+
+	gf_sema_wait(w->has_room);
+	gf_mx_p(w->mx);
+	gf_list_add(w->jobs, job);
+	w->nb_pending++;
+	e = w->e;
+	gf_mx_v(w->mx);
+	gf_sema_notify(w->has_job, 1);
+	return e;
+}
+
+/*waits for all queued samples to be written*/
+static GF_Err avc_import_writer_sync(AVCImportWriter *w)
+{
+	GF_Err e;
+	gf_mx_p(w->mx);
+	if (w->nb_pending) {
+		w->sync_wait = 1;
+		gf_mx_v(w->mx);
+		gf_sema_wait(w->synced);
+		gf_mx_p(w->mx);
+	}
+	e = w->e;
+	gf_mx_v(w->mx);
+	return e;
+}
+
+/*flushes all queued samples and destroys the writer*/
+static GF_Err avc_import_writer_del(AVCImportWriter *w)
+{
+	GF_Err e = avc_import_writer_sync(w);
+	/*wake up the writer on an empty queue to end it*/
+	gf_sema_notify(w->has_job, 1);
+	gf_th_stop(w->th);
+	gf_th_del(w->th);
+	gf_sema_del(w->has_job);
+	gf_sema_del(w->has_room);
+	gf_sema_del(w->synced);
+	gf_mx_del(w->mx);
+	gf_list_del(w->jobs);
+	gf_free(w);
+	return e;
+}
+
 GF_Err gf_import_h264(GF_MediaImporter *import)
 {
-	u64 nal_start, nal_end, total_size;
-	u32 nal_size, track, trackID, di, cur_samp, nb_i, nb_idr, nb_p, nb_b, nb_sp, nb_si, nb_sei, max_w, max_h, max_total_delay;
+	u64 nal_start, total_size;
+	u32 nal_size, hdr_size, track, trackID, di, cur_samp, nb_i, nb_idr, nb_p, nb_b, nb_sp, nb_si, nb_sei, max_w, max_h, max_total_delay;
 	s32 idx, sei_recovery_frame_count;
 	u64 duration;
 	u8 nal_type;
@@ -3755,6 +4009,8 @@ GF_Err gf_import_h264(GF_MediaImporter *import)
 	GF_AVCConfig *avccfg, *svccfg, *dstcfg;
 	GF_BitStream *bs;
 	GF_BitStream *sample_data;
+	AVCImportReader reader;
+	AVCImportWriter *writer;
 	Bool flush_sample, sample_is_rap, sample_has_islice, first_nal, slice_is_ref, has_cts_offset, detect_fps, is_paff, set_subsamples, slice_force_ref;
 	u32 ref_frame, timescale, copy_size, size_length, dts_inc;
 	s32 last_poc, max_last_poc, max_last_b_poc, poc_diff, prev_last_poc, min_poc, poc_shift;
@@ -3765,7 +4021,7 @@ GF_Err gf_import_h264(GF_MediaImporter *import)
 	u8 priority_prev_nalu_prefix;
 	Double FPS;
 	char *buffer;
-	u32 max_size = 4096;
+	char hdr_buffer[AVC_IMPORT_HDR_SIZE];
 
 	if (import->flags & GF_IMPORT_PROBE_ONLY) {
 		import->nb_tracks = 1;
@@ -3793,6 +4049,12 @@ GF_Err gf_import_h264(GF_MediaImporter *import)
 	get_video_timing(FPS, &timescale, &dts_inc);
 
 	poc_diff = 0;
+	bs = NULL;
+	memset(&reader, 0, sizeof(AVCImportReader));
+	reader.in = mdia;
+	reader.alloc_size = AVC_IMPORT_READ_SIZE;
+	reader.data = (char*)gf_malloc(sizeof(char) * reader.alloc_size);
+	writer = NULL;
 
 
 restart_import:
@@ -3803,14 +4065,15 @@ restart_import:
 	svccfg = gf_odf_avc_cfg_new();
 	/*we don't handle split import (one track / layer)*/
 	svccfg->complete_representation = 1;
-	buffer = (char*)gf_malloc(sizeof(char) * max_size);
 	sample_data = NULL;
 	first_avc = 1;
 	last_svc_sps = 0;
 	sei_recovery_frame_count = -1;
 
-	bs = gf_bs_from_file(mdia, GF_BITSTREAM_READ);
-	if (!AVC_IsStartCode(bs)) {
+	reader.size = reader.pos = 0;
+	reader.data_offset = 0;
+	reader.eof = 0;
+	if (!avc_import_reader_start_code(&reader)) {
 		e = gf_import_message(import, GF_NON_COMPLIANT_BITSTREAM, "Cannot find H264 start code");
 		goto exit;
 	}
@@ -3840,13 +4103,18 @@ restart_import:
 	e = gf_isom_avc_config_new(import->dest, track, avccfg, NULL, NULL, &di);
 	if (e) goto exit;
 
+	/*samples are written by a separate thread while we parse the next NAL units*/
+	writer = avc_import_writer_new(import->dest, track, di);
+
 	sample_data = NULL;
 	sample_is_rap = 0;
 	sample_has_islice = 0;
 	cur_samp = 0;
 	is_paff = 0;
-	total_size = gf_bs_get_size(bs);
-	nal_start = gf_bs_get_position(bs);
+	gf_f64_seek(mdia, 0, SEEK_END);
+	total_size = gf_f64_tell(mdia);
+	gf_f64_seek(mdia, reader.data_offset + reader.size, SEEK_SET);
+	nal_start = 0;
 	duration = (u64) ( ((Double)import->duration) * timescale / 1000.0);
 
 	nb_i = nb_idr = nb_p = nb_b = nb_sp = nb_si = nb_sei = 0;
@@ -3864,19 +4132,15 @@ restart_import:
 	res_prev_nalu_prefix = 0;
 	priority_prev_nalu_prefix = 0;
 
-	while (gf_bs_available(bs)) {
+	while (avc_import_reader_available(&reader)) {
 		u8 nal_hdr, skip_nal, is_subseq, add_sps;
-		nal_size = AVC_NextStartCode(bs);
-
-		if (nal_size>max_size) {
-			buffer = (char*)gf_realloc(buffer, sizeof(char)*nal_size);
-			max_size = nal_size;
-		}
-
-		/*read the file, and work on a memory buffer*/
-		gf_bs_read_data(bs, buffer, nal_size);
+		/*NAL units are sliced in place in the read buffer*/
+		nal_size = avc_import_reader_next_nal(&reader, &buffer, &nal_start);
+		if (!nal_size) break;
 
-		gf_bs_seek(bs, nal_start);
+		/*only the NAL header is parsed here, remove emulation bytes from it*/
+		hdr_size = AVC_RemoveEmulationBytes(buffer, hdr_buffer, MIN(nal_size, AVC_IMPORT_HDR_SIZE));
+		bs = gf_bs_new(hdr_buffer, hdr_size, GF_BITSTREAM_READ);
 		nal_hdr = gf_bs_read_u8(bs);
 		nal_type = nal_hdr & 0x1F;
 
@@ -3902,6 +4166,9 @@ restart_import:
 		default:
 			break;
 		}
+		gf_bs_del(bs);
+		bs = NULL;
+
 		switch (nal_type) {
 		case GF_AVC_NALU_SVC_SUBSEQ_PARAM:
 			if (import->flags & GF_IMPORT_SVC_NONE) break;
@@ -3970,16 +4237,14 @@ restart_import:
 					dts_inc =   2 * avc.sps[idx].vui.num_units_in_tick * DeltaTfiDivisorIdx;
 					FPS = (Double)timescale / dts_inc;
 					detect_fps = 0;
+					avc_import_writer_del(writer);
+					writer = NULL;
 					gf_isom_remove_track(import->dest, track);
 					if (sample_data) gf_bs_del(sample_data);
 					gf_odf_avc_cfg_del(avccfg);
 					avccfg = NULL;
 					gf_odf_avc_cfg_del(svccfg);
 					svccfg = NULL;
-					gf_free(buffer);
-					buffer = NULL;
-					gf_bs_del(bs);
-					bs = NULL;
 					gf_f64_seek(mdia, 0, SEEK_SET);
 					goto restart_import;
 				}
@@ -4112,9 +4377,8 @@ restart_import:
 			break;
 		}
 
-		if (!nal_size) break;
-
 		if (flush_sample && sample_data) {
+			u32 group_type = 0;
 			GF_ISOSample *samp = gf_isom_sample_new();
 			samp->DTS = (u64)dts_inc*cur_samp;
 			samp->IsRAP = sample_is_rap;
@@ -4139,6 +4403,8 @@ restart_import:
 				samp->dataLength -= size_length/8 + prev_nalu_prefix_size;
 
 				if (set_subsamples) {
+					e = avc_import_writer_sync(writer);
+					if (e) goto exit;
 					/* determine the number of subsamples */
 					nb_subs = gf_isom_sample_has_subsamples(import->dest, track, cur_samp+1);
 					if (nb_subs) {
@@ -4165,27 +4431,24 @@ restart_import:
 			store the POC as the CTS offset and update the whole table at the end*/
 			samp->CTS_Offset = last_poc - poc_shift;
 			assert(last_poc >= poc_shift);
-			e = gf_isom_add_sample(import->dest, track, di, samp);
-			if (e) goto exit;
-
-			cur_samp++;
 
 			/*write sampleGroups info*/
 			if (!samp->IsRAP && (sei_recovery_frame_count>=0)) {
 				/*generic GDR*/
 				if (sei_recovery_frame_count) {
 					if (!use_opengop_gdr) use_opengop_gdr = 1;
-					e = gf_isom_set_sample_roll_group(import->dest, track, cur_samp, (s16) sei_recovery_frame_count);
+					group_type = 1;
 				} 
 				/*open-GOP*/
 				else if (sample_has_islice) {
 					if (!use_opengop_gdr) use_opengop_gdr = 2;
-					e = gf_isom_set_sample_rap_group(import->dest, track, cur_samp, 0);
+					group_type = 2;
 				}
-				if (e) goto exit;
 			}
+			cur_samp++;
+			e = avc_import_writer_push(writer, samp, cur_samp, group_type, (s16) sei_recovery_frame_count);
+			if (e) goto exit;
 
-			gf_isom_sample_del(&samp);
 			gf_set_progress("Importing AVC-H264", (u32) (nal_start/1024), (u32) (total_size/1024) );
 			first_nal = 1;
 
@@ -4204,6 +4467,8 @@ restart_import:
 				if (size_length+diff_size == 24) diff_size+=8;
 
 				gf_import_message(import, GF_OK, "Adjusting AVC SizeLength to %d bits", size_length+diff_size);
+				e = avc_import_writer_sync(writer);
+				if (e) goto exit;
 				gf_media_avc_rewrite_samples(import->dest, track, size_length, size_length+diff_size);
 
 				/*rewrite current sample*/
@@ -4251,6 +4516,8 @@ restart_import:
 				prio = (63 - (p[1] & 0x3F)) << 2;
 				
 				if (set_subsamples) {
+					e = avc_import_writer_sync(writer);
+					if (e) goto exit;
 					gf_isom_add_subsample(import->dest, track, cur_samp+1, copy_size+size_length/8, prio, res, 1);
 				}
 
@@ -4260,6 +4527,8 @@ restart_import:
 					priority_prev_nalu_prefix = prio;
 				}
 			} else if (set_subsamples) {
+				e = avc_import_writer_sync(writer);
+				if (e) goto exit;
 				/* use the res and priority value of last prefix NALU */
 				gf_isom_add_subsample(import->dest, track, cur_samp+1, copy_size+size_length/8, priority_prev_nalu_prefix, res_prev_nalu_prefix, 0);
 			}
@@ -4306,6 +4575,8 @@ restart_import:
 				if (avc.s_info.poc<poc_shift) {
 					u32 j;
 					if (ref_frame) {
+						e = avc_import_writer_sync(writer);
+						if (e) goto exit;
 						for (j=ref_frame; j<=cur_samp; j++) {
 							GF_ISOSample *samp = gf_isom_get_sample_info(import->dest, track, j, NULL, NULL);
 							if (!samp) break;
@@ -4371,31 +4642,21 @@ restart_import:
 			}
 		}
 
-		gf_bs_align(bs);
-		nal_end = gf_bs_get_position(bs);
-		assert(nal_start <= nal_end);
-		assert(nal_end <= nal_start + nal_size);
-		if (nal_end != nal_start + nal_size)
-			gf_bs_seek(bs, nal_start + nal_size);
-
-		if (!gf_bs_available(bs)) break;
+		if (!avc_import_reader_available(&reader)) break;
 		if (duration && (dts_inc*cur_samp > duration)) break;
 		if (import->flags & GF_IMPORT_DO_ABORT) break;
 
 		/*consume next start code*/
-		nal_start = AVC_NextStartCode(bs);
-		if (nal_start) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_CODING, ("[avc-h264] invalid nal_size (%u)? Skipping "LLU" bytes to reach next start code\n", nal_size, nal_start));
-			gf_bs_skip_bytes(bs, nal_start);
-		}
-		nal_start = AVC_IsStartCode(bs);
-		if (!nal_start) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_CODING, ("[avc-h264] error: no start code found ("LLU" bytes read out of "LLU") - leaving\n", gf_bs_get_position(bs), gf_bs_get_size(bs)));
+		if (!avc_import_reader_start_code(&reader)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_CODING, ("[avc-h264] error: no start code found ("LLU" bytes read out of "LLU") - leaving\n", reader.data_offset + reader.pos, total_size));
 			break;
 		}
-		nal_start = gf_bs_get_position(bs);
 	}
 
+	e = avc_import_writer_del(writer);
+	writer = NULL;
+	if (e) goto exit;
+
 	/*final flush*/
 	if (sample_data) {
 		GF_ISOSample *samp = gf_isom_sample_new();
@@ -4555,11 +4816,12 @@ restart_import:
 	}
 
 exit:
+	if (writer) avc_import_writer_del(writer);
 	if (sample_data) gf_bs_del(sample_data);
 	gf_odf_avc_cfg_del(avccfg);
 	gf_odf_avc_cfg_del(svccfg);
-	gf_free(buffer);
-	gf_bs_del(bs);
+	gf_free(reader.data);
+	if (bs) gf_bs_del(bs);
 	fclose(mdia);
 	return e;
 }
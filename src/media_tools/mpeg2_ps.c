@@ -52,8 +52,6 @@ static GFINLINE u32 convert32 (u8 *p)
 #endif
 }
 
-#define FDNULL 0
-
 /*
  * structure for passing timestamps around
  */
@@ -78,11 +76,14 @@ typedef struct mpeg2ps_record_pes_t
 typedef struct mpeg2ps_stream_t 
 {
   mpeg2ps_record_pes_t *record_first, *record_last;
-  FILE *m_fd;
+  mpeg2ps_t *ps;
   Bool is_video;
   u8 m_stream_id;    // program stream id
   u8 m_substream_id; // substream, for program stream id == 0xbd
 
+  // location of the next pes to read for this stream
+  s64 pes_pos;
+
   mpeg2ps_ts_t next_pes_ts, frame_ts;
   u32 frames_since_last_ts;
   u64 last_ts;
@@ -128,6 +129,13 @@ struct mpeg2ps_ {
   mpeg2ps_stream_t *audio_streams[32];
   char *filename;
   FILE *fd;
+  /*
+   * read buffer - all streams are read through the same file handle.
+   * buf_offset is the file location of buf[0]
+   */
+  u8 *buf;
+  u32 buf_size, buf_alloc, buf_pos;
+  s64 buf_offset;
   u64 first_dts;
   u32 audio_cnt, video_cnt;
   s64 end_loc;
@@ -135,8 +143,12 @@ struct mpeg2ps_ {
   u64 max_time;  // time is in msec.
 };
 
+#define MPEG2PS_READ_BUFFER_SIZE (256 * 1024)
+
 /*************************************************************************
- * File access routines.  Could all be inlined
+ * File access routines.  Everything is read through the buffer of the
+ * mpeg2ps_t, so skipping over the pes of other streams is only a pointer
+ * move most of the time
  *************************************************************************/
 static FILE *file_open (const char *name)
 {
@@ -153,22 +165,55 @@ static void file_close (FILE *fd)
   fclose(fd);
 }
 
-static Bool file_read_bytes(FILE *fd,
+/*
+ * file_fill - make sure we have len bytes in the buffer
+ */
+static Bool file_fill (mpeg2ps_t *ps, u32 len)
+{
+  u32 left = ps->buf_size - ps->buf_pos;
+  if (left >= len) return 1;
+  if (len > ps->buf_alloc) return 0;
+
+  memmove(ps->buf, ps->buf + ps->buf_pos, left);
+  ps->buf_offset += ps->buf_pos;
+  ps->buf_pos = 0;
+  ps->buf_size = left + (u32) fread(ps->buf + left, 1, ps->buf_alloc - left, ps->fd);
+  return (ps->buf_size >= len) ? 1 : 0;
+}
+
+static Bool file_read_bytes(mpeg2ps_t *ps,
 			     u8 *buffer, 
 			     u32 len)
 {
-  u32 readval = fread(buffer, 1, len, fd);
-  return readval == len;
+  if (file_fill(ps, len) == 0) {
+    ps->buf_pos = ps->buf_size;
+    return 0;
+  }
+  memcpy(buffer, ps->buf + ps->buf_pos, len);
+  ps->buf_pos += len;
+  return 1;
 }
 
-// note: len could be negative.
-static void file_skip_bytes (FILE *fd, s32 len)
+#define file_location(__ps) ((__ps)->buf_offset + (__ps)->buf_pos)
+
+static void file_seek_to (mpeg2ps_t *ps, s64 loc)
 {
-  gf_f64_seek(fd, len, SEEK_CUR);
+  if (loc < 0) loc = 0;
+  // stay in the buffer if we can
+  if (loc >= ps->buf_offset && loc <= ps->buf_offset + ps->buf_size) {
+    ps->buf_pos = (u32) (loc - ps->buf_offset);
+    return;
+  }
+  gf_f64_seek(ps->fd, loc, SEEK_SET);
+  ps->buf_offset = loc;
+  ps->buf_pos = ps->buf_size = 0;
 }
 
-#define file_location(__f) gf_f64_tell(__f)
-#define file_seek_to(__f, __off) gf_f64_seek(__f, __off, SEEK_SET)
+// note: len could be negative.
+static void file_skip_bytes (mpeg2ps_t *ps, s32 len)
+{
+  file_seek_to(ps, file_location(ps) + len);
+}
 
 static u64 file_size(FILE *fd)
 {
@@ -363,11 +408,13 @@ static u64 read_pts (u8 *pak)
 }
 
 
-static mpeg2ps_stream_t *mpeg2ps_stream_create (u8 stream_id,
+static mpeg2ps_stream_t *mpeg2ps_stream_create (mpeg2ps_t *ps,
+						u8 stream_id,
 						u8 substream)
 {
   mpeg2ps_stream_t *ptr;
   GF_SAFEALLOC(ptr, mpeg2ps_stream_t);
+  ptr->ps = ps;
   ptr->m_stream_id = stream_id;
   ptr->m_substream_id = substream;
   ptr->is_video = stream_id >= 0xe0;
@@ -384,10 +431,6 @@ static void mpeg2ps_stream_destroy (mpeg2ps_stream_t *sptr)
     sptr->record_first = p->next_rec;
     gf_free(p);
   }
-  if (sptr->m_fd != FDNULL) {
-    file_close(sptr->m_fd);
-    sptr->m_fd = FDNULL;
-  }
   if (sptr->pes_buffer) gf_free(sptr->pes_buffer);
   gf_free(sptr);
 }
@@ -397,7 +440,7 @@ static void mpeg2ps_stream_destroy (mpeg2ps_stream_t *sptr)
  * adv_past_pack_hdr - read the pack header, advance past it
  * we don't do anything with the data
  */
-static void adv_past_pack_hdr (FILE *fd, 
+static void adv_past_pack_hdr (mpeg2ps_t *ps,
 			       u8 *pak,
 			       u32 read_from_start)
 {
@@ -405,73 +448,53 @@ static void adv_past_pack_hdr (FILE *fd,
   u8 readbyte;
   u8 val;
   if (read_from_start < 5) {
-    file_skip_bytes(fd, 5 - read_from_start);
-    file_read_bytes(fd, &readbyte, 1);
+    file_skip_bytes(ps, 5 - read_from_start);
+    file_read_bytes(ps, &readbyte, 1);
     val = readbyte;
   } else {
     val = pak[4];
   }
-    
+
   // we've read 6 bytes
   if ((val & 0xc0) != 0x40) {
     // mpeg1
-    file_skip_bytes(fd, 12 - read_from_start); // skip 6 more bytes
+    file_skip_bytes(ps, 12 - read_from_start); // skip 6 more bytes
     return;
   }
-  file_skip_bytes(fd, 13 - read_from_start);
-  file_read_bytes(fd, &readbyte, 1);
+  file_skip_bytes(ps, 13 - read_from_start);
+  file_read_bytes(ps, &readbyte, 1);
   stuffed = readbyte & 0x7;
-  file_skip_bytes(fd, stuffed);
+  file_skip_bytes(ps, stuffed);
 }
 
 /*
  * find_pack_start
- * look for the pack start code in the file - read 512 bytes at a time, 
- * searching for that code.
+ * look for the pack start code in the file, starting with the len bytes
+ * we just read - we search the read buffer for that code.
  * Note: we may also be okay looking for >= 00 00 01 bb
  */
-static Bool find_pack_start (FILE *fd, 
-			     u8 *saved,
+static Bool find_pack_start (mpeg2ps_t *ps,
 			     u32 len)
 {
-  u8 buffer[512];
-  u32 buffer_on = 0, new_offset, scode;
-  memcpy(buffer, saved, len);
-  if (file_read_bytes(fd, buffer + len, sizeof(buffer) - len) == 0) {
-    return 0;
-  }
+  u32 avail, new_offset, scode;
+  file_skip_bytes(ps, -(s32)len);
   while (1) {
-    if (gf_mv12_next_start_code(buffer + buffer_on,
-				 sizeof(buffer) - buffer_on, 
+    if (file_fill(ps, 4) == 0) {
+      return 0;
+    }
+    avail = ps->buf_size - ps->buf_pos;
+    if (gf_mv12_next_start_code(ps->buf + ps->buf_pos,
+				 avail,
 				 &new_offset, 
 				 &scode) >= 0) {
-      buffer_on += new_offset;
+      ps->buf_pos += new_offset;
       if (scode == MPEG2_PS_PACKSTART) {
-	file_skip_bytes(fd, buffer_on - 512); // go back to header
 	return 1;
       }
-      buffer_on += 1;
+      ps->buf_pos += 1;
     } else {
-      len = 0;
-      if (buffer[sizeof(buffer) - 3] == 0 &&
-	  buffer[sizeof(buffer) - 2] == 0 &&
-	  buffer[sizeof(buffer) - 1] == 1) {
-	buffer[0] = 0;
-	buffer[1] = 0;
-	buffer[2] = 1;
-	len = 3;
-      } else if (*(u16 *)(buffer + sizeof(buffer) - 2) == 0) {
-	buffer[0] = 0;
-	buffer[1] = 0;
-	len = 2;
-      } else if (buffer[sizeof(buffer) - 1] == 0) {
-	buffer[0] = 0;
-	len = 1;
-      }
-      if (file_read_bytes(fd, buffer + len, sizeof(buffer) - len) == 0) {
-	return 0;
-      }
-      buffer_on = 0;
+      // keep the last 3 bytes, they may be the start of the code
+      ps->buf_pos += avail - 3;
     }
   }
   return 0;
@@ -504,7 +527,7 @@ static void copy_bytes_to_pes_buffer (mpeg2ps_stream_t *sptr,
       sptr->pes_buffer_size_max = to_move + pes_len + 2048;
     }
   }
-  file_read_bytes(sptr->m_fd, sptr->pes_buffer + sptr->pes_buffer_size, pes_len);
+  file_read_bytes(sptr->ps, sptr->pes_buffer + sptr->pes_buffer_size, pes_len);
   sptr->pes_buffer_size += pes_len;
 #if 0
   printf("copying %u bytes - on %u size %u\n",
@@ -519,7 +542,7 @@ static void copy_bytes_to_pes_buffer (mpeg2ps_stream_t *sptr,
  * 00 00 01 and the next byte > 0xbb.
  * We return the pes len to read, and the "next byte"
  */
-static Bool read_to_next_pes_header (FILE *fd, 
+static Bool read_to_next_pes_header (mpeg2ps_t *ps,
 				     u8 *stream_id,
 				     u16 *pes_len)
 {
@@ -528,7 +551,7 @@ static Bool read_to_next_pes_header (FILE *fd,
 
   while (1) {
     // read the pes header
-    if (file_read_bytes(fd, local, 6) == 0) {
+    if (file_read_bytes(ps, local, 6) == 0) {
       return 0;
     }
 
@@ -537,18 +560,18 @@ static Bool read_to_next_pes_header (FILE *fd,
     // we might want to also read until next PES - look into that.
     if (((hdr & MPEG2_PS_START_MASK) != MPEG2_PS_START) ||
 	(hdr < MPEG2_PS_END)) {
-      if (find_pack_start(fd, local, 6) == 0) {
+      if (find_pack_start(ps, 6) == 0) {
 	return 0;
       }
       continue;
     }
     if (hdr == MPEG2_PS_PACKSTART) {
       // pack start code - we can skip down
-      adv_past_pack_hdr(fd, local, 6);
+      adv_past_pack_hdr(ps, local, 6);
       continue;
     }
     if (hdr == MPEG2_PS_END) {
-      file_skip_bytes(fd, -2);
+      file_skip_bytes(ps, -2);
       continue;
     }
 
@@ -556,7 +579,7 @@ static Bool read_to_next_pes_header (FILE *fd,
     *stream_id = hdr & 0xff;
     *pes_len = convert16(local + 4);
 #if 0
-    printf("loc: "X64" %x len %u\n", file_location(fd) - 6,
+    printf("loc: "X64" %x len %u\n", file_location(ps) - 6,
 	   local[3],
 	   *pes_len);
 #endif
@@ -570,7 +593,7 @@ static Bool read_to_next_pes_header (FILE *fd,
  * this should read past the pes header for the audio and video streams
  * it will store the timestamps if it reads them
  */
-static Bool read_pes_header_data (FILE *fd, 
+static Bool read_pes_header_data (mpeg2ps_t *ps,
 				  u16 orig_pes_len,
 				  u16 *pes_left,
 				  Bool *have_ts,
@@ -583,12 +606,12 @@ static Bool read_pes_header_data (FILE *fd,
   ts->have_pts = 0;
   ts->have_dts = 0;
   *have_ts = 0;
-  if (file_read_bytes(fd, local, 1) == 0) {
+  if (file_read_bytes(ps, local, 1) == 0) {
     return 0;
   }
   pes_len--; // remove this first byte from length
   while (*local == 0xff) {
-    if (file_read_bytes(fd, local, 1) == 0) {
+    if (file_read_bytes(ps, local, 1) == 0) {
       return 0;
     }
     pes_len--;
@@ -599,8 +622,8 @@ static Bool read_pes_header_data (FILE *fd,
   }
   if ((*local & 0xc0) == 0x40) { 
     // buffer scale & size
-    file_skip_bytes(fd, 1);
-    if (file_read_bytes(fd, local, 1) == 0) {
+    file_skip_bytes(ps, 1);
+    if (file_read_bytes(ps, local, 1) == 0) {
       return 0;
     }
     pes_len -= 2;
@@ -608,7 +631,7 @@ static Bool read_pes_header_data (FILE *fd,
 
   if ((*local & 0xf0) == 0x20) {
     // mpeg-1 with pts
-    if (file_read_bytes(fd, local + 1, 4) == 0) {
+    if (file_read_bytes(ps, local + 1, 4) == 0) {
       return 0;
     }
     ts->have_pts = 1;
@@ -618,7 +641,7 @@ static Bool read_pes_header_data (FILE *fd,
     pes_len -= 4;
   } else if ((*local & 0xf0) == 0x30) {
     // have mpeg 1 pts and dts
-    if (file_read_bytes(fd, local + 1, 9) == 0) {
+    if (file_read_bytes(ps, local + 1, 9) == 0) {
       return 0;
     }
     ts->have_pts = 1;
@@ -629,7 +652,7 @@ static Bool read_pes_header_data (FILE *fd,
     pes_len -= 9;
   } else if ((*local & 0xc0) == 0x80) {
     // mpeg2 pes header  - we're pointing at the flags field now
-    if (file_read_bytes(fd, local + 1, 2) == 0) {
+    if (file_read_bytes(ps, local + 1, 2) == 0) {
       return 0;
     }
     hdr_len = local[2];
@@ -637,7 +660,7 @@ static Bool read_pes_header_data (FILE *fd,
     if ((local[1] & 0xc0) == 0x80) {
       // just pts
       ts->have_pts = 1;
-      file_read_bytes(fd, local, 5);
+      file_read_bytes(ps, local, 5);
       ts->pts = ts->dts = read_pts(local);
       *have_ts = 1;
       hdr_len -= 5;
@@ -646,16 +669,16 @@ static Bool read_pes_header_data (FILE *fd,
       ts->have_pts = 1;
       ts->have_dts = 1;
       *have_ts = 1;
-      file_read_bytes(fd, local, 10);
+      file_read_bytes(ps, local, 10);
       ts->pts = read_pts(local);
       ts->dts = read_pts(local  + 5);    
       hdr_len -= 10;
     }
-    file_skip_bytes(fd, hdr_len);
+    file_skip_bytes(ps, hdr_len);
   } else if (*local != 0xf) {
-    file_skip_bytes(fd, pes_len);
+    file_skip_bytes(ps, pes_len);
     pes_len = 0;
-  } 
+  }
   *pes_left = pes_len;
   return 1;
 }
@@ -665,23 +688,24 @@ static Bool search_for_next_pes_header (mpeg2ps_stream_t *sptr,
 					Bool *have_ts, 
 					s64 *found_loc)
 {
+  mpeg2ps_t *ps = sptr->ps;
   u8 stream_id;
   u8 local;
   s64 loc;
   while (1) {
     // this will read until we find the next pes.  We don't know if the
     // stream matches - this will read over pack headers
-    if (read_to_next_pes_header(sptr->m_fd, &stream_id, pes_len) == 0) {
+    if (read_to_next_pes_header(ps, &stream_id, pes_len) == 0) {
       return 0;
     }
 
     if (stream_id != sptr->m_stream_id) {
-      file_skip_bytes(sptr->m_fd, *pes_len);
+      file_skip_bytes(ps, *pes_len);
       continue;
     }
-    loc = file_location(sptr->m_fd) - 6; 
+    loc = file_location(ps) - 6; 
     // advance past header, reading pts
-    if (read_pes_header_data(sptr->m_fd, 
+    if (read_pes_header_data(ps, 
 			     *pes_len, 
 			     pes_len, 
 			     have_ts, 
@@ -693,17 +717,19 @@ static Bool search_for_next_pes_header (mpeg2ps_stream_t *sptr,
     // matches.
     if (sptr->m_stream_id == 0xbd) {
       // ac3 or pcm
-      file_read_bytes(sptr->m_fd, &local, 1);
+      if (file_read_bytes(ps, &local, 1) == 0) {
+	return 0;
+      }
       *pes_len -= 1;
       if (local != sptr->m_substream_id) {
-	file_skip_bytes(sptr->m_fd, *pes_len);
+	file_skip_bytes(ps, *pes_len);
 	continue; // skip to the next one
       }
       *pes_len -= 3;
-      file_skip_bytes(sptr->m_fd, 3); // 4 bytes - we don't need now...
+      file_skip_bytes(ps, 3); // 4 bytes - we don't need now...
       // we need more here...
     }
-    if (have_ts) {
+    if (*have_ts) {
       mpeg2ps_record_pts(sptr, loc, &sptr->next_pes_ts);
     }
     if (found_loc != NULL) *found_loc = loc;
@@ -715,25 +741,27 @@ static Bool search_for_next_pes_header (mpeg2ps_stream_t *sptr,
 /*
  * mpeg2ps_stream_read_next_pes_buffer - for the given stream, 
  * go forward in the file until the next PES for the stream is read.  Read
- * the header (pts, dts), and read the data into the pes_buffer pointer
+ * the header (pts, dts), and read the data into the pes_buffer pointer.
+ * All streams read through the buffer of the mpeg2ps_t, each from its
+ * own location
  */
 static Bool mpeg2ps_stream_read_next_pes_buffer (mpeg2ps_stream_t *sptr)
 {
   u16 pes_len;
   Bool have_ts;
+  Bool ret;
 
-  if (search_for_next_pes_header(sptr, &pes_len, &have_ts, NULL) == 0) {
-    return 0;
-  }
-
-  copy_bytes_to_pes_buffer(sptr, pes_len);
-
-  return 1;
+  file_seek_to(sptr->ps, sptr->pes_pos);
+  ret = search_for_next_pes_header(sptr, &pes_len, &have_ts, NULL);
+  if (ret) copy_bytes_to_pes_buffer(sptr, pes_len);
+  sptr->pes_pos = file_location(sptr->ps);
+  return ret;
 }
 
 
 /***************************************************************************
- * Frame reading routine.  For each stream, the fd's should be different.
+ * Frame reading routine.  All streams share the file, see
+ * mpeg2ps_stream_read_next_pes_buffer.
  * we will read from the pes stream, and save it in the stream's pes buffer.
  * This will give us raw data that we can search through for frame headers, 
  * and the like.  We shouldn't read more than we need - when we need to read, 
@@ -1006,7 +1034,6 @@ static void get_info_from_frame (mpeg2ps_stream_t *sptr,
 			       &sptr->bit_rate,
 			       &sptr->par) < 0) {
       sptr->m_stream_id = 0;
-      sptr->m_fd = FDNULL;
     }
     sptr->ticks_per_frame = (u64)(90000.0 / sptr->frame_rate);
     return;
@@ -1053,6 +1080,16 @@ static void clear_stream_buffer (mpeg2ps_stream_t *sptr)
   sptr->frame_ts.have_dts = sptr->frame_ts.have_pts = 0;
 }
 
+/*
+ * stream_reset - drop the data we have for the stream.  The next read
+ * will start at loc
+ */
+static void stream_reset (mpeg2ps_stream_t *sptr, s64 loc)
+{
+  clear_stream_buffer(sptr);
+  sptr->pes_pos = loc;
+}
+
 /*
  * convert_to_msec - convert ts (at 90000) to msec, based on base_ts and
  * frames_since_last_ts.
@@ -1123,7 +1160,7 @@ static Bool add_stream (mpeg2ps_t *ps,
 
   // need to add
 
-  sptr = mpeg2ps_stream_create(stream_id, substream);
+  sptr = mpeg2ps_stream_create(ps, stream_id, substream);
   sptr->first_pes_loc = first_loc;
   if (ts == NULL ||
       (ts->have_dts == 0 && ts->have_pts == 0)) {
@@ -1147,14 +1184,6 @@ static Bool add_stream (mpeg2ps_t *ps,
   return 1;
 }
 
-static void check_fd_for_stream (mpeg2ps_t *ps, 
-			  mpeg2ps_stream_t *sptr)
-{
-  if (sptr->m_fd != FDNULL) return;
-
-  sptr->m_fd = file_open(ps->filename);
-}
-
 /*
  * advance_frame - when we're reading frames, this indicates that we're
  * done.  We will call this when we read a frame, but not when we
@@ -1186,8 +1215,6 @@ static void get_info_for_all_streams (mpeg2ps_t *ps)
   u8 *buffer;
   u32 buflen;
 
-	file_seek_to(ps->fd, 0);
-
   // av will be 0 for video streams, 1 for audio streams
   // av is just so I don't have to dup a lot of code that does the
   // same thing.
@@ -1198,16 +1225,14 @@ static void get_info_for_all_streams (mpeg2ps_t *ps)
       if (av == 0) sptr = ps->video_streams[stream_ix];
       else sptr = ps->audio_streams[stream_ix];
 
-      // we don't open a seperate file descriptor yet (only when they
-      // start reading or seeking).  Use the one from the ps.
-      sptr->m_fd = ps->fd; // for now
-      clear_stream_buffer(sptr);
+      // each stream is read from the start of the file, alone
+      stream_reset(sptr, 0);
       if (mpeg2ps_stream_read_frame(sptr,
 				    &buffer, 
 				    &buflen,
 				    0) == 0) {
+	stream_reset(sptr, 0);
 	sptr->m_stream_id = 0;
-	sptr->m_fd = FDNULL;
 	continue;
       }
       get_info_from_frame(sptr, buffer, buflen);
@@ -1240,8 +1265,7 @@ static void get_info_for_all_streams (mpeg2ps_t *ps)
 	  }
 	}
       }
-      clear_stream_buffer(sptr);
-      sptr->m_fd = FDNULL;
+      stream_reset(sptr, 0);
     }
   }
 }
@@ -1272,12 +1296,12 @@ static void mpeg2ps_scan_file (mpeg2ps_t *ps)
    * the file size / 50
    */
   loc = 0;
-  while (read_to_next_pes_header(ps->fd, &stream_id, &pes_len) && 
+  while (read_to_next_pes_header(ps, &stream_id, &pes_len) && 
 	 loc < check) {
     pes_left = pes_len;
     if (stream_id >= 0xbd && stream_id < 0xf0) {
-      loc = file_location(ps->fd) - 6;
-      if (read_pes_header_data(ps->fd, 
+      loc = file_location(ps) - 6;
+      if (read_pes_header_data(ps, 
 			       pes_len, 
 			       &pes_left, 
 			       &have_ts, 
@@ -1287,7 +1311,7 @@ static void mpeg2ps_scan_file (mpeg2ps_t *ps)
       valid_stream = 0;
       substream = 0;
       if (stream_id == 0xbd) {
-	if (file_read_bytes(ps->fd, &substream, 1) == 0) {
+	if (file_read_bytes(ps, &substream, 1) == 0) {
 	  return;
 	}
 	pes_left--; // remove byte we just read
@@ -1325,7 +1349,7 @@ static void mpeg2ps_scan_file (mpeg2ps_t *ps)
 	}
       }
     }
-    file_skip_bytes(ps->fd, pes_left);
+    file_skip_bytes(ps, pes_left);
   }
   if (ps->video_cnt == 0 && ps->audio_cnt == 0) {
     return;
@@ -1335,12 +1359,12 @@ static void mpeg2ps_scan_file (mpeg2ps_t *ps)
    * dts that we can
    */
   //  printf("to end "X64"\n", end - orig_check);
-  file_seek_to(ps->fd, ps->end_loc - orig_check);
+  file_seek_to(ps, ps->end_loc - orig_check);
 
-  while (read_to_next_pes_header(ps->fd, &stream_id, &pes_len)) {
-    loc = file_location(ps->fd) - 6;
+  while (read_to_next_pes_header(ps, &stream_id, &pes_len)) {
+    loc = file_location(ps) - 6;
     if (stream_id == 0xbd || (stream_id >= 0xc0 && stream_id < 0xf0)) {
-      if (read_pes_header_data(ps->fd, 
+      if (read_pes_header_data(ps, 
 			       pes_len, 
 			       &pes_left, 
 			       &have_ts, 
@@ -1348,13 +1372,13 @@ static void mpeg2ps_scan_file (mpeg2ps_t *ps)
 	return;
       }
       if (stream_id == 0xbd) {
-	if (file_read_bytes(ps->fd, &substream, 1) == 0) {
+	if (file_read_bytes(ps, &substream, 1) == 0) {
 	  return;
 	}
 	pes_left--; // remove byte we just read
 	if (!((substream >= 0x80 && substream < 0x90) ||
 	      (substream >= 0xa0 && substream < 0xb0))) {
-	  file_skip_bytes(ps->fd, pes_left);
+	  file_skip_bytes(ps, pes_left);
 	  continue;
 	}
       } else {
@@ -1375,7 +1399,9 @@ static void mpeg2ps_scan_file (mpeg2ps_t *ps)
       if (ts.have_dts) printf(" dts "U64, ts.dts);
       printf("\n");
 #endif
-      file_skip_bytes(ps->fd, pes_left);
+      file_skip_bytes(ps, pes_left);
+    } else {
+      file_skip_bytes(ps, pes_len);
     }
   }
 
@@ -1418,18 +1444,15 @@ static void mpeg2ps_scan_file (mpeg2ps_t *ps)
       
       // pick up here - find the final time...
       if (sptr->end_dts_loc != 0) {
-	file_seek_to(ps->fd, sptr->end_dts_loc);
-	sptr->m_fd = ps->fd;
+	stream_reset(sptr, sptr->end_dts_loc);
 	frame_cnt_since_last = 0;
-	clear_stream_buffer(sptr);
 	while (mpeg2ps_stream_read_frame(sptr,
 					 &buffer, 
 					 &buflen,
 					 1)) {
 	  frame_cnt_since_last++;
 	}
-	sptr->m_fd = FDNULL;
-	clear_stream_buffer(sptr);
+	stream_reset(sptr, 0);
 	ps->max_time = MAX(ps->max_time, 
 			   convert_ts(sptr, 
 				      TS_MSEC,
@@ -1441,7 +1464,7 @@ static void mpeg2ps_scan_file (mpeg2ps_t *ps)
   }
 
   ps->max_dts = (ps->max_time * 90) + ps->first_dts;
-  file_seek_to(ps->fd, 0);
+  file_seek_to(ps, 0);
 }
 
 /*************************************************************************
@@ -1614,6 +1637,8 @@ mpeg2ps_t *mpeg2ps_init (const char *filename)
     gf_free(ps);
     return NULL;
   }
+  ps->buf_alloc = MPEG2PS_READ_BUFFER_SIZE;
+  ps->buf = (u8 *)gf_malloc(ps->buf_alloc);
   
   ps->filename = gf_strdup(filename);
   mpeg2ps_scan_file(ps);
@@ -1639,14 +1664,10 @@ void mpeg2ps_close (mpeg2ps_t *ps)
 
   if (ps->filename) gf_free(ps->filename);
   if (ps->fd) file_close(ps->fd);
+  if (ps->buf) gf_free(ps->buf);
   gf_free(ps);
 }
 
-/*
- * check_fd_for_stream will make sure we have a fd for the stream we're
- * trying to read - we use a different fd for each stream
- */
-
 /*
  * stream_convert_frame_ts_to_msec - given a "read" frame, we'll
  * calculate the msec and freq timestamps.  This can be called more
@@ -1691,7 +1712,6 @@ Bool mpeg2ps_get_video_frame(mpeg2ps_t *ps, u32 streamno,
   if (invalid_video_streamno(ps, streamno)) return 0;
 
   sptr = ps->video_streams[streamno];
-  check_fd_for_stream(ps, sptr);
 
   if (sptr->have_frame_loaded == 0) {
     // if we don't have the frame in the buffer (like after a seek), 
@@ -1734,7 +1754,6 @@ Bool mpeg2ps_get_audio_frame(mpeg2ps_t *ps, u32 streamno,
   if (invalid_audio_streamno(ps, streamno)) return 0;
 
   sptr = ps->audio_streams[streamno];
-  check_fd_for_stream(ps, sptr);
 
   if (sptr->have_frame_loaded == 0) {
     if (mpeg2ps_stream_read_frame(sptr, buffer, buflen, 0) == 0) 
@@ -1757,17 +1776,18 @@ Bool mpeg2ps_get_audio_frame(mpeg2ps_t *ps, u32 streamno,
 
 u64 mpeg2ps_get_ps_size(mpeg2ps_t *ps)
 {
-	return file_size(ps->fd);
+	return ps->end_loc;
 }
+
 s64 mpeg2ps_get_video_pos(mpeg2ps_t *ps, u32 streamno)
 {
   if (invalid_video_streamno(ps, streamno)) return 0;
-  return gf_f64_tell(ps->video_streams[streamno]->m_fd);
+  return ps->video_streams[streamno]->pes_pos;
 }
 s64 mpeg2ps_get_audio_pos(mpeg2ps_t *ps, u32 streamno)
 {
   if (invalid_audio_streamno(ps, streamno)) return 0;
-  return gf_f64_tell(ps->audio_streams[streamno]->m_fd);
+  return ps->audio_streams[streamno]->pes_pos;
 }
 
 #endif /*GPAC_DISABLE_MPEG2PS*/
@@ -129,12 +129,16 @@ static u32 gf_m2ts_reframe_avc_h264(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Bool
 
 	while (sc_pos<data_len) {
 		/* u32 sctype=0;*/
-		unsigned char *start = (unsigned char *)memchr(data+sc_pos, 0, data_len-sc_pos);
-		if (!start) break;
-		sc_pos = start - data;
+		unsigned char *start;
+		/*locate next 0x000000 or 0x000001 - other null bytes only cancel a pending escape code*/
+		u32 next_pos = sc_pos + gf_media_next_start_code_ex(data+sc_pos, data_len-sc_pos, 0xFE, 0x00);
+		if (esc_code_found && (next_pos > sc_pos) && memchr(data+sc_pos, 0, next_pos-sc_pos))
+			esc_code_found = 0;
+		sc_pos = next_pos;
 		/*not enough space to test for start code, don't check it*/
 		if (data_len - sc_pos < 5)
 			break;
+		start = data + sc_pos;
 
 		/*0x00000001 start code*/
 		if (!start[1] && !start[2] && (start[3]==1)) {
@@ -276,9 +280,12 @@ static u32 gf_m2ts_reframe_mpeg_video(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Boo
 	pck.flags = 0;
 
 	while (sc_pos+4<data_len) {
-		unsigned char *start = (unsigned char*)memchr(data+sc_pos, 0, data_len-sc_pos);
-		if (!start) break;
-		sc_pos = start - (unsigned char*)data;
+		unsigned char *start;
+		/*the start code value byte must be in the buffer*/
+		u32 next_pos = sc_pos + gf_media_next_start_code(data+sc_pos, data_len-1-sc_pos);
+		if (next_pos == data_len-1) break;
+		sc_pos = next_pos;
+		start = data + sc_pos;
 
 		/*found picture or sequence start_code*/
 		if (!start[1] && (start[2]==0x01)) {
@@ -26,8 +26,12 @@
 int gexp[512];
 int glog[256];
 
+/* full multiplication table, gmul_table[a][b] = a*b */
+static u8 gmul_table[256][256];
+
 
 static void init_exp_table (void);
+static void init_mult_table (void);
 
 
 void
@@ -35,6 +39,7 @@ init_galois_tables (void)
 {	
   /* initialize the table of powers of alpha */
   init_exp_table();
+  init_mult_table();
 }
 
 
@@ -65,24 +70,28 @@ init_exp_table (void)
     gexp[i+255] = gexp[i];
   }
 	
-  for (i = 1; i < 256; i++) {
-    for (z = 0; z < 256; z++) {
-      if (gexp[z] == i) {
-	glog[i] = z;
-	break;
-      }
+  /* gexp[] is a permutation of 1..255 over [0, 254], first match is the lowest exponent */
+  for (z = 254; z >= 0; z--) glog[gexp[z]] = z;
+}
+
+static void
+init_mult_table (void)
+{
+  int a, b;
+  for (a = 0; a < 256; a++) {
+    gmul_table[0][a] = gmul_table[a][0] = 0;
+  }
+  for (a = 1; a < 256; a++) {
+    for (b = 1; b < 256; b++) {
+      gmul_table[a][b] = (u8) gexp[glog[a] + glog[b]];
     }
   }
 }
 
-/* multiplication using logarithms */
+/* multiplication using the precomputed table */
 int gmult(int a, int b)
 {
-  int i,j;
-  if (a==0 || b == 0) return (0);
-  i = glog[a];
-  j = glog[b];
-  return (gexp[i+j]);
+  return gmul_table[a][b];
 }
 		
 
@@ -152,16 +161,18 @@ Modified_Berlekamp_Massey (void)
     d = compute_discrepancy(psi, synBytes, L, n);
 		
     if (d != 0) {
+      const u8 *mul_d = gmul_table[d];
 		
       /* psi2 = psi - d*D */
-      for (i = 0; i < MAXDEG; i++) psi2[i] = psi[i] ^ gmult(d, D[i]);
+      for (i = 0; i < MAXDEG; i++) psi2[i] = psi[i] ^ mul_d[D[i]];
 		
 		
       if (L < (n-k)) {
+	const u8 *mul_inv_d = gmul_table[ginv(d)];
 	L2 = n-k;
 	k = n-L;
 	/* D = scale_poly(ginv(d), psi); */
-	for (i = 0; i < MAXDEG; i++) D[i] = gmult(psi[i], ginv(d));
+	for (i = 0; i < MAXDEG; i++) D[i] = mul_inv_d[psi[i]];
 	L = L2;
       }
 			
@@ -199,21 +210,15 @@ void
 mult_polys (int dst[], int p1[], int p2[])
 {
   int i, j;
-  int tmp1[MAXDEG*2];
 	
   for (i=0; i < (MAXDEG*2); i++) dst[i] = 0;
 	
   for (i = 0; i < MAXDEG; i++) {
-    for(j=MAXDEG; j<(MAXDEG*2); j++) tmp1[j]=0;
-		
-    /* scale tmp1 by p1[i] */
-    for(j=0; j<MAXDEG; j++) tmp1[j]=gmult(p2[j], p1[i]);
-    /* and mult (shift) tmp1 right by i */
-    for (j = (MAXDEG*2)-1; j >= i; j--) tmp1[j] = tmp1[j-i];
-    for (j = 0; j < i; j++) tmp1[j] = 0;
-		
-    /* add into partial product */
-    for(j=0; j < (MAXDEG*2); j++) dst[j] ^= tmp1[j];
+    const u8 *mul_p1;
+    if (!p1[i]) continue;
+    /* add p2 scaled by p1[i] and shifted right by i into the product, terms above MAXDEG*2 are dropped */
+    mul_p1 = gmul_table[p1[i]];
+    for (j = 0; (j < MAXDEG) && (i+j < MAXDEG*2); j++) dst[i+j] ^= mul_p1[p2[j]];
   }
 }
 
@@ -256,7 +261,7 @@ compute_discrepancy (int lambda[], int S[], int L, int n)
   int i, sum=0;
 	
   for (i = 0; i <= L; i++) 
-    sum ^= gmult(lambda[i], S[n-i]);
+    sum ^= gmul_table[lambda[i]][S[n-i]];
   return (sum);
 }
 
@@ -277,7 +282,8 @@ void copy_poly (int dst[], int src[])
 void scale_poly (int k, int poly[]) 
 {	
   int i;
-  for (i = 0; i < MAXDEG; i++) poly[i] = gmult(k, poly[i]);
+  const u8 *mul_k = gmul_table[k];
+  for (i = 0; i < MAXDEG; i++) poly[i] = mul_k[poly[i]];
 }
 
 
@@ -307,19 +313,28 @@ static void mul_z_poly (int src[])
 void 
 Find_Roots (void)
 {
-  int sum, r, k;	
+  int sum, r, k, deg;	
+  int terms[NPAR+1];
   NErrors = 0;
+
+  /* Chien search: terms[k] holds Lambda[k]*alpha^(k*r), updated with one table lookup per step */
+  deg = 0;
+  for (k = 0; k < NPAR+1; k++) {
+    terms[k] = Lambda[k];
+    if (Lambda[k]) deg = k;
+  }
   
   for (r = 1; r < 256; r++) {
-    sum = 0;
+    sum = terms[0];
     /* evaluate lambda at r */
-    for (k = 0; k < NPAR+1; k++) {
-      sum ^= gmult(gexp[(k*r)%255], Lambda[k]);
+    for (k = 1; k <= deg; k++) {
+      terms[k] = gmul_table[terms[k]][gexp[k]];
+      sum ^= terms[k];
     }
     if (sum == 0) 
       { 
 	ErrorLocs[NErrors] = (255-r); NErrors++; 
-	if (DEBUG) fprintf(stderr, "Root found at r = %d, (255-r) = %d\n", r, (255-r));
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[RS] Root found at r = %d, (255-r) = %d\n", r, (255-r)));
       }
   }
 }
@@ -360,7 +375,7 @@ correct_errors_erasures (unsigned char codeword[],
     /* first check for illegal error locs */
     for (r = 0; r < NErrors; r++) {
       if (ErrorLocs[r] >= csize) {
-	if (DEBUG) fprintf(stderr, "Error loc i=%d outside of codeword length %d\n", i, csize);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[RS] Error loc i=%d outside of codeword length %d\n", ErrorLocs[r], csize));
 	return(0);
       }
     }
@@ -381,14 +396,14 @@ correct_errors_erasures (unsigned char codeword[],
       }
       
       err = gmult(num, ginv(denom));
-      if (DEBUG) fprintf(stderr, "Error magnitude %#x at loc %d\n", err, csize-i);
+      GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[RS] Error magnitude %#x at loc %d\n", err, csize-i));
       
       codeword[csize-i-1] ^= err;
     }
     return(1);
   }
   else {
-    if (DEBUG && NErrors) fprintf(stderr, "Uncorrectable codeword\n");
+    if (NErrors) GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[RS] Uncorrectable codeword\n"));
     return(0);
   }
 }
@@ -419,6 +434,10 @@ correct_errors_erasures (unsigned char codeword[],
  void  
  initialize_ecc ()  
  {  
+   static int ecc_initialized = 0;
+   if (ecc_initialized) return;
+   ecc_initialized = 1;
+
    /* Initialize the galois field arithmetic tables */  
      init_galois_tables();  
    
@@ -480,9 +499,10 @@ correct_errors_erasures (unsigned char codeword[],
  {  
    int i, j, sum;  
    for (j = 0; j < NPAR;  j++) {  
+     const u8 *mul_aj = gmul_table[gexp[j+1]];
      sum = 0;  
      for (i = 0; i < nbytes; i++) {  
-       sum = data[i] ^ gmult(gexp[j+1], sum);  
+       sum = data[i] ^ mul_aj[sum];
      }  
      synBytes[j]  = sum;  
    }  
@@ -500,6 +520,175 @@ correct_errors_erasures (unsigned char codeword[],
    return nz;  
  }  
    
+
+/********************************************************** 
+ * Frame decoder 
+ * 
+ * Decodes a whole frame stored column by column (rows bytes per column), 
+ * data_cols data columns followed by NPAR parity columns, as found in 
+ * MPE-FEC frames. Syndromes are computed for a block of rows at once 
+ * while walking the columns, and only rows with a non-zero syndrome 
+ * are gathered and corrected. 
+ */
+
+/* number of rows whose syndromes are computed together */
+#define RS_ROW_BLOCK	64
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <tmmintrin.h>
+#define GF_RS_SIMD_SSSE3
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define GF_RS_SIMD_NEON
+#endif
+
+#if defined(GF_RS_SIMD_SSSE3) || defined(GF_RS_SIMD_NEON)
+/* products of alpha^(j+1) with all low nibbles [0] and high nibbles [1], used as byte shuffle tables */
+static u8 syn_nibble_tables[NPAR][2][16];
+
+static void
+init_syndrome_tables (void)
+{
+  int j, x;
+  for (j = 0; j < NPAR; j++) {
+    const u8 *mul_aj = gmul_table[gexp[j+1]];
+    for (x = 0; x < 16; x++) {
+      syn_nibble_tables[j][0][x] = mul_aj[x];
+      syn_nibble_tables[j][1][x] = mul_aj[x<<4];
+    }
+  }
+}
+#endif
+
+/* Horner evaluation of the NPAR syndromes of rows [first_row, first_row+nb_rows[ */
+static void
+compute_block_syndromes (unsigned char *data, int data_cols, unsigned char *parity, int rows, int first_row, int nb_rows, u8 synd[NPAR][RS_ROW_BLOCK])
+{
+  int c, j, r;
+#if defined(GF_RS_SIMD_SSSE3)
+  __m128i nibble_mask = _mm_set1_epi8(0x0F);
+#elif defined(GF_RS_SIMD_NEON)
+  uint8x16_t nibble_mask = vdupq_n_u8(0x0F);
+#endif
+
+  memset(synd, 0, sizeof(u8)*NPAR*RS_ROW_BLOCK);
+  for (c = 0; c < data_cols + NPAR; c++) {
+    const u8 *col = (c < data_cols) ? data + c*rows : parity + (c-data_cols)*rows;
+    col += first_row;
+
+    for (j = 0; j < NPAR; j++) {
+      const u8 *mul_aj;
+      u8 *s = synd[j];
+      r = 0;
+#if defined(GF_RS_SIMD_SSSE3)
+      {
+	__m128i tlo = _mm_loadu_si128((const __m128i *) syn_nibble_tables[j][0]);
+	__m128i thi = _mm_loadu_si128((const __m128i *) syn_nibble_tables[j][1]);
+	for (; r + 16 <= nb_rows; r += 16) {
+	  __m128i v = _mm_loadu_si128((const __m128i *) (s+r));
+	  __m128i lo = _mm_and_si128(v, nibble_mask);
+	  __m128i hi = _mm_and_si128(_mm_srli_epi64(v, 4), nibble_mask);
+	  v = _mm_xor_si128(_mm_shuffle_epi8(tlo, lo), _mm_shuffle_epi8(thi, hi));
+	  v = _mm_xor_si128(v, _mm_loadu_si128((const __m128i *) (col+r)));
+	  _mm_storeu_si128((__m128i *) (s+r), v);
+	}
+      }
+#elif defined(GF_RS_SIMD_NEON)
+      {
+	uint8x16_t tlo = vld1q_u8(syn_nibble_tables[j][0]);
+	uint8x16_t thi = vld1q_u8(syn_nibble_tables[j][1]);
+	for (; r + 16 <= nb_rows; r += 16) {
+	  uint8x16_t v = vld1q_u8(s+r);
+	  v = veorq_u8(vqtbl1q_u8(tlo, vandq_u8(v, nibble_mask)), vqtbl1q_u8(thi, vshrq_n_u8(v, 4)));
+	  v = veorq_u8(v, vld1q_u8(col+r));
+	  vst1q_u8(s+r, v);
+	}
+      }
+#endif
+      mul_aj = gmul_table[gexp[j+1]];
+      for (; r < nb_rows; r++) s[r] = mul_aj[s[r]] ^ col[r];
+    }
+  }
+}
+
+int
+decode_frame (unsigned char *data, int data_cols, unsigned char *parity, int rows,
+	      unsigned int *data_err, unsigned int *parity_err, int *nb_corrected)
+{
+  u8 synd[NPAR][RS_ROW_BLOCK];
+  unsigned char line[255];
+  int erasures[NPAR];
+  int csize = data_cols + NPAR;
+  int first_row, r, j, c, nb_failed = 0;
+#if defined(GF_RS_SIMD_SSSE3) || defined(GF_RS_SIMD_NEON)
+  static int syn_tables_ready = 0;
+#endif
+
+  if (nb_corrected) *nb_corrected = 0;
+  if ((csize > 255) || (rows <= 0)) return rows;
+
+  initialize_ecc();
+#if defined(GF_RS_SIMD_SSSE3) || defined(GF_RS_SIMD_NEON)
+  if (!syn_tables_ready) {
+    init_syndrome_tables();
+    syn_tables_ready = 1;
+  }
+#endif
+
+  for (first_row = 0; first_row < rows; first_row += RS_ROW_BLOCK) {
+    int nb_rows = MIN(RS_ROW_BLOCK, rows - first_row);
+    compute_block_syndromes(data, data_cols, parity, rows, first_row, nb_rows, synd);
+
+    for (r = 0; r < nb_rows; r++) {
+      int nz = 0;
+      int nerasures = 0;
+      u32 offset = first_row + r;
+      for (j = 0; j < NPAR; j++) {
+	synBytes[j] = synd[j][r];
+	nz |= synBytes[j];
+      }
+      /* valid codeword, nothing to do */
+      if (!nz) continue;
+
+      /* gather the row; erasure locations are counted from the end of the codeword */
+      for (c = 0; c < csize; c++) {
+	unsigned int erased;
+	if (c < data_cols) {
+	  line[c] = data[offset];
+	  erased = data_err ? data_err[offset] : 0;
+	} else {
+	  line[c] = parity[offset - data_cols*rows];
+	  erased = parity_err ? parity_err[offset - data_cols*rows] : 0;
+	}
+	offset += rows;
+	if (erased) {
+	  if (nerasures < NPAR) erasures[nerasures] = csize - 1 - c;
+	  nerasures++;
+	}
+      }
+      if ((nerasures > NPAR) || !correct_errors_erasures(line, csize, nerasures, erasures)) {
+	nb_failed++;
+	continue;
+      }
+      /* reject miscorrections */
+      decode_data(line, csize);
+      if (check_syndrome()) {
+	nb_failed++;
+	continue;
+      }
+
+      offset = first_row + r;
+      for (c = 0; c < csize; c++) {
+	if (c < data_cols) data[offset] = line[c];
+	else parity[offset - data_cols*rows] = line[c];
+	offset += rows;
+      }
+      if (nb_corrected) (*nb_corrected)++;
+    }
+  }
+  return nb_failed;
+}
+   
    
  void  
  debug_check_syndrome (void)  
@@ -119,6 +119,26 @@ typedef struct
 	char *value;
 } BTDefSymbol;
 
+typedef struct
+{
+	/*route insert/replace command, NULL if the route is created in the graph*/
+	GF_Command *com;
+	char *from_node, *from_field, *to_node, *to_field;
+	/*ID and name of a DEFed route created in the graph*/
+	u32 ID;
+	char *name;
+} BTPendingRoute;
+
+static void gf_bt_del_pending_route(BTPendingRoute *pr)
+{
+	gf_free(pr->from_node);
+	gf_free(pr->from_field);
+	gf_free(pr->to_node);
+	gf_free(pr->to_field);
+	if (pr->name) gf_free(pr->name);
+	gf_free(pr);
+}
+
 typedef struct
 {
 	GF_SceneLoader *load;
@@ -142,6 +162,10 @@ typedef struct
 	/*routes are not created in the graph when parsing, so we need to track insert and delete/replace*/
 	GF_List *unresolved_routes, *inserted_routes, *peeked_nodes;
 	GF_List *undef_nodes, *def_nodes;
+	/*index of def_nodes by DEF name*/
+	GF_SGIndex def_index;
+	/*routes using nodes not yet DEFed, resolved in declaration order once the nodes are DEFed*/
+	GF_List *pending_routes;
 
 	char *line_buffer;
 	char cur_buffer[500];
@@ -175,6 +199,8 @@ typedef struct
 GF_Err gf_bt_parse_bifs_command(GF_BTParser *parser, char *name, GF_List *cmdList);
 GF_Route *gf_bt_parse_route(GF_BTParser *parser, Bool skip_def, Bool is_insert, GF_Command *com);
 void gf_bt_resolve_routes(GF_BTParser *parser, Bool clean);
+void gf_bt_resolve_pending_routes(GF_BTParser *parser, Bool force);
+void gf_bt_set_pending_route_name(GF_BTParser *parser, u32 rID, char *name);
 
 GF_Node *gf_bt_peek_node(GF_BTParser *parser, char *defID);
 
@@ -1222,15 +1248,21 @@ void gf_bt_check_unresolved_nodes(GF_BTParser *parser)
 
 Bool gf_bt_has_been_def(GF_BTParser *parser, char *node_name)
 {
-	u32 i, count;
-	count = gf_list_count(parser->def_nodes);
-	for (i=0; i<count; i++) {
-		GF_Node *n = (GF_Node *) gf_list_get(parser->def_nodes, i);
+	GF_Node *n;
+	u32 pos = 0;
+	u32 hash = gf_sg_hash_string(node_name);
+	while ((n = (GF_Node *) gf_sg_index_enum(&parser->def_index, hash, &pos))) {
 		if (!strcmp(gf_node_get_name(n), node_name)) return 1;
 	}
 	return 0;
 }
 
+static void gf_bt_reset_def_nodes(GF_BTParser *parser)
+{
+	gf_list_reset(parser->def_nodes);
+	gf_sg_index_reset(&parser->def_index);
+}
+
 u32 gf_bt_get_node_tag(GF_BTParser *parser, char *node_name)
 {
 	u32 tag;
@@ -1362,7 +1394,10 @@ GF_Node *gf_bt_sf_node(GF_BTParser *parser, char *node_name, GF_Node *parent, ch
 		parser->last_error = GF_SG_UNKNOWN_NODE;
 		return NULL;
 	}
-	if (register_def) gf_list_add(parser->def_nodes, node);
+	if (register_def) {
+		gf_list_add(parser->def_nodes, node);
+		gf_sg_index_add(&parser->def_index, gf_sg_hash_string(name), node);
+	}
 
 	gf_node_register(node, parent);
 
@@ -1565,6 +1600,8 @@ GF_Node *gf_bt_sf_node(GF_BTParser *parser, char *node_name, GF_Node *parent, ch
 		gf_node_unregister(undef_node, NULL);
 		gf_list_del_item(parser->undef_nodes, undef_node);
 	}
+	/*routes waiting for this node can now be created*/
+	if (register_def && gf_list_count(parser->pending_routes)) gf_bt_resolve_pending_routes(parser, 0);
 
 	if (!parser->parsing_proto && is_script && (parser->load->flags & GF_SM_LOAD_FOR_PLAYBACK) ) {
 		if (parser->cur_com) {
@@ -1593,17 +1630,12 @@ GF_Node *gf_bt_peek_node(GF_BTParser *parser, char *defID)
 	Bool prev_is_insert = 0;
 	char *str, *ret;
 	char nName[1000];
-	u32 pos, line, line_pos, i, count;
+	u32 pos, line, line_pos;
 
+	/*peeked nodes are DEFed in the graph, no need to look for them in peeked_nodes*/
 	n = gf_sg_find_node_by_name(parser->load->scene_graph, defID);
 	if (n) return n;
 
-	count = gf_list_count(parser->peeked_nodes);
-	for (i=0; i<count; i++) {
-		n = (GF_Node *)gf_list_get(parser->peeked_nodes, i);
-		if (!strcmp(gf_node_get_name(n), defID)) return n;
-	}
-
 	the_node = NULL;
 	pos = parser->line_start_pos;
 	line_pos = parser->line_pos;
@@ -1728,10 +1760,12 @@ GF_Err gf_bt_parse_proto(GF_BTParser *parser, char *proto_code, GF_List *proto_l
 	GF_Proto *proto, *prevproto;
 	GF_ProtoFieldInterface *pfield;
 	GF_SceneGraph *sg;
+	GF_List *prev_pending_routes;
 	char *str, *name;
 	char szDefName[1024];
 	Bool isDEF;
 
+	prev_pending_routes = NULL;
 	if (proto_code)
 		str = proto_code;
 	else
@@ -1891,6 +1925,9 @@ next_field:
 	sg = parser->load->scene_graph;
 	parser->parsing_proto = proto;
 	parser->load->scene_graph = gf_sg_proto_get_graph(proto);
+	/*routes of the proto body only use nodes of the proto body*/
+	prev_pending_routes = parser->pending_routes;
+	parser->pending_routes = gf_list_new();
 
 	isDEF = 0;
 	while (!gf_bt_check_code(parser, '}')) {
@@ -1906,8 +1943,12 @@ next_field:
 			if (isDEF) {
 				u32 rID = gf_bt_get_route(parser, szDefName);
 				if (!rID) rID = gf_bt_get_next_route_id(parser);
-				parser->last_error = gf_sg_route_set_id(r, rID);
-				gf_sg_route_set_name(r, szDefName);
+				if (r) {
+					parser->last_error = gf_sg_route_set_id(r, rID);
+					gf_sg_route_set_name(r, szDefName);
+				} else if (!parser->last_error) {
+					gf_bt_set_pending_route_name(parser, rID, szDefName);
+				}
 				isDEF = 0;
 			}
 		} else {
@@ -1924,25 +1965,85 @@ next_field:
 	}
 	gf_bt_resolve_routes(parser, 1);
 	gf_bt_check_unresolved_nodes(parser);
+	gf_list_del(parser->pending_routes);
+	parser->pending_routes = prev_pending_routes;
 	parser->load->scene_graph = sg;
 	parser->parsing_proto = prevproto;
 	return parser->last_error;
 
 err:
+	if (prev_pending_routes) {
+		while (gf_list_count(parser->pending_routes)) {
+			BTPendingRoute *pr = (BTPendingRoute *)gf_list_get(parser->pending_routes, 0);
+			gf_list_rem(parser->pending_routes, 0);
+			gf_bt_del_pending_route(pr);
+		}
+		gf_list_del(parser->pending_routes);
+		parser->pending_routes = prev_pending_routes;
+	}
 	if (proto_list) gf_list_del_item(proto_list, proto);
 	gf_sg_proto_del(proto);
 	return parser->last_error;
 }
 
 
-GF_Route *gf_bt_parse_route(GF_BTParser *parser, Bool skip_def, Bool is_insert, GF_Command *com)
+/*USEd nodes not yet DEFed cannot be used in routes*/
+static GF_Node *gf_bt_find_route_node(GF_BTParser *parser, char *name)
+{
+	GF_Node *n = gf_sg_find_node_by_name(parser->load->scene_graph, name);
+	if (n && (n->sgprivate->tag == TAG_UndefinedNode)) return NULL;
+	return n;
+}
+
+static Bool gf_bt_get_route_field(GF_BTParser *parser, GF_Node *node, char *name, GF_FieldInfo *info)
+{
+	GF_Err e = gf_node_get_field_by_name(node, name, info);
+	/*VRML loosy syntax*/
+	if ((e != GF_OK) && parser->is_wrl && !strnicmp(name, "set_", 4))
+		e = gf_node_get_field_by_name(node, &name[4], info);
+
+	if ((e != GF_OK) && parser->is_wrl && strstr(name, "_changed")) {
+		char *s = strstr(name, "_changed");
+		s[0] = 0;
+		e = gf_node_get_field_by_name(node, name, info);
+	}
+
+	if (e != GF_OK) {
+		gf_bt_report(parser, GF_BAD_PARAM, "%s not a field of node %s (%s)", name, gf_node_get_name(node), gf_node_get_class_name(node));
+		return 0;
+	}
+	return 1;
+}
+
+static GF_Route *gf_bt_set_route(GF_BTParser *parser, GF_Node *orig, char *orig_name, GF_Node *dest, char *dest_name, GF_Command *com, u32 rID, char *rName)
 {
 	GF_Route *r;
-	char *str, nstr[1000], rName[1000];
+	GF_FieldInfo orig_field, dest_field;
+
+	if (!gf_bt_get_route_field(parser, orig, orig_name, &orig_field)) return NULL;
+	if (!gf_bt_get_route_field(parser, dest, dest_name, &dest_field)) return NULL;
+
+	if (com) {
+		com->fromNodeID = gf_node_get_id(orig);
+		com->fromFieldIndex = orig_field.fieldIndex;
+		com->toNodeID = gf_node_get_id(dest);
+		com->toFieldIndex = dest_field.fieldIndex;
+		return NULL;
+	}
+	r = gf_sg_route_new(parser->load->scene_graph, orig, orig_field.fieldIndex, dest, dest_field.fieldIndex);
+	if (r && rID) {
+		gf_sg_route_set_id(r, rID);
+		gf_sg_route_set_name(r, rName);
+	}
+	return r;
+}
+
+GF_Route *gf_bt_parse_route(GF_BTParser *parser, Bool skip_def, Bool is_insert, GF_Command *com)
+{
+	char *str, nstr[1000], rName[1000], fromField[1000], toNode[1000], toField[1000];
 	u32 rID;
 	GF_Node *orig, *dest;
-	GF_FieldInfo orig_field, dest_field;
-	GF_Err e;
+	BTPendingRoute *pr;
 
 	rID = 0;
 	strcpy(nstr, gf_bt_get_next(parser, 1));
@@ -1960,91 +2061,96 @@ GF_Route *gf_bt_parse_route(GF_BTParser *parser, Bool skip_def, Bool is_insert,
 		if (!rID) rID = gf_bt_get_next_route_id(parser);
 		strcpy(nstr, gf_bt_get_next(parser, 1));
 	}
-	orig = gf_bt_peek_node(parser, nstr);
-	if (!orig) {
-		gf_bt_report(parser, GF_BAD_PARAM, "cannot find node %s", nstr);
-		return NULL;
-	}
 	if (!gf_bt_check_code(parser, '.')) {
 		gf_bt_report(parser, GF_BAD_PARAM, ". expected in route decl");
 		return NULL;
 	}
-	str = gf_bt_get_next(parser, 0);
-	e = gf_node_get_field_by_name(orig, str, &orig_field);
-	/*VRML loosy syntax*/
-	if ((e != GF_OK) && parser->is_wrl && !strnicmp(str, "set_", 4))
-		e = gf_node_get_field_by_name(orig, &str[4], &orig_field);
-
-	if ((e != GF_OK) && parser->is_wrl && strstr(str, "_changed")) {
-		char *s = strstr(str, "_changed");
-		s[0] = 0;
-		e = gf_node_get_field_by_name(orig, str, &orig_field);
-	}
-
-	if (e != GF_OK) {
-		gf_bt_report(parser, GF_BAD_PARAM, "%s not a field of node %s (%s)", str, gf_node_get_name(orig), gf_node_get_class_name(orig));
-		return NULL;
-	}
+	strcpy(fromField, gf_bt_get_next(parser, 0));
 	str = gf_bt_get_next(parser, 0);
 	if (strcmp(str, "TO")) {
 		gf_bt_report(parser, GF_BAD_PARAM, "TO expected in route declaration - got \"%s\"", str);
 		return NULL;
 	}
 
-	strcpy(nstr, gf_bt_get_next(parser, 1));
-	dest = gf_bt_peek_node(parser, nstr);
-	if (!dest) {
-		gf_bt_report(parser, GF_BAD_PARAM, "cannot find node %s", nstr);
-		return NULL;
-	}
+	strcpy(toNode, gf_bt_get_next(parser, 1));
 	if (!gf_bt_check_code(parser, '.')) {
 		gf_bt_report(parser, GF_BAD_PARAM, ". expected in route decl");
 		return NULL;
 	}
-	str = gf_bt_get_next(parser, 0);
-	e = gf_node_get_field_by_name(dest, str, &dest_field);
-	/*VRML loosy syntax*/
-	if ((e != GF_OK) && parser->is_wrl && !strnicmp(str, "set_", 4))
-		e = gf_node_get_field_by_name(dest, &str[4], &dest_field);
+	strcpy(toField, gf_bt_get_next(parser, 0));
 
-	if ((e != GF_OK) && parser->is_wrl && strstr(str, "_changed")) {
-		char *s = strstr(str, "_changed");
-		s[0] = 0;
-		e = gf_node_get_field_by_name(dest, str, &dest_field);
+	if (com && rID) {
+		com->RouteID = rID;
+		com->def_name = gf_strdup(rName);
+		/*whenever inserting routes, keep track of max defined ID*/
+		if (is_insert) {
+			gf_sg_set_max_defined_route_id(parser->load->scene_graph, rID);
+			if (parser->load->ctx && (rID>parser->load->ctx->max_route_id))
+				parser->load->ctx->max_route_id = rID;
+		}
 	}
 
-	if (e != GF_OK) {
-		gf_bt_report(parser, GF_BAD_PARAM, "%s not a field of node %s (%s)", str, gf_node_get_name(dest), gf_node_get_class_name(dest));
-		return NULL;
+	/*routes are resolved in declaration order: once a route is pending, the next ones are too*/
+	orig = dest = NULL;
+	if (!gf_list_count(parser->pending_routes)) {
+		orig = gf_bt_find_route_node(parser, nstr);
+		dest = gf_bt_find_route_node(parser, toNode);
 	}
-	if (com) {
-		com->fromNodeID = gf_node_get_id(orig);
-		com->fromFieldIndex = orig_field.fieldIndex;
-		com->toNodeID = gf_node_get_id(dest);
-		com->toFieldIndex = dest_field.fieldIndex;
-		if (rID) {
-			com->RouteID = rID;
-			com->def_name = gf_strdup(rName);
-			/*whenever inserting routes, keep track of max defined ID*/
-			if (is_insert) {
-				gf_sg_set_max_defined_route_id(parser->load->scene_graph, rID);
-				if (parser->load->ctx && (rID>parser->load->ctx->max_route_id))
-					parser->load->ctx->max_route_id = rID;
-			}
-		}
+	if (orig && dest) return gf_bt_set_route(parser, orig, fromField, dest, toField, com, rID, rName);
+
+	/*forward reference: keep parsing and create the route once the nodes are DEFed, rather than
+	looking for the nodes further in the file*/
+	GF_SAFEALLOC(pr, BTPendingRoute);
+	if (!pr) {
+		parser->last_error = GF_OUT_OF_MEM;
 		return NULL;
 	}
-	r = gf_sg_route_new(parser->load->scene_graph, orig, orig_field.fieldIndex, dest, dest_field.fieldIndex);
-	if (r && rID) {
-		gf_sg_route_set_id(r, rID);
-		gf_sg_route_set_name(r, rName);
+	pr->com = com;
+	pr->from_node = gf_strdup(nstr);
+	pr->from_field = gf_strdup(fromField);
+	pr->to_node = gf_strdup(toNode);
+	pr->to_field = gf_strdup(toField);
+	if (!com && rID) {
+		pr->ID = rID;
+		pr->name = gf_strdup(rName);
+	}
+	gf_list_add(parser->pending_routes, pr);
+	return NULL;
+}
+
+/*sets ID and name of the last parsed route when it is still pending*/
+void gf_bt_set_pending_route_name(GF_BTParser *parser, u32 rID, char *name)
+{
+	BTPendingRoute *pr = (BTPendingRoute *)gf_list_last(parser->pending_routes);
+	if (!pr || pr->com) return;
+	pr->ID = rID;
+	if (pr->name) gf_free(pr->name);
+	pr->name = gf_strdup(name);
+}
+
+void gf_bt_resolve_pending_routes(GF_BTParser *parser, Bool force)
+{
+	GF_Node *orig, *dest;
+	while (gf_list_count(parser->pending_routes)) {
+		BTPendingRoute *pr = (BTPendingRoute *)gf_list_get(parser->pending_routes, 0);
+		orig = gf_bt_find_route_node(parser, pr->from_node);
+		dest = gf_bt_find_route_node(parser, pr->to_node);
+		if (!force && (!orig || !dest)) break;
+		gf_list_rem(parser->pending_routes, 0);
+
+		if (!orig) gf_bt_report(parser, GF_BAD_PARAM, "cannot find node %s", pr->from_node);
+		else if (!dest) gf_bt_report(parser, GF_BAD_PARAM, "cannot find node %s", pr->to_node);
+		else gf_bt_set_route(parser, orig, pr->from_field, dest, pr->to_field, pr->com, pr->ID, pr->name);
+
+		gf_bt_del_pending_route(pr);
 	}
-	return r;
 }
 
 void gf_bt_resolve_routes(GF_BTParser *parser, Bool clean)
 {
 	GF_Command *com;
+	/*create routes still waiting for their nodes*/
+	gf_bt_resolve_pending_routes(parser, 1);
 	/*resolve all commands*/
 	while(gf_list_count(parser->unresolved_routes) ) {
 		com = (GF_Command *)gf_list_get(parser->unresolved_routes, 0);
@@ -2119,7 +2225,7 @@ GF_Err gf_bt_parse_bifs_command(GF_BTParser *parser, char *name, GF_List *cmdLis
 			}
 			gf_bt_resolve_routes(parser, 1);
 			com = gf_sg_command_new(parser->load->scene_graph, GF_SG_SCENE_REPLACE);
-			while (gf_list_count(parser->def_nodes)) gf_list_rem(parser->def_nodes, 0);
+			gf_bt_reset_def_nodes(parser);
 
 			while (1) {
 				str = gf_bt_get_next(parser, 0);
@@ -3334,6 +3440,7 @@ GF_Err gf_bt_loader_run_intern(GF_BTParser *parser, GF_Command *init_com, Bool i
 			/*reset all contexts*/
 			if (parser->od_au && (parser->od_au->timing != parser->au_time)) parser->od_au = NULL;
 			if (parser->bifs_au && (parser->bifs_au->timing != parser->au_time)) {
+				gf_bt_resolve_pending_routes(parser, 1);
 				gf_bt_check_unresolved_nodes(parser);
 				parser->bifs_au = NULL;
 			}
@@ -3389,6 +3496,8 @@ GF_Err gf_bt_loader_run_intern(GF_BTParser *parser, GF_Command *init_com, Bool i
 				} else if (r) {
 					gf_sg_route_set_id(r, rID);
 					gf_sg_route_set_name(r, szDEFName);
+				} else if (!parser->last_error) {
+					gf_bt_set_pending_route_name(parser, rID, szDEFName);
 				}
 				has_id = 0;
 			}
@@ -3642,7 +3751,14 @@ void load_bt_done(GF_SceneLoader *load)
 	gf_list_del(parser->inserted_routes);
 	gf_list_del(parser->undef_nodes);
 	gf_list_del(parser->def_nodes);
+	gf_sg_index_reset(&parser->def_index);
 	gf_list_del(parser->peeked_nodes);
+	while (gf_list_count(parser->pending_routes)) {
+		BTPendingRoute *pr = (BTPendingRoute *)gf_list_get(parser->pending_routes, 0);
+		gf_list_rem(parser->pending_routes, 0);
+		gf_bt_del_pending_route(pr);
+	}
+	gf_list_del(parser->pending_routes);
 	while (gf_list_count(parser->def_symbols)) {
 		BTDefSymbol *d = (BTDefSymbol *)gf_list_get(parser->def_symbols, 0);
 		gf_list_rem(parser->def_symbols, 0);
@@ -3739,6 +3855,7 @@ GF_Err gf_sm_load_init_bt(GF_SceneLoader *load)
 	parser->undef_nodes = gf_list_new();
 	parser->def_nodes = gf_list_new();
 	parser->peeked_nodes = gf_list_new();
+	parser->pending_routes = gf_list_new();
 	parser->scripts = gf_list_new();
 
 	load->process = load_bt_run;
@@ -3770,11 +3887,15 @@ GF_List *gf_sm_load_bt_from_string(GF_SceneGraph *in_scene, char *node_str, Bool
 	parser.undef_nodes = gf_list_new();
 	parser.def_nodes = gf_list_new();
 	parser.peeked_nodes = gf_list_new();
+	parser.pending_routes = gf_list_new();
 	parser.is_wrl = force_wrl;
 	gf_bt_loader_run_intern(&parser, NULL, 1);
 	gf_list_del(parser.undef_nodes);
 	gf_list_del(parser.def_nodes);
+	gf_sg_index_reset(&parser.def_index);
 	gf_list_del(parser.peeked_nodes);
+	/*pending routes are resolved at the end of gf_bt_loader_run_intern*/
+	gf_list_del(parser.pending_routes);
 	while (gf_list_count(parser.def_symbols)) {
 		BTDefSymbol *d = (BTDefSymbol *)gf_list_get(parser.def_symbols, 0);
 		gf_list_rem(parser.def_symbols, 0);
@@ -86,6 +86,10 @@ typedef struct
 
 	GF_List *peeked_nodes;
 	GF_List *def_nodes;
+	/*index of def_nodes by DEF name*/
+	GF_SGIndex def_index;
+	/*nodes USEd before being DEFed*/
+	GF_List *undef_nodes;
 	GF_List *inserted_routes, *unresolved_routes;
 
 	/* OD and ESD links*/
@@ -1020,15 +1024,37 @@ static void xmt_parse_mf_field(GF_XMTParser *parser, GF_FieldInfo *info, GF_Node
 
 static Bool xmt_has_been_def(GF_XMTParser *parser, char *node_name)
 {
-	u32 i, count;
-	count = gf_list_count(parser->def_nodes);
-	for (i=0; i<count; i++) {
-		GF_Node *n = (GF_Node *)gf_list_get(parser->def_nodes, i);
+	GF_Node *n;
+	u32 pos = 0;
+	u32 hash = gf_sg_hash_string(node_name);
+	while ((n = (GF_Node *)gf_sg_index_enum(&parser->def_index, hash, &pos))) {
 		if (!strcmp(gf_node_get_name(n), node_name)) return 1;
 	}
 	return 0;
 }
 
+/*node USEd before being DEFed: the node created for the USE element is DEFed in the graph and used
+until the DEF element is parsed, rather than looking for the DEF further in the document*/
+static void xmt_set_forward_node(GF_XMTParser *parser, GF_Node *node, char *name)
+{
+	gf_node_set_id(node, xmt_get_node_id(parser, name), name);
+	if (!parser->parsing_proto) gf_node_init(node);
+	gf_node_register(node, NULL);
+	gf_list_add(parser->undef_nodes, node);
+}
+
+static void xmt_check_unresolved_nodes(GF_XMTParser *parser)
+{
+	while (gf_list_count(parser->undef_nodes)) {
+		GF_Node *n = (GF_Node *)gf_list_get(parser->undef_nodes, 0);
+		gf_list_rem(parser->undef_nodes, 0);
+		xmt_report(parser, GF_BAD_PARAM, "Warning: Cannot find node %s referenced in USE - skipping", gf_node_get_name(n));
+		/*remove it from the scene*/
+		gf_node_replace(n, NULL, 0);
+		gf_node_unregister(n, NULL);
+	}
+}
+
 static u32 xmt_get_route(GF_XMTParser *parser, char *name, Bool del_com) 
 {
 	u32 i;
@@ -1408,12 +1434,12 @@ static GF_Node *xmt_parse_element(GF_XMTParser *parser, char *name, const char *
 	u32	tag, i, ID;
 	Bool register_def = 0;
 	Bool is_script = 0;
-	GF_Node *node;
+	GF_Node *node, *replace_node;
 	GF_FieldInfo container;
 	char *def_name;
 	GF_Proto *proto = NULL;
 
-	node = NULL;
+	node = replace_node = NULL;
 	if (!strcmp(name, "NULL")) return NULL;
 	if (!strcmp(name, "ROUTE")) {
 		if (!parser->parsing_proto && (parser->doc_type==1) ) {
@@ -1727,18 +1753,25 @@ static GF_Node *xmt_parse_element(GF_XMTParser *parser, char *name, const char *
 			GF_Node *undef_node = gf_sg_find_node_by_name(parser->load->scene_graph, att->value);
 			register_def = 1;
 			if (undef_node) {
+				Bool is_forward = (gf_list_del_item(parser->undef_nodes, undef_node)>=0) ? 1 : 0;
 				gf_list_del_item(parser->peeked_nodes, undef_node);
 				ID = gf_node_get_id(undef_node);
 				/*if we see twice a DEF N1 then force creation of a new node*/
 				if (xmt_has_been_def(parser, att->value)) {
 					ID = xmt_get_node_id(parser, att->value);
 					xmt_report(parser, GF_OK, "Warning: Node %s has been defined several times - IDs may get corrupted", att->value);
+				}
+				/*USEd before with another element type, replace it once DEFed*/
+				else if (is_forward && tag && (tag != gf_node_get_tag(undef_node))) {
+					replace_node = undef_node;
+					is_forward = 0;
 				} else {
 					gf_node_register(node, NULL);
 					gf_node_unregister(node, NULL);
 					node = undef_node;
 					ID = 0;
 				}
+				if (is_forward) gf_node_unregister(undef_node, NULL);
 			} else {
 				ID = xmt_get_node_id(parser, att->value);
 
@@ -1750,7 +1783,14 @@ static GF_Node *xmt_parse_element(GF_XMTParser *parser, char *name, const char *
 			GF_Err e;
 			GF_Node *def_node;
 
-			def_node = xmt_find_node(parser, att->value);
+			def_node = gf_sg_find_node_by_name(parser->load->scene_graph, att->value);
+			if (!def_node && tag) {
+				xmt_set_forward_node(parser, node, att->value);
+				ID = 0;
+				register_def = 0;
+				tag = 0;
+				break;
+			}
 
 			e = GF_OK;
 			if (!def_node) 
@@ -1797,8 +1837,15 @@ static GF_Node *xmt_parse_element(GF_XMTParser *parser, char *name, const char *
 
 	if (!parser->parsing_proto) xmt_update_timenode(parser, node);
 
-	if (register_def) gf_list_add(parser->def_nodes, node);
+	if (register_def) {
+		gf_list_add(parser->def_nodes, node);
+		gf_sg_index_add(&parser->def_index, gf_sg_hash_string(def_name), node);
+	}
 	if (ID) gf_node_set_id(node, ID, def_name);
+	if (replace_node) {
+		gf_node_replace(replace_node, node, 0);
+		gf_node_unregister(replace_node, NULL);
+	}
 
 	if (is_script) {
 		u32 last_field = gf_node_get_field_count(parent->node);
@@ -2195,6 +2242,7 @@ static void xmt_parse_command(GF_XMTParser *parser, const char *name, const GF_X
 			tag = GF_SG_SCENE_REPLACE;
 			au_is_rap = 1;
 			gf_list_reset(parser->def_nodes);
+			gf_sg_index_reset(&parser->def_index);
 		}
 		else if (!strcmp(name, "Insert")) 
 			tag = GF_SG_ROUTE_INSERT;
@@ -2949,6 +2997,7 @@ static GF_XMTParser *xmt_new_parser(GF_SceneLoader *load)
 	parser->esd_links = gf_list_new();
 	parser->def_nodes = gf_list_new();
 	parser->peeked_nodes = gf_list_new();
+	parser->undef_nodes = gf_list_new();
 	parser->inserted_routes = gf_list_new();
 	parser->unresolved_routes = gf_list_new();
 
@@ -3055,6 +3104,7 @@ static GF_Err load_xmt_run(GF_SceneLoader *load)
 
 	e = gf_xml_sax_parse_file(parser->sax_parser, (const char *)load->fileName, xmt_progress);
 
+	xmt_check_unresolved_nodes(parser);
 	xmt_resolve_routes(parser);
 	xmt_resolve_od_links(parser);
 
@@ -3073,6 +3123,7 @@ static GF_Err load_xmt_parse_string(GF_SceneLoader *load, const char *str)
 	}
 	e = gf_xml_sax_parse(parser->sax_parser, str);
 
+	xmt_check_unresolved_nodes(parser);
 	xmt_resolve_routes(parser);
 	xmt_resolve_od_links(parser);
 
@@ -3098,7 +3149,14 @@ static void load_xmt_done(GF_SceneLoader *load)
 	gf_list_del(parser->nodes);
 	gf_list_del(parser->descriptors);
 	gf_list_del(parser->def_nodes);
+	gf_sg_index_reset(&parser->def_index);
 	gf_list_del(parser->peeked_nodes);
+	while (gf_list_count(parser->undef_nodes)) {
+		GF_Node *n = (GF_Node *)gf_list_get(parser->undef_nodes, 0);
+		gf_list_rem(parser->undef_nodes, 0);
+		gf_node_unregister(n, NULL);
+	}
+	gf_list_del(parser->undef_nodes);
 
 	gf_list_del(parser->inserted_routes);
 	gf_list_del(parser->unresolved_routes);
@@ -80,8 +80,13 @@ static GF_Err gf_sm_setup_bifsenc(GF_SceneEngine *seng, GF_StreamContext *sc, GF
 
 	if (!esd->decoderConfig || (esd->decoderConfig->streamType != GF_STREAM_SCENE)) return GF_BAD_PARAM;
 
-	if (!seng->bifsenc)
+	if (!seng->bifsenc) {
 		seng->bifsenc = gf_bifs_encoder_new(seng->ctx->scene_graph);
+		/*the scene is encoded over and over (carousels), only re-encode modified subtrees - this needs
+		node modifications to be signaled to the engine*/
+		if (gf_sg_get_private(seng->sg)==seng) 
+			gf_bifs_encoder_enable_node_cache(seng->bifsenc, 1);
+	}
 
 	delete_bcfg = 0;
 	/*inputctx is not properly setup, do it*/
@@ -814,6 +819,7 @@ void gf_seng_terminate(GF_SceneEngine *seng)
 {
 #ifndef GPAC_DISABLE_BIFS_ENC
 	if (seng->bifsenc) gf_bifs_encoder_del(seng->bifsenc);
+	seng->bifsenc = NULL;
 #endif
 
 #ifndef GPAC_DISABLE_LASER
@@ -896,6 +902,10 @@ static void gf_seng_on_node_modified(void *_seng, u32 type, GF_Node *node, void
 #endif
 	case GF_SG_CALLBACK_MODIFIED:
 		gf_node_dirty_parents(node);
+#ifndef GPAC_DISABLE_BIFS_ENC
+		if (((GF_SceneEngine *)_seng)->bifsenc) 
+			gf_bifs_encoder_node_changed(((GF_SceneEngine *)_seng)->bifsenc, node);
+#endif
 		break;
 	}
 }
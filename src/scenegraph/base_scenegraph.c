@@ -42,6 +42,141 @@ static void node_modif_stub(GF_SceneGraph *sg, GF_Node *node, GF_FieldInfo *info
 {
 }
 
+#define SG_INDEX_MIN_SIZE	64
+
+u32 gf_sg_hash_int(u32 val)
+{
+	val ^= val >> 16;
+	val *= 0x85ebca6b;
+	val ^= val >> 13;
+	val *= 0xc2b2ae35;
+	val ^= val >> 16;
+	/*0 is reserved for empty slots*/
+	return val ? val : 1;
+}
+
+u32 gf_sg_hash_ptr(void *ptr)
+{
+	u64 val = (u64) (size_t) ptr;
+	return gf_sg_hash_int((u32) (val ^ (val>>32)) );
+}
+
+u32 gf_sg_hash_string(const char *str)
+{
+	/*FNV-1a*/
+	u32 val = 2166136261U;
+	while (*str) {
+		val ^= (u8) *str;
+		val *= 16777619;
+		str++;
+	}
+	return val ? val : 1;
+}
+
+static void sg_index_insert(GF_SGIndex *idx, u32 hash, void *item)
+{
+	u32 mask = idx->size - 1;
+	u32 i = hash & mask;
+	/*stop at the first empty or deleted slot*/
+	while (idx->slots[i].item) i = (i+1) & mask;
+	if (!idx->slots[i].hash) idx->used++;
+	idx->slots[i].hash = hash;
+	idx->slots[i].item = item;
+	idx->count++;
+}
+
+static void sg_index_rehash(GF_SGIndex *idx, u32 new_size)
+{
+	u32 i, old_size = idx->size;
+	GF_SGIndexSlot *old_slots = idx->slots;
+
+	idx->slots = (GF_SGIndexSlot *) gf_malloc(sizeof(GF_SGIndexSlot) * new_size);
+	memset(idx->slots, 0, sizeof(GF_SGIndexSlot) * new_size);
+	idx->size = new_size;
+	idx->count = idx->used = 0;
+	for (i=0; i<old_size; i++) {
+		if (old_slots[i].item) sg_index_insert(idx, old_slots[i].hash, old_slots[i].item);
+	}
+	if (old_slots) gf_free(old_slots);
+}
+
+void gf_sg_index_add(GF_SGIndex *idx, u32 hash, void *item)
+{
+	/*keep load factor (including deleted slots) under 3/4, rehash to at most 1/2 of live items*/
+	if (4*(idx->used+1) > 3*idx->size) {
+		u32 new_size = idx->size ? idx->size : SG_INDEX_MIN_SIZE;
+		while (2*(idx->count+1) > new_size) new_size *= 2;
+		sg_index_rehash(idx, new_size);
+	}
+	sg_index_insert(idx, hash, item);
+}
+
+Bool gf_sg_index_remove(GF_SGIndex *idx, u32 hash, void *item)
+{
+	u32 i, mask;
+	if (!idx->size) return 0;
+	mask = idx->size - 1;
+	i = hash & mask;
+	while (idx->slots[i].hash) {
+		if ((idx->slots[i].item==item) && (idx->slots[i].hash==hash)) {
+			/*leave a deleted marker (hash set, no item) so that probing continues*/
+			idx->slots[i].item = NULL;
+			idx->count--;
+			if (!idx->count) {
+				memset(idx->slots, 0, sizeof(GF_SGIndexSlot) * idx->size);
+				idx->used = 0;
+			}
+			return 1;
+		}
+		i = (i+1) & mask;
+	}
+	return 0;
+}
+
+void *gf_sg_index_enum(GF_SGIndex *idx, u32 hash, u32 *pos)
+{
+	u32 mask;
+	if (!idx->count) return NULL;
+	mask = idx->size - 1;
+	while (*pos < idx->size) {
+		GF_SGIndexSlot *slot = &idx->slots[(hash + *pos) & mask];
+		(*pos)++;
+		if (!slot->hash) break;
+		if (slot->item && (slot->hash==hash)) return slot->item;
+	}
+	*pos = idx->size;
+	return NULL;
+}
+
+void gf_sg_index_reset(GF_SGIndex *idx)
+{
+	if (idx->slots) gf_free(idx->slots);
+	memset(idx, 0, sizeof(GF_SGIndex));
+}
+
+/*returns the DEF entry of the node in the given graph*/
+static GFINLINE NodeIDedItem *sg_get_def_item(GF_SceneGraph *sg, GF_Node *node)
+{
+	NodeIDedItem *reg_node;
+	u32 pos = 0;
+	u32 hash = gf_sg_hash_ptr(node);
+	while ((reg_node = (NodeIDedItem *) gf_sg_index_enum(&sg->def_by_node, hash, &pos))) {
+		if (reg_node->node == node) return reg_node;
+	}
+	return NULL;
+}
+
+/*checks whether a is located before b in the (sorted) DEF list - only used when several nodes share the same ID or name*/
+static Bool sg_def_item_is_before(NodeIDedItem *a, NodeIDedItem *b)
+{
+	if (a->NodeID != b->NodeID) return (a->NodeID < b->NodeID) ? 1 : 0;
+	while (a->next && (a->next->NodeID == b->NodeID)) {
+		if (a->next == b) return 1;
+		a = a->next;
+	}
+	return 0;
+}
+
 GF_EXPORT
 GF_SceneGraph *gf_sg_new()
 {
@@ -142,6 +277,7 @@ void gf_sg_del(GF_SceneGraph *sg)
 	gf_list_del(sg->dom_evt.evt_list);
 	gf_list_del(sg->xlink_hrefs);
 	gf_list_del(sg->smil_timed_elements);
+	if (sg->smil_waiting_elements) gf_free(sg->smil_waiting_elements);
 	gf_list_del(sg->modified_smil_timed_elements);
 	gf_list_del(sg->listeners_to_add);
 	gf_mx_del(sg->dom_evt_mx);
@@ -151,8 +287,14 @@ void gf_sg_del(GF_SceneGraph *sg)
 	gf_list_del(sg->objects);
 #endif
 
+	gf_sg_index_reset(&sg->def_by_id);
+	gf_sg_index_reset(&sg->def_by_name);
+	gf_sg_index_reset(&sg->def_by_node);
+
 #ifndef GPAC_DISABLE_VRML
 	gf_list_del(sg->Routes);
+	gf_sg_index_reset(&sg->routes_by_id);
+	gf_sg_index_reset(&sg->routes_by_name);
 	gf_list_del(sg->protos);
 	gf_list_del(sg->unregistered_protos);
 	gf_list_del(sg->routes_to_activate);
@@ -265,25 +407,15 @@ void SG_GraphRemoved(GF_Node *node, GF_SceneGraph *sg)
 	}
 }
 
-GFINLINE GF_Node *SG_SearchForNode(GF_SceneGraph *sg, GF_Node *node)
+static GFINLINE GF_Node *SG_SearchForNode(GF_SceneGraph *sg, GF_Node *node)
 {
-	NodeIDedItem *reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->node == node) return reg_node->node;
-		reg_node = reg_node->next;
-	}
-	return NULL;
+	NodeIDedItem *reg_node = sg_get_def_item(sg, node);
+	return reg_node ? reg_node->node : NULL;
 }
 
 static GFINLINE u32 get_num_id_nodes(GF_SceneGraph *sg)
 {
-	u32 count = 0;
-	NodeIDedItem *reg_node = sg->id_node;
-	while (reg_node) {
-		count++;
-		reg_node = reg_node->next;
-	}
-	return count;
+	return sg->def_by_id.count;
 }
 
 GF_EXPORT
@@ -475,18 +607,7 @@ restart:
 	while (par->parent_scene) par = par->parent_scene;
 
 #ifndef GPAC_DISABLE_SVG
-	if (par != sg) {
-		u32 count, i;
-		count = gf_list_count(par->smil_timed_elements);
-		for (i=0; i<count; i++) {
-			SMIL_Timing_RTI *rti = gf_list_get(par->smil_timed_elements, i);
-			if (rti->timed_elt->sgprivate->scenegraph == sg) {
-				gf_list_rem(par->smil_timed_elements, i);
-				i--;
-				count--;
-			}
-		}
-	}
+	if (par != sg) gf_smil_timing_remove_graph(par, sg);
 #endif
 
 #ifdef GF_SELF_REPLACE_ENABLE
@@ -498,10 +619,11 @@ restart:
 
 GFINLINE GF_Node *SG_SearchForDuplicateNodeID(GF_SceneGraph *sg, u32 nodeID, GF_Node *toExclude)
 {
-	NodeIDedItem *reg_node = sg->id_node;
-	while (reg_node) {
+	NodeIDedItem *reg_node;
+	u32 pos = 0;
+	u32 hash = gf_sg_hash_int(nodeID);
+	while ((reg_node = (NodeIDedItem *) gf_sg_index_enum(&sg->def_by_id, hash, &pos))) {
 		if ((reg_node->node != toExclude) && (reg_node->NodeID == nodeID)) return reg_node->node;
-		reg_node = reg_node->next;
 	}
 	return NULL;
 }
@@ -510,12 +632,8 @@ void *gf_node_get_name_address(GF_Node*node)
 {
 	NodeIDedItem *reg_node;
 	if (!(node->sgprivate->flags & GF_NODE_IS_DEF)) return NULL;
-	reg_node = node->sgprivate->scenegraph->id_node;
-	while (reg_node) {
-		if (reg_node->node == node) return &reg_node->NodeName;
-		reg_node = reg_node->next;
-	}
-	return NULL;
+	reg_node = sg_get_def_item(node->sgprivate->scenegraph, node);
+	return reg_node ? &reg_node->NodeName : NULL;
 }
 
 void gf_sg_set_private(GF_SceneGraph *sg, void *ptr)
@@ -579,31 +697,26 @@ void gf_sg_set_root_node(GF_SceneGraph *sg, GF_Node *node)
 
 void remove_node_id(GF_SceneGraph *sg, GF_Node *node)
 {
-	NodeIDedItem *reg_node = sg->id_node;
-	if (reg_node && (reg_node->node==node)) {
-		sg->id_node = reg_node->next;
-		if (sg->id_node_last==reg_node) 
-			sg->id_node_last = reg_node->next;
-		if (reg_node->NodeName) gf_free(reg_node->NodeName);
-		gf_free(reg_node);
-	} else {
-		NodeIDedItem *to_del;
-		while (reg_node->next) {
-			if (reg_node->next->node!=node) {
-				reg_node = reg_node->next;
-				continue;
-			}
-			to_del = reg_node->next;
-			reg_node->next = to_del->next;
-			if (sg->id_node_last==to_del) {
-				sg->id_node_last = reg_node->next ? reg_node->next : reg_node;
-			}
-			if (to_del->NodeName) gf_free(to_del->NodeName);
-			to_del->NodeName = NULL;
-			gf_free(to_del);
-			break;
-		}
+	NodeIDedItem *reg_node = sg_get_def_item(sg, node);
+	if (!reg_node) return;
+
+	/*nodes sharing an ID are next to each other in the list*/
+	if ((!reg_node->prev || (reg_node->prev->NodeID != reg_node->NodeID))
+		&& (!reg_node->next || (reg_node->next->NodeID != reg_node->NodeID)))
+		sg->nb_def_ids--;
+
+	if (reg_node->prev) reg_node->prev->next = reg_node->next;
+	else sg->id_node = reg_node->next;
+	if (reg_node->next) reg_node->next->prev = reg_node->prev;
+	else sg->id_node_last = reg_node->prev;
+
+	gf_sg_index_remove(&sg->def_by_id, gf_sg_hash_int(reg_node->NodeID), reg_node);
+	gf_sg_index_remove(&sg->def_by_node, gf_sg_hash_ptr(node), reg_node);
+	if (reg_node->NodeName) {
+		gf_sg_index_remove(&sg->def_by_name, gf_sg_hash_string(reg_node->NodeName), reg_node);
+		gf_free(reg_node->NodeName);
 	}
+	gf_free(reg_node);
 }
 
 GF_Err gf_node_try_destroy(GF_SceneGraph *sg, GF_Node *pNode, GF_Node *parentNode)
@@ -928,37 +1041,45 @@ GF_Err gf_node_replace(GF_Node *node, GF_Node *new_node, Bool updateOrderedGroup
 static GFINLINE void insert_node_def(GF_SceneGraph *sg, GF_Node *def, u32 ID, const char *name)
 {
 	NodeIDedItem *reg_node, *cur;
+	u32 pos = 0;
 
 	reg_node = (NodeIDedItem *) gf_malloc(sizeof(NodeIDedItem));
 	reg_node->node = def;
 	reg_node->NodeID = ID;
 	reg_node->NodeName = name ? gf_strdup(name) : NULL;
+	reg_node->next = reg_node->prev = NULL;
 
 	if (!sg->id_node) {
 		sg->id_node = reg_node;
 		sg->id_node_last = sg->id_node;
-		reg_node->next = NULL;
-	} else if (sg->id_node_last->NodeID < ID) {
+	} else if (sg->id_node_last->NodeID <= ID) {
+		reg_node->prev = sg->id_node_last;
 		sg->id_node_last->next = reg_node;
 		sg->id_node_last = reg_node;
-		reg_node->next = NULL;
 	} else if (sg->id_node->NodeID>ID) {
 		reg_node->next = sg->id_node;
+		sg->id_node->prev = reg_node;
 		sg->id_node = reg_node;
 	} else {
-		cur = sg->id_node;
-		while (cur->next) {
-			if (cur->next->NodeID>ID) {
-				reg_node->next = cur->next;
-				cur->next = reg_node;
-				return;
-			}
-			cur = cur->next;
+		/*ID already in use (node replacement), insert after the last node with this ID, otherwise browse the list*/
+		u32 hash = gf_sg_hash_int(ID);
+		while ((cur = (NodeIDedItem *) gf_sg_index_enum(&sg->def_by_id, hash, &pos))) {
+			if (cur->NodeID == ID) break;
 		}
+		if (!cur) cur = sg->id_node;
+		/*the last node has a greater ID so cur->next is never NULL here*/
+		while (cur->next->NodeID <= ID) cur = cur->next;
+		reg_node->next = cur->next;
+		reg_node->prev = cur;
+		cur->next->prev = reg_node;
 		cur->next = reg_node;
-		sg->id_node_last = reg_node;
-		reg_node->next = NULL;
 	}
+	if ((!reg_node->prev || (reg_node->prev->NodeID != ID)) && (!reg_node->next || (reg_node->next->NodeID != ID)))
+		sg->nb_def_ids++;
+
+	gf_sg_index_add(&sg->def_by_id, gf_sg_hash_int(ID), reg_node);
+	gf_sg_index_add(&sg->def_by_node, gf_sg_hash_ptr(def), reg_node);
+	if (reg_node->NodeName) gf_sg_index_add(&sg->def_by_name, gf_sg_hash_string(reg_node->NodeName), reg_node);
 }
 
 
@@ -1134,25 +1255,31 @@ GF_SceneGraph *gf_node_get_graph(GF_Node *node)
 GF_EXPORT
 GF_Node *gf_sg_find_node(GF_SceneGraph *sg, u32 nodeID)
 {
-	NodeIDedItem *reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->NodeID == nodeID) return reg_node->node;
-		reg_node = reg_node->next;
+	NodeIDedItem *reg_node, *found = NULL;
+	u32 pos = 0;
+	u32 hash = gf_sg_hash_int(nodeID);
+	/*several nodes may share the same ID, return the first one in the DEF list*/
+	while ((reg_node = (NodeIDedItem *) gf_sg_index_enum(&sg->def_by_id, hash, &pos))) {
+		if (reg_node->NodeID != nodeID) continue;
+		if (!found || sg_def_item_is_before(reg_node, found)) found = reg_node;
 	}
-	return NULL;
+	return found ? found->node : NULL;
 }
 
 GF_EXPORT
 GF_Node *gf_sg_find_node_by_name(GF_SceneGraph *sg, char *name)
 {
-	if (name) {
-		NodeIDedItem *reg_node = sg->id_node;
-		while (reg_node) {
-			if (reg_node->NodeName && !strcmp(reg_node->NodeName, name)) return reg_node->node;
-			reg_node = reg_node->next;
-		}
+	NodeIDedItem *reg_node, *found = NULL;
+	u32 hash, pos = 0;
+	if (!name) return NULL;
+
+	hash = gf_sg_hash_string(name);
+	/*several nodes may share the same name, return the first one in the DEF list*/
+	while ((reg_node = (NodeIDedItem *) gf_sg_index_enum(&sg->def_by_name, hash, &pos))) {
+		if (strcmp(reg_node->NodeName, name)) continue;
+		if (!found || sg_def_item_is_before(reg_node, found)) found = reg_node;
 	}
-	return NULL;
+	return found ? found->node : NULL;
 }
 
 
@@ -1162,6 +1289,9 @@ u32 gf_sg_get_next_available_node_id(GF_SceneGraph *sg)
 	u32 ID;
 	NodeIDedItem *reg_node;
 	if (!sg->id_node) return 1;
+	/*no gap in the IDs*/
+	if (sg->id_node_last->NodeID - sg->id_node->NodeID + 1 == sg->nb_def_ids)
+		return sg->id_node_last->NodeID + 1;
 	reg_node = sg->id_node;
 	ID = reg_node->NodeID;
 	/*nodes are sorted*/
@@ -1215,12 +1345,8 @@ u32 gf_node_get_id(GF_Node*p)
 	if (p == (GF_Node*)sg->pOwningProto) sg = sg->parent_scene;
 #endif
 
-	reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->node==p) return reg_node->NodeID;
-		reg_node = reg_node->next;
-	}
-	return 0;
+	reg_node = sg_get_def_item(sg, p);
+	return reg_node ? reg_node->NodeID : 0;
 }
 
 GF_EXPORT
@@ -1236,12 +1362,8 @@ const char *gf_node_get_name(GF_Node*p)
 	if (p == (GF_Node*)sg->pOwningProto) sg = sg->parent_scene;
 #endif
 
-	reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->node==p) return reg_node->NodeName;
-		reg_node = reg_node->next;
-	}
-	return NULL;
+	reg_node = sg_get_def_item(sg, p);
+	return reg_node ? reg_node->NodeName : NULL;
 }
 
 GF_EXPORT
@@ -1261,13 +1383,10 @@ const char *gf_node_get_name_and_id(GF_Node*p, u32 *id)
 	if (p == (GF_Node*)sg->pOwningProto) sg = sg->parent_scene;
 #endif
 
-	reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->node==p) {
-			*id = reg_node->NodeID;
-			return reg_node->NodeName;
-		}
-		reg_node = reg_node->next;
+	reg_node = sg_get_def_item(sg, p);
+	if (reg_node) {
+		*id = reg_node->NodeID;
+		return reg_node->NodeName;
 	}
 	*id = 0;
 	return NULL;
@@ -1493,6 +1612,22 @@ void gf_sg_parent_reset(GF_Node *node)
 }
 
 
+void gf_node_reset_routes(GF_Node *node)
+{
+	u32 i;
+	struct _node_interactive_ext *interact = node->sgprivate->interact;
+	if (!interact) return;
+
+	if (interact->routes) gf_list_del(interact->routes);
+	interact->routes = NULL;
+	for (i=0; i<interact->nb_field_routes; i++) {
+		gf_list_del(interact->field_routes[i].routes);
+	}
+	if (interact->field_routes) gf_free(interact->field_routes);
+	interact->field_routes = NULL;
+	interact->nb_field_routes = 0;
+}
+
 void gf_node_free(GF_Node *node)
 {
 	if (!node) return;
@@ -1500,9 +1635,7 @@ void gf_node_free(GF_Node *node)
 	if (node->sgprivate->UserCallback) node->sgprivate->UserCallback(node, NULL, 1);
 
 	if (node->sgprivate->interact) {
-		if (node->sgprivate->interact->routes) {
-			gf_list_del(node->sgprivate->interact->routes);
-		}
+		gf_node_reset_routes(node);
 #ifndef GPAC_DISABLE_SVG
 		if (node->sgprivate->interact->dom_evt) {
 			while (gf_list_count(node->sgprivate->interact->dom_evt->evt_list)) {
@@ -2037,7 +2170,7 @@ static GF_Err gf_node_deactivate_ex(GF_Node *node)
 		/*deactivate anmiations*/
 		if (gf_svg_is_timing_tag(node->sgprivate->tag)) {
 			SVGTimedAnimBaseElement *timed = (SVGTimedAnimBaseElement*)node;
-			if (gf_list_del_item(node->sgprivate->scenegraph->smil_timed_elements, timed->timingp->runtime)>=0) {
+			if (gf_smil_timing_unschedule(timed->timingp->runtime)) {
 				if (timed->timingp->runtime->evaluate) {
 					timed->timingp->runtime->evaluate(timed->timingp->runtime, 0, SMIL_TIMING_EVAL_DEACTIVATE);
 				}
@@ -2079,7 +2212,7 @@ static u32 gf_node_activate_ex(GF_Node *node)
 		/*deactivate anmiations*/
 		if (gf_svg_is_timing_tag(node->sgprivate->tag)) {
 			SVGTimedAnimBaseElement *timed = (SVGTimedAnimBaseElement*)node;
-			gf_list_add(node->sgprivate->scenegraph->smil_timed_elements, timed->timingp->runtime);
+			gf_smil_timing_wake(timed->timingp->runtime);
 			node->sgprivate->flags &= ~GF_NODE_IS_DEACTIVATED;
 			if (timed->timingp->runtime->evaluate) {
 				timed->timingp->runtime->evaluate(timed->timingp->runtime, 0, SMIL_TIMING_EVAL_ACTIVATE);
@@ -355,8 +355,7 @@ GF_Err gf_sg_command_apply(GF_SceneGraph *graph, GF_Command *com, Double time_of
 		if (!node || !def) return GF_SG_UNKNOWN_NODE;
 		name = NULL;
 		if (r) {
-			name = r->name;
-			r->name = NULL;
+			name = r->name ? gf_strdup(r->name) : NULL;
 			gf_sg_route_del(r);
 		}
 		r = gf_sg_route_new(graph, def, com->fromFieldIndex, node, com->toFieldIndex);
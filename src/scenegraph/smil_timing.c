@@ -270,34 +270,173 @@ static Bool gf_smil_timing_get_next_interval(SMIL_Timing_RTI *rti, Bool current,
 	}
 }
 
-/* To reduce the process of notifying the time to all timed elements, we add to the scene graph 
-   only the timed elements which have a resolved current interval, other timed elements will be 
-   added at runtime when an event leads to the creation of a new interval.
-   We also insert the new timed element in the order of the current_interval begin value, to stop 
-   the notification of time when not necessary */
-static Bool gf_smil_timing_add_to_sg(GF_SceneGraph *sg, SMIL_Timing_RTI *rti)
+/* To reduce the process of notifying the time to all timed elements, the rootmost scene graph only 
+   notifies at each frame the timed elements which may change at this time: active ones, and the ones 
+   about to switch to their next interval. Timed elements waiting for a resolved begin are kept in a 
+   binary heap ordered by begin, and are moved to the notified list when their begin is reached. 
+   Other timed elements (unresolved begin, done or frozen without next interval) are not notified 
+   until they are modified, by an event or an update, which leads to the creation of a new interval. */
+
+static GF_SceneGraph *gf_smil_timing_get_root_sg(SMIL_Timing_RTI *rti)
 {
-	if (rti->current_interval->begin != -1) {
-		SMIL_Timing_RTI *cur_rti = NULL;
-		u32 i;
+	GF_SceneGraph *sg = rti->timed_elt->sgprivate->scenegraph;
+	while (sg->parent_scene) sg = sg->parent_scene;
+	return sg;
+}
+
+static void gf_smil_heap_set(GF_SceneGraph *sg, u32 idx, SMIL_Timing_RTI *rti)
+{
+	sg->smil_waiting_elements[idx] = rti;
+	rti->sched_index = idx;
+}
+
+static void gf_smil_heap_sift_up(GF_SceneGraph *sg, u32 idx)
+{
+	SMIL_Timing_RTI *rti = sg->smil_waiting_elements[idx];
+	while (idx) {
+		u32 parent = (idx-1) / 2;
+		if (sg->smil_waiting_elements[parent]->sched_time <= rti->sched_time) break;
+		gf_smil_heap_set(sg, idx, sg->smil_waiting_elements[parent]);
+		idx = parent;
+	}
+	gf_smil_heap_set(sg, idx, rti);
+}
+
+static void gf_smil_heap_sift_down(GF_SceneGraph *sg, u32 idx)
+{
+	SMIL_Timing_RTI *rti = sg->smil_waiting_elements[idx];
+	while (1) {
+		u32 child = 2*idx + 1;
+		if (child >= sg->nb_smil_waiting) break;
+		if ((child+1 < sg->nb_smil_waiting) && (sg->smil_waiting_elements[child+1]->sched_time < sg->smil_waiting_elements[child]->sched_time))
+			child++;
+		if (rti->sched_time <= sg->smil_waiting_elements[child]->sched_time) break;
+		gf_smil_heap_set(sg, idx, sg->smil_waiting_elements[child]);
+		idx = child;
+	}
+	gf_smil_heap_set(sg, idx, rti);
+}
 
-		for (i = 0; i < gf_list_count(sg->smil_timed_elements); i++) {
-			cur_rti = (SMIL_Timing_RTI *)gf_list_get(sg->smil_timed_elements, i);
-			if (cur_rti->current_interval->begin > rti->current_interval->begin) break;
+static void gf_smil_heap_push(GF_SceneGraph *sg, SMIL_Timing_RTI *rti)
+{
+	if (sg->nb_smil_waiting == sg->smil_waiting_alloc) {
+		sg->smil_waiting_alloc = sg->smil_waiting_alloc ? 2*sg->smil_waiting_alloc : 64;
+		sg->smil_waiting_elements = gf_realloc(sg->smil_waiting_elements, sizeof(SMIL_Timing_RTI *) * sg->smil_waiting_alloc);
+	}
+	rti->sched_time = rti->current_interval->begin;
+	rti->sched_state = SMIL_SCHED_WAITING;
+	gf_smil_heap_set(sg, sg->nb_smil_waiting, rti);
+	sg->nb_smil_waiting++;
+	gf_smil_heap_sift_up(sg, sg->nb_smil_waiting-1);
+}
+
+static void gf_smil_heap_remove(GF_SceneGraph *sg, u32 idx)
+{
+	SMIL_Timing_RTI *last;
+	sg->nb_smil_waiting--;
+	if (idx == sg->nb_smil_waiting) return;
+	last = sg->smil_waiting_elements[sg->nb_smil_waiting];
+	gf_smil_heap_set(sg, idx, last);
+	gf_smil_heap_sift_down(sg, idx);
+	/*the last element may also be lower than the parent of the removed one*/
+	if (last->sched_index == idx) gf_smil_heap_sift_up(sg, idx);
+}
+
+/* inserts the timed element in the list notified at each frame, after the elements with a lower or equal begin */
+static void gf_smil_timing_add_awake(GF_SceneGraph *sg, SMIL_Timing_RTI *rti)
+{
+	u32 i = gf_list_count(sg->smil_timed_elements);
+	while (i) {
+		SMIL_Timing_RTI *cur_rti = (SMIL_Timing_RTI *)gf_list_get(sg->smil_timed_elements, i-1);
+		if (cur_rti->current_interval->begin <= rti->current_interval->begin) break;
+		i--;
+	}
+	gf_list_insert(sg->smil_timed_elements, rti, i);
+	rti->sched_state = SMIL_SCHED_AWAKE;
+}
+
+/* returns the index the element had in the list of notified elements, or -1 */
+static s32 gf_smil_timing_unschedule_ex(GF_SceneGraph *sg, SMIL_Timing_RTI *rti)
+{
+	s32 idx = -1;
+	if (rti->sched_state == SMIL_SCHED_AWAKE) {
+		idx = gf_list_del_item(sg->smil_timed_elements, rti);
+	} else if (rti->sched_state == SMIL_SCHED_WAITING) {
+		gf_smil_heap_remove(sg, rti->sched_index);
+	}
+	rti->sched_state = SMIL_SCHED_NONE;
+	return idx;
+}
+
+/* schedules the next notification of the timed element according to its state, 
+   returns the index the element had in the list of notified elements if it was removed from it, or -1 */
+static s32 gf_smil_timing_schedule(GF_SceneGraph *sg, SMIL_Timing_RTI *rti)
+{
+	u32 state;
+	s32 idx;
+
+	if (rti->evaluate_status == SMIL_TIMING_EVAL_FRACTION) {
+		state = SMIL_SCHED_AWAKE;
+	} else if (rti->status == SMIL_STATUS_WAITING_TO_BEGIN) {
+		state = (rti->current_interval->begin == -1) ? SMIL_SCHED_NONE : SMIL_SCHED_WAITING;
+	} else if ((rti->status == SMIL_STATUS_DONE) || (rti->status == SMIL_STATUS_FROZEN)) {
+		state = (rti->next_interval->begin == -1) ? SMIL_SCHED_NONE : SMIL_SCHED_AWAKE;
+	} else {
+		state = SMIL_SCHED_AWAKE;
+	}
+	if ((state == rti->sched_state) && (state != SMIL_SCHED_WAITING)) return -1;
+
+	idx = gf_smil_timing_unschedule_ex(sg, rti);
+	if (state == SMIL_SCHED_WAITING) gf_smil_heap_push(sg, rti);
+	else if (state == SMIL_SCHED_AWAKE) gf_smil_timing_add_awake(sg, rti);
+	return idx;
+}
+
+Bool gf_smil_timing_unschedule(SMIL_Timing_RTI *rti)
+{
+	Bool was_scheduled = rti->sched_state ? 1 : 0;
+	gf_smil_timing_unschedule_ex(gf_smil_timing_get_root_sg(rti), rti);
+	return was_scheduled;
+}
+
+void gf_smil_timing_wake(SMIL_Timing_RTI *rti)
+{
+	GF_SceneGraph *sg = gf_smil_timing_get_root_sg(rti);
+	if (rti->sched_state == SMIL_SCHED_AWAKE) return;
+	gf_smil_timing_unschedule_ex(sg, rti);
+	gf_smil_timing_add_awake(sg, rti);
+}
+
+void gf_smil_timing_remove_graph(GF_SceneGraph *root, GF_SceneGraph *sg)
+{
+	u32 i, count;
+	count = gf_list_count(root->smil_timed_elements);
+	for (i=0; i<count; i++) {
+		SMIL_Timing_RTI *rti = gf_list_get(root->smil_timed_elements, i);
+		if (rti->timed_elt->sgprivate->scenegraph == sg) {
+			gf_list_rem(root->smil_timed_elements, i);
+			rti->sched_state = SMIL_SCHED_NONE;
+			i--;
+			count--;
+		}
+	}
+	i = 0;
+	while (i < root->nb_smil_waiting) {
+		SMIL_Timing_RTI *rti = root->smil_waiting_elements[i];
+		if (rti->timed_elt->sgprivate->scenegraph == sg) {
+			gf_smil_heap_remove(root, i);
+			rti->sched_state = SMIL_SCHED_NONE;
+		} else {
+			i++;
 		}
-		gf_list_insert(sg->smil_timed_elements, rti, i);
-		return 1;
 	}
-	return 0;
 }
 
-/* when a timed element restarts, since the list of timed elements in the scene graph, 
-   to which scene time is notified at each rendering cycle, is sorted, we need to remove 
-   and reinsert this timed element as if it was a new one, to make sure the sorting is correct */
+/* when a timed element restarts or is modified, its intervals change: it is queued to be notified 
+   again at the end of the current notification cycle, and rescheduled according to its new state */
 static void gf_smil_mark_modified(SMIL_Timing_RTI *rti, Bool remove)
 {
-	GF_SceneGraph * sg = rti->timed_elt->sgprivate->scenegraph;
-	while (sg->parent_scene) sg = sg->parent_scene;
+	GF_SceneGraph * sg = gf_smil_timing_get_root_sg(rti);
 	if (remove) {
 		gf_list_del_item(sg->modified_smil_timed_elements, rti);
 	} else {
@@ -374,7 +513,7 @@ void gf_smil_timing_init_runtime_info(GF_Node *timed_elt)
 	   sharing the same scene time, we therefore add this timed element to the rootmost scene graph. */
 	sg = timed_elt->sgprivate->scenegraph;
 	while (sg->parent_scene) sg = sg->parent_scene;
-	gf_smil_timing_add_to_sg(sg, rti);
+	gf_smil_timing_schedule(sg, rti);
 }
 
 
@@ -410,7 +549,7 @@ void gf_smil_timing_delete_runtime_info(GF_Node *timed_elt, SMIL_Timing_RTI *rti
 	/* we inform the rootmost scene graph that this node will not need notification of the scene time anymore */
 	sg = timed_elt->sgprivate->scenegraph;
 	while (sg->parent_scene) sg = sg->parent_scene;
-	gf_list_del_item(sg->smil_timed_elements, rti);
+	gf_smil_timing_unschedule_ex(sg, rti);
 	gf_list_del_item(sg->modified_smil_timed_elements, rti);
 
 	/*remove all associated listeners*/
@@ -429,7 +568,7 @@ Bool gf_smil_timing_is_active(GF_Node *node)
 	return (timingp->runtime->status == SMIL_STATUS_ACTIVE);
 }
 
-/* This function notifies the scene time to all the timed elements from the list in the given scene graph.
+/* This function notifies the scene time to the timed elements of the given scene graph which may change at this time.
    It returns the number of active timed elements. If no timed element is active, this means that from the timing
    point of view, the scene has not changed and no rendering refresh is needed, even if the time has changed.
    It uses an additional list of modified timed elements to insure that no timing 
@@ -439,8 +578,7 @@ Bool gf_smil_notify_timed_elements(GF_SceneGraph *sg)
 {
 	SMIL_Timing_RTI *rti;
 	u32 active_count, i;
-	s32 ret;
-	Bool do_loop;
+	s32 ret, idx;
 	if (!sg) return 0;
 
 	active_count = 0;
@@ -452,12 +590,20 @@ Bool gf_smil_notify_timed_elements(GF_SceneGraph *sg)
 
 	*/
 	
-	/* notify the new scene time to the register timed elements 
+	/* wake up the timed elements whose begin has been reached; the heap top is the lowest begin, 
+	   assuming all graphs share the same scene time the next ones don't need to be checked */
+	while (sg->nb_smil_waiting) {
+		rti = sg->smil_waiting_elements[0];
+		if (rti->sched_time > gf_node_get_scene_time((GF_Node*)rti->timed_elt)) break;
+		gf_smil_heap_remove(sg, 0);
+		gf_smil_timing_add_awake(sg, rti);
+	}
+
+	/* notify the new scene time to the awake timed elements 
 	   this might modify other timed elements or the element itself 
 	   in which case it will be added to the list of modified elements */
 	i = 0;
-	do_loop = 1;
-	while(do_loop && (rti = (SMIL_Timing_RTI *)gf_list_enum(sg->smil_timed_elements, &i))) {
+	while((rti = (SMIL_Timing_RTI *)gf_list_enum(sg->smil_timed_elements, &i))) {
 		ret = gf_smil_timing_notify_time(rti, gf_node_get_scene_time((GF_Node*)rti->timed_elt) );
 		switch (ret) {
 		case -1:
@@ -465,12 +611,10 @@ Bool gf_smil_notify_timed_elements(GF_SceneGraph *sg)
 			   when a discard element is executed, it automatically removes itself from the list of timed element 
 			   in the scene graph, we need to fix the index i. */
 			i--;
-			break;
+			continue;
 		case -2:
-			/* special return value, -2 means that the tested timed element is waiting to begin
-			   Assuming that the timed elements are sorted by begin order, 
-			   the next ones don't need to be checked */
-			do_loop = 0;
+			/* special return value, -2 means that the tested timed element is waiting to begin, 
+			   it is moved back to the waiting heap below */
 			break;
 		case -3:
 			/* special case for animation elements which do not need to be notified anymore, 
@@ -478,7 +622,7 @@ Bool gf_smil_notify_timed_elements(GF_SceneGraph *sg)
 			i--;
 			active_count ++;
 			gf_node_dirty_parent_graph(rti->timed_elt);
-			break;
+			continue;
 		case 1:
 			active_count++;
 			gf_node_dirty_parent_graph(rti->timed_elt);
@@ -487,6 +631,9 @@ Bool gf_smil_notify_timed_elements(GF_SceneGraph *sg)
 		default:
 			break;
 		}
+		/* elements which are no longer active nor about to restart leave the notified list */
+		idx = gf_smil_timing_schedule(sg, rti);
+		if ((idx>=0) && ((u32) idx < i)) i--;
 	}
 
 	/* notify the timed elements which have been modified either since the previous frame (updates, scripts) or 
@@ -496,18 +643,15 @@ Bool gf_smil_notify_timed_elements(GF_SceneGraph *sg)
 		rti = gf_list_get(sg->modified_smil_timed_elements, 0);
 		gf_list_rem(sg->modified_smil_timed_elements, 0);
 
-		/* then remove it in the list of non modified (if it was there) */
-		gf_list_del_item(sg->smil_timed_elements, rti);
-
-		/* then insert it at its right position (in the sorted list of timed elements) */
-		gf_smil_timing_add_to_sg(sg, rti);
+		/* then remove it from the scheduler (if it was there) */
+		gf_smil_timing_unschedule_ex(sg, rti);
 
-		/* finally again notify this timed element */
+		/* again notify this timed element */
 		rti->force_reevaluation = 1;
 		ret = gf_smil_timing_notify_time(rti, gf_node_get_scene_time((GF_Node*)rti->timed_elt) );
 		switch (ret) {
 		case -1:
-			break;
+			continue;
 		case -2:
 			break;
 		case -3:
@@ -522,7 +666,8 @@ Bool gf_smil_notify_timed_elements(GF_SceneGraph *sg)
 		default:
 			break;
 		}
-
+		/* finally reschedule it according to its new intervals */
+		gf_smil_timing_schedule(sg, rti);
 	}
 	return (active_count>0);
 }
@@ -789,9 +934,7 @@ force_end:
 		} else if ((rti->status == SMIL_STATUS_DONE) && 
 			        timingp->restart && (*timingp->restart == SMIL_RESTART_NEVER)) {
 			/* the timed element is done and cannot restart, we don't need to evaluate it anymore */
-			GF_SceneGraph * sg = rti->timed_elt->sgprivate->scenegraph;
-			while (sg->parent_scene) sg = sg->parent_scene;
-			gf_list_del_item(sg->smil_timed_elements, rti);
+			gf_smil_timing_unschedule(rti);
 			ret = -1;
 		}
 	}
@@ -890,9 +890,7 @@ GF_Err gf_sg_proto_field_set_ised(GF_Proto *proto, u32 protoFieldIndex, GF_Node
 		r->FromNode = node;
 		r->ToField.fieldIndex = protoFieldIndex;
 		r->ToNode = NULL;
-		if (!node->sgprivate->interact) GF_SAFEALLOC(node->sgprivate->interact, struct _node_interactive_ext);
-		if (!node->sgprivate->interact->routes) node->sgprivate->interact->routes = gf_list_new();
-		gf_list_add(node->sgprivate->interact->routes, r);
+		gf_node_add_route(node, r);
 	} else {
 		switch (field.eventType) {
 		case GF_SG_EVENT_FIELD:
@@ -916,9 +914,7 @@ GF_Err gf_sg_proto_field_set_ised(GF_Proto *proto, u32 protoFieldIndex, GF_Node
 				r2->ToField.fieldIndex = protoFieldIndex;
 				r2->ToNode = NULL;
 				r2->graph =  proto->sub_graph;
-				if (!node->sgprivate->interact) GF_SAFEALLOC(node->sgprivate->interact, struct _node_interactive_ext);
-				if (!node->sgprivate->interact->routes) node->sgprivate->interact->routes = gf_list_new();
-				gf_list_add(node->sgprivate->interact->routes, r2);
+				gf_node_add_route(node, r2);
 				gf_list_add(proto->sub_graph->Routes, r2);
 			}
 			break;
@@ -970,9 +966,7 @@ GF_Err gf_sg_proto_instance_set_ised(GF_Node *protoinst, u32 protoFieldIndex, GF
 		r->FromNode = node;
 		r->ToField.fieldIndex = protoFieldIndex;
 		r->ToNode = protoinst;
-		if (!node->sgprivate->interact) GF_SAFEALLOC(node->sgprivate->interact, struct _node_interactive_ext);
-		if (!node->sgprivate->interact->routes) node->sgprivate->interact->routes = gf_list_new();
-		gf_list_add(node->sgprivate->interact->routes, r);
+		gf_node_add_route(node, r);
 	} else {
 		switch (field.eventType) {
 		case GF_SG_EVENT_FIELD:
@@ -997,9 +991,7 @@ GF_Err gf_sg_proto_instance_set_ised(GF_Node *protoinst, u32 protoFieldIndex, GF
 				r2->ToField.fieldIndex = protoFieldIndex;
 				r2->ToNode = protoinst;
 				r2->graph =  node->sgprivate->scenegraph;
-				if (!node->sgprivate->interact) GF_SAFEALLOC(node->sgprivate->interact, struct _node_interactive_ext);
-				if (!node->sgprivate->interact->routes) node->sgprivate->interact->routes = gf_list_new();
-				gf_list_add(node->sgprivate->interact->routes, r2);
+				gf_node_add_route(node, r2);
 				gf_list_add(r->graph->Routes, r2);
 			}
 			break;
@@ -1008,9 +1000,7 @@ GF_Err gf_sg_proto_instance_set_ised(GF_Node *protoinst, u32 protoFieldIndex, GF
 			r->FromNode = node;
 			r->ToField.fieldIndex = protoFieldIndex;
 			r->ToNode = protoinst;
-			if (!node->sgprivate->interact) GF_SAFEALLOC(node->sgprivate->interact, struct _node_interactive_ext);
-			if (!node->sgprivate->interact->routes) node->sgprivate->interact->routes = gf_list_new();
-			gf_list_add(node->sgprivate->interact->routes, r);
+			gf_node_add_route(node, r);
 			break;
 		default:
 			gf_free(r);
@@ -1111,6 +1101,7 @@ void gf_sg_proto_propagate_event(GF_Node *node, u32 fieldIndex, GF_Node *from_no
 {
 	u32 i;
 	GF_Route *r;
+	GF_List *routes;
 	if (!node) return;
 	/*propagation only for proto*/
 	if (node->sgprivate->tag != TAG_ProtoNode) return;
@@ -1120,9 +1111,13 @@ void gf_sg_proto_propagate_event(GF_Node *node, u32 fieldIndex, GF_Node *from_no
 	the same scene graph as the proto (eg from the proto code) we don't propagate the event*/
 	if (from_node->sgprivate->scenegraph == node->sgprivate->scenegraph) return;
 
+	/*routes from this field*/
+	routes = gf_node_get_field_routes(node, fieldIndex);
+	if (!routes) return;
+
 	/*for all ISed routes*/
 	i=0;
-	while ((r = (GF_Route*)gf_list_enum(node->sgprivate->interact->routes, &i))) {
+	while ((r = (GF_Route*)gf_list_enum(routes, &i))) {
 		if (!r->IS_route) continue;
 		/*connecting from this node && field to a destination node other than the event source (this will break loops due to exposedFields)*/
 		if ((r->FromNode == node) && (r->FromField.fieldIndex == fieldIndex) && (r->ToNode != from_node) ) {
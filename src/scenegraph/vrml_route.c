@@ -29,6 +29,74 @@
 
 #ifndef GPAC_DISABLE_VRML
 
+/*locates the dispatch entry for the given field, or the position where it should be inserted*/
+static GF_FieldRoutes *node_find_field_routes(struct _node_interactive_ext *interact, u32 fieldIndex, u32 *insert_pos)
+{
+	u32 low = 0;
+	u32 high = interact->nb_field_routes;
+	while (low < high) {
+		u32 mid = (low + high) / 2;
+		GF_FieldRoutes *fr = &interact->field_routes[mid];
+		if (fr->fieldIndex == fieldIndex) return fr;
+		if (fr->fieldIndex < fieldIndex) low = mid + 1;
+		else high = mid;
+	}
+	if (insert_pos) *insert_pos = low;
+	return NULL;
+}
+
+void gf_node_add_route(GF_Node *node, GF_Route *r)
+{
+	GF_FieldRoutes *fr;
+	u32 pos;
+	struct _node_interactive_ext *interact;
+
+	if (!node->sgprivate->interact) GF_SAFEALLOC(node->sgprivate->interact, struct _node_interactive_ext);
+	interact = node->sgprivate->interact;
+	if (!interact->routes) interact->routes = gf_list_new();
+	gf_list_add(interact->routes, r);
+
+	/*only routes starting from this node are dispatched by gf_node_event_out*/
+	if (r->FromNode != node) return;
+
+	fr = node_find_field_routes(interact, r->FromField.fieldIndex, &pos);
+	if (!fr) {
+		interact->field_routes = (GF_FieldRoutes *) gf_realloc(interact->field_routes, sizeof(GF_FieldRoutes) * (interact->nb_field_routes+1));
+		if (pos < interact->nb_field_routes) 
+			memmove(&interact->field_routes[pos+1], &interact->field_routes[pos], sizeof(GF_FieldRoutes) * (interact->nb_field_routes - pos));
+		interact->nb_field_routes++;
+		fr = &interact->field_routes[pos];
+		fr->fieldIndex = r->FromField.fieldIndex;
+		fr->routes = gf_list_new();
+	}
+	gf_list_add(fr->routes, r);
+}
+
+void gf_node_remove_route(GF_Node *node, GF_Route *r)
+{
+	GF_FieldRoutes *fr;
+	struct _node_interactive_ext *interact = node->sgprivate->interact;
+	if (!interact || !interact->routes) return;
+
+	gf_list_del_item(interact->routes, r);
+	/*empty dispatch entries are kept until the node is destroyed, since the route may be removed while its event is being dispatched*/
+	fr = node_find_field_routes(interact, r->FromField.fieldIndex, NULL);
+	if (fr) gf_list_del_item(fr->routes, r);
+
+	if (!gf_list_count(interact->routes)) {
+		gf_list_del(interact->routes);
+		interact->routes = NULL;
+	}
+}
+
+GF_List *gf_node_get_field_routes(GF_Node *node, u32 fieldIndex)
+{
+	GF_FieldRoutes *fr;
+	if (!node->sgprivate->interact || !node->sgprivate->interact->nb_field_routes) return NULL;
+	fr = node_find_field_routes(node->sgprivate->interact, fieldIndex, NULL);
+	return fr ? fr->routes : NULL;
+}
+
 
 GF_EXPORT
 GF_Route *gf_sg_route_new(GF_SceneGraph *sg, GF_Node *fromNode, u32 fromField, GF_Node *toNode, u32 toField)
@@ -44,9 +112,7 @@ GF_Route *gf_sg_route_new(GF_SceneGraph *sg, GF_Node *fromNode, u32 fromField, G
 	r->ToField.fieldIndex = toField;
 	r->graph = sg;
 
-	if (!fromNode->sgprivate->interact) GF_SAFEALLOC(fromNode->sgprivate->interact, struct _node_interactive_ext);
-	if (!fromNode->sgprivate->interact->routes) fromNode->sgprivate->interact->routes = gf_list_new();
-	gf_list_add(fromNode->sgprivate->interact->routes, r);
+	gf_node_add_route(fromNode, r);
 	gf_list_add(sg->Routes, r);
 	return r;
 }
@@ -58,14 +124,10 @@ void gf_sg_route_del(GF_Route *r)
 
 	/*remove declared routes*/
 	gf_list_del_item(r->graph->Routes, r);
+	if (r->ID) gf_sg_index_remove(&r->graph->routes_by_id, gf_sg_hash_int(r->ID), r);
+	if (r->name) gf_sg_index_remove(&r->graph->routes_by_name, gf_sg_hash_string(r->name), r);
 	/*remove route from node - do this regardless of setup state since the route is registered upon creation*/
-	if (r->FromNode && r->FromNode->sgprivate->interact && r->FromNode->sgprivate->interact->routes) {
-		gf_list_del_item(r->FromNode->sgprivate->interact->routes, r);
-		if (!gf_list_count(r->FromNode->sgprivate->interact->routes)) {
-			gf_list_del(r->FromNode->sgprivate->interact->routes);
-			r->FromNode->sgprivate->interact->routes = NULL;
-		}
-	}
+	if (r->FromNode) gf_node_remove_route(r->FromNode, r);
 	/*special case for script events: notify desdctruction*/
 	if (r->ToNode && (r->ToField.fieldType==GF_SG_VRML_SCRIPT_FUNCTION) && r->ToField.on_event_in) {
 		r->is_setup = 0;
@@ -158,8 +220,9 @@ void gf_sg_route_unqueue(GF_SceneGraph *sg, GF_Route *r)
 GF_Route *gf_sg_route_find(GF_SceneGraph *sg, u32 RouteID)
 {
 	GF_Route *r;
-	u32 i=0;
-	while ((r = (GF_Route*)gf_list_enum(sg->Routes, &i))) {
+	u32 pos=0;
+	u32 hash = gf_sg_hash_int(RouteID);
+	while ((r = (GF_Route*)gf_sg_index_enum(&sg->routes_by_id, hash, &pos))) {
 		if (r->ID == RouteID) return r;
 	}
 	return NULL;
@@ -168,12 +231,13 @@ GF_Route *gf_sg_route_find(GF_SceneGraph *sg, u32 RouteID)
 GF_Route *gf_sg_route_find_by_name(GF_SceneGraph *sg, char *name)
 {
 	GF_Route *r;
-	u32 i;
+	u32 hash, pos;
 	if (!sg || !name) return NULL;
 
-	i=0;
-	while ((r = (GF_Route*)gf_list_enum(sg->Routes, &i))) {
-		if (r->name && !strcmp(r->name, name)) return r;
+	pos=0;
+	hash = gf_sg_hash_string(name);
+	while ((r = (GF_Route*)gf_sg_index_enum(&sg->routes_by_name, hash, &pos))) {
+		if (!strcmp(r->name, name)) return r;
 	}
 	return NULL;
 }
@@ -186,7 +250,9 @@ GF_Err gf_sg_route_set_id(GF_Route *route, u32 ID)
 
 	ptr = gf_sg_route_find(route->graph, ID);
 	if (ptr) return GF_BAD_PARAM;
+	if (route->ID) gf_sg_index_remove(&route->graph->routes_by_id, gf_sg_hash_int(route->ID), route);
 	route->ID = ID;
+	gf_sg_index_add(&route->graph->routes_by_id, gf_sg_hash_int(ID), route);
 	return GF_OK;
 }
 u32 gf_sg_route_get_id(GF_Route *route) 
@@ -200,8 +266,12 @@ GF_Err gf_sg_route_set_name(GF_Route *route, char *name)
 	if (!name || !route) return GF_BAD_PARAM;
 	ptr = gf_sg_route_find_by_name(route->graph, name);
 	if (ptr) return GF_BAD_PARAM;
-	if (route->name) gf_free(route->name);
+	if (route->name) {
+		gf_sg_index_remove(&route->graph->routes_by_name, gf_sg_hash_string(route->name), route);
+		gf_free(route->name);
+	}
 	route->name = gf_strdup(name);
+	gf_sg_index_add(&route->graph->routes_by_name, gf_sg_hash_string(route->name), route);
 	return GF_OK;
 }
 char *gf_sg_route_get_name(GF_Route *route)
@@ -229,13 +299,15 @@ static void gf_node_event_out_proto(GF_Node *node, u32 FieldIndex)
 {
 	u32 i;
 	GF_Route *r;
+	GF_List *routes;
 	if (!node) return;
 	
-	if (!node->sgprivate->interact) return;
+	routes = gf_node_get_field_routes(node, FieldIndex);
+	if (!routes) return;
 	
 	//search for routes to activate in the order they where declared
 	i=0;
-	while ((r = (GF_Route*)gf_list_enum(node->sgprivate->interact->routes, &i))) {
+	while ((r = (GF_Route*)gf_list_enum(routes, &i))) {
 		if (r->IS_route) continue;
 		if (r->FromNode != node) continue;
 		if (r->FromField.fieldIndex != FieldIndex) continue;
@@ -356,14 +428,16 @@ void gf_node_event_out(GF_Node *node, u32 FieldIndex)
 {
 	u32 i;
 	GF_Route *r;
+	GF_List *routes;
 	if (!node) return;
 	
-	/*node has no routes*/
-	if (!node->sgprivate->interact || !node->sgprivate->interact->routes) return;
+	/*no routes from this field*/
+	routes = gf_node_get_field_routes(node, FieldIndex);
+	if (!routes) return;
 	
 	//search for routes to activate in the order they where declared
 	i=0;
-	while ((r = (GF_Route*)gf_list_enum(node->sgprivate->interact->routes, &i))) {
+	while ((r = (GF_Route*)gf_list_enum(routes, &i))) {
 		if (r->FromNode != node) continue;
 		if (r->FromField.fieldIndex != FieldIndex) continue;
 
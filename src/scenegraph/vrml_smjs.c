@@ -876,9 +876,7 @@ static JSBool SMJS_FUNCTION(addRoute)
 		r->is_setup = 1;
 		r->graph = n1->sgprivate->scenegraph;
 
-		if (!n1->sgprivate->interact) GF_SAFEALLOC(n1->sgprivate->interact, struct _node_interactive_ext);
-		if (!n1->sgprivate->interact->routes) n1->sgprivate->interact->routes = gf_list_new();
-		gf_list_add(n1->sgprivate->interact->routes, r);
+		gf_node_add_route(n1, r);
 		gf_list_add(n1->sgprivate->scenegraph->Routes, r);
 	}
 
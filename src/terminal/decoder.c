@@ -32,6 +32,9 @@
 #include "media_control.h"
 #include "input_sensor.h"
 
+/*max number of frames flushed from a re-ordering codec at end of stream (reordering depth + frame threads)*/
+#define MAX_FLUSHED_FRAMES	32
+
 GF_Err Codec_Load(GF_Codec *codec, GF_ESD *esd, u32 PL);
 GF_Err gf_codec_process_raw_media_pull(GF_Codec *codec, u32 TimeAvailable);
 
@@ -639,6 +642,134 @@ static GF_Err ResizeCompositionBuffer(GF_Codec *dec, u32 NewSize)
 	return GF_OK;
 }
 
+/*signature of image AUs, used to detect identical images sent again and again (for instance streaming a carousel).
+This is a 64 bit FNV-1a on 32 bit words, much cheaper than a SHA-1 - AU sizes are compared as well*/
+static u64 MediaCodec_GetSignature(char *data, u32 size)
+{
+	u32 i, val;
+	u64 sig = ((u64) 0xCBF29CE4 << 32) | 0x84222325;
+	const u64 prime = ((u64) 1 << 40) | 0x1B3;
+
+	for (i=0; i+4<=size; i+=4) {
+		memcpy(&val, data+i, 4);
+		sig = (sig ^ val) * prime;
+	}
+	for (; i<size; i++) {
+		sig = (sig ^ (u8) data[i]) * prime;
+	}
+	return sig;
+}
+
+static u64 MediaCodec_GetConfigSignature(GF_ESD *esd)
+{
+	u64 sig = esd->decoderConfig->objectTypeIndication;
+	if (esd->decoderConfig->decoderSpecificInfo && esd->decoderConfig->decoderSpecificInfo->data) 
+		sig ^= MediaCodec_GetSignature(esd->decoderConfig->decoderSpecificInfo->data, esd->decoderConfig->decoderSpecificInfo->dataLength);
+	return sig;
+}
+
+/*stores a decoded image in the terminal image cache*/
+static void MediaCodec_CacheImage(GF_Codec *codec, GF_Channel *ch, char *data, u32 size, u32 au_size, u64 au_signature)
+{
+	u32 w, h, stride, pf, par;
+	GF_CodecCapability cap;
+	if (!codec->odm->term->image_cache || !ch->service) return;
+
+	/*the decoder and not the cached image gives the properties of the decoded image*/
+	cap.CapCode = GF_CODEC_WIDTH;
+	cap.cap.valueInt = 0;
+	codec->decio->GetCapabilities(codec->decio, &cap);
+	w = cap.cap.valueInt;
+	cap.CapCode = GF_CODEC_HEIGHT;
+	cap.cap.valueInt = 0;
+	codec->decio->GetCapabilities(codec->decio, &cap);
+	h = cap.cap.valueInt;
+	cap.CapCode = GF_CODEC_STRIDE;
+	cap.cap.valueInt = 0;
+	codec->decio->GetCapabilities(codec->decio, &cap);
+	stride = cap.cap.valueInt;
+	cap.CapCode = GF_CODEC_PIXEL_FORMAT;
+	cap.cap.valueInt = 0;
+	codec->decio->GetCapabilities(codec->decio, &cap);
+	pf = cap.cap.valueInt;
+	cap.CapCode = GF_CODEC_PAR;
+	cap.cap.valueInt = 0;
+	codec->decio->GetCapabilities(codec->decio, &cap);
+	par = cap.cap.valueInt;
+
+	gf_term_image_cache_add(codec->odm->term, ch->service->url, ch->esd->ESID, MediaCodec_GetConfigSignature(ch->esd), au_size, au_signature, data, size, w, h, stride, pf, par);
+}
+
+/*uses the image decoded by another object for the same resource if any. Returns 1 if the AU was consumed*/
+static Bool MediaCodec_UseCachedImage(GF_Codec *codec, GF_Channel *ch, GF_DBUnit *AU, u64 au_signature)
+{
+	GF_CMUnit *CU;
+	u32 unit_size;
+	GF_CachedImage *img;
+	if (!codec->odm->term->image_cache || !ch->service) return 0;
+
+	img = gf_term_image_cache_get(codec->odm->term, ch->service->url, ch->esd->ESID, MediaCodec_GetConfigSignature(ch->esd), AU->dataLength, au_signature);
+	if (!img) return 0;
+
+	if (codec->cached_image) gf_term_image_cache_release(codec->odm->term, codec->cached_image);
+	codec->cached_image = img;
+	/*resize the composition memory and update config from the cached image*/
+	ResizeCompositionBuffer(codec, img->size);
+
+	if (LockCompositionUnit(codec, AU->CTS, &CU, &unit_size) != GF_OK) return 0;
+	if (!CU->data || (unit_size < img->size)) {
+		UnlockCompositionUnit(codec, CU, 0);
+		return 0;
+	}
+	memcpy(CU->data, img->data, img->size);
+	UnlockCompositionUnit(codec, CU, img->size);
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CODEC, ("[%s] ODM%d at %d using cached image for TS %d\n", codec->decio->module_name, codec->odm->OD->objectDescriptorID, gf_clock_real_time(ch->clock), AU->CTS));
+	codec->last_unit_dts = AU->DTS;
+	codec->last_unit_cts = AU->CTS;
+	gf_es_drop_au(ch);
+	return 1;
+}
+
+/*decodes the next image in the spare unit of the composition memory while the current one is displayed. The
+image is dispatched when due by MediaCodec_Process. Returns 1 if the AU was consumed*/
+static Bool MediaCodec_DecodeAhead(GF_Codec *codec, GF_Channel *ch, GF_DBUnit *AU)
+{
+	GF_CMUnit *CU;
+	GF_Err e;
+	u32 unit_size, now;
+	GF_MediaDecoder *mdec = (GF_MediaDecoder*)codec->decio;
+
+	unit_size = codec->CB->UnitSize;
+	CU = gf_cm_lock_ahead(codec->CB, AU->CTS, unit_size);
+	if (!CU) return 0;
+
+	now = gf_term_get_time(codec->odm->term);
+	e = mdec->ProcessData(mdec, AU->data, AU->dataLength, ch->esd->ESID, CU->data, &unit_size, AU->PaddingBits, GF_CODEC_LEVEL_NORMAL);
+	/*new image size: grow the spare unit, the composition memory is resized when the image is dispatched*/
+	if (e==GF_BUFFER_TOO_SMALL) {
+		CU = gf_cm_lock_ahead(codec->CB, AU->CTS, unit_size);
+		if (!CU) return 0;
+		e = mdec->ProcessData(mdec, AU->data, AU->dataLength, ch->esd->ESID, CU->data, &unit_size, AU->PaddingBits, GF_CODEC_LEVEL_NORMAL);
+	}
+	now = gf_term_get_time(codec->odm->term) - now;
+	if (codec->Status == GF_ESM_CODEC_STOP) return 0;
+
+	if (e) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CODEC, ("[%s] ODM%d At %d (frame TS %d - %d ms ): decoded error %s\n", codec->decio->module_name, codec->odm->OD->objectDescriptorID, gf_clock_real_time(ch->clock), AU->CTS, now, gf_error_to_string(e) ));
+		gf_cm_unlock_ahead(codec->CB, CU, 0, 0);
+	} else {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CODEC, ("[%s] ODM%d at %d decoded image TS %d ahead of time in %d ms\n", codec->decio->module_name, codec->odm->OD->objectDescriptorID, gf_clock_real_time(ch->clock), AU->CTS, now));
+		MediaCodec_CacheImage(codec, ch, CU->data, unit_size, AU->dataLength, MediaCodec_GetSignature(AU->data, AU->dataLength));
+		gf_cm_unlock_ahead(codec->CB, CU, unit_size, unit_size);
+		codec_update_stats(codec, AU->dataLength, now);
+	}
+	codec->last_unit_dts = AU->DTS;
+	codec->last_unit_cts = AU->CTS;
+	gf_es_drop_au(ch);
+	return 1;
+}
+
 static GF_Err MediaCodec_Process(GF_Codec *codec, u32 TimeAvailable)
 {
 	GF_CMUnit *CU;
@@ -656,19 +787,39 @@ static GF_Err MediaCodec_Process(GF_Codec *codec, u32 TimeAvailable)
 
 	entryTime = gf_term_get_time(codec->odm->term);
 
+	/*image decoded ahead of time, nothing else to do until it is dispatched*/
+	if (codec->CB && gf_cm_has_ahead(codec->CB)) {
+		Bool resized = codec->CB->ahead_unit_size ? 1 : 0;
+		if (!gf_cm_dispatch_ahead(codec->CB, gf_clock_time(codec->ck)))
+			return GF_OK;
+		/*the previous image came from the image cache, config is now given by the decoder*/
+		if (codec->cached_image) {
+			gf_term_image_cache_release(codec->odm->term, codec->cached_image);
+			codec->cached_image = NULL;
+			resized = 1;
+		}
+		/*the image size changed, update config*/
+		if (resized) ResizeCompositionBuffer(codec, 0);
+	}
+
 	/*fetch next AU in DTS order for this codec*/
 	Decoder_GetNextAU(codec, &ch, &AU);
 	/*no active channel return*/
 	if (!AU || !ch) {
 		/*if the codec is in EOS state, assume we're done*/
 		if (codec->Status == GF_ESM_CODEC_EOS) {
-			/*if codec is reordering, try to flush it*/
-			if (codec->is_reordering) {
+			/*if codec is reordering, try to flush it - frame-threaded decoders may hold several frames,
+			flush until no more output*/
+			while (codec->is_reordering && (codec->nb_flushed_frames < MAX_FLUSHED_FRAMES)) {
 				if ( LockCompositionUnit(codec, codec->last_unit_cts+1, &CU, &unit_size) == GF_OUT_OF_MEM)
 					return GF_OK;
 				assert( CU );
 				e = mdec->ProcessData(mdec, NULL, 0, 0, CU->data, &unit_size, 0, 0);
-				if (e==GF_OK) e = UnlockCompositionUnit(codec, CU, unit_size);
+				if (e!=GF_OK) unit_size = 0;
+				UnlockCompositionUnit(codec, CU, unit_size);
+				if (!unit_size) break;
+				codec->nb_flushed_frames++;
+				codec->last_unit_cts++;
 			}
 			gf_term_stop_codec(codec);
 			if (codec->CB) gf_cm_set_eos(codec->CB);
@@ -683,6 +834,9 @@ static GF_Err MediaCodec_Process(GF_Codec *codec, u32 TimeAvailable)
 	obj_time = gf_clock_time(codec->ck);
 	/*Media Time for media codecs is updated in the CB*/
 
+	/*new input, reset flush counter*/
+	codec->nb_flushed_frames = 0;
+
 	if (!codec->CB) {
 		gf_es_drop_au(ch);
 		return GF_BAD_PARAM;
@@ -690,10 +844,9 @@ static GF_Err MediaCodec_Process(GF_Codec *codec, u32 TimeAvailable)
 
 	/*image codecs*/
 	if (codec->CB->Capacity == 1) {
-		/*a SHA signature is computed for each AU. This avoids decoding/recompositing when identical (for instance streaming a carousel)*/
-		u8 new_unit_signature[20];
-		gf_sha1_csum((u8*)AU->data, AU->dataLength, new_unit_signature);
-		if (!memcmp(codec->last_unit_signature, new_unit_signature, sizeof(new_unit_signature))) {
+		/*a signature is computed for each AU. This avoids decoding/recompositing when identical (for instance streaming a carousel)*/
+		u64 new_unit_signature = MediaCodec_GetSignature(AU->data, AU->dataLength);
+		if ((codec->last_unit_size == AU->dataLength) && (codec->last_unit_signature == new_unit_signature)) {
 			codec->nb_repeted_frames++;
 			gf_es_drop_au(ch);
 			return GF_OK;
@@ -707,13 +860,24 @@ static GF_Err MediaCodec_Process(GF_Codec *codec, u32 TimeAvailable)
 			gf_mx_v(codec->odm->mx);
 		}
 
-		/*CB is already full*/
-		if (codec->CB->UnitCount)
+		/*CB is already full, decode the image ahead of its composition time*/
+		if (codec->CB->UnitCount) {
+			unit_size = AU->dataLength;
+			if (MediaCodec_DecodeAhead(codec, ch, AU)) {
+				codec->nb_repeted_frames = 0;
+				codec->last_unit_size = unit_size;
+				codec->last_unit_signature = new_unit_signature;
+			}
 			return GF_OK;
+		}
 
 		codec->nb_repeted_frames = 0;
-		memcpy(codec->last_unit_signature, new_unit_signature, sizeof(new_unit_signature));
+		codec->last_unit_size = AU->dataLength;
+		codec->last_unit_signature = new_unit_signature;
 
+		/*image already decoded for the same resource by another object (other scene or reload)*/
+		if (MediaCodec_UseCachedImage(codec, ch, AU, new_unit_signature)) 
+			return GF_OK;
 	}
 
 	/*try to refill the full buffer*/
@@ -837,6 +1001,15 @@ scalable_retry:
 		case GF_OK:
 			if (unit_size) {
 				GF_LOG(GF_LOG_DEBUG, GF_LOG_CODEC, ("[%s] ODM%d at %d decoded frame TS %d in %d ms (DTS %d) - %d in CB\n", codec->decio->module_name, codec->odm->OD->objectDescriptorID, gf_clock_real_time(ch->clock), AU->CTS, now, AU->DTS, codec->CB->UnitCount + 1));
+				/*share decoded images with other objects using the same resource*/
+				if (codec->CB->Capacity == 1) {
+					if (codec->cached_image) {
+						gf_term_image_cache_release(codec->odm->term, codec->cached_image);
+						codec->cached_image = NULL;
+						gf_mo_update_caps(codec->odm->mo);
+					}
+					MediaCodec_CacheImage(codec, ch, CU->data, unit_size, codec->last_unit_size, codec->last_unit_signature);
+				}
 			}
 			/*if no size the decoder is not using the composition memory - if the object is in intitial buffering resume it!!*/
 			else if (codec->CB->Status == CB_BUFFER) {
@@ -1002,6 +1175,29 @@ GF_Err gf_codec_process(GF_Codec *codec, u32 TimeAvailable)
 GF_Err gf_codec_get_capability(GF_Codec *codec, GF_CodecCapability *cap)
 {
 	cap->cap.valueInt = 0;
+	/*image copied from the image cache, the decoder was never configured with it*/
+	if (codec->cached_image) {
+		switch (cap->CapCode) {
+		case GF_CODEC_WIDTH:
+			cap->cap.valueInt = codec->cached_image->width;
+			return GF_OK;
+		case GF_CODEC_HEIGHT:
+			cap->cap.valueInt = codec->cached_image->height;
+			return GF_OK;
+		case GF_CODEC_STRIDE:
+			cap->cap.valueInt = codec->cached_image->stride;
+			return GF_OK;
+		case GF_CODEC_PIXEL_FORMAT:
+			cap->cap.valueInt = codec->cached_image->pixel_format;
+			return GF_OK;
+		case GF_CODEC_PAR:
+			cap->cap.valueInt = codec->cached_image->pixel_ar;
+			return GF_OK;
+		case GF_CODEC_OUTPUT_SIZE:
+			cap->cap.valueInt = codec->cached_image->size;
+			return GF_OK;
+		}
+	}
 	if (codec->decio) 
 		return codec->decio->GetCapabilities(codec->decio, cap);
 
@@ -1091,7 +1287,8 @@ void gf_codec_set_status(GF_Codec *codec, u32 Status)
 		codec->cur_audio_bytes = codec->cur_video_frames = 0;
 		codec->nb_droped = 0;
 		codec->nb_repeted_frames = 0;
-		memset(codec->last_unit_signature, 0, sizeof(codec->last_unit_signature));
+		codec->last_unit_size = 0;
+		codec->last_unit_signature = 0;
 	}
 	else codec->Status = Status;
 
@@ -1308,6 +1505,8 @@ void gf_codec_del(GF_Codec *codec)
 	}
 	if (codec->CB) gf_cm_del(codec->CB);
 	codec->CB = NULL;
+	if (codec->cached_image) gf_term_image_cache_release(codec->odm->term, codec->cached_image);
+	codec->cached_image = NULL;
 	if (codec->inChannels) gf_list_del(codec->inChannels);
 	codec->inChannels = NULL;
 	gf_free(codec);
@@ -30,6 +30,7 @@
 
 
 u32 MM_Loop(void *par);
+u32 MM_ImageLoop(void *par);
 
 
 enum
@@ -41,6 +42,10 @@ enum
 	/*only used by threaded decs to signal end of thread*/
 	GF_MM_CE_DEAD = 1<<4,
 	GF_MM_CE_DISCRADED = 1<<5,
+	/*codec is an image codec (single unit composition memory)*/
+	GF_MM_CE_IMAGE = 1<<6,
+	/*codec is handled by the image decoder pool*/
+	GF_MM_CE_POOLED = 1<<7,
 };
 
 typedef struct
@@ -54,6 +59,9 @@ typedef struct
 
 GF_Err gf_term_init_scheduler(GF_Terminal *term, u32 threading_mode)
 {
+	u32 i;
+	const char *sOpt;
+
 	term->mm_mx = gf_mx_new("MediaManager");
 	term->codecs = gf_list_new();
 
@@ -75,6 +83,20 @@ GF_Err gf_term_init_scheduler(GF_Terminal *term, u32 threading_mode)
 	term->flags |= GF_TERM_RUNNING;
 	term->priority = GF_THREAD_PRIORITY_NORMAL;
 	gf_th_run(term->mm_thread, MM_Loop, term);
+
+	/*image decoder pool - images are decoded ahead of time by these threads so that large images
+	do not block the media manager*/
+	sOpt = gf_cfg_get_key(term->user->config, "Systems", "ImageDecoderThreads");
+	term->nb_image_threads = sOpt ? atoi(sOpt) : 2;
+	if (term->nb_image_threads) {
+		term->image_codecs = gf_list_new();
+		term->image_mx = gf_mx_new("ImageDecoders");
+		term->image_threads = (GF_Thread **) gf_malloc(sizeof(GF_Thread *) * term->nb_image_threads);
+		for (i=0; i<term->nb_image_threads; i++) {
+			term->image_threads[i] = gf_th_new("ImageDecoder");
+			gf_th_run(term->image_threads[i], MM_ImageLoop, term);
+		}
+	}
 	return GF_OK;
 }
 
@@ -100,6 +122,15 @@ void gf_term_stop_scheduler(GF_Terminal *term)
 
 		assert(! gf_list_count(term->codecs));
 		gf_th_del(term->mm_thread);
+
+		for (i=0; i<term->nb_image_threads; i++) {
+			gf_th_del(term->image_threads[i]);
+		}
+		if (term->image_threads) {
+			gf_free(term->image_threads);
+			gf_list_del(term->image_codecs);
+			gf_mx_del(term->image_mx);
+		}
 	}
 	gf_list_del(term->codecs);
 	gf_mx_del(term->mm_mx);
@@ -116,6 +147,30 @@ static CodecEntry *mm_get_codec(GF_List *list, GF_Codec *codec)
 }
 
 
+/*moves a codec entry to the image decoder pool*/
+static void mm_pool_add(GF_Terminal *term, CodecEntry *ce)
+{
+	ce->mx = gf_mx_new(ce->dec->decio->module_name);
+	ce->flags |= GF_MM_CE_POOLED;
+	gf_mx_p(term->image_mx);
+	gf_list_add(term->image_codecs, ce);
+	gf_mx_v(term->image_mx);
+}
+
+/*removes a codec entry from the image decoder pool, waiting for the pool to release the decoder*/
+static void mm_pool_remove(GF_Terminal *term, CodecEntry *ce)
+{
+	gf_mx_p(term->image_mx);
+	gf_list_del_item(term->image_codecs, ce);
+	gf_mx_v(term->image_mx);
+
+	gf_mx_p(ce->mx);
+	gf_mx_v(ce->mx);
+	gf_mx_del(ce->mx);
+	ce->mx = NULL;
+	ce->flags &= ~GF_MM_CE_POOLED;
+}
+
 void gf_term_add_codec(GF_Terminal *term, GF_Codec *codec)
 {
 	u32 i, count;
@@ -160,6 +215,20 @@ void gf_term_add_codec(GF_Terminal *term, GF_Codec *codec)
 		goto exit;
 	}
 
+	/*images (single unit composition memory) are decoded by the image decoder pool, unless all decoders
+	run in the media manager thread*/
+	if ((codec->type==GF_STREAM_VISUAL) && !(codec->flags & GF_ESM_CODEC_IS_RAW_MEDIA)) {
+		cap.CapCode = GF_CODEC_BUFFER_MAX;
+		cap.cap.valueInt = 1;
+		gf_codec_get_capability(codec, &cap);
+		if (cap.cap.valueInt == 1) cd->flags |= GF_MM_CE_IMAGE;
+	}
+	if ((cd->flags & GF_MM_CE_IMAGE) && term->nb_image_threads && !(term->flags & GF_TERM_SINGLE_THREAD)) {
+		mm_pool_add(term, cd);
+		gf_list_add(term->codecs, cd);
+		goto exit;
+	}
+
 	//add codec 1- per priority 2- per type, audio being first
 	//priorities inherits from Systems (5bits) so range from 0 to 31
 	//we sort from MAX to MIN
@@ -228,7 +297,9 @@ void gf_term_remove_codec(GF_Terminal *term, GF_Codec *codec)
 	while ((ce = (CodecEntry*)gf_list_enum(term->codecs, &i))) {
 		if (ce->dec != codec) continue;
 
-		if (ce->thread) {
+		if (ce->flags & GF_MM_CE_POOLED) {
+			mm_pool_remove(term, ce);
+		} else if (ce->thread) {
 			if (ce->flags & GF_MM_CE_RUNNING) {
 				ce->flags &= ~GF_MM_CE_RUNNING;
 				while (! (ce->flags & GF_MM_CE_DEAD)) gf_sleep(10);
@@ -293,7 +364,7 @@ static u32 MM_SimulationStep_Decoder(GF_Terminal *term)
 		ce = (CodecEntry*)gf_list_get(term->codecs, term->last_codec);
 		if (!ce) break;
 
-		if (!(ce->flags & GF_MM_CE_RUNNING) || (ce->flags & GF_MM_CE_THREADED) ) {
+		if (!(ce->flags & GF_MM_CE_RUNNING) || (ce->flags & (GF_MM_CE_THREADED | GF_MM_CE_POOLED)) ) {
 			remain--;
 			if (!remain) break;
 			term->last_codec = (term->last_codec + 1) % count;
@@ -412,6 +483,39 @@ u32 RunSingleDec(void *ptr)
 	return 0;
 }
 
+u32 MM_ImageLoop(void *par)
+{
+	GF_Err e;
+	u32 i, time_taken;
+	Bool locked;
+	CodecEntry *ce;
+	GF_Terminal *term = (GF_Terminal *) par;
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[MediaManager] Entering image decoder thread ID %d\n", gf_th_id() ));
+
+	while (term->flags & GF_TERM_RUNNING) {
+		time_taken = gf_sys_clock();
+		/*process all image codecs, skipping the ones being decoded by other threads of the pool*/
+		for (i=0; ; i++) {
+			gf_mx_p(term->image_mx);
+			ce = (CodecEntry*)gf_list_get(term->image_codecs, i);
+			locked = (ce && gf_mx_try_lock(ce->mx)) ? 1 : 0;
+			gf_mx_v(term->image_mx);
+			if (!ce) break;
+			if (!locked) continue;
+
+			if (ce->flags & GF_MM_CE_RUNNING) {
+				e = gf_codec_process(ce->dec, term->frame_duration);
+				if (e) gf_term_message(ce->dec->odm->term, ce->dec->odm->net_service->url, "Decoding Error", e);
+			}
+			gf_mx_v(ce->mx);
+		}
+		time_taken = gf_sys_clock() - time_taken;
+		gf_sleep( (time_taken < term->frame_duration) ? term->frame_duration - time_taken : 1);
+	}
+	return 0;
+}
+
 /*NOTE: when starting/stoping a decoder we only lock the decoder mutex, NOT the media manager. This
 avoids deadlocking in case a system codec waits for the scene graph and the compositor requests 
 a stop/start on a media*/
@@ -445,7 +549,7 @@ void gf_term_start_codec(GF_Codec *codec)
 		if (ce->thread) {
 			gf_th_run(ce->thread, RunSingleDec, ce);
 			gf_th_set_priority(ce->thread, term->priority);
-		} else {
+		} else if (!(ce->flags & GF_MM_CE_POOLED)) {
 			term->cumulated_priority += ce->dec->Priority+1;
 		}
 	}
@@ -493,7 +597,7 @@ void gf_term_stop_codec(GF_Codec *codec)
 	/*don't wait for end of thread since this can be triggered within the decoding thread*/
 	if (ce->flags & GF_MM_CE_RUNNING) {
 		ce->flags &= ~GF_MM_CE_RUNNING;
-		if (!ce->thread) 
+		if (!ce->thread && !(ce->flags & GF_MM_CE_POOLED)) 
 			term->cumulated_priority -= codec->Priority+1;
 	}
 
@@ -505,7 +609,7 @@ void gf_term_stop_codec(GF_Codec *codec)
 void gf_term_set_threading(GF_Terminal *term, u32 mode)
 {
 	u32 i;
-	Bool thread_it, restart_it;
+	Bool thread_it, pool_it, restart_it;
 	CodecEntry *ce;
 
 	switch (mode) {
@@ -535,9 +639,13 @@ void gf_term_set_threading(GF_Terminal *term, u32 mode)
 		/*free mode, decoder wants threading - do */
 		if ((mode == GF_TERM_THREAD_FREE) && (ce->flags & GF_MM_CE_REQ_THREAD)) thread_it = 1;
 		else if (mode == GF_TERM_THREAD_MULTI) thread_it = 1;
+		/*images go to the image decoder pool when not threaded, unless in single thread mode*/
+		pool_it = 0;
+		if (!thread_it && (ce->flags & GF_MM_CE_IMAGE) && term->nb_image_threads && (mode != GF_TERM_THREAD_SINGLE)) pool_it = 1;
 
 		if (thread_it && (ce->flags & GF_MM_CE_THREADED)) continue;
-		if (!thread_it && !(ce->flags & GF_MM_CE_THREADED)) continue;
+		if (pool_it && (ce->flags & GF_MM_CE_POOLED)) continue;
+		if (!thread_it && !pool_it && !(ce->flags & (GF_MM_CE_THREADED | GF_MM_CE_POOLED)) ) continue;
 
 		restart_it = 0;
 		if (ce->flags & GF_MM_CE_RUNNING) {
@@ -554,6 +662,8 @@ void gf_term_set_threading(GF_Terminal *term, u32 mode)
 			gf_mx_del(ce->mx);
 			ce->mx = NULL;
 			ce->flags &= ~GF_MM_CE_THREADED;
+		} else if (ce->flags & GF_MM_CE_POOLED) {
+			mm_pool_remove(term, ce);
 		} else {
 			term->cumulated_priority -= ce->dec->Priority+1;
 		}
@@ -562,6 +672,8 @@ void gf_term_set_threading(GF_Terminal *term, u32 mode)
 			ce->flags |= GF_MM_CE_THREADED;
 			ce->thread = gf_th_new(ce->dec->decio->module_name);
 			ce->mx = gf_mx_new(ce->dec->decio->module_name);
+		} else if (pool_it) {
+			mm_pool_add(term, ce);
 		}
 
 		if (restart_it) {
@@ -569,7 +681,7 @@ void gf_term_set_threading(GF_Terminal *term, u32 mode)
 			if (ce->thread) {
 				gf_th_run(ce->thread, RunSingleDec, ce);
 				gf_th_set_priority(ce->thread, term->priority);
-			} else {
+			} else if (!(ce->flags & GF_MM_CE_POOLED)) {
 				term->cumulated_priority += ce->dec->Priority+1;
 			}
 		}
@@ -610,6 +722,9 @@ void gf_term_set_priority(GF_Terminal *term, s32 Priority)
 		if (ce->flags & GF_MM_CE_THREADED)
 			gf_th_set_priority(ce->thread, Priority);
 	}
+	for (i=0; i<term->nb_image_threads; i++) {
+		gf_th_set_priority(term->image_threads[i], Priority);
+	}
 	term->priority = Priority;
 	gf_mx_v(term->mm_mx);
 }
@@ -158,6 +158,11 @@ void gf_cm_del(GF_CompositionMemory *cb)
 	  gf_cm_unit_del(cb->input, cb->no_allocation);
 	  cb->input = NULL;
 	}
+	if (cb->ahead) {
+		if (cb->ahead->data) my_large_gf_free(cb->ahead->data);
+		gf_free(cb->ahead);
+		cb->ahead = NULL;
+	}
 	gf_odm_lock(cb->odm, 0);
 	gf_free(cb);
 }
@@ -367,6 +372,83 @@ void gf_cm_unlock_input(GF_CompositionMemory *cb, GF_CMUnit *cu, u32 cu_size, Bo
 }
 
 
+GF_CMUnit *gf_cm_lock_ahead(GF_CompositionMemory *cb, u32 TS, u32 size)
+{
+	GF_MediaObject *mo;
+	Bool in_use;
+	if ((cb->Capacity != 1) || cb->no_allocation) return NULL;
+	if (!cb->ahead) {
+		GF_SAFEALLOC(cb->ahead, GF_CMUnit);
+		if (!cb->ahead) return NULL;
+	}
+	/*image not yet dispatched*/
+	if (cb->ahead->dataLength) return NULL;
+
+	/*after a swap the spare unit holds the previous image, which the compositor keeps drawing until it
+	fetches the new one: don't overwrite or free it before that*/
+	gf_odm_lock(cb->odm, 1);
+	mo = cb->odm->mo;
+	in_use = (mo && mo->num_open && cb->ahead->data && (mo->frame >= cb->ahead->data) && (mo->frame < cb->ahead->data + cb->ahead_size)) ? 1 : 0;
+	gf_odm_lock(cb->odm, 0);
+	if (in_use) return NULL;
+
+	if (size < cb->UnitSize) size = cb->UnitSize;
+	if (cb->ahead_size < size) {
+		if (cb->ahead->data) my_large_gf_free(cb->ahead->data);
+		cb->ahead->data = (char*) my_large_alloc(size);
+		cb->ahead_size = cb->ahead->data ? size : 0;
+		if (!cb->ahead->data) return NULL;
+	}
+	cb->ahead->TS = TS;
+	cb->ahead->RenderedLength = 0;
+	return cb->ahead;
+}
+
+void gf_cm_unlock_ahead(GF_CompositionMemory *cb, GF_CMUnit *cu, u32 cu_size, u32 unit_size)
+{
+	cu->dataLength = cu_size;
+	if (!cu_size) cu->TS = 0;
+	cb->ahead_unit_size = (cu_size && (unit_size != cb->UnitSize)) ? unit_size : 0;
+}
+
+Bool gf_cm_has_ahead(GF_CompositionMemory *cb)
+{
+	return (cb->ahead && cb->ahead->dataLength) ? 1 : 0;
+}
+
+Bool gf_cm_dispatch_ahead(GF_CompositionMemory *cb, u32 obj_time)
+{
+	char *data;
+	GF_CMUnit *cu, *ahead = cb->ahead;
+
+	if (!ahead || !ahead->dataLength) return 0;
+	if (cb->UnitCount && (obj_time < ahead->TS)) return 0;
+
+	gf_odm_lock(cb->odm, 1);
+	/*single unit, input is output - swap buffers. The spare unit may be larger than needed, the old output
+	is at least as large as the old unit size*/
+	cu = cb->input;
+	data = cu->data;
+	cu->data = ahead->data;
+	ahead->data = data;
+	cb->ahead_size = cb->UnitSize;
+	if (cb->ahead_unit_size) cb->UnitSize = cb->ahead_unit_size;
+	cb->ahead_unit_size = 0;
+
+	if (!cu->dataLength) cb->UnitCount += 1;
+	cu->TS = ahead->TS;
+	cu->dataLength = ahead->dataLength;
+	cu->RenderedLength = 0;
+	ahead->dataLength = 0;
+	ahead->TS = 0;
+
+	if ((cb->odm->codec->type==GF_STREAM_VISUAL) && cb->odm->mo && cb->odm->mo->num_open) {
+		gf_term_invalidate_compositor(cb->odm->term);
+	}
+	gf_odm_lock(cb->odm, 0);
+	return 1;
+}
+
 /*Reset composition memory. Note we don't reset the content of each frame since it would lead to green frames 
 when using bitmap (visual), where data is not cached*/
 void gf_cm_reset(GF_CompositionMemory *cb)
@@ -394,6 +476,8 @@ void gf_cm_reset(GF_CompositionMemory *cb)
 	cb->output = cb->input;
 	cb->UnitCount = 0;
 	cb->HasSeenEOS = 0;
+	/*discard any image decoded ahead*/
+	if (cb->ahead) cb->ahead->dataLength = 0;
 
 	if (cb->odm->mo) cb->odm->mo->timestamp = 0;
 	gf_odm_lock(cb->odm, 0);
@@ -410,6 +494,8 @@ void gf_cm_resize(GF_CompositionMemory *cb, u32 newCapacity)
 	cu = cb->input;
 
 	cb->UnitSize = newCapacity;
+	/*the spare unit is reallocated when next used*/
+	if (cb->ahead) cb->ahead->dataLength = 0;
 	if (!cb->no_allocation) {
 		my_large_gf_free(cu->data);
 		cu->data = (char*) my_large_alloc(newCapacity);
@@ -454,6 +540,7 @@ void gf_cm_reinit(GF_CompositionMemory *cb, u32 UnitSize, u32 Capacity)
 	cu = NULL;
 	cb->Capacity = Capacity;
 	cb->UnitSize = UnitSize;
+	if (cb->ahead) cb->ahead->dataLength = 0;
 
 	prev = NULL;
 	i = 1;
@@ -666,3 +753,153 @@ void gf_cm_abort_buffering(GF_CompositionMemory *cb)
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_SYNC, ("[SyncLayer] ODM%d: buffering off at %d (nb buffering on clock: %d)\n", cb->odm->OD->objectDescriptorID, gf_term_get_time(cb->odm->term), cb->odm->codec->ck->Buffering));
 	}
 }
+
+
+static void image_cache_free(GF_CachedImage *img)
+{
+	gf_free(img->url);
+	if (img->data) gf_free(img->data);
+	gf_free(img);
+}
+
+static void image_cache_remove(GF_ImageCache *ic, GF_CachedImage *img)
+{
+	gf_list_del_item(ic->images, img);
+	ic->size -= img->size;
+	/*still displayed, destroyed when released*/
+	if (img->nb_refs) img->removed = 1;
+	else image_cache_free(img);
+}
+
+/*discards the least recently used images not in use until size bytes can be added*/
+static void image_cache_purge(GF_ImageCache *ic, u32 size)
+{
+	s32 i = gf_list_count(ic->images) - 1;
+	while ((i>=0) && (ic->size + size > ic->max_size)) {
+		GF_CachedImage *img = gf_list_get(ic->images, i);
+		if (!img->nb_refs) image_cache_remove(ic, img);
+		i--;
+	}
+}
+
+void gf_term_image_cache_set_size(GF_Terminal *term, u32 max_size)
+{
+	GF_ImageCache *ic = term->image_cache;
+	if (!ic) {
+		if (!max_size) return;
+		GF_SAFEALLOC(ic, GF_ImageCache);
+		if (!ic) return;
+		ic->images = gf_list_new();
+		ic->mx = gf_mx_new("ImageCache");
+		term->image_cache = ic;
+	}
+	gf_mx_p(ic->mx);
+	ic->max_size = max_size;
+	image_cache_purge(ic, 0);
+	gf_mx_v(ic->mx);
+}
+
+void gf_term_image_cache_del(GF_Terminal *term)
+{
+	GF_ImageCache *ic = term->image_cache;
+	if (!ic) return;
+	while (gf_list_count(ic->images)) {
+		GF_CachedImage *img = gf_list_last(ic->images);
+		gf_list_rem_last(ic->images);
+		image_cache_free(img);
+	}
+	gf_list_del(ic->images);
+	gf_mx_del(ic->mx);
+	gf_free(ic);
+	term->image_cache = NULL;
+}
+
+GF_CachedImage *gf_term_image_cache_get(GF_Terminal *term, const char *url, u32 ESID, u64 config_signature, u32 au_size, u64 au_signature)
+{
+	u32 i;
+	GF_CachedImage *img;
+	GF_ImageCache *ic = term->image_cache;
+	if (!ic || !ic->max_size || !url) return NULL;
+
+	gf_mx_p(ic->mx);
+	i=0;
+	while ((img = (GF_CachedImage *)gf_list_enum(ic->images, &i))) {
+		if ((img->ESID != ESID) || (img->config_signature != config_signature) || strcmp(img->url, url)) continue;
+		/*resource has changed*/
+		if ((img->au_size != au_size) || (img->au_signature != au_signature)) {
+			img = NULL;
+			break;
+		}
+		if (i>1) {
+			gf_list_rem(ic->images, i-1);
+			gf_list_insert(ic->images, img, 0);
+		}
+		img->nb_refs++;
+		break;
+	}
+	gf_mx_v(ic->mx);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_MEDIA, ("[Terminal] Image cache %s for %s\n", img ? "hit" : "miss", url));
+	return img;
+}
+
+void gf_term_image_cache_release(GF_Terminal *term, GF_CachedImage *img)
+{
+	GF_ImageCache *ic = term->image_cache;
+	if (!img) return;
+	if (ic) gf_mx_p(ic->mx);
+	assert(img->nb_refs);
+	img->nb_refs--;
+	if (!img->nb_refs && img->removed) image_cache_free(img);
+	if (ic) gf_mx_v(ic->mx);
+}
+
+void gf_term_image_cache_add(GF_Terminal *term, const char *url, u32 ESID, u64 config_signature, u32 au_size, u64 au_signature, 
+							 char *data, u32 size, u32 width, u32 height, u32 stride, u32 pixel_format, u32 pixel_ar)
+{
+	u32 i;
+	GF_CachedImage *img;
+	GF_ImageCache *ic = term->image_cache;
+	if (!ic || !url || !size || (size > ic->max_size)) return;
+
+	gf_mx_p(ic->mx);
+	/*only one image per resource*/
+	i=0;
+	while ((img = (GF_CachedImage *)gf_list_enum(ic->images, &i))) {
+		if ((img->ESID != ESID) || (img->config_signature != config_signature) || strcmp(img->url, url)) continue;
+		/*already there*/
+		if ((img->au_size == au_size) && (img->au_signature == au_signature)) {
+			gf_mx_v(ic->mx);
+			return;
+		}
+		image_cache_remove(ic, img);
+		break;
+	}
+	image_cache_purge(ic, size);
+	if (ic->size + size > ic->max_size) {
+		gf_mx_v(ic->mx);
+		return;
+	}
+
+	GF_SAFEALLOC(img, GF_CachedImage);
+	if (img) img->data = (char*)gf_malloc(sizeof(char)*size);
+	if (!img || !img->data) {
+		if (img) gf_free(img);
+		gf_mx_v(ic->mx);
+		return;
+	}
+	memcpy(img->data, data, size);
+	img->size = size;
+	img->url = gf_strdup(url);
+	img->ESID = ESID;
+	img->config_signature = config_signature;
+	img->au_size = au_size;
+	img->au_signature = au_signature;
+	img->width = width;
+	img->height = height;
+	img->stride = stride;
+	img->pixel_format = pixel_format;
+	img->pixel_ar = pixel_ar;
+	gf_list_insert(ic->images, img, 0);
+	ic->size += size;
+	gf_mx_v(ic->mx);
+}
@@ -125,6 +125,12 @@ struct _composition_memory
 
 	/*trick for temporal scalability: this is the last rendered CTS*/
 	u32 LastRenderedTS;
+
+	/*spare unit for images (Capacity==1): the next image is decoded in it while the current one is displayed,
+	and swapped with the output when due. ahead_size is the allocated size of the spare unit, ahead_unit_size
+	the new unit size to use once swapped (0 if unchanged)*/
+	GF_CMUnit *ahead;
+	u32 ahead_size, ahead_unit_size;
 };
 
 /*a composition buffer only has fixed-size unit*/
@@ -154,6 +160,18 @@ void gf_cm_reset(GF_CompositionMemory *cb);
 /*resize the buffers*/
 void gf_cm_resize(GF_CompositionMemory *cb, u32 newCapacity);
 
+/*locks the spare unit of an image CB for decoding the image of given TS ahead of time - size is the minimal
+size needed, the unit size of the CB is used if smaller. Returns NULL if no memory or if the spare unit is in use*/
+GF_CMUnit *gf_cm_lock_ahead(GF_CompositionMemory *cb, u32 TS, u32 size);
+/*marks the spare unit as holding an image. If cu_size is 0, nothing is dispatched. unit_size is the unit size
+the decoder was called with*/
+void gf_cm_unlock_ahead(GF_CompositionMemory *cb, GF_CMUnit *cu, u32 cu_size, u32 unit_size);
+/*returns 1 if the spare unit holds an image*/
+Bool gf_cm_has_ahead(GF_CompositionMemory *cb);
+/*swaps the spare unit with the output if the image is due at obj_time (or if the CB is empty). Returns 1 if
+dispatched, 0 if the image is not yet due*/
+Bool gf_cm_dispatch_ahead(GF_CompositionMemory *cb, u32 obj_time);
+
 /*set the status of the buffer. Buffering is done automatically*/
 void gf_cm_set_status(GF_CompositionMemory *cb, u32 Status);
 
@@ -166,6 +184,49 @@ Bool gf_cm_is_eos(GF_CompositionMemory *cb);
 /*aborts buffering if any*/
 void gf_cm_abort_buffering(GF_CompositionMemory *cb);
 
+
+/*decoded image shared by all image objects using the same resource, so that images are not decoded again
+when reloading or switching scenes*/
+typedef struct _cached_image
+{
+	/*resource URL, ES ID and signature of the decoder config*/
+	char *url;
+	u32 ESID;
+	u64 config_signature;
+	/*size and signature of the AU the image was decoded from*/
+	u32 au_size;
+	u64 au_signature;
+
+	/*decoded image and its properties*/
+	char *data;
+	u32 size;
+	u32 width, height, stride, pixel_format, pixel_ar;
+
+	/*number of codecs using the image - an image is only destroyed when no longer used*/
+	u32 nb_refs;
+	/*set when the image is no longer in the cache but still used*/
+	Bool removed;
+} GF_CachedImage;
+
+struct _image_cache
+{
+	/*cached images, most recently used first*/
+	GF_List *images;
+	/*memory used by the images and memory budget in bytes*/
+	u32 size, max_size;
+	GF_Mutex *mx;
+};
+
+/*sets the memory budget of the image cache (0 disables the cache), creating the cache if needed*/
+void gf_term_image_cache_set_size(GF_Terminal *term, u32 max_size);
+void gf_term_image_cache_del(GF_Terminal *term);
+/*returns the image decoded from the given AU of the resource, or NULL. The image shall be released once no longer used*/
+GF_CachedImage *gf_term_image_cache_get(GF_Terminal *term, const char *url, u32 ESID, u64 config_signature, u32 au_size, u64 au_signature);
+void gf_term_image_cache_release(GF_Terminal *term, GF_CachedImage *img);
+/*stores a copy of a decoded image, replacing the image previously decoded for the resource*/
+void gf_term_image_cache_add(GF_Terminal *term, const char *url, u32 ESID, u64 config_signature, u32 au_size, u64 au_signature, 
+							 char *data, u32 size, u32 width, u32 height, u32 stride, u32 pixel_format, u32 pixel_ar);
+
 #ifdef __cplusplus
 }
 #endif
@@ -352,6 +352,10 @@ static void gf_term_reload_cfg(GF_Terminal *term)
 	sOpt = gf_cfg_get_key(term->user->config, "Network", "DataTimeout");
 	if (sOpt) term->net_data_timeout = atoi(sOpt);
 
+	/*decoded images are kept for other scenes and reloads, size in kilobytes*/
+	sOpt = gf_cfg_get_key(term->user->config, "Systems", "ImageCacheSize");
+	gf_term_image_cache_set_size(term, 1024 * (sOpt ? atoi(sOpt) : 8192));
+
 	if (term->root_scene) gf_scene_set_duration(term->root_scene);
 
 #ifndef GPAC_DISABLE_SVG
@@ -707,6 +711,7 @@ GF_Err gf_term_del(GF_Terminal * term)
 
 	/*stop the media manager */
 	gf_term_stop_scheduler(term);
+	gf_term_image_cache_del(term);
 
 	/*remove all event filters*/
 	gf_list_reset(term->event_filters);
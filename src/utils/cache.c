@@ -66,6 +66,7 @@ enum CacheValid
 struct __CacheReaderStruct {
 	FILE * readPtr;
 	s64 readPosition;
+	DownloadedCacheEntry entry;
 };
 
 typedef struct __DownloadedRangeStruc {
@@ -157,6 +158,29 @@ struct __DownloadedCacheEntryStruct
 	/*start and end range of the cache*/
 	u64 range_start, range_end;
 
+	/**
+	* Set for entries kept in memory, in which case no file is written until gf_cache_entry_persist is called
+	*/
+	Bool mem_storage;
+	/**
+	* Memory storage of the entry
+	*/
+	char * mem_data;
+	u32 mem_size, mem_alloc;
+	/**
+	* Protects the memory storage, since the data may be read or persisted while being downloaded
+	*/
+	GF_Mutex * mem_mx;
+	/**
+	* Set for cacheable resources, which are written to their cache file when evicted from memory
+	*/
+	Bool mem_write_back;
+	/**
+	* Links and accounted size of the entry in the memory cache LRU list of the downloader
+	*/
+	DownloadedCacheEntry lru_prev, lru_next;
+	u32 lru_size;
+	Bool in_lru;
 };
 
 Bool delete_cache_files(void *cbck, char *item_name, char *item_path) {
@@ -363,7 +387,7 @@ static const char * default_cache_file_suffix = ".dat";
 
 static const char * cache_file_info_suffix = ".txt";
 
-DownloadedCacheEntry gf_cache_create_entry ( GF_DownloadManager * dm, const char * cache_directory, const char * url , u64 start_range, u64 end_range)
+DownloadedCacheEntry gf_cache_create_entry ( GF_DownloadManager * dm, const char * cache_directory, const char * url , u64 start_range, u64 end_range, Bool mem_storage)
 {
 	char tmp[_CACHE_TMP_SIZE];
 	u8 hash[_CACHE_HASH_SIZE];
@@ -477,6 +501,12 @@ DownloadedCacheEntry gf_cache_create_entry ( GF_DownloadManager * dm, const char
 	strcat( tmp, entry->hash );
 	strcat( tmp , ext);
 	strcat ( tmp, cache_file_info_suffix );
+	if (mem_storage) {
+		/*no properties file until the entry is persisted*/
+		entry->mem_storage = 1;
+		entry->mem_mx = gf_mx_new("CacheEntryMemory");
+		return entry;
+	}
 	entry->properties = gf_cfg_force_new ( cache_directory, tmp );
 	if ( !entry->properties )
 	{
@@ -521,7 +551,17 @@ GF_Err gf_cache_close_write_cache( const DownloadedCacheEntry entry, const GF_Do
 	if (!sess || !entry->write_session || entry->write_session != sess)
 		return GF_OK;
 	assert( sess == entry->write_session );
-	if (entry->writeFilePtr) {
+	if (entry->mem_mx) gf_mx_p(entry->mem_mx);
+	if (entry->mem_storage) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK,
+			("[CACHE] Closing memory cache of %s, %d bytes written.\n", entry->url, entry->written_in_cache));
+		entry->cacheSize = entry->mem_size;
+		if (success) {
+			gf_cache_set_last_modified_on_disk( entry, gf_cache_get_last_modified_on_server(entry));
+			gf_cache_set_etag_on_disk( entry, gf_cache_get_etag_on_server(entry));
+		}
+	}
+	else if (entry->writeFilePtr) {
 		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK,
 			("[CACHE] Closing file %s, %d bytes written.\n", entry->cache_filename, entry->written_in_cache));
 		if (fflush( entry->writeFilePtr ) || fclose( entry->writeFilePtr ))
@@ -542,6 +582,7 @@ GF_Err gf_cache_close_write_cache( const DownloadedCacheEntry entry, const GF_Do
 		}
 	}
 	entry->write_session = NULL;
+	if (entry->mem_mx) gf_mx_v(entry->mem_mx);
 #ifdef ENABLE_WRITE_MX
 	gf_mx_v(entry->write_mutex);
 #endif
@@ -558,6 +599,13 @@ GF_Err gf_cache_open_write_cache( const DownloadedCacheEntry entry, const GF_Dow
 	gf_mx_p(entry->write_mutex);
 #endif
 	entry->write_session = sess;
+	entry->written_in_cache = 0;
+	if (entry->mem_storage) {
+		gf_mx_p(entry->mem_mx);
+		entry->mem_size = 0;
+		gf_mx_v(entry->mem_mx);
+		return GF_OK;
+	}
 	assert( ! entry->writeFilePtr);
 	GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK,
 		("[CACHE] Opening cache file %s for write (%s)...\n", entry->cache_filename, entry->url));
@@ -579,6 +627,31 @@ GF_Err gf_cache_write_to_cache( const DownloadedCacheEntry entry, const GF_Downl
 	u32 readen;
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[CACHE] gf_cache_write_to_cache:%d\n", __LINE__));
 	CHECK_ENTRY;
+	if (entry->mem_mx && data && (sess == entry->write_session)) {
+		gf_mx_p(entry->mem_mx);
+		if (entry->mem_storage) {
+			if (entry->mem_size + size > entry->mem_alloc) {
+				u32 new_alloc = entry->mem_alloc ? entry->mem_alloc : 4096;
+				while (new_alloc < entry->mem_size + size) new_alloc *= 2;
+				if (entry->contentLength && (new_alloc > entry->contentLength) && (entry->mem_size + size <= entry->contentLength))
+					new_alloc = entry->contentLength;
+				entry->mem_data = gf_realloc(entry->mem_data, sizeof(char) * new_alloc);
+				if (!entry->mem_data) {
+					entry->mem_size = entry->mem_alloc = 0;
+					gf_mx_v(entry->mem_mx);
+					return GF_OUT_OF_MEM;
+				}
+				entry->mem_alloc = new_alloc;
+			}
+			memcpy(entry->mem_data + entry->mem_size, data, sizeof(char) * size);
+			entry->mem_size += size;
+			entry->written_in_cache += size;
+			gf_mx_v(entry->mem_mx);
+			return GF_OK;
+		}
+		/*entry has been persisted, go on in the cache file*/
+		gf_mx_v(entry->mem_mx);
+	}
 	if (!data || !entry->writeFilePtr || sess != entry->write_session) {
 		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("Incorrect parameter : data=%p, entry->writeFilePtr=%p at "__FILE__, data, entry->writeFilePtr));
 		return GF_BAD_PARAM;
@@ -611,8 +684,12 @@ GF_CacheReader gf_cache_reader_new(const DownloadedCacheEntry entry) {
 	reader = gf_malloc(sizeof(struct __CacheReaderStruct));
 	if (reader == NULL)
 		return NULL;
-	reader->readPtr = gf_f64_open( entry->cache_filename, "rb" );
+	reader->entry = entry;
 	reader->readPosition = 0;
+	reader->readPtr = NULL;
+	if (entry->mem_storage)
+		return reader;
+	reader->readPtr = gf_f64_open( entry->cache_filename, "rb" );
 	if (!reader->readPtr) {
 		gf_cache_reader_del(reader);
 		return NULL;
@@ -627,13 +704,20 @@ GF_Err gf_cache_reader_del( GF_CacheReader handle ) {
 		fclose(handle->readPtr);
 	handle->readPtr = NULL;
 	handle->readPosition = -1;
+	gf_free(handle);
 	return GF_OK;
 }
 
 s64 gf_cache_reader_seek_at( GF_CacheReader reader, u64 seekPosition) {
 	if (!reader)
 		return -1;
-	reader->readPosition = gf_f64_seek(reader->readPtr, seekPosition, SEEK_SET);
+	if (!reader->readPtr) {
+		reader->readPosition = seekPosition;
+		return reader->readPosition;
+	}
+	if (gf_f64_seek(reader->readPtr, seekPosition, SEEK_SET))
+		return -1;
+	reader->readPosition = seekPosition;
 	return reader->readPosition;
 }
 
@@ -649,7 +733,28 @@ s64 gf_cache_reader_full_size( GF_CacheReader reader );
 
 s32 gf_cache_reader_read( GF_CacheReader reader, char * buff, s32 length) {
 	s32 readen;
-	if (!reader || !buff || length < 0 || !reader->readPtr)
+	if (!reader || !buff || length < 0)
+		return -1;
+	if (!reader->readPtr && reader->entry && reader->entry->mem_mx) {
+		DownloadedCacheEntry entry = reader->entry;
+		gf_mx_p(entry->mem_mx);
+		if (entry->mem_storage) {
+			readen = 0;
+			if (reader->readPosition < entry->mem_size) {
+				readen = (s32) (entry->mem_size - reader->readPosition);
+				if (readen > length) readen = length;
+				memcpy(buff, entry->mem_data + reader->readPosition, sizeof(char) * readen);
+				reader->readPosition += readen;
+			}
+			gf_mx_v(entry->mem_mx);
+			return readen;
+		}
+		gf_mx_v(entry->mem_mx);
+		/*entry has been persisted since the reader was created*/
+		reader->readPtr = gf_f64_open( entry->cache_filename, "rb" );
+		if (reader->readPtr) gf_f64_seek(reader->readPtr, reader->readPosition, SEEK_SET);
+	}
+	if (!reader->readPtr)
 		return -1;
 	readen = fread(buff, sizeof(char), length, reader->readPtr);
 	if (readen > 0)
@@ -672,7 +777,8 @@ GF_Err gf_cache_delete_entry ( const DownloadedCacheEntry entry )
 		gf_mx_del(entry->write_mutex);
 	}
 #endif
-	if (entry->deletableFilesOnDelete) {
+	/*memory entries have no file*/
+	if (entry->deletableFilesOnDelete && !entry->mem_storage) {
 		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[CACHE] url %s cleanup, deleting %s...\n", entry->url, entry->cache_filename));
 		if (GF_OK != gf_delete_file(entry->cache_filename))
 			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[CACHE] gf_cache_delete_entry:%d, failed to delete file %s\n", __LINE__, entry->cache_filename));
@@ -680,6 +786,12 @@ GF_Err gf_cache_delete_entry ( const DownloadedCacheEntry entry )
 #ifdef ENABLE_WRITE_MX
 	entry->write_mutex = NULL;
 #endif
+	if (entry->mem_data)
+		gf_free(entry->mem_data);
+	entry->mem_data = NULL;
+	if (entry->mem_mx)
+		gf_mx_del(entry->mem_mx);
+	entry->mem_mx = NULL;
 	entry->write_session = NULL;
 	entry->writeFilePtr = NULL;
 	if (entry->serverETag)
@@ -745,7 +857,12 @@ GF_Err gf_cache_delete_entry ( const DownloadedCacheEntry entry )
 
 Bool gf_cache_check_if_cache_file_is_corrupted(const DownloadedCacheEntry entry) {
 
-	FILE *the_cache = gf_f64_open ( entry->cache_filename, "rb" );
+	FILE *the_cache;
+	/*memory entries are valid once fully downloaded*/
+	if (entry->mem_storage)
+		return (!entry->cacheSize || (entry->cacheSize != entry->contentLength)) ? 1 : 0;
+
+	the_cache = gf_f64_open ( entry->cache_filename, "rb" );
 	if ( the_cache )
 	{
 		char * endPtr;
@@ -828,6 +945,103 @@ s32 gf_cache_add_session_to_cache_entry(DownloadedCacheEntry entry, GF_DownloadS
 	return count + 1;
 }
 
+Bool gf_cache_entry_is_in_memory(const DownloadedCacheEntry entry)
+{
+	return entry ? entry->mem_storage : 0;
+}
+
+u32 gf_cache_get_memory_size(const DownloadedCacheEntry entry)
+{
+	return (entry && entry->mem_storage) ? entry->mem_alloc : 0;
+}
+
+GF_Err gf_cache_entry_persist(const DownloadedCacheEntry entry)
+{
+	FILE *f;
+	char *propfile;
+	CHECK_ENTRY;
+	if (!entry->mem_storage)
+		return GF_OK;
+	gf_mx_p(entry->mem_mx);
+	f = gf_f64_open(entry->cache_filename, "wb");
+	if (!f) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[CACHE] Error while opening cache file %s for writting.\n", entry->cache_filename));
+		gf_mx_v(entry->mem_mx);
+		return GF_IO_ERR;
+	}
+	if (entry->mem_size && (gf_fwrite(entry->mem_data, sizeof(char), entry->mem_size, f) != entry->mem_size)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[CACHE] Error while writting memory cache to %s.\n", entry->cache_filename));
+		fclose(f);
+		gf_delete_file(entry->cache_filename);
+		gf_mx_v(entry->mem_mx);
+		return GF_IO_ERR;
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[CACHE] url %s moved from memory to %s (%d bytes)\n", entry->url, entry->cache_filename, entry->mem_size));
+
+	propfile = gf_malloc(sizeof(char) * (strlen(entry->cache_filename) + strlen(cache_file_info_suffix) + 1));
+	strcpy(propfile, entry->cache_filename);
+	strcat(propfile, cache_file_info_suffix);
+	entry->properties = gf_cfg_force_new(NULL, propfile);
+	gf_free(propfile);
+
+	gf_free(entry->mem_data);
+	entry->mem_data = NULL;
+	entry->mem_size = entry->mem_alloc = 0;
+	entry->mem_storage = 0;
+	/*an ongoing download goes on in the cache file*/
+	if (entry->write_session) {
+		entry->writeFilePtr = f;
+	} else {
+		fclose(f);
+		gf_cache_flush_disk_cache(entry);
+	}
+	gf_mx_v(entry->mem_mx);
+	return GF_OK;
+}
+
+void gf_cache_entry_set_write_back(const DownloadedCacheEntry entry)
+{
+	if (entry && entry->mem_storage) entry->mem_write_back = 1;
+}
+
+Bool gf_cache_entry_is_write_back(const DownloadedCacheEntry entry)
+{
+	return (entry && entry->mem_storage) ? entry->mem_write_back : 0;
+}
+
+void gf_cache_lru_remove(DownloadedCacheEntry *first, DownloadedCacheEntry *last, u32 *total_size, const DownloadedCacheEntry entry)
+{
+	if (!entry || !entry->in_lru) return;
+	if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+	else *first = entry->lru_next;
+	if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+	else *last = entry->lru_prev;
+	entry->lru_prev = entry->lru_next = NULL;
+	*total_size -= entry->lru_size;
+	entry->lru_size = 0;
+	entry->in_lru = 0;
+}
+
+void gf_cache_lru_append(DownloadedCacheEntry *first, DownloadedCacheEntry *last, u32 *total_size, const DownloadedCacheEntry entry)
+{
+	if (!entry || entry->in_lru || !entry->mem_storage) return;
+	entry->lru_prev = *last;
+	entry->lru_next = NULL;
+	if (*last) (*last)->lru_next = entry;
+	else *first = entry;
+	*last = entry;
+	gf_mx_p(entry->mem_mx);
+	entry->lru_size = entry->mem_alloc;
+	gf_mx_v(entry->mem_mx);
+	*total_size += entry->lru_size;
+	entry->in_lru = 1;
+}
+
+DownloadedCacheEntry gf_cache_lru_get_next(const DownloadedCacheEntry entry)
+{
+	return entry ? entry->lru_next : NULL;
+}
+
 FILE *gf_cache_get_file_pointer(const DownloadedCacheEntry entry) 
 {
 	if (entry) return entry->writeFilePtr;
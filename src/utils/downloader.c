@@ -45,6 +45,13 @@
 #include <unistd.h>
 #endif
 
+#if defined(__linux__)
+#define GPAC_DM_HAS_EPOLL
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
 #define SIZE_IN_STREAM ( 2 << 29 )
 
 
@@ -54,6 +61,16 @@
 #define GF_DOWNLOAD_BUFFER_SIZE		8192
 #define GF_WAIT_REPLY_SLEEP	20
 
+/*event loop mode: sessions without known content length are processed at this interval regardless of socket events,
+to detect the end of the transfer*/
+#define GF_DM_IO_SWEEP_MS		500
+/*event loop mode: rate-limited sessions and platforms without epoll are polled at this interval*/
+#define GF_DM_IO_POLL_MS		10
+#define GF_DM_IO_MAX_EVENTS		64
+
+/*number of buckets of the cache entry index, must be a power of 2*/
+#define GF_DM_CACHE_INDEX_SIZE	256
+
 
 static void gf_dm_connect(GF_DownloadSession *sess);
 
@@ -88,6 +105,38 @@ typedef struct __partialDownloadStruct {
     char * filename;
 } GF_PartialDownload ;
 
+/*I/O thread driving several threaded sessions from a single event loop*/
+typedef struct __gf_dm_io_thread
+{
+    struct __gf_download_manager *dm;
+    GF_Thread *th;
+    GF_Mutex *mx;
+    /*sessions handled by this thread*/
+    GF_List *sessions;
+    Bool run;
+    u32 last_sweep;
+    /*last session ID given, IDs are used in the event loop rather than session pointers which may be reused*/
+    u32 last_io_id;
+#ifdef GPAC_DM_HAS_EPOLL
+    int epoll_fd;
+    /*wakes up the loop when a session is added or the thread is stopped*/
+    int wake_fd[2];
+#endif
+} GF_DownloadIOThread;
+
+/*idle kept-alive connection, reusable by any session to the same server*/
+typedef struct
+{
+    char *server_name;
+    u16 port;
+    Bool use_ssl;
+    GF_Socket *sock;
+#ifdef GPAC_HAS_SSL
+    SSL *ssl;
+#endif
+    u32 idle_since;
+} GF_DMPooledConnection;
+
 struct __gf_download_session
 {
     /*this is always 0 and helps differenciating downloads from other interfaces (interfaceType != 0)*/
@@ -96,6 +145,13 @@ struct __gf_download_session
     struct __gf_download_manager *dm;
     GF_Thread *th;
     GF_Mutex *mx;
+    /*I/O thread driving the session in event loop mode*/
+    struct __gf_dm_io_thread *io;
+    /*socket handle registered in the I/O thread event loop, -1 if none*/
+    s32 io_fd;
+    /*ID of the session in the I/O thread*/
+    u32 io_id;
+    Bool io_ready, io_throttled, connect_pending;
 
     Bool in_callback, destroy;
     u32 proxy_enabled;
@@ -140,6 +196,19 @@ struct __gf_download_session
 #ifdef GPAC_HAS_SSL
     SSL *ssl;
 #endif
+    /*connection taken from the connection pool, not yet validated by a reply*/
+    Bool conn_reused;
+    /*the reply has been fully received, the connection can be reused*/
+    Bool reply_done;
+    /*the server closes the connection after the reply*/
+    Bool server_close;
+    /*a byte-range request for pipe_url has been pipelined on the connection*/
+    Bool pipe_pending, pipelining;
+    char *pipe_url;
+    u64 pipe_start, pipe_end;
+    /*data received past the end of the current reply, belonging to the pipelined reply*/
+    char *pipe_data;
+    u32 pipe_data_size;
 
     void (*do_requests)(struct __gf_download_session *);
 
@@ -169,8 +238,23 @@ struct __gf_download_manager
     GF_List *skip_proxy_servers;
     GF_List *credentials;
     GF_List *cache_entries;
+    /*hash index of cache_entries on URL and byte range*/
+    GF_List *cache_index[GF_DM_CACHE_INDEX_SIZE];
+    /*LRU list of the cache entries kept in memory, least recently used first, and their accounted size in bytes*/
+    DownloadedCacheEntry mem_cache_first, mem_cache_last;
+    u32 mem_cache_size;
+    /*memory cache budget in bytes, 0 if memory cache is disabled*/
+    u32 mem_cache_max_size;
     /* FIXME : should be placed in DownloadedCacheEntry maybe... */
     GF_List * partial_downloads;
+    /*event loop I/O threads, empty if each threaded session runs its own thread*/
+    GF_List *io_threads;
+    /*idle connections, most recently used last*/
+    GF_List *conn_pool;
+    GF_Mutex *pool_mx;
+    /*max number of idle connections (0 disables the pool) and idle timeout in ms*/
+    u32 pool_max_size, pool_timeout;
+    u32 pool_hits, pool_misses, pool_pipelined;
 #ifdef GPAC_HAS_SSL
     SSL_CTX *ssl_ctx;
 #endif
@@ -439,31 +523,132 @@ static Bool gf_dm_can_handle_url(GF_DownloadManager *dm, const char *url)
     return 0;
 }
 
+/*!
+ * Memory cache LRU list handling, implemented in cache.c. The list and its total size are owned by the
+ * download manager and only modified while holding its cache mutex. The accounted size of an entry is its
+ * memory size when appended to the list.
+ */
+void gf_cache_lru_remove(DownloadedCacheEntry *first, DownloadedCacheEntry *last, u32 *total_size, const DownloadedCacheEntry entry);
+void gf_cache_lru_append(DownloadedCacheEntry *first, DownloadedCacheEntry *last, u32 *total_size, const DownloadedCacheEntry entry);
+DownloadedCacheEntry gf_cache_lru_get_next(const DownloadedCacheEntry entry);
+
+/*!
+ * Marks a memory entry as a cacheable resource, written to its cache file when evicted from memory.
+ * implemented in cache.c
+ */
+void gf_cache_entry_set_write_back(const DownloadedCacheEntry entry);
+Bool gf_cache_entry_is_write_back(const DownloadedCacheEntry entry);
+
+/*sessions created with GF_NETIO_SESSION_NOT_CACHED or GF_NETIO_SESSION_MEMORY_CACHE keep their data in the memory cache*/
+#define GF_DM_SESS_USES_MEM_CACHE(__sess) (__sess->dm->mem_cache_max_size && (__sess->flags & (GF_NETIO_SESSION_NOT_CACHED | GF_NETIO_SESSION_MEMORY_CACHE)))
+
+static u32 gf_dm_cache_index_hash(const char *url, u64 start_range, u64 end_range)
+{
+	u32 hash = 5381;
+	while (*url) {
+		hash = hash*33 + (u8) *url;
+		url++;
+	}
+	hash ^= (u32) start_range * 2654435761U;
+	hash ^= (u32) end_range * 40503;
+	hash ^= hash >> 16;
+	return hash & (GF_DM_CACHE_INDEX_SIZE-1);
+}
+
+/*moves an entry to the most recently used end of the memory cache and updates its accounted size - cache_mx must be held*/
+static void gf_dm_mem_cache_touch(GF_DownloadManager *dm, DownloadedCacheEntry entry)
+{
+	gf_cache_lru_remove(&dm->mem_cache_first, &dm->mem_cache_last, &dm->mem_cache_size, entry);
+	if (gf_cache_entry_is_in_memory(entry))
+		gf_cache_lru_append(&dm->mem_cache_first, &dm->mem_cache_last, &dm->mem_cache_size, entry);
+}
+
+/*adds an entry to the cache - cache_mx must be held*/
+static void gf_dm_cache_add_entry(GF_DownloadManager *dm, DownloadedCacheEntry entry)
+{
+	u32 h = gf_dm_cache_index_hash(gf_cache_get_url(entry), gf_cache_get_start_range(entry), gf_cache_get_end_range(entry));
+	gf_list_add(dm->cache_entries, entry);
+	if (!dm->cache_index[h]) dm->cache_index[h] = gf_list_new();
+	gf_list_add(dm->cache_index[h], entry);
+	gf_dm_mem_cache_touch(dm, entry);
+}
+
+/*removes an entry from the cache without destroying it - cache_mx must be held*/
+static void gf_dm_cache_remove_entry(GF_DownloadManager *dm, DownloadedCacheEntry entry)
+{
+	u32 h = gf_dm_cache_index_hash(gf_cache_get_url(entry), gf_cache_get_start_range(entry), gf_cache_get_end_range(entry));
+	gf_list_del_item(dm->cache_entries, entry);
+	if (dm->cache_index[h]) gf_list_del_item(dm->cache_index[h], entry);
+	gf_cache_lru_remove(&dm->mem_cache_first, &dm->mem_cache_last, &dm->mem_cache_size, entry);
+}
+
+/*looks up an entry in the cache index - cache_mx must be held*/
+static DownloadedCacheEntry gf_dm_cache_find_entry(GF_DownloadManager *dm, const char *url, u64 start_range, u64 end_range)
+{
+	u32 i, count;
+	GF_List *bucket = dm->cache_index[ gf_dm_cache_index_hash(url, start_range, end_range) ];
+	count = bucket ? gf_list_count(bucket) : 0;
+	for (i = 0 ; i < count; i++) {
+		DownloadedCacheEntry e = gf_list_get(bucket, i);
+		assert( gf_cache_get_url(e) );
+		if (strcmp(gf_cache_get_url(e), url)) continue;
+		if (start_range != gf_cache_get_start_range(e)) continue;
+		if (end_range != gf_cache_get_end_range(e)) continue;
+		return e;
+	}
+	return NULL;
+}
+
+/*moves a memory entry to disk - cache_mx must be held*/
+static GF_Err gf_dm_cache_persist_entry(GF_DownloadManager *dm, DownloadedCacheEntry entry)
+{
+	GF_Err e;
+	if (!gf_cache_entry_is_in_memory(entry)) return GF_OK;
+	e = gf_cache_entry_persist(entry);
+	if (e == GF_OK)
+		gf_cache_lru_remove(&dm->mem_cache_first, &dm->mem_cache_last, &dm->mem_cache_size, entry);
+	return e;
+}
+
+/*releases the least recently used memory entries no longer attached to a session, until the memory cache fits its
+budget. Complete cacheable resources are written to their cache file, other entries are destroyed*/
+static void gf_dm_mem_cache_evict(GF_DownloadManager *dm)
+{
+	DownloadedCacheEntry entry, next;
+	gf_mx_p( dm->cache_mx );
+	entry = dm->mem_cache_first;
+	while (entry && (dm->mem_cache_size > dm->mem_cache_max_size)) {
+		next = gf_cache_lru_get_next(entry);
+		if (!gf_cache_get_sessions_count_for_cache_entry(entry)) {
+			if (gf_cache_entry_is_write_back(entry) && !gf_cache_check_if_cache_file_is_corrupted(entry)
+				&& (gf_dm_cache_persist_entry(dm, entry) == GF_OK)) {
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[CACHE] Moved %s from memory cache to disk\n", gf_cache_get_url(entry)));
+			} else {
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[CACHE] Evicting %s from memory cache\n", gf_cache_get_url(entry)));
+				gf_dm_cache_remove_entry(dm, entry);
+				gf_cache_delete_entry(entry);
+			}
+		}
+		entry = next;
+	}
+	gf_mx_v( dm->cache_mx );
+}
+
 /*!
  * Finds an existing entry in the cache for a given URL
  * \param sess The session configured with the URL
  * \return NULL if none found, the DownloadedCacheEntry otherwise
  */
 DownloadedCacheEntry gf_dm_find_cached_entry_by_url(GF_DownloadSession * sess) {
-    u32 i, count;
+    DownloadedCacheEntry e;
     assert( sess && sess->dm && sess->dm->cache_entries );
     gf_mx_p( sess->dm->cache_mx );
-    count = gf_list_count(sess->dm->cache_entries);
-    for (i = 0 ; i < count; i++) {
-        const char * url;
-        DownloadedCacheEntry e = gf_list_get(sess->dm->cache_entries, i);
-        assert(e);
-        url = gf_cache_get_url(e);
-        assert( url );
-        if (strcmp(url, sess->orig_url)) continue;
-		if (sess->range_start != gf_cache_get_start_range(e)) continue;
-		if (sess->range_end != gf_cache_get_end_range(e)) continue;
-		/*OK that's ours*/
-		gf_mx_v( sess->dm->cache_mx );
-		return e;
-    }
+    e = gf_dm_cache_find_entry(sess->dm, sess->orig_url, sess->range_start, sess->range_end);
+    /*move it to the most recently used end of the memory cache*/
+    if (e && gf_cache_entry_is_in_memory(e))
+        gf_dm_mem_cache_touch(sess->dm, e);
     gf_mx_v( sess->dm->cache_mx );
-    return NULL;
+    return e;
 }
 
 /**
@@ -472,7 +657,7 @@ DownloadedCacheEntry gf_dm_find_cached_entry_by_url(GF_DownloadSession * sess) {
  * \param url The full URL
  * \return The DownloadedCacheEntry
  */
-DownloadedCacheEntry gf_cache_create_entry( GF_DownloadManager * dm, const char * cache_directory, const char * url, u64 start_range, u64 end_range);
+DownloadedCacheEntry gf_cache_create_entry( GF_DownloadManager * dm, const char * cache_directory, const char * url, u64 start_range, u64 end_range, Bool mem_storage);
 
 /*!
  * Removes a session for a DownloadedCacheEntry
@@ -497,19 +682,23 @@ void gf_dm_remove_cache_entry_from_session(GF_DownloadSession * sess) {
 
 			&& (0 == gf_cache_get_sessions_count_for_cache_entry(sess->cache_entry)))
         {
-            u32 i, count;
             gf_mx_p( sess->dm->cache_mx );
-            count = gf_list_count( sess->dm->cache_entries );
-            for (i = 0; i < count; i++) {
-                DownloadedCacheEntry ex = gf_list_get(sess->dm->cache_entries, i);
-                if (ex == sess->cache_entry) {
-                    gf_list_rem(sess->dm->cache_entries, i);
-                    gf_cache_delete_entry( sess->cache_entry );
-                    break;
-                }
+            if (gf_list_find(sess->dm->cache_entries, sess->cache_entry) >= 0) {
+                gf_dm_cache_remove_entry(sess->dm, sess->cache_entry);
+                gf_cache_delete_entry( sess->cache_entry );
             }
             gf_mx_v( sess->dm->cache_mx );
         }
+        else if (sess->dm && gf_cache_entry_is_in_memory(sess->cache_entry)
+                 && (0 == gf_cache_get_sessions_count_for_cache_entry(sess->cache_entry)))
+        {
+            /*the entry is no longer used, account its final size and make room in the memory cache*/
+            gf_mx_p( sess->dm->cache_mx );
+            if (gf_list_find(sess->dm->cache_entries, sess->cache_entry) >= 0)
+                gf_dm_mem_cache_touch(sess->dm, sess->cache_entry);
+            gf_mx_v( sess->dm->cache_mx );
+            gf_dm_mem_cache_evict(sess->dm);
+        }
     }
 }
 
@@ -528,12 +717,18 @@ void gf_dm_configure_cache(GF_DownloadSession *sess)
     GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[Downloader] gf_dm_configure_cache(%p), cached=%s\n", sess, sess->flags & GF_NETIO_SESSION_NOT_CACHED ? "no" : "yes" ));
     gf_dm_remove_cache_entry_from_session(sess);
     entry = gf_dm_find_cached_entry_by_url(sess);
+    gf_mx_p( sess->dm->cache_mx );
     if (!entry) {
-		entry = gf_cache_create_entry(sess->dm, sess->dm->cache_directory, sess->orig_url, sess->range_start, sess->range_end);
-        gf_mx_p( sess->dm->cache_mx );
-        gf_list_add(sess->dm->cache_entries, entry);
-        gf_mx_v( sess->dm->cache_mx );
-    }
+		entry = gf_cache_create_entry(sess->dm, sess->dm->cache_directory, sess->orig_url, sess->range_start, sess->range_end, GF_DM_SESS_USES_MEM_CACHE(sess) ? 1 : 0);
+        gf_dm_cache_add_entry(sess->dm, entry);
+    } else if (gf_cache_entry_is_in_memory(entry) && !GF_DM_SESS_USES_MEM_CACHE(sess)) {
+		/*the session reads its data from the cache file*/
+		gf_dm_cache_persist_entry(sess->dm, entry);
+    }
+    /*cacheable resources kept in memory go to disk when evicted*/
+    if (!(sess->flags & GF_NETIO_SESSION_NOT_CACHED))
+        gf_cache_entry_set_write_back(entry);
+    gf_mx_v( sess->dm->cache_mx );
     assert( entry );
     sess->cache_entry = entry;
     gf_cache_add_session_to_cache_entry(sess->cache_entry, sess);
@@ -571,7 +766,7 @@ void gf_dm_delete_cached_file_entry(const GF_DownloadManager * dm,  const char *
             gf_cache_entry_set_delete_files_when_deleted(e);
             if (0 == gf_cache_get_sessions_count_for_cache_entry( e )) {
                 /* No session attached anymore... we can delete it */
-                gf_list_rem(dm->cache_entries, i);
+                gf_dm_cache_remove_entry((GF_DownloadManager *) dm, e);
                 gf_cache_delete_entry(e);
             }
             /* If deleted or not, we don't search further */
@@ -594,6 +789,172 @@ void gf_dm_delete_cached_file_entry_session(const GF_DownloadSession * sess,  co
     }
 }
 
+GF_EXPORT
+GF_Err gf_dm_persist_cached_file_entry_session(const GF_DownloadSession * sess, const char * url, u64 start_range, u64 end_range)
+{
+    GF_Err e;
+    GF_URL_Info info;
+    DownloadedCacheEntry entry;
+    if (!sess || !sess->dm || !url)
+        return GF_BAD_PARAM;
+    gf_dm_url_info_init(&info);
+    e = gf_dm_get_url_info(url, &info, NULL);
+    if (e != GF_OK) {
+        gf_dm_url_info_del(&info);
+        return e;
+    }
+    gf_mx_p( sess->dm->cache_mx );
+    entry = gf_dm_cache_find_entry(sess->dm, info.canonicalRepresentation, start_range, end_range);
+    e = entry ? gf_dm_cache_persist_entry(sess->dm, entry) : GF_URL_ERROR;
+    gf_mx_v( sess->dm->cache_mx );
+    if (!entry)
+        GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[CACHE] Cannot find URL %s, cache file won't be written.\n", info.canonicalRepresentation));
+    gf_dm_url_info_del(&info);
+    return e;
+}
+
+
+static void gf_dm_io_update_events(GF_DownloadIOThread *io, GF_DownloadSession *sess, Bool detach);
+void http_do_requests(GF_DownloadSession *sess);
+static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP);
+
+static void gf_dm_pool_del_connection(GF_DMPooledConnection *pc)
+{
+#ifdef GPAC_HAS_SSL
+    if (pc->ssl) {
+        SSL_shutdown(pc->ssl);
+        SSL_free(pc->ssl);
+    }
+#endif
+    gf_sk_del(pc->sock);
+    gf_free(pc->server_name);
+    gf_free(pc);
+}
+
+/*moves the session connection to server_name:port to the pool if the reply has been fully received and the server keeps the connection open*/
+static Bool gf_dm_pool_put(GF_DownloadSession *sess, const char *server_name, u16 port, Bool use_ssl)
+{
+    GF_DMPooledConnection *pc;
+    GF_DownloadManager *dm = sess->dm;
+    if (!dm || !dm->pool_max_size || !sess->sock || !server_name) return 0;
+    if (!sess->reply_done || sess->server_close || sess->pipe_pending || sess->pipe_data_size || sess->connect_pending) return 0;
+
+    /*stop monitoring the socket in the event loop of the session*/
+    if (sess->io) gf_dm_io_update_events(sess->io, sess, 1);
+
+    GF_SAFEALLOC(pc, GF_DMPooledConnection);
+    if (!pc) return 0;
+    pc->server_name = gf_strdup(server_name);
+    pc->port = port;
+    pc->use_ssl = use_ssl;
+    pc->sock = sess->sock;
+#ifdef GPAC_HAS_SSL
+    pc->ssl = sess->ssl;
+    sess->ssl = NULL;
+#endif
+    pc->idle_since = gf_sys_clock();
+    sess->sock = NULL;
+
+    gf_mx_p(dm->pool_mx);
+    gf_list_add(dm->conn_pool, pc);
+    /*drop the oldest idle connection*/
+    if (gf_list_count(dm->conn_pool) > dm->pool_max_size) {
+        GF_DMPooledConnection *old = gf_list_get(dm->conn_pool, 0);
+        gf_list_rem(dm->conn_pool, 0);
+        gf_dm_pool_del_connection(old);
+    }
+    gf_mx_v(dm->pool_mx);
+    GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[HTTP] Keeping connection to %s:%d for reuse\n", server_name, port));
+    return 1;
+}
+
+/*assigns an idle connection to the same server to the session if any*/
+static Bool gf_dm_pool_get(GF_DownloadSession *sess)
+{
+    u32 i, now;
+    GF_DownloadManager *dm = sess->dm;
+    GF_DMPooledConnection *found = NULL;
+    if (!dm || !dm->pool_max_size || !sess->server_name) return 0;
+
+    now = gf_sys_clock();
+    while (1) {
+        char probe[1];
+        u32 read;
+        GF_Err e;
+        GF_DMPooledConnection *pc = NULL;
+
+        /*take the most recent idle connection to this server out of the pool*/
+        gf_mx_p(dm->pool_mx);
+        i = gf_list_count(dm->conn_pool);
+        while (i) {
+            GF_DMPooledConnection *a_pc = gf_list_get(dm->conn_pool, i-1);
+            i--;
+            if (now - a_pc->idle_since > dm->pool_timeout) {
+                gf_list_rem(dm->conn_pool, i);
+                gf_dm_pool_del_connection(a_pc);
+                continue;
+            }
+            if (a_pc->port != sess->port) continue;
+            if (a_pc->use_ssl != ((sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? 1 : 0)) continue;
+            if (strcmp(a_pc->server_name, sess->server_name)) continue;
+            gf_list_rem(dm->conn_pool, i);
+            pc = a_pc;
+            break;
+        }
+        if (!pc) dm->pool_misses++;
+        gf_mx_v(dm->pool_mx);
+        if (!pc) return 0;
+
+        /*the connection is now owned by this session, probe it without blocking other sessions on the pool.
+        An idle connection shall have nothing to read, otherwise it has been closed by the server. Probing waits a bit,
+        so connections idle for a short time are reused directly - if closed meanwhile, the request is retried on a new one*/
+        e = (now - pc->idle_since > 100) ? gf_sk_receive(pc->sock, probe, 1, 0, &read) : GF_IP_NETWORK_EMPTY;
+        if (e == GF_IP_NETWORK_EMPTY) {
+            found = pc;
+            break;
+        }
+        gf_dm_pool_del_connection(pc);
+    }
+    gf_mx_p(dm->pool_mx);
+    dm->pool_hits++;
+    gf_mx_v(dm->pool_mx);
+
+    GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Reusing connection to %s:%d\n", sess->server_name, sess->port));
+    sess->sock = found->sock;
+#ifdef GPAC_HAS_SSL
+    sess->ssl = found->ssl;
+#endif
+    sess->conn_reused = 1;
+    gf_free(found->server_name);
+    gf_free(found);
+    return 1;
+}
+
+/*closes the session connection, unless it can be kept for reuse*/
+static void gf_dm_close_connection(GF_DownloadSession *sess, Bool force_close)
+{
+    if (!force_close && gf_dm_pool_put(sess, sess->server_name, sess->port, (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? 1 : 0)) return;
+#ifdef GPAC_HAS_SSL
+    if (sess->ssl) {
+        SSL_shutdown(sess->ssl);
+        SSL_free(sess->ssl);
+        sess->ssl = NULL;
+    }
+#endif
+    if (sess->sock) {
+        GF_Socket * sx = sess->sock;
+        sess->sock = NULL;
+        gf_sk_del(sx);
+    }
+    sess->connect_pending = 0;
+    sess->conn_reused = 0;
+    sess->pipe_pending = 0;
+    if (sess->pipe_url) gf_free(sess->pipe_url);
+    sess->pipe_url = NULL;
+    if (sess->pipe_data) gf_free(sess->pipe_data);
+    sess->pipe_data = NULL;
+    sess->pipe_data_size = 0;
+}
 
 static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 {
@@ -605,19 +966,7 @@ static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
         gf_mx_p(sess->mx);
 
 	if (force_close || !(sess->flags & GF_NETIO_SESSION_PERSISTENT)) {
-#ifdef GPAC_HAS_SSL
-		if (sess->ssl) {
-			SSL_shutdown(sess->ssl);
-			SSL_free(sess->ssl);
-			sess->ssl = NULL;
-		}
-#endif
-		if (sess->sock) {
-			GF_Socket * sx = sess->sock;
-			sess->sock = NULL;
-			gf_sk_del(sx);
-			//sess->sock = NULL;
-		}
+		gf_dm_close_connection(sess, force_close);
 	}
     sess->status = GF_NETIO_DISCONNECTED;
     if (sess->num_retry) sess->num_retry--;
@@ -632,7 +981,7 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
     if (!sess)
       return;
     /*self-destruction, let the download manager destroy us*/
-    if (sess->th && sess->in_callback) {
+    if ((sess->th || sess->io) && sess->in_callback) {
         sess->destroy = 1;
         return;
     }
@@ -649,8 +998,26 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
         sess->th = NULL;
         sess->mx = NULL;
     }
+    /*if driven by an I/O thread, detach from its event loop - the socket is closed and no longer monitored*/
+    if (sess->io) {
+        gf_mx_p(sess->io->mx);
+        gf_list_del_item(sess->io->sessions, sess);
+        gf_mx_v(sess->io->mx);
+        sess->io = NULL;
+    }
+    if (sess->mx) {
+        gf_mx_del(sess->mx);
+        sess->mx = NULL;
+    }
+    /*connection kept open after the last reply of a persistent session*/
+    gf_dm_close_connection(sess, 0);
 
-    if (sess->dm) gf_list_del_item(sess->dm->sessions, sess);
+    if (sess->dm) {
+        /*sessions may be destroyed by I/O threads*/
+        gf_mx_p(sess->dm->cache_mx);
+        gf_list_del_item(sess->dm->sessions, sess);
+        gf_mx_v(sess->dm->cache_mx);
+    }
     /*
              TODO: something to clean an cache files ?
     	if (sess->cache_name && !sess->use_cache_extension && !(sess->flags & GF_NETIO_SESSION_KEEP_CACHE) ) {
@@ -678,8 +1045,6 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
     GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[Downloader] gf_dm_sess_del(%p) : DONE\n", sess ));
 }
 
-void http_do_requests(GF_DownloadSession *sess);
-
 static void gf_dm_sess_notify_state(GF_DownloadSession *sess, u32 dnload_status, GF_Err error)
 {
     if (sess->user_proc) {
@@ -887,12 +1252,18 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url)
 	Bool socket_changed = 0;
     GF_Err e;
     GF_URL_Info info;
+    /*server of the current connection*/
+    char *prev_server = NULL;
+    u16 prev_port = sess->port;
+    Bool prev_ssl = (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? 1 : 0;
     gf_dm_url_info_init(&info);
     e = gf_dm_get_url_info(url, &info, sess->remote_path);
 	if (e) return e;
     
 	if (!sess->sock) socket_changed = 1;
 	else if (sess->status>GF_NETIO_DISCONNECTED) socket_changed = 1;
+	/*the previous reply was not fully read or the server is closing the connection*/
+	else if (!sess->reply_done || sess->server_close) socket_changed = 1;
 
 	if (sess->port != info.port) {
 		socket_changed = 1;
@@ -920,7 +1291,7 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url)
 	if (sess->server_name && info.server_name && !strcmp(sess->server_name, info.server_name)) {
 	} else {
 		socket_changed = 1;
-		if (sess->server_name) gf_free(sess->server_name);
+		prev_server = sess->server_name;
 		sess->server_name = info.server_name ? gf_strdup(info.server_name) : NULL;
 	}
 
@@ -951,10 +1322,12 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url)
 		/*this should be done when building HTTP GET request in case we have range directives*/
 		gf_dm_configure_cache(sess);
 	} else {
-		if (sess->sock) gf_sk_del(sess->sock);
-		sess->sock = NULL;
+		/*the connection may still be used by other sessions to the previous server*/
+		if (!sess->sock || !gf_dm_pool_put(sess, prev_server ? prev_server : sess->server_name, prev_port, prev_ssl))
+			gf_dm_close_connection(sess, 1);
 		sess->status = GF_NETIO_SETUP;
 	}
+	if (prev_server) gf_free(prev_server);
     return e;
 }
 
@@ -989,6 +1362,280 @@ static u32 gf_dm_session_thread(void *par)
     return 1;
 }
 
+/*sessions relying on the download timeout rather than socket events to end*/
+static GFINLINE Bool gf_dm_io_needs_sweep(GF_DownloadSession *sess)
+{
+    return ((sess->status == GF_NETIO_DATA_EXCHANGE) && !sess->total_size) ? 1 : 0;
+}
+
+/*sessions which can progress without waiting for socket events*/
+static GFINLINE Bool gf_dm_io_needs_poll(GF_DownloadSession *sess)
+{
+    if (sess->destroy) return 1;
+    if ((sess->status == GF_NETIO_SETUP) && !sess->connect_pending) return 1;
+    if (sess->status == GF_NETIO_CONNECTED) return 1;
+    if (sess->status >= GF_NETIO_DISCONNECTED) return 1;
+    return 0;
+}
+
+/*(re)arms the session socket in the event loop for the event its state is waiting for. A closed socket is removed
+from the epoll set by the system, so stale handles are never unregistered explicitly*/
+static void gf_dm_io_update_events(GF_DownloadIOThread *io, GF_DownloadSession *sess, Bool detach)
+{
+#ifdef GPAC_DM_HAS_EPOLL
+    struct epoll_event ev;
+    s32 fd = sess->sock ? gf_sk_get_handle(sess->sock) : -1;
+
+    memset(&ev, 0, sizeof(struct epoll_event));
+    if (!detach && !sess->io_throttled && (fd>0)) {
+        if (sess->connect_pending) ev.events = EPOLLOUT;
+        else if ((sess->status == GF_NETIO_WAIT_FOR_REPLY) || (sess->status == GF_NETIO_DATA_EXCHANGE)) ev.events = EPOLLIN;
+    }
+    if (!ev.events) {
+        if ((sess->io_fd>=0) && (fd == sess->io_fd)) epoll_ctl(io->epoll_fd, EPOLL_CTL_DEL, fd, &ev);
+        sess->io_fd = -1;
+        return;
+    }
+    ev.data.u64 = sess->io_id;
+    if (epoll_ctl(io->epoll_fd, EPOLL_CTL_MOD, fd, &ev) && epoll_ctl(io->epoll_fd, EPOLL_CTL_ADD, fd, &ev)) {
+        GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[Downloader] Cannot monitor socket for %s, polling session\n", sess->orig_url));
+        sess->io_fd = -1;
+        sess->io_throttled = 1;
+        return;
+    }
+    sess->io_fd = fd;
+#endif
+}
+
+static void gf_dm_io_process_session(GF_DownloadIOThread *io, GF_DownloadSession *sess)
+{
+    Bool destroy;
+    gf_mx_p(sess->mx);
+    if (!sess->destroy && (sess->status < GF_NETIO_DISCONNECTED)) {
+        if (sess->status < GF_NETIO_CONNECTED) {
+            gf_dm_connect(sess);
+        } else {
+            sess->do_requests(sess);
+        }
+        /*data left in the socket while over the rate limit, resume on next poll*/
+        sess->io_throttled = 0;
+        if (io->dm->limit_data_rate && (sess->status == GF_NETIO_DATA_EXCHANGE) && (sess->bytes_per_sec > io->dm->limit_data_rate))
+            sess->io_throttled = 1;
+#ifdef GPAC_HAS_SSL
+        /*decrypted data may be pending while the socket is empty*/
+        if (sess->ssl && SSL_pending(sess->ssl)) sess->io_ready = 1;
+#endif
+    }
+    /*same as the end of a session thread*/
+    destroy = sess->destroy;
+    if (destroy || (sess->status >= GF_NETIO_DISCONNECTED)) {
+        gf_dm_io_update_events(io, sess, 1);
+        gf_list_del_item(io->sessions, sess);
+        gf_dm_disconnect(sess, 0);
+        sess->status = GF_NETIO_STATE_ERROR;
+        sess->last_error = 0;
+        sess->flags |= GF_DOWNLOAD_SESSION_THREAD_DEAD;
+    } else {
+        gf_dm_io_update_events(io, sess, 0);
+    }
+    gf_mx_v(sess->mx);
+
+    /*the session was deleted by the user from one of its callbacks and is now detached, nobody else uses it*/
+    if (destroy) gf_dm_sess_del(sess);
+}
+
+static s32 gf_dm_io_get_timeout(GF_DownloadIOThread *io, u32 now)
+{
+    u32 i, count;
+    s32 timeout;
+#ifndef GPAC_DM_HAS_EPOLL
+    return GF_DM_IO_POLL_MS;
+#endif
+    count = gf_list_count(io->sessions);
+    /*nothing to do, wait for a session to be added*/
+    if (!count) return -1;
+    timeout = GF_DM_IO_SWEEP_MS - (s32) (now - io->last_sweep);
+    if (timeout<0) timeout = 0;
+    for (i=0; i<count; i++) {
+        GF_DownloadSession *sess = gf_list_get(io->sessions, i);
+        if (sess->io_ready || gf_dm_io_needs_poll(sess)) return 0;
+        if (sess->io_throttled && (timeout > GF_DM_IO_POLL_MS)) timeout = GF_DM_IO_POLL_MS;
+    }
+    return timeout;
+}
+
+static u32 gf_dm_io_thread_run(void *par)
+{
+    u32 i, now;
+    s32 timeout;
+    Bool sweep;
+#ifdef GPAC_DM_HAS_EPOLL
+    s32 nb_events;
+    char wake_buf[64];
+    struct epoll_event events[GF_DM_IO_MAX_EVENTS];
+#endif
+    GF_DownloadIOThread *io = (GF_DownloadIOThread *)par;
+
+    GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[Downloader] Entering I/O thread ID %d\n", gf_th_id() ));
+    gf_mx_p(io->mx);
+    io->last_sweep = gf_sys_clock();
+    while (io->run) {
+        timeout = gf_dm_io_get_timeout(io, gf_sys_clock());
+        gf_mx_v(io->mx);
+
+#ifdef GPAC_DM_HAS_EPOLL
+        nb_events = epoll_wait(io->epoll_fd, events, GF_DM_IO_MAX_EVENTS, timeout);
+#else
+        gf_sleep(timeout);
+#endif
+
+        gf_mx_p(io->mx);
+#ifdef GPAC_DM_HAS_EPOLL
+        for (i=0; (s32) i<nb_events; i++) {
+            u32 j, io_id = (u32) events[i].data.u64;
+            if (!io_id) {
+                while (read(io->wake_fd[0], wake_buf, 64) == 64) {}
+                continue;
+            }
+            /*the session may have been destroyed while waiting*/
+            for (j=0; j<gf_list_count(io->sessions); j++) {
+                GF_DownloadSession *sess = gf_list_get(io->sessions, j);
+                if (sess->io_id == io_id) {
+                    sess->io_ready = 1;
+                    break;
+                }
+            }
+        }
+        now = gf_sys_clock();
+        sweep = (now - io->last_sweep >= GF_DM_IO_SWEEP_MS) ? 1 : 0;
+        if (sweep) io->last_sweep = now;
+#else
+        /*no socket events, poll all sessions*/
+        sweep = 1;
+        for (i=0; i<gf_list_count(io->sessions); i++) {
+            GF_DownloadSession *sess = gf_list_get(io->sessions, i);
+            sess->io_ready = 1;
+        }
+#endif
+
+        i = 0;
+        while (i<gf_list_count(io->sessions)) {
+            GF_DownloadSession *sess = gf_list_get(io->sessions, i);
+            if (sess->io_ready || sess->io_throttled || gf_dm_io_needs_poll(sess) || (sweep && gf_dm_io_needs_sweep(sess))) {
+                sess->io_ready = 0;
+                gf_dm_io_process_session(io, sess);
+            }
+            /*callbacks may have removed sessions from the loop*/
+            if (gf_list_get(io->sessions, i) == sess) i++;
+        }
+    }
+    gf_mx_v(io->mx);
+    return 0;
+}
+
+static void gf_dm_io_wake(GF_DownloadIOThread *io)
+{
+#ifdef GPAC_DM_HAS_EPOLL
+    char c = 0;
+    if (write(io->wake_fd[1], &c, 1) != 1) {
+        GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[Downloader] Cannot wake up I/O thread\n"));
+    }
+#endif
+}
+
+static GF_DownloadIOThread *gf_dm_io_new(GF_DownloadManager *dm)
+{
+    GF_DownloadIOThread *io;
+#ifdef GPAC_DM_HAS_EPOLL
+    struct epoll_event ev;
+#endif
+    GF_SAFEALLOC(io, GF_DownloadIOThread);
+    if (!io) return NULL;
+    io->dm = dm;
+#ifdef GPAC_DM_HAS_EPOLL
+    io->epoll_fd = epoll_create(GF_DM_IO_MAX_EVENTS);
+    if (io->epoll_fd < 0) {
+        gf_free(io);
+        return NULL;
+    }
+    if (pipe(io->wake_fd)) {
+        close(io->epoll_fd);
+        gf_free(io);
+        return NULL;
+    }
+    fcntl(io->wake_fd[0], F_SETFL, fcntl(io->wake_fd[0], F_GETFL, 0) | O_NONBLOCK);
+    memset(&ev, 0, sizeof(struct epoll_event));
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0;
+    epoll_ctl(io->epoll_fd, EPOLL_CTL_ADD, io->wake_fd[0], &ev);
+#endif
+    io->sessions = gf_list_new();
+    io->mx = gf_mx_new("DownloadIOThread");
+    io->th = gf_th_new("DownloadIOThread");
+    io->run = 1;
+    gf_th_run(io->th, gf_dm_io_thread_run, io);
+    return io;
+}
+
+/*ends the event loop, sessions are no longer processed nor destroyed by the thread*/
+static void gf_dm_io_stop(GF_DownloadIOThread *io)
+{
+    if (!io->th) return;
+    gf_mx_p(io->mx);
+    io->run = 0;
+    gf_mx_v(io->mx);
+    gf_dm_io_wake(io);
+    gf_th_del(io->th);
+    io->th = NULL;
+}
+
+static void gf_dm_io_del(GF_DownloadIOThread *io)
+{
+    gf_dm_io_stop(io);
+    gf_list_del(io->sessions);
+    gf_mx_del(io->mx);
+#ifdef GPAC_DM_HAS_EPOLL
+    close(io->epoll_fd);
+    close(io->wake_fd[0]);
+    close(io->wake_fd[1]);
+#endif
+    gf_free(io);
+}
+
+/*hands a threaded session to the least loaded I/O thread*/
+static GF_Err gf_dm_io_add_session(GF_DownloadSession *sess)
+{
+    u32 i, min_count;
+    GF_DownloadIOThread *io = NULL;
+    if (sess->io && !(sess->flags & GF_DOWNLOAD_SESSION_THREAD_DEAD)) {
+        GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[HTTP] Session already started - ignoring start\n"));
+        return GF_OK;
+    }
+    min_count = 0;
+    for (i=0; i<gf_list_count(sess->dm->io_threads); i++) {
+        GF_DownloadIOThread *an_io = gf_list_get(sess->dm->io_threads, i);
+        if (!io || (gf_list_count(an_io->sessions) < min_count)) {
+            io = an_io;
+            min_count = gf_list_count(an_io->sessions);
+        }
+    }
+    if (!sess->mx) sess->mx = gf_mx_new(sess->orig_url);
+    if (!sess->mx) return GF_OUT_OF_MEM;
+
+    gf_mx_p(io->mx);
+    sess->flags &= ~GF_DOWNLOAD_SESSION_THREAD_DEAD;
+    sess->io = io;
+    io->last_io_id++;
+    if (!io->last_io_id) io->last_io_id++;
+    sess->io_id = io->last_io_id;
+    sess->io_fd = -1;
+    sess->io_ready = sess->io_throttled = 0;
+    gf_list_add(io->sessions, sess);
+    gf_mx_v(io->mx);
+    gf_dm_io_wake(io);
+    return GF_OK;
+}
+
 
 GF_EXPORT
 GF_DownloadSession *gf_dm_sess_new_simple(GF_DownloadManager * dm, const char *url, u32 dl_flags,
@@ -1008,6 +1655,7 @@ GF_DownloadSession *gf_dm_sess_new_simple(GF_DownloadManager * dm, const char *u
     sess->usr_cbk = usr_cbk;
     sess->creds = NULL;
     sess->dm = dm;
+    sess->io_fd = -1;
 	sess->disable_cache = dm->disable_cache;
     assert( dm );
 
@@ -1041,7 +1689,9 @@ GF_DownloadSession *gf_dm_sess_new(GF_DownloadManager *dm, const char *url, u32
     sess = gf_dm_sess_new_simple(dm, url, dl_flags, user_io, usr_cbk, e);
     if (sess) {
         sess->dm = dm;
+        gf_mx_p(dm->cache_mx);
         gf_list_add(dm->sessions, sess);
+        gf_mx_v(dm->cache_mx);
     }
     return sess;
 }
@@ -1051,6 +1701,15 @@ static GF_Err gf_dm_read_data(GF_DownloadSession *sess, char *data, u32 data_siz
     GF_Err e;
     if (!sess)
         return GF_BAD_PARAM;
+    /*data of a pipelined reply received with the previous reply*/
+    if (sess->pipe_data_size) {
+        u32 size = MIN(data_size, sess->pipe_data_size);
+        memcpy(data, sess->pipe_data, size);
+        sess->pipe_data_size -= size;
+        memmove(sess->pipe_data, sess->pipe_data + size, sess->pipe_data_size);
+        *out_read = size;
+        return GF_OK;
+    }
 #ifdef GPAC_HAS_SSL
     if (sess->ssl) {
         u32 size = SSL_read(sess->ssl, data, data_size);
@@ -1109,7 +1768,23 @@ static void gf_dm_connect(GF_DownloadSession *sess)
     GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("gf_dm_connect"":%d\n", __LINE__));
     if (!sess->sock) {
         sess->num_retry = 40;
+        /*idle connection to the same server*/
+        if (gf_dm_pool_get(sess)) {
+            sess->status = GF_NETIO_CONNECTED;
+            gf_dm_sess_notify_state(sess, GF_NETIO_CONNECTED, GF_OK);
+            gf_dm_configure_cache(sess);
+            return;
+        }
         sess->sock = gf_sk_new(GF_SOCK_TYPE_TCP);
+        sess->connect_pending = 0;
+    }
+
+    /*non-blocking connection started by the event loop*/
+    if (sess->connect_pending) {
+        e = gf_sk_get_connect_status(sess->sock);
+        if (e == GF_IP_SOCK_WOULD_BLOCK) return;
+        sess->connect_pending = 0;
+        goto connect_done;
     }
 
     /*connect*/
@@ -1164,8 +1839,21 @@ static void gf_dm_connect(GF_DownloadSession *sess)
     GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Connecting to %s:%d\n", proxy, proxy_port));
 
 	if (sess->status == GF_NETIO_SETUP) {
-		e = gf_sk_connect(sess->sock, (char *) proxy, proxy_port, (char *)ip);
+		/*in event loop mode, the connection is never waited for: the socket is monitored until writable.
+		The socket stays in non-blocking mode, reads and writes being checked with select. The SSL handshake
+		is blocking, such sessions are connected in blocking mode*/
+		if (sess->io && !(sess->flags & GF_DOWNLOAD_SESSION_USE_SSL)) {
+			gf_sk_set_block_mode(sess->sock, 1);
+			e = gf_sk_connect(sess->sock, (char *) proxy, proxy_port, (char *)ip);
+			if (e == GF_IP_SOCK_WOULD_BLOCK) {
+				sess->connect_pending = 1;
+				return;
+			}
+		} else {
+			e = gf_sk_connect(sess->sock, (char *) proxy, proxy_port, (char *)ip);
+		}
 
+connect_done:
 		/*retry*/
 		if ((e == GF_IP_SOCK_WOULD_BLOCK) && sess->num_retry) {
 			sess->status = GF_NETIO_SETUP;
@@ -1308,11 +1996,57 @@ GF_EXPORT
 GF_Err gf_dm_sess_set_range(GF_DownloadSession *sess, u64 start_range, u64 end_range)
 {
 	if (!sess) return GF_BAD_PARAM;
-	if (sess->cache_entry) return GF_BAD_PARAM;
-	if (sess->status != GF_NETIO_SETUP) return GF_BAD_PARAM;
+	/*session reusing its connection, the cache entry set up for the previous range is replaced*/
+	if (sess->status == GF_NETIO_CONNECTED) {
+		if (sess->th || sess->io) return GF_BAD_PARAM;
+		gf_dm_remove_cache_entry_from_session(sess);
+		sess->cache_entry = NULL;
+	} else {
+		if (sess->cache_entry) return GF_BAD_PARAM;
+		if (sess->status != GF_NETIO_SETUP) return GF_BAD_PARAM;
+	}
+	sess->range_start = start_range;
+	sess->range_end = end_range;
+    sess->needs_range = (start_range || end_range) ? 1 : 0;
+	if (sess->status == GF_NETIO_CONNECTED)
+		gf_dm_configure_cache(sess);
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_dm_sess_pipeline_range(GF_DownloadSession *sess, u64 start_range, u64 end_range)
+{
+	GF_Err e;
+	u32 status;
+	u64 prev_start, prev_end;
+	char sHTTP[GF_DOWNLOAD_BUFFER_SIZE];
+	if (!sess || !(sess->flags & GF_NETIO_SESSION_PERSISTENT) || !sess->sock) return GF_BAD_PARAM;
+	if ((sess->http_read_type != GET) || !sess->needs_range || sess->pipe_pending || sess->server_close) return GF_BAD_PARAM;
+	if ((sess->status != GF_NETIO_WAIT_FOR_REPLY) && (sess->status != GF_NETIO_DATA_EXCHANGE)) return GF_BAD_PARAM;
+
+	/*the request is sent on the connection while the current reply is being received*/
+	status = sess->status;
+	prev_start = sess->range_start;
+	prev_end = sess->range_end;
 	sess->range_start = start_range;
 	sess->range_end = end_range;
-    sess->needs_range = 1;
+	sess->status = GF_NETIO_CONNECTED;
+	sess->pipelining = 1;
+	e = http_send_headers(sess, sHTTP);
+	sess->pipelining = 0;
+	sess->status = status;
+	sess->range_start = prev_start;
+	sess->range_end = prev_end;
+	if (e) {
+		/*part of the request may have been sent, the connection cannot be reused*/
+		sess->server_close = 1;
+		return e;
+	}
+	sess->pipe_pending = 1;
+	sess->pipe_url = gf_strdup(sess->orig_url);
+	sess->pipe_start = start_range;
+	sess->pipe_end = end_range;
+	sess->dm->pool_pipelined++;
 	return GF_OK;
 }
 
@@ -1323,6 +2057,9 @@ GF_Err gf_dm_sess_process(GF_DownloadSession *sess)
 
 	/*if session is threaded, start thread*/
 	if (! (sess->flags & GF_NETIO_SESSION_NOT_THREADED)) {
+		/*event loop mode, the session is driven by one of the I/O threads*/
+		if (sess->dm && gf_list_count(sess->dm->io_threads)) return gf_dm_io_add_session(sess);
+
 		if (sess->th) {
 			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[HTTP] Session already started - ignoring start\n"));
 			return GF_OK;
@@ -1345,7 +2082,11 @@ GF_Err gf_dm_sess_process(GF_DownloadSession *sess)
                 gf_sleep(16);
             break;
         case GF_NETIO_WAIT_FOR_REPLY:
-            gf_sleep(16);
+            /*a pipelined reply may already be there, only wait if nothing was received*/
+            sess->do_requests(sess);
+            if (sess->status == GF_NETIO_WAIT_FOR_REPLY)
+                gf_sleep(16);
+            break;
         case GF_NETIO_CONNECTED:
         case GF_NETIO_DATA_EXCHANGE:
             sess->do_requests(sess);
@@ -1425,6 +2166,7 @@ GF_DownloadManager *gf_dm_new(GF_Config *cfg)
     dm->credentials = gf_list_new();
     dm->skip_proxy_servers = gf_list_new();
     dm->partial_downloads = gf_list_new();
+    dm->io_threads = gf_list_new();
     dm->cfg = cfg;
     dm->cache_mx = gf_mx_new("download_manager_cache_mx");
     default_cache_dir = NULL;
@@ -1455,6 +2197,49 @@ GF_DownloadManager *gf_dm_new(GF_Config *cfg)
 		if (opt && !strcmp(opt, "yes")) dm->disable_cache = 1;
 	}
 
+	if (cfg) {
+		opt = gf_cfg_get_key(cfg, "Downloader", "MemoryCacheSize");
+		if (!opt) {
+			gf_cfg_set_key(cfg, "Downloader", "MemoryCacheSize", "16384");
+			opt = "16384";
+		}
+		/*in kilobytes*/
+		dm->mem_cache_max_size = 1024 * atoi(opt);
+	}
+
+	dm->conn_pool = gf_list_new();
+	dm->pool_mx = gf_mx_new("download_manager_pool_mx");
+	if (cfg) {
+		opt = gf_cfg_get_key(cfg, "Downloader", "ConnectionPoolSize");
+		if (!opt) {
+			gf_cfg_set_key(cfg, "Downloader", "ConnectionPoolSize", "8");
+			opt = "8";
+		}
+		dm->pool_max_size = atoi(opt);
+		opt = gf_cfg_get_key(cfg, "Downloader", "ConnectionPoolTimeout");
+		if (!opt) {
+			gf_cfg_set_key(cfg, "Downloader", "ConnectionPoolTimeout", "15000");
+			opt = "15000";
+		}
+		/*in milliseconds*/
+		dm->pool_timeout = atoi(opt);
+	}
+
+	if (cfg) {
+		u32 i, nb_threads;
+		opt = gf_cfg_get_key(cfg, "Downloader", "IOThreads");
+		if (!opt) gf_cfg_set_key(cfg, "Downloader", "IOThreads", "0");
+		nb_threads = opt ? atoi(opt) : 0;
+		for (i=0; i<nb_threads; i++) {
+			GF_DownloadIOThread *io = gf_dm_io_new(dm);
+			if (!io) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[Downloader] Cannot create I/O thread, using one thread per session\n"));
+				break;
+			}
+			gf_list_add(dm->io_threads, io);
+		}
+	}
+
 	dm->head_timeout = 5000;
 	if (cfg) {
         opt = gf_cfg_get_key(cfg, "Downloader", "HTTPHeadTimeout");
@@ -1474,6 +2259,14 @@ GF_DownloadManager *gf_dm_new(GF_Config *cfg)
     return dm;
 }
 
+GF_EXPORT
+void gf_dm_get_pool_stats(GF_DownloadManager *dm, u32 *nb_hits, u32 *nb_misses, u32 *nb_pipelined)
+{
+    if (nb_hits) *nb_hits = dm ? dm->pool_hits : 0;
+    if (nb_misses) *nb_misses = dm ? dm->pool_misses : 0;
+    if (nb_pipelined) *nb_pipelined = dm ? dm->pool_pipelined : 0;
+}
+
 void gf_dm_set_auth_callback(GF_DownloadManager *dm,
                              Bool (*GetUserPassword)(void *usr_cbk, const char *site_url, char *usr_name, char *password),
                              void *usr_cbk)
@@ -1487,10 +2280,15 @@ void gf_dm_set_auth_callback(GF_DownloadManager *dm,
 GF_EXPORT
 void gf_dm_del(GF_DownloadManager *dm)
 {
+    u32 i;
     if (!dm)
         return;
     assert( dm->sessions);
     assert( dm->cache_mx );
+    /*stop I/O threads first so that they don't destroy sessions while we do - I/O threads may need the cache mutex*/
+    for (i=0; i<gf_list_count(dm->io_threads); i++) {
+        gf_dm_io_stop(gf_list_get(dm->io_threads, i));
+    }
     gf_mx_p( dm->cache_mx );
 
     while (gf_list_count(dm->partial_downloads)) {
@@ -1511,6 +2309,24 @@ void gf_dm_del(GF_DownloadManager *dm)
     }
     gf_list_del(dm->sessions);
     dm->sessions = NULL;
+    while (gf_list_count(dm->io_threads)) {
+        GF_DownloadIOThread *io = gf_list_get(dm->io_threads, 0);
+        gf_list_rem(dm->io_threads, 0);
+        gf_dm_io_del(io);
+    }
+    gf_list_del(dm->io_threads);
+    dm->io_threads = NULL;
+    if (dm->pool_hits || dm->pool_misses) {
+        GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[Downloader] Connection pool: %d hits %d misses (%d %%) - %d pipelined requests\n", dm->pool_hits, dm->pool_misses, 100*dm->pool_hits / (dm->pool_hits+dm->pool_misses), dm->pool_pipelined));
+    }
+    while (gf_list_count(dm->conn_pool)) {
+        GF_DMPooledConnection *conn = gf_list_get(dm->conn_pool, 0);
+        gf_list_rem(dm->conn_pool, 0);
+        gf_dm_pool_del_connection(conn);
+    }
+    gf_list_del(dm->conn_pool);
+    dm->conn_pool = NULL;
+    gf_mx_del(dm->pool_mx);
     assert( dm->skip_proxy_servers );
     while (gf_list_count(dm->skip_proxy_servers)) {
         char *serv = gf_list_get(dm->skip_proxy_servers, 0);
@@ -1531,15 +2347,25 @@ void gf_dm_del(GF_DownloadManager *dm)
     {
         /* Deletes DownloadedCacheEntry and associated files if required */
         Bool delete_my_files = gf_dm_needs_to_delete_cache(dm);
+        u32 i;
         while (gf_list_count(dm->cache_entries)) {
             const DownloadedCacheEntry entry = gf_list_get( dm->cache_entries, 0);
             gf_list_rem( dm->cache_entries, 0);
             if (delete_my_files)
                 gf_cache_entry_set_delete_files_when_deleted(entry);
+            /*keep complete cacheable resources for the next run*/
+            else if (gf_cache_entry_is_write_back(entry) && !gf_cache_check_if_cache_file_is_corrupted(entry))
+                gf_cache_entry_persist(entry);
             gf_cache_delete_entry(entry);
         }
         gf_list_del( dm->cache_entries );
         dm->cache_entries = NULL;
+        for (i=0; i<GF_DM_CACHE_INDEX_SIZE; i++) {
+            if (dm->cache_index[i]) gf_list_del(dm->cache_index[i]);
+            dm->cache_index[i] = NULL;
+        }
+        dm->mem_cache_first = dm->mem_cache_last = NULL;
+        dm->mem_cache_size = 0;
     }
 
     gf_list_del( dm->partial_downloads );
@@ -1646,6 +2472,7 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, const char *d
     }
 
     if (sess->total_size && (sess->bytes_done == sess->total_size)) {
+        sess->reply_done = 1;
         gf_dm_disconnect(sess, 0);
         par.msg_type = GF_NETIO_DATA_TRANSFERED;
         par.error = GF_OK;
@@ -1674,7 +2501,7 @@ GF_Err gf_dm_sess_fetch_data(GF_DownloadSession *sess, char *buffer, u32 buffer_
 {
     GF_Err e;
     if (/*sess->cache || */ !buffer || !buffer_size) return GF_BAD_PARAM;
-    if (sess->th) return GF_BAD_PARAM;
+    if (sess->th || sess->io) return GF_BAD_PARAM;
     if (sess->status == GF_NETIO_DISCONNECTED) return GF_EOS;
     if (sess->status > GF_NETIO_DATA_TRANSFERED) return GF_BAD_PARAM;
 
@@ -1738,6 +2565,18 @@ const char *gf_dm_sess_get_cache_name(GF_DownloadSession * sess)
     return gf_cache_get_cache_filename(sess->cache_entry);
 }
 
+GF_EXPORT
+GF_Err gf_dm_sess_persist_cache(GF_DownloadSession * sess)
+{
+    GF_Err e;
+    if (!sess || !sess->dm) return GF_BAD_PARAM;
+    if (! sess->cache_entry )  return GF_BAD_PARAM;
+    gf_mx_p( sess->dm->cache_mx );
+    e = gf_dm_cache_persist_entry(sess->dm, sess->cache_entry);
+    gf_mx_v( sess->dm->cache_mx );
+    return e;
+}
+
 GF_EXPORT
 Bool gf_dm_sess_can_be_cached_on_disk(const GF_DownloadSession *sess)
 {
@@ -1938,7 +2777,7 @@ static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP) {
     }
 
 
-    if (!send_profile) {
+    if (!send_profile && !sess->pipelining) {
         gf_dm_sess_user_io(sess, &par);
         if (par.data && par.size) {
             sprintf(range_buf, "Content-Length: %d\r\n", par.size);
@@ -1952,8 +2791,8 @@ static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP) {
 	    /* This will force the server to respond with Icy-Metaint */
 		strcat(sHTTP, "Icy-Metadata: 1\r\n");
 
-		/*cached headers are not appended in POST*/
-		if (!sess->disable_cache && (GF_OK < appendHttpCacheHeaders( sess->cache_entry, sHTTP)) ) {
+		/*cached headers are not appended in POST, nor in pipelined requests which have no cache entry yet*/
+		if (!sess->disable_cache && !sess->pipelining && (GF_OK < appendHttpCacheHeaders( sess->cache_entry, sHTTP)) ) {
 	        GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("Cache Entry : %p, FAILED to append cache directives.", sess->cache_entry));
 		}
 	}
@@ -2012,13 +2851,22 @@ static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP) {
         GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Sending request %s\n ; Error Code=%d\n", sHTTP, e));
     }
 
+    if (sess->pipelining) return e;
     if (e) {
+        /*pooled connection closed by the server while idle, reconnect*/
+        if (sess->conn_reused) {
+            GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Reused connection to %s closed, reconnecting\n", sess->server_name));
+            gf_dm_disconnect(sess, 1);
+            sess->status = GF_NETIO_SETUP;
+            return e;
+        }
         sess->status = GF_NETIO_STATE_ERROR;
         sess->last_error = e;
         gf_dm_sess_notify_state(sess, GF_NETIO_STATE_ERROR, e);
         return e;
     }
 
+    sess->reply_done = 0;
     sess->status = GF_NETIO_WAIT_FOR_REPLY;
     gf_dm_sess_notify_state(sess, GF_NETIO_WAIT_FOR_REPLY, GF_OK);
     return GF_OK;
@@ -2048,7 +2896,11 @@ static GF_Err http_parse_remaining_body(GF_DownloadSession * sess, char * sHTTP)
             }
         }
 #endif
-        e = gf_dm_read_data(sess, sHTTP, GF_DOWNLOAD_BUFFER_SIZE, &size);
+        /*do not read past the reply, the connection may carry a pipelined reply*/
+        size = GF_DOWNLOAD_BUFFER_SIZE;
+        if (sess->total_size && (sess->total_size != SIZE_IN_STREAM) && (sess->total_size - sess->bytes_done < size))
+            size = sess->total_size - sess->bytes_done;
+        e = gf_dm_read_data(sess, sHTTP, size, &size);
         if (e!= GF_IP_CONNECTION_CLOSED && (!size || e == GF_IP_NETWORK_EMPTY)) {
             if (e == GF_IP_CONNECTION_CLOSED || (!sess->total_size && (gf_sys_clock() - sess->start_time > 5000))) {
                 sess->total_size = sess->bytes_done;
@@ -2184,6 +3036,10 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
     }
     rsp_code = (u32) atoi(comp);
     Pos = gf_token_get(buf, Pos, " \r\n", comp, 400);
+    /*the server answered on this connection*/
+    sess->conn_reused = 0;
+    /*HTTP/1.0 servers close the connection unless told otherwise*/
+    sess->server_close = strncmp(buf, "HTTP/1.1", 8) ? 1 : 0;
 
     no_range = range = ContentLength = first_byte = last_byte = total_size = 0;
     /* parse header */
@@ -2279,8 +3135,10 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
             if (sess->dm && sess->dm->cfg)
                 gf_cfg_set_key(sess->dm->cfg, "Downloader", "UserProfileID", hdr_val);
         }
-        /*			else if (!stricmp(hdr, "Connection") )
-        				if (strstr(hdr_val, "close")) sess->http_read_type = 1; */
+        else if (!stricmp(hdr, "Connection") ) {
+            if (strstr(hdr_val, "close")) sess->server_close = 1;
+            else if (strstr(hdr_val, "eep-")) sess->server_close = 0;
+        }
 
         if (sep) sep[0]=':';
         if (hdr_sep) hdr_sep[0] = '\r';
@@ -2343,12 +3201,12 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
         if (sess->user_proc) {
             /* For modules that do not use cache and have problems with GF_NETIO_DATA_TRANSFERED ... */
             const char * filename;
-            FILE * f;
+            GF_CacheReader reader;
             filename = gf_cache_get_cache_filename(sess->cache_entry);
             GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Sending data to modules from %s...\n", filename));
-            f = gf_f64_open(filename, "rb");
+            reader = gf_cache_reader_new(sess->cache_entry);
             assert(filename);
-            if (!f) {
+            if (!reader) {
                 GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] FAILED to open cache file %s for reading contents !\n", filename));
                 /* Ooops, no cache, redowload everything ! */
                 gf_dm_disconnect(sess, 0);
@@ -2375,7 +3233,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
                 int read = 0;
                 u32 total_size = gf_cache_get_cache_filesize(sess->cache_entry);
                 do {
-                    read = fread(file_cache_buff, sizeof(char), 16384, f);
+                    read = gf_cache_reader_read(reader, file_cache_buff, 16384);
                     if (read > 0) {
                         sess->bytes_done += read;
                         sess->total_size = total_size;
@@ -2388,7 +3246,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
                     }
                 } while ( read > 0);
             }
-            fclose(f);
+            gf_cache_reader_del(reader);
             GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] all data has been sent to modules from %s.\n", filename));
         }
         /* Cache file is the most recent */
@@ -2509,6 +3367,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
         sess->use_cache_file = 0;
 
     if (sess->http_read_type==HEAD) {
+        sess->reply_done = 1;
         gf_dm_disconnect(sess, 0);
         gf_dm_sess_notify_state(sess, GF_NETIO_DATA_TRANSFERED, GF_OK);
         sess->status = GF_NETIO_DISCONNECTED;
@@ -2567,6 +3426,15 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 
     /* we may have existing data in this buffer ... */
     if (!e && (BodyStart < (s32) bytesRead)) {
+        /*data past the body belongs to the pipelined reply*/
+        if ((sess->status == GF_NETIO_DATA_EXCHANGE) && sess->total_size && (sess->total_size != SIZE_IN_STREAM) && ((u32) (bytesRead - BodyStart) > sess->total_size)) {
+            u32 extra = bytesRead - BodyStart - sess->total_size;
+            sess->pipe_data = gf_realloc(sess->pipe_data, sizeof(char) * (sess->pipe_data_size + extra));
+            memmove(sess->pipe_data + extra, sess->pipe_data, sess->pipe_data_size);
+            memcpy(sess->pipe_data, sHTTP + BodyStart + sess->total_size, extra);
+            sess->pipe_data_size += extra;
+            bytesRead -= extra;
+        }
         gf_dm_data_received(sess, sHTTP + BodyStart, bytesRead - BodyStart);
         if (sess->init_data) gf_free(sess->init_data);
         sess->init_data_size = bytesRead - BodyStart;
@@ -2596,6 +3464,24 @@ void http_do_requests(GF_DownloadSession *sess)
     char sHTTP[GF_DOWNLOAD_BUFFER_SIZE];
     switch (sess->status) {
     case GF_NETIO_CONNECTED:
+        if (sess->pipe_pending) {
+            /*the request has already been sent on the connection*/
+            if (sess->needs_range && (sess->http_read_type == GET) && !strcmp(sess->pipe_url, sess->orig_url)
+                    && (sess->pipe_start == sess->range_start) && (sess->pipe_end == sess->range_end)) {
+                sess->pipe_pending = 0;
+                gf_free(sess->pipe_url);
+                sess->pipe_url = NULL;
+                sess->reply_done = 0;
+                sess->status = GF_NETIO_WAIT_FOR_REPLY;
+                gf_dm_sess_notify_state(sess, GF_NETIO_WAIT_FOR_REPLY, GF_OK);
+                break;
+            }
+            /*another resource is requested, the pipelined reply cannot be skipped*/
+            GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Pipelined request for %s not used, reconnecting\n", sess->pipe_url));
+            gf_dm_disconnect(sess, 1);
+            sess->status = GF_NETIO_SETUP;
+            break;
+        }
         http_send_headers(sess, sHTTP);
         break;
     case GF_NETIO_WAIT_FOR_REPLY:
@@ -2774,7 +3660,8 @@ const char * gf_cache_get_cache_filename_range( const GF_DownloadSession * sess,
         /* Not found, we are gonna create the file */
         char * newFilename;
         GF_PartialDownload * partial;
-        FILE * fw, *fr;
+        FILE * fw;
+        GF_CacheReader fr;
         u32 maxLen;
         const char * orig = gf_cache_get_cache_filename(sess->cache_entry);
         if (orig == NULL)
@@ -2791,47 +3678,49 @@ const char * gf_cache_get_cache_filename_range( const GF_DownloadSession * sess,
             gf_free( newFilename );
             return NULL;
         }
-        fr = gf_f64_open(orig, "rb");
+        /*the reader serves both memory and disk entries*/
+        fr = gf_cache_reader_new(sess->cache_entry);
         if (!fr) {
             GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[CACHE] Cannot open full cache file %s\n", orig));
             gf_free( newFilename );
             fclose( fw );
+            return NULL;
         }
         /* Now, we copy ! */
         {
             char copyBuff[GF_DOWNLOAD_BUFFER_SIZE];
             s64 read, write, total;
             total = endOffset - startOffset;
-            read = gf_f64_seek(fr, startOffset, SEEK_SET);
+            read = gf_cache_reader_seek_at(fr, startOffset);
             if (read != startOffset) {
                 GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[CACHE] Cannot seek at right start offset in %s\n", orig));
-                fclose( fr );
+                gf_cache_reader_del( fr );
                 fclose( fw );
                 gf_free( newFilename );
                 return NULL;
             }
             do {
-                read = fread(copyBuff, sizeof(char), MIN(sizeof(copyBuff), (size_t)  total), fr);
+                read = gf_cache_reader_read(fr, copyBuff, (s32) MIN(sizeof(copyBuff), (size_t)  total));
                 if (read > 0) {
                     total-= read;
                     write = gf_fwrite(copyBuff, sizeof(char), (size_t) read, fw);
                     if (write != read) {
                         /* Something bad happened */
                         fclose( fw );
-                        fclose (fr );
+                        gf_cache_reader_del( fr );
                         gf_free( newFilename );
                         return NULL;
                     }
                 } else {
                     if (read < 0) {
                         fclose( fw );
-                        fclose( fr );
+                        gf_cache_reader_del( fr );
                         gf_free( newFilename );
                         return NULL;
                     }
                 }
             } while (total > 0);
-            fclose( fr );
+            gf_cache_reader_del( fr );
             fclose (fw);
             partial = gf_malloc( sizeof(GF_PartialDownload));
             if (partial == NULL) {
@@ -2851,7 +3740,7 @@ const char * gf_cache_get_cache_filename_range( const GF_DownloadSession * sess,
 GF_Err gf_dm_sess_reassign(GF_DownloadSession *sess, u32 flags, gf_dm_user_io user_io, void *cbk)
 {
 	/*shall only be called for non-threaded sessions!! */
-	if (sess->th) return GF_BAD_PARAM;
+	if (sess->th || sess->io) return GF_BAD_PARAM;
 
 #if 0
 	/*if the user requests non-cached (eg callback-sent) data, but the session was configured to use file, we need to copy back existing
@@ -2902,6 +3791,13 @@ GF_Err gf_dm_sess_reassign(GF_DownloadSession *sess, u32 flags, gf_dm_user_io us
 	sess->user_proc = user_io;
 	sess->usr_cbk = cbk;
 
+	/*the new user reads the data from the cache file*/
+	if (sess->cache_entry && gf_cache_entry_is_in_memory(sess->cache_entry) && !GF_DM_SESS_USES_MEM_CACHE(sess)) {
+		gf_mx_p( sess->dm->cache_mx );
+		gf_dm_cache_persist_entry(sess->dm, sess->cache_entry);
+		gf_mx_v( sess->dm->cache_mx );
+	}
+
 	sess->num_retry = SESSION_RETRY_COUNT;
 
 	if (sess->status==GF_NETIO_DISCONNECTED)
@@ -66,6 +66,7 @@
 #define SLEEP_ABS_SELECT		1
 
 static u32 sys_start_time = 0;
+static u64 sys_start_time_hr = 0;
 #endif
 
 
@@ -83,6 +84,20 @@ u32 gf_sys_clock()
 	gettimeofday(&now, NULL);
 	return ( (now.tv_sec)*1000 + (now.tv_usec) / 1000) - sys_start_time;
 }
+
+GF_EXPORT
+u64 gf_sys_clock_high_res()
+{
+#if defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((u64) now.tv_sec)*1000000 + now.tv_nsec/1000 - sys_start_time_hr;
+#else
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return ((u64) now.tv_sec)*1000000 + now.tv_usec - sys_start_time_hr;
+#endif
+}
 #endif
 
 
@@ -943,6 +958,15 @@ u32 gf_sys_clock()
 {
 	return OS_GetSysClock();
 }
+
+u64 gf_sys_clock_high_res()
+{
+	LARGE_INTEGER now;
+	if (!frequency.QuadPart) return 1000 * (u64) OS_GetSysClock();
+	QueryPerformanceCounter(&now);
+	now.QuadPart -= init_counter.QuadPart;
+	return (u64) ((now.QuadPart * 1000000) / frequency.QuadPart);
+}
 #endif
 
 
@@ -1095,6 +1119,7 @@ void gf_sys_init(Bool enable_memory_tracker)
 		memset(&the_rti, 0, sizeof(GF_SystemRTInfo));
 		the_rti.pid = getpid();
 		sys_start_time = gf_sys_clock();
+		sys_start_time_hr = gf_sys_clock_high_res();
 #endif
 		GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("[core] process id %d\n", the_rti.pid));
 
@@ -1708,6 +1733,7 @@ Bool gf_sys_get_rti(u32 refresh_time_ms, GF_SystemRTInfo *rti, u32 flags)
 }
 
 
+GF_EXPORT
 char * gf_get_default_cache_directory(){  
 #ifdef _WIN32_WCE
 	return gf_strdup( "\\windows\\temp" );
@@ -530,6 +530,20 @@ GF_Err gf_sk_connect(GF_Socket *sock, const char *PeerName, u16 PortNumber, cons
 
 		ret = connect(sock->socket, aip->ai_addr, aip->ai_addrlen);
 		if (ret == SOCKET_ERROR) {
+			/*non-blocking connect in progress, completion is checked with gf_sk_get_connect_status*/
+			if (sock->flags & GF_SOCK_NON_BLOCKING) {
+				u32 err = LASTSOCKERROR;
+#ifndef WIN32
+				if (err == EINPROGRESS) err = EAGAIN;
+#endif
+				if (err == EAGAIN) {
+					memcpy(&sock->dest_addr, aip->ai_addr, aip->ai_addrlen);
+					sock->dest_addr_len = aip->ai_addrlen;
+					freeaddrinfo(res);
+					if (lip) freeaddrinfo(lip);
+					return GF_IP_SOCK_WOULD_BLOCK;
+				}
+			}
 			closesocket(sock->socket);
 			sock->socket = NULL_SOCKET;
 			continue;
@@ -584,6 +598,9 @@ GF_Err gf_sk_connect(GF_Socket *sock, const char *PeerName, u16 PortNumber, cons
 			u32 res = LASTSOCKERROR;
 			GF_LOG(GF_LOG_NETWORK, GF_LOG_ERROR, ("[Core] Couldn't connect socket - last sock error %d\n", res));
 			switch (res) {
+#ifndef WIN32
+			case EINPROGRESS:
+#endif
 			case EAGAIN: return GF_IP_SOCK_WOULD_BLOCK;
 #ifdef WIN32
 			case WSAEINVAL:
@@ -605,6 +622,38 @@ GF_Err gf_sk_connect(GF_Socket *sock, const char *PeerName, u16 PortNumber, cons
 }
 
 
+GF_EXPORT
+GF_Err gf_sk_get_connect_status(GF_Socket *sock)
+{
+	s32 ready, res;
+#ifdef WIN32
+	s32 len;
+#else
+	socklen_t len;
+#endif
+	struct timeval timeout;
+	fd_set Group;
+	if (!sock || !sock->socket) return GF_BAD_PARAM;
+
+	FD_ZERO(&Group);
+	FD_SET(sock->socket, &Group);
+	timeout.tv_sec = 0;
+	timeout.tv_usec = 0;
+	ready = select(sock->socket+1, NULL, &Group, NULL, &timeout);
+	if (ready == SOCKET_ERROR) return GF_IP_NETWORK_FAILURE;
+	if (!ready || !FD_ISSET(sock->socket, &Group)) return GF_IP_SOCK_WOULD_BLOCK;
+
+	res = 0;
+	len = sizeof(res);
+	if (getsockopt(sock->socket, SOL_SOCKET, SO_ERROR, (char *) &res, &len) == SOCKET_ERROR) return GF_IP_NETWORK_FAILURE;
+	if (res) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] Couldn't connect socket - socket error %d\n", res));
+		return GF_IP_CONNECTION_FAILURE;
+	}
+	return GF_OK;
+}
+
+
 //binds the given socket to the specified port. If ReUse is true
 //this will enable reuse of ports on a single machine
 GF_EXPORT
@@ -1166,6 +1215,7 @@ GF_Err gf_sk_receive(GF_Socket *sock, char *buffer, u32 length, u32 startFrom, u
 }
 
 
+GF_EXPORT
 GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 {
 	s32 i;
@@ -1177,6 +1227,7 @@ GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 	return GF_OK;
 }
 
+GF_EXPORT
 GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 {
 	u32 client_address_size;
@@ -71,6 +71,13 @@ u32 gf_sys_clock()
 	return ( (now.tv_sec)*1000 + (now.tv_usec) / 1000) - sys_start_time;
 }
 
+GF_EXPORT
+u64 gf_sys_clock_high_res()
+{
+	/*no high resolution counter used here, millisecond precision*/
+	return 1000 * (u64) gf_sys_clock();
+}
+
 
 GF_EXPORT
 void gf_sleep(u32 ms)